@@ -0,0 +1,15 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+uniform sampler2D texture_diffuse1;
+
+void main()
+{
+    vec4 colour = texture(texture_diffuse1, TexCoords);
+    // The atlas is transparent around the model
+    if (colour.a < 0.5)
+        discard;
+    FragColor = colour;
+}
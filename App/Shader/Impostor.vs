@@ -0,0 +1,45 @@
+#version 330 core
+layout (location = 0) in vec2 aCorner;
+layout (location = 1) in vec4 aInstance;
+
+out vec2 TexCoords;
+
+layout (std140) uniform Camera
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec4 cameraPosition;
+};
+
+// The centre and half size of the bounds of the model which was rendered into the atlas
+uniform vec3 impostorCentre;
+uniform vec2 impostorHalfSize;
+// The number of view angles in the atlas
+uniform float numViews;
+
+const float PI = 3.14159265;
+
+void main()
+{
+    // aInstance holds the position of the instance in xyz and its scale in w
+    vec3 centre = aInstance.xyz + impostorCentre * aInstance.w;
+
+    // Turn the quad around the up axis to face the camera
+    vec2 toCamera = cameraPosition.xz - centre.xz;
+    if (dot(toCamera, toCamera) < 0.0001)
+        toCamera = vec2(0.0, 1.0);
+    toCamera = normalize(toCamera);
+    vec3 right = vec3(toCamera.y, 0.0, -toCamera.x);
+
+    vec3 worldPos = centre
+                  + right * (aCorner.x * impostorHalfSize.x * aInstance.w)
+                  + vec3(0.0, aCorner.y * impostorHalfSize.y * aInstance.w, 0.0);
+
+    // Pick the view angle in the atlas which is nearest to the direction of the camera
+    float angle = atan(toCamera.x, toCamera.y);
+    float frame = mod(floor(angle * numViews / (2.0 * PI) + 0.5), numViews);
+    TexCoords = vec2((frame + (aCorner.x + 1.0) * 0.5) / numViews, (aCorner.y + 1.0) * 0.5);
+
+    gl_Position = viewProjection * vec4(worldPos, 1.0f);
+}
@@ -0,0 +1,21 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+// The model matrix of each draw, selected by the base instance of its indirect draw command
+layout (location = 3) in mat4 aModel;
+
+out vec2 TexCoord;
+
+layout (std140) uniform Camera
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec4 cameraPosition;
+};
+
+void main()
+{
+	gl_Position = viewProjection * aModel * vec4(aPos, 1.0);
+	TexCoord = vec2(aTexCoord.x, aTexCoord.y);
+}
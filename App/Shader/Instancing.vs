@@ -5,11 +5,16 @@ layout (location = 3) in mat4 aInstanceMatrix;
 
 out vec2 TexCoords;
 
-uniform mat4 projection;
-uniform mat4 view;
+layout (std140) uniform Camera
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec4 cameraPosition;
+};
 
 void main()
 {
     TexCoords = aTexCoords;
-    gl_Position = projection * view * aInstanceMatrix * vec4(aPos, 1.0f); 
+    gl_Position = viewProjection * aInstanceMatrix * vec4(aPos, 1.0f); 
 }
\ No newline at end of file
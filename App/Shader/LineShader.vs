@@ -5,11 +5,16 @@ layout (location = 1) in vec4 aColor;
 out vec4 ourColor;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform Camera
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec4 cameraPosition;
+};
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0f);
+    gl_Position = viewProjection * model * vec4(aPos, 1.0f);
     ourColor = aColor;
 }
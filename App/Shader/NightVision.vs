@@ -6,13 +6,18 @@ layout (location = 2) in vec2 texCoords;
 out vec2 TexCoords;
  
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform Camera
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec4 cameraPosition;
+};
  
 void main()
 {
  
-gl_Position = projection * view * model * vec4(position, 1.0f);
+gl_Position = viewProjection * model * vec4(position, 1.0f);
 TexCoords = texCoords;
  
 }
\ No newline at end of file
@@ -0,0 +1,17 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec4 aColor;
+
+out vec2 TexCoord;
+out vec4 Color;
+
+uniform mat4 transform;
+
+void main()
+{
+	// The corners of the sprites are already moved to their positions by CSpriteBatcher
+	gl_Position = transform * vec4(aPos, 0.0, 1.0);
+	TexCoord = aTexCoord;
+	Color = aColor;
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 TexCoord;
+
+// The tile textures, one per layer
+uniform sampler2DArray texture1;
+
+void main()
+{
+	FragColor = texture(texture1, TexCoord);
+}
\ No newline at end of file
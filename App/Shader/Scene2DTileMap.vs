@@ -0,0 +1,14 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec3 aTexCoord;
+
+out vec3 TexCoord;
+
+uniform mat4 transform;
+
+void main()
+{
+	gl_Position = transform * vec4(aPos, 0.0, 1.0);
+	// The z of the texture coordinate is the layer of the tile in the array texture
+	TexCoord = aTexCoord;
+}
\ No newline at end of file
@@ -10,8 +10,13 @@ out vec2 TexCoords;
 out vec4 Color;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform Camera
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec4 cameraPosition;
+};
 
 void main()
 {
@@ -20,5 +25,5 @@ void main()
     TexCoords = aTexCoords;
 	Color = aColor;
     
-    gl_Position = projection * view * vec4(FragPos, 1.0);
+    gl_Position = viewProjection * vec4(FragPos, 1.0);
 }
\ No newline at end of file
@@ -1,10 +1,16 @@
 #version 330
 
+layout (std140) uniform Camera
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec4 cameraPosition;
+};
+
 uniform struct Matrices
 {
-	mat4 projMatrix;
 	mat4 modelMatrix;
-	mat4 viewMatrix;                                                                           
 	mat4 normalMatrix;
 } matrices;
 
@@ -22,10 +28,10 @@ uniform mat4 HeightmapScaleMatrix;
 void main()
 {
   vec4 inPositionScaled = HeightmapScaleMatrix * vec4(inPosition, 1.0);
-  mat4 mMVP = matrices.projMatrix * matrices.viewMatrix * matrices.modelMatrix;
+  mat4 mMVP = viewProjection * matrices.modelMatrix;
     
   gl_Position = mMVP * inPositionScaled;
-  vEyeSpacePos = matrices.viewMatrix * matrices.modelMatrix * vec4(inPosition, 1.0);
+  vEyeSpacePos = view * matrices.modelMatrix * vec4(inPosition, 1.0);
 
   vTexCoord = inCoord;
   vNormal = inNormal;
@@ -1,12 +1,12 @@
 #version 330 core
 in vec2 TexCoords;
+in vec3 TextColour;
 out vec4 colour;
 
 uniform sampler2D text;
-uniform vec3 textColour;
 
 void main()
 {    
     vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
-    colour = vec4(textColour, 1.0) * sampled;
+    colour = vec4(TextColour, 1.0) * sampled;
 }  
\ No newline at end of file
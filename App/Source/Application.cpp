@@ -43,6 +43,24 @@ using namespace std;
 // Include CPauseState
 #include "GameStateManagement/PauseState.h"
 
+// Include CLogger
+#include "System\Logger.h"
+// Include CMemoryStats
+#include "System\MemoryStats.h"
+// Include CFrameArena
+#include "System\FrameArena.h"
+// Include CRandomStreams
+#include "System\Random.h"
+
+// Include CCameraUniformBuffer
+#include "RenderControl\CameraUniformBuffer.h"
+// Include CIndirectDrawBuffer
+#include "RenderControl\IndirectDrawBuffer.h"
+// Include CSpriteBatcher
+#include "RenderControl\SpriteBatcher.h"
+// Include COcclusionCuller
+#include "RenderControl\OcclusionCuller.h"
+
 /**
  @brief Define an error callback
  @param error The error code
@@ -136,6 +154,19 @@ Application::~Application(void)
  */
 bool Application::Init(void)
 {
+	// Start the logger first, so that the other singletons can write to it
+	CLogger::GetInstance()->Init(CLogger::OUTPUT_CONSOLE | CLogger::OUTPUT_FILE, "Log.txt");
+#ifdef _DEBUG
+	CLogger::GetInstance()->SetLevel(CLogger::LEVEL_DEBUG);
+#endif
+
+	// Count the heap allocations of each frame on this thread
+	CMemoryStats::GetInstance()->Init();
+	// Initialise the arena for the transient allocations of each frame
+	CFrameArena::GetInstance()->Init();
+	// Seed the random number streams of all the subsystems from the global seed
+	CRandomStreams::GetInstance()->Init(CSettings::GetInstance()->uiRandomSeed);
+
 	// glfw: initialize and configure
 	// ------------------------------
 	//Initialize GLFW
@@ -221,8 +252,13 @@ bool Application::Init(void)
 	// Initialise the CSoundController singleton
 	CSoundController::GetInstance()->Init();
 
+	// Initialise the camera uniform buffer which the 3D shaders read the camera from
+	CCameraUniformBuffer::GetInstance()->Init();
+
 	// Add the shaders to the ShaderManager
 	CShaderManager::GetInstance()->Add("2DShader", "Shader//Scene2D.vs", "Shader//Scene2D.fs");
+	CShaderManager::GetInstance()->Add("2DTileMapShader", "Shader//Scene2DTileMap.vs", "Shader//Scene2DTileMap.fs");
+	CShaderManager::GetInstance()->Add("2DSpriteShader", "Shader//Scene2DSprite.vs", "Shader//Scene2DSprite.fs");
 	CShaderManager::GetInstance()->Add("2DColorShader", "Shader//Scene2DColor.vs", 
 										"Shader//Scene2DColor.fs");
 
@@ -231,13 +267,23 @@ bool Application::Init(void)
 	CShaderManager::GetInstance()->Add("Shader3D_SkyBox", "Shader//SkyBox.vs", "Shader//SkyBox.fs");
 	CShaderManager::GetInstance()->Add("Shader3DNoColour", "Shader//Ground.vs", "Shader//Ground.fs");
 	CShaderManager::GetInstance()->Add("Shader_GUI", "Shader//GUIShader.vs", "Shader//GUIShader.fs");
+	CShaderManager::GetInstance()->Add("textShader", "Shader//text.vs", "Shader//text.fs");
 	CShaderManager::GetInstance()->Add("Shader3D_Model", "Shader//ModelShader.vs", "Shader//ModelShader.fs");
 	CShaderManager::GetInstance()->Add("cRenderToTextureShader", "Shader//RenderToTexture.vs", "Shader//RenderToTexture.fs");
 	CShaderManager::GetInstance()->Add("Shader3D_Instancing", "Shader//Instancing.vs", "Shader//Instancing.fs");
+	CShaderManager::GetInstance()->Add("Shader3D_Impostor", "Shader//Impostor.vs", "Shader//Impostor.fs");
 	CShaderManager::GetInstance()->Add("Shader3D_Terrain", "Shader//Terrain.vs", "Shader//Terrain.fs");
+	CShaderManager::GetInstance()->Add("Shader3D_Indirect", "Shader//Indirect.vs", "Shader//Ground.fs");
 
 	CShaderManager::GetInstance()->Add("NightVision", "Shader//NightVision.vs", "Shader//NightVision.fs");
 
+	// Initialise the shared buffers which the solid objects submit their indirect draws into
+	CIndirectDrawBuffer::GetInstance()->Init("Shader3D_Indirect");
+	// Initialise the streaming buffers which the 2D entities submit their sprites into
+	CSpriteBatcher::GetInstance()->Init("2DSpriteShader");
+	// Initialise the occlusion culling and start its worker thread
+	COcclusionCuller::GetInstance()->Init();
+
 	// Initialise the CFPSCounter instance
 	cFPSCounter = CFPSCounter::GetInstance();
 	cFPSCounter->Init();
@@ -276,6 +322,10 @@ void Application::Run(void)
 		if (dElapsedTime > 0.0166666666666667)
 			dElapsedTime = 0.0166666666666667;
 
+		// Free the transient allocations of the last frame, and start counting the heap allocations
+		CFrameArena::GetInstance()->Reset();
+		CMemoryStats::GetInstance()->BeginFrame();
+
 		// Call the active Game State's Update method
 		if (CGameStateManager::GetInstance()->Update(dElapsedTime) == false)
 		{
@@ -285,6 +335,8 @@ void Application::Run(void)
 		// Call the active Game State's Render method
 		CGameStateManager::GetInstance()->Render();
 
+		CMemoryStats::GetInstance()->EndFrame();
+
 		// glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
 		// -------------------------------------------------------------------------------
 		glfwSwapBuffers(cSettings->pWindow);
@@ -333,6 +385,14 @@ void Application::Destroy(void)
 	CGameStateManager::GetInstance()->Destroy();
 	// Destory the ShaderManager
 	CShaderManager::GetInstance()->Destroy();
+	// Destroy the camera uniform buffer
+	CCameraUniformBuffer::GetInstance()->Destroy();
+	// Destroy the indirect draw buffers
+	CIndirectDrawBuffer::GetInstance()->Destroy();
+	// Destroy the sprite batcher
+	CSpriteBatcher::GetInstance()->Destroy();
+	// Destroy the occlusion culling, which stops its worker thread
+	COcclusionCuller::GetInstance()->Destroy();
 
 	// Destroy the mouse instance
 	CMouseController::GetInstance()->Destroy();
@@ -353,6 +413,16 @@ void Application::Destroy(void)
 
 	// Destroy the CSettings instance
 	CSettings::GetInstance()->Destroy();
+
+	// Destroy the CRandomStreams
+	CRandomStreams::GetInstance()->Destroy();
+
+	// Destroy the CFrameArena and the CMemoryStats
+	CFrameArena::GetInstance()->Destroy();
+	CMemoryStats::GetInstance()->Destroy();
+
+	// Destroy the CLogger last, after writing out the remaining log messages
+	CLogger::GetInstance()->Destroy();
 }
 
 /**
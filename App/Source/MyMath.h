@@ -15,6 +15,9 @@ Header file for math helper functions
 #include <ctime>
 #include <cstdlib>
 
+// Include CRandomStreams
+#include "System/Random.h"
+
 /******************************************************************************/
 /*!
 \brief
@@ -192,16 +195,16 @@ T Lerp(T a, T b, T t)
 /******************************************************************************/
 /*!
 \brief
-Initialize Random Number Generator
+Initialize Random Number Generator. Every stream is seeded from one global seed.
 
-\param None
+\param seed - the global seed, or 0 to seed from the clock
  
 \exception None
 \return None
 */
-	inline void InitRNG(void)
+	inline void InitRNG(unsigned long long seed = 0)
 	{
-		srand (static_cast<unsigned> (time(0)));
+		CRandomStreams::GetInstance()->Init(seed);
 	}//end of InitRNG function
 	
 /******************************************************************************/
@@ -209,14 +212,14 @@ Initialize Random Number Generator
 \brief
 Return a random integer
 
-\param None
+\param stream - the stream of the subsystem which uses the number
  
 \exception None
 \return Random integer
 */
-	inline unsigned RandInt(void)
+	inline unsigned RandInt(CRandomStreams::STREAM stream = CRandomStreams::GENERAL)
 	{
-		return rand();
+		return CRandomStreams::GetInstance()->Get(stream).NextUInt();
 	}//end of RandInt function
 	
 /******************************************************************************/
@@ -226,29 +229,29 @@ Return a random integer between min and max
 
 \param min - minimum range
 \param max - maximum range
+\param stream - the stream of the subsystem which uses the number
  
 \exception None
 \return Random integer
 */
-	inline int RandIntMinMax (int min, int max)
+	inline int RandIntMinMax (int min, int max, CRandomStreams::STREAM stream = CRandomStreams::GENERAL)
 	{
-		int num = rand() % (max - min + 1);
-		return (num + min);
+		return CRandomStreams::GetInstance()->Get(stream).RangeInt(min, max);
 	}//end of RandIntMinMax function
 	
 /******************************************************************************/
 /*!
 \brief
-Return a random float
+Return a random float between 0 and 1
 
-\param None
+\param stream - the stream of the subsystem which uses the number
  
 \exception None
 \return Random float
 */
-	inline float RandFloat (void)
+	inline float RandFloat (CRandomStreams::STREAM stream = CRandomStreams::GENERAL)
 	{
-		return rand() / static_cast <float> (RAND_MAX);
+		return CRandomStreams::GetInstance()->Get(stream).NextFloat();
 	}//end of RandFloat function
 	
 /******************************************************************************/
@@ -258,14 +261,14 @@ Return a random float between min and max
 
 \param min - minimum range
 \param max - maximum range
+\param stream - the stream of the subsystem which uses the number
  
 \exception None
 \return Random float
 */
-	inline float RandFloatMinMax (float min, float max)
+	inline float RandFloatMinMax (float min, float max, CRandomStreams::STREAM stream = CRandomStreams::GENERAL)
 	{
-		float num = (max - min) * RandFloat ();
-		return (num + min);
+		return CRandomStreams::GetInstance()->Get(stream).RangeFloat(min, max);
 	}//end of RandFloatMinMax function
 
 }//end namespace Math
@@ -21,20 +21,26 @@ using namespace std;
 
 // Include the Map2D as we will use it to check the player's movements and actions
 #include "Map2D.h"
+#include "RenderControl\SpriteBatcher.h"
+// Include CPathRequestService
+#include "PathRequestService.h"
 // Include math.h
 #include <math.h>
+// Include algorithm
+#include <algorithm>
 
 /**
  @brief Constructor This constructor has protected access modifier as this class will be a Singleton
  */
 CEnemy2D::CEnemy2D(void)
 	: bIsActive(false)
+	, quadMesh(NULL)
 	, cMap2D(NULL)
 	, cSettings(NULL)
 	, cPlayer2D(NULL)
 	, sCurrentFSM(FSM::IDLE)
 	, iFSMCounter(0)
-	, quadMesh(NULL)
+	, uiPathAgentID(-1)
 {
 	transform = glm::mat4(1.0f);	// make sure to initialize matrix to identity matrix first
 
@@ -69,6 +75,10 @@ CEnemy2D::~CEnemy2D(void)
 	// We won't delete this since it was created elsewhere
 	cMap2D = NULL;
 
+	// Cancel the path request of this enemy2D
+	if (uiPathAgentID != (unsigned int)-1)
+		CPathRequestService::GetInstance()->RemoveAgent(uiPathAgentID);
+
 	// optional: de-allocate all resources once they've outlived their purpose:
 	glDeleteVertexArrays(1, &VAO);
 	glDeleteBuffers(1, &VBO);
@@ -119,6 +129,9 @@ bool CEnemy2D::Init(void)
 	cPhysics2D.Init();
 	cPhysics2D.SetStatus(CPhysics2D::STATUS::FALL);
 
+	// Get an ID for the path requests of this enemy2D
+	uiPathAgentID = CPathRequestService::GetInstance()->AddAgent();
+
 	// If this class is initialised properly, then set the bIsActive to true
 	bIsActive = true;
 
@@ -167,41 +180,32 @@ void CEnemy2D::Update(const double dElapsedTime)
 	case ATTACK:
 		if (cPhysics2D.CalculateDistance(i32vec2Index, cPlayer2D->i32vec2Index) < 5.0f)
 		{
-			// Calculate a path to the player
-			//cMap2D->PrintSelf();
-			//cout << "StartPos: " << i32vec2Index.x << ", " << i32vec2Index.y << endl;
-			//cout << "TargetPos: " << cPlayer2D->i32vec2Index.x << ", " 
-			//		<< cPlayer2D->i32vec2Index.y << endl;
-			auto path = cMap2D->PathFind(	i32vec2Index, 
+			if (cSettings->bUseAsyncPathFinding == true)
+			{
+				// Ask for a path to the player, which is found in the background and arrives in a later frame.
+				// The last path is followed until then. The nearer enemies are searched first.
+				CPathRequestService* cPathRequestService = CPathRequestService::GetInstance();
+				cPathRequestService->GetPath(uiPathAgentID, vPath);
+				cPathRequestService->RequestPath(	uiPathAgentID,
+													i32vec2Index,
+													cPlayer2D->i32vec2Index,
+													(int)cPhysics2D.CalculateDistance(i32vec2Index, cPlayer2D->i32vec2Index));
+			}
+			else
+			{
+				// Calculate a path to the player
+				//cMap2D->PrintSelf();
+				//cout << "StartPos: " << i32vec2Index.x << ", " << i32vec2Index.y << endl;
+				//cout << "TargetPos: " << cPlayer2D->i32vec2Index.x << ", " 
+				//		<< cPlayer2D->i32vec2Index.y << endl;
+				vPath = cMap2D->PathFind(	i32vec2Index, 
 											cPlayer2D->i32vec2Index, 
 											heuristic::euclidean, 
 											10);
-			//cout << "=== Printing out the path ===" << endl;
+			}
 
 			// Calculate new destination
-			bool bFirstPosition = true;
-			for (const auto& coord : path)
-			{
-				//std::cout << coord.x << "," << coord.y << "\n";
-				if (bFirstPosition == true)
-				{
-					// Set a destination
-					i32vec2Destination = coord;
-					// Calculate the direction between enemy2D and this destination
-					i32vec2Direction = i32vec2Destination - i32vec2Index;
-					bFirstPosition = false;
-				}
-				else
-				{
-					if ((coord - i32vec2Destination) == i32vec2Direction)
-					{
-						// Set a destination
-						i32vec2Destination = coord;
-					}
-					else
-						break;
-				}
-			}
+			UpdateDestination(vPath);
 
 			//cout << "i32vec2Destination : " << i32vec2Destination.x 
 			//		<< ", " << i32vec2Destination.y << endl;
@@ -266,6 +270,18 @@ void CEnemy2D::Render(void)
 	if (!bIsActive)
 		return;
 
+	if (cSettings->bUseSpriteBatching == true)
+	{
+		// Add this enemy to the CSpriteBatcher, which draws all the enemies together
+		CSpriteBatcher::GetInstance()->Submit(	iTextureID,
+												glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+												vec2UVCoordinate,
+												glm::vec2(cSettings->TILE_WIDTH, cSettings->TILE_HEIGHT),
+												currentColor,
+												0);
+		return;
+	}
+
 	glBindVertexArray(VAO);
 	// get matrix's uniform location and set matrix
 	unsigned int transformLoc = glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "transform");
@@ -436,7 +452,7 @@ bool CEnemy2D::CheckPosition(DIRECTION eDirection)
 		if (i32vec2NumMicroSteps.y == 0)
 		{
 			// If the grid is not accessible, then return false
-			if (cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x) >= 100)
+			if (cMap2D->IsSolid(i32vec2Index.y, i32vec2Index.x))
 			{
 				return false;
 			}
@@ -445,8 +461,8 @@ bool CEnemy2D::CheckPosition(DIRECTION eDirection)
 		else if (i32vec2NumMicroSteps.y != 0)
 		{
 			// If the 2 grids are not accessible, then return false
-			if ((cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x) >= 100) ||
-				(cMap2D->GetMapInfo(i32vec2Index.y + 1, i32vec2Index.x) >= 100))
+			if (cMap2D->IsSolid(i32vec2Index.y, i32vec2Index.x) ||
+				cMap2D->IsSolid(i32vec2Index.y + 1, i32vec2Index.x))
 			{
 				return false;
 			}
@@ -465,7 +481,7 @@ bool CEnemy2D::CheckPosition(DIRECTION eDirection)
 		if (i32vec2NumMicroSteps.y == 0)
 		{
 			// If the grid is not accessible, then return false
-			if (cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x + 1) >= 100)
+			if (cMap2D->IsSolid(i32vec2Index.y, i32vec2Index.x + 1))
 			{
 				return false;
 			}
@@ -474,8 +490,8 @@ bool CEnemy2D::CheckPosition(DIRECTION eDirection)
 		else if (i32vec2NumMicroSteps.y != 0)
 		{
 			// If the 2 grids are not accessible, then return false
-			if ((cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x + 1) >= 100) ||
-				(cMap2D->GetMapInfo(i32vec2Index.y + 1, i32vec2Index.x + 1) >= 100))
+			if (cMap2D->IsSolid(i32vec2Index.y, i32vec2Index.x + 1) ||
+				cMap2D->IsSolid(i32vec2Index.y + 1, i32vec2Index.x + 1))
 			{
 				return false;
 			}
@@ -495,7 +511,7 @@ bool CEnemy2D::CheckPosition(DIRECTION eDirection)
 		if (i32vec2NumMicroSteps.x == 0)
 		{
 			// If the grid is not accessible, then return false
-			if (cMap2D->GetMapInfo(i32vec2Index.y + 1, i32vec2Index.x) >= 100)
+			if (cMap2D->IsSolid(i32vec2Index.y + 1, i32vec2Index.x))
 			{
 				return false;
 			}
@@ -504,8 +520,8 @@ bool CEnemy2D::CheckPosition(DIRECTION eDirection)
 		else if (i32vec2NumMicroSteps.x != 0)
 		{
 			// If the 2 grids are not accessible, then return false
-			if ((cMap2D->GetMapInfo(i32vec2Index.y + 1, i32vec2Index.x) >= 100) ||
-				(cMap2D->GetMapInfo(i32vec2Index.y + 1, i32vec2Index.x + 1) >= 100))
+			if (cMap2D->IsSolid(i32vec2Index.y + 1, i32vec2Index.x) ||
+				cMap2D->IsSolid(i32vec2Index.y + 1, i32vec2Index.x + 1))
 			{
 				return false;
 			}
@@ -517,7 +533,7 @@ bool CEnemy2D::CheckPosition(DIRECTION eDirection)
 		if (i32vec2NumMicroSteps.x == 0)
 		{
 			// If the grid is not accessible, then return false
-			if (cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x) >= 100)
+			if (cMap2D->IsSolid(i32vec2Index.y, i32vec2Index.x))
 			{
 				return false;
 			}
@@ -526,8 +542,8 @@ bool CEnemy2D::CheckPosition(DIRECTION eDirection)
 		else if (i32vec2NumMicroSteps.x != 0)
 		{
 			// If the 2 grids are not accessible, then return false
-			if ((cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x) >= 100) ||
-				(cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x + 1) >= 100))
+			if (cMap2D->IsSolid(i32vec2Index.y, i32vec2Index.x) ||
+				cMap2D->IsSolid(i32vec2Index.y, i32vec2Index.x + 1))
 			{
 				return false;
 			}
@@ -568,45 +584,42 @@ void CEnemy2D::UpdateJumpFall(const double dElapsedTime)
 		// Call the physics engine update method to calculate the final velocity and displacement
 		cPhysics2D.Update();
 		// Get the displacement from the physics engine
-		glm::vec2 v2Displacement = cPhysics2D.GetDisplacement();
-
-		// Store the current i32vec2Index.y
-		int iIndex_YAxis_OLD = i32vec2Index.y;
+		glm::vec2 v2Displacement = cPhysics2D.GetDeltaDisplacement();
 
+		// Translate the displacement from pixels to micro steps
 		int iDisplacement_MicroSteps = (int)(v2Displacement.y / cSettings->MICRO_STEP_YAXIS); //DIsplacement divide by distance for 1 microstep
-		if (i32vec2Index.y < (int)cSettings->NUM_TILES_YAXIS)
+
+		// Sweep the enemy2D up through the map, so that a fast jump cannot pass through a tile
+		const glm::vec2 vec2Position(	i32vec2Index.x + (float)i32vec2NumMicroSteps.x / cSettings->NUM_STEPS_PER_TILE_XAXIS,
+										i32vec2Index.y + (float)i32vec2NumMicroSteps.y / cSettings->NUM_STEPS_PER_TILE_YAXIS);
+		glm::i32vec2 i32vec2HitTile;
+		float fTimeOfImpact;
+		if ((iDisplacement_MicroSteps > 0) &&
+			(cMap2D->SweepAABB(	vec2Position,
+								vec2Position + glm::vec2(1.0f, 1.0f),
+								glm::vec2(0.0f, (float)iDisplacement_MicroSteps / cSettings->NUM_STEPS_PER_TILE_YAXIS),
+								i32vec2HitTile,
+								fTimeOfImpact) == true))
+		{
+			// Stop below the tile which was hit, aligned with the row
+			i32vec2Index.y = i32vec2HitTile.y - 1;
+			i32vec2NumMicroSteps.y = 0;
+			// Set the Physics to fall status
+			cPhysics2D.SetStatus(CPhysics2D::STATUS::FALL);
+		}
+		else
 		{
-			i32vec2NumMicroSteps.y += iDisplacement_MicroSteps;
-			if (i32vec2NumMicroSteps.y > cSettings->NUM_STEPS_PER_TILE_YAXIS)
-			{
-				i32vec2NumMicroSteps.y -= cSettings->NUM_STEPS_PER_TILE_YAXIS;
-				if (i32vec2NumMicroSteps.y < 0)
-					i32vec2NumMicroSteps.y = 0;
-				i32vec2Index.y++;
-			}
+			// Move by the whole displacement
+			int iMicroSteps = i32vec2Index.y * (int)cSettings->NUM_STEPS_PER_TILE_YAXIS + i32vec2NumMicroSteps.y + iDisplacement_MicroSteps;
+			if (iMicroSteps < 0)
+				iMicroSteps = 0;
+			i32vec2Index.y = iMicroSteps / (int)cSettings->NUM_STEPS_PER_TILE_YAXIS;
+			i32vec2NumMicroSteps.y = iMicroSteps % (int)cSettings->NUM_STEPS_PER_TILE_YAXIS;
 		}
 
 		// Constraint the player's position within the screen boundary
 		Constraint(UP);
 
-		// Iterate through all rows until the proposed row
-		// Check if the player will hit a tile; stop jump if so.
-		int iIndex_YAxis_Proposed = i32vec2Index.y;
-		for (int i = iIndex_YAxis_OLD; i <= iIndex_YAxis_Proposed; i++)
-		{
-			// Change the player's index to the current i value
-			i32vec2Index.y = i;
-			// If the new position is not feasible, then revert to old position
-			if (CheckPosition(UP) == false)
-			{
-				// Align with the row
-				i32vec2NumMicroSteps.y = 0;
-				// Set the Physics to fall status
-				cPhysics2D.SetStatus(CPhysics2D::STATUS::FALL);
-				break;
-			}
-		}
-
 		// If the player is still jumping and the initial velocity has reached zero or below zero, 
 		// then it has reach the peak of its jump
 		if ((cPhysics2D.GetStatus() == CPhysics2D::STATUS::JUMP) && (cPhysics2D.GetInitialVelocity().y <= 0.0f))
@@ -622,46 +635,41 @@ void CEnemy2D::UpdateJumpFall(const double dElapsedTime)
 		// Call the physics engine update method to calculate the final velocity and displacement
 		cPhysics2D.Update();
 		// Get the displacement from the physics engine
-		glm::vec2 v2Displacement = cPhysics2D.GetDisplacement();
-
-		// Store the current i32vec2Index.y
-		int iIndex_YAxis_OLD = i32vec2Index.y;
+		glm::vec2 v2Displacement = cPhysics2D.GetDeltaDisplacement();
 
 		// Translate the displacement from pixels to indices
-		int iDisplacement_MicroSteps = (int)(v2Displacement.y / cSettings->MICRO_STEP_YAXIS);
-
-		if (i32vec2Index.y >= 0)
+		int iDisplacement_MicroSteps = abs((int)(v2Displacement.y / cSettings->MICRO_STEP_YAXIS));
+
+		// Sweep the enemy2D down through the map, so that a fast fall cannot pass through a tile
+		const glm::vec2 vec2Position(	i32vec2Index.x + (float)i32vec2NumMicroSteps.x / cSettings->NUM_STEPS_PER_TILE_XAXIS,
+										i32vec2Index.y + (float)i32vec2NumMicroSteps.y / cSettings->NUM_STEPS_PER_TILE_YAXIS);
+		glm::i32vec2 i32vec2HitTile;
+		float fTimeOfImpact;
+		if ((iDisplacement_MicroSteps > 0) &&
+			(cMap2D->SweepAABB(	vec2Position,
+								vec2Position + glm::vec2(1.0f, 1.0f),
+								glm::vec2(0.0f, -(float)iDisplacement_MicroSteps / cSettings->NUM_STEPS_PER_TILE_YAXIS),
+								i32vec2HitTile,
+								fTimeOfImpact) == true))
+		{
+			// Land on top of the tile which was hit
+			i32vec2Index.y = i32vec2HitTile.y + 1;
+			// Set the Physics to idle status
+			cPhysics2D.SetStatus(CPhysics2D::STATUS::IDLE);
+			i32vec2NumMicroSteps.y = 0;
+		}
+		else
 		{
-			i32vec2NumMicroSteps.y -= fabs(iDisplacement_MicroSteps);
-			if (i32vec2NumMicroSteps.y < 0)
-			{
-				i32vec2NumMicroSteps.y = ((int)cSettings->NUM_STEPS_PER_TILE_YAXIS) - 1;
-				i32vec2Index.y--;
-			}
+			// Move by the whole displacement
+			int iMicroSteps = i32vec2Index.y * (int)cSettings->NUM_STEPS_PER_TILE_YAXIS + i32vec2NumMicroSteps.y - iDisplacement_MicroSteps;
+			if (iMicroSteps < 0)
+				iMicroSteps = 0;
+			i32vec2Index.y = iMicroSteps / (int)cSettings->NUM_STEPS_PER_TILE_YAXIS;
+			i32vec2NumMicroSteps.y = iMicroSteps % (int)cSettings->NUM_STEPS_PER_TILE_YAXIS;
 		}
 
 		// Constraint the player's position within the screen boundary
 		Constraint(DOWN);
-
-		// Iterate through all rows until the proposed row
-		// Check if the player will hit a tile; stop fall if so.
-		int iIndex_YAxis_Proposed = i32vec2Index.y;
-		for (int i = iIndex_YAxis_OLD; i >= iIndex_YAxis_Proposed; i--)
-		{
-			// Change the player's index to the current i value
-			i32vec2Index.y = i;
-			// If the new position is not feasible, then revert to old position
-			if (CheckPosition(DOWN) == false)
-			{
-				// Revert to the previous position
-				if (i != iIndex_YAxis_OLD)
-					i32vec2Index.y = i + 1;
-				// Set the Physics to idle status
-				cPhysics2D.SetStatus(CPhysics2D::STATUS::IDLE);
-				i32vec2NumMicroSteps.y = 0;
-				break;
-			}
-		}
 	}
 }
 
@@ -812,3 +820,40 @@ void CEnemy2D::UpdatePosition(void)
 		}
 	}
 }
+
+/**
+ @brief Set the destination and direction from the first straight part of a path. A path which was found in an
+		earlier frame is followed from the current tile, and is ignored if this enemy2D has moved off it.
+ @param path A const std::vector<glm::i32vec2>& variable containing the path, which does not include its start
+ */
+void CEnemy2D::UpdateDestination(const std::vector<glm::i32vec2>& path)
+{
+	// Skip the part of the path which this enemy2D has already moved along
+	std::vector<glm::i32vec2>::const_iterator itCoord = std::find(path.begin(), path.end(), i32vec2Index);
+	if (itCoord == path.end())
+		itCoord = path.begin();
+	else
+		++itCoord;
+	if (itCoord == path.end())
+		return;
+
+	// The next tile of the path has to be next to this enemy2D
+	const glm::i32vec2 i32vec2Step = *itCoord - i32vec2Index;
+	if ((abs(i32vec2Step.x) > 1) || (abs(i32vec2Step.y) > 1))
+		return;
+
+	// Set a destination
+	i32vec2Destination = *itCoord;
+	// Calculate the direction between enemy2D and this destination
+	i32vec2Direction = i32vec2Destination - i32vec2Index;
+	for (++itCoord; itCoord != path.end(); ++itCoord)
+	{
+		if ((*itCoord - i32vec2Destination) == i32vec2Direction)
+		{
+			// Set a destination
+			i32vec2Destination = *itCoord;
+		}
+		else
+			break;
+	}
+}
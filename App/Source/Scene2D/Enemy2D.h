@@ -28,6 +28,8 @@ class CMap2D;
 // Include Player2D
 #include "Player2D.h"
 
+#include <vector>
+
 class CEnemy2D : public CEntity2D
 {
 public:
@@ -138,6 +140,11 @@ protected:
 	// FSM counter - count how many frames it has been in this FSM
 	int iFSMCounter;
 
+	// The ID of this enemy2D in the CPathRequestService
+	unsigned int uiPathAgentID;
+	// The last path to the player which was found for this enemy2D
+	std::vector<glm::i32vec2> vPath;
+
 	// Max count in a state
 	const int iMaxFSMCounter = 60;
 
@@ -167,5 +174,8 @@ protected:
 
 	// Update position
 	void UpdatePosition(void);
+
+	// Set the destination and direction from the first straight part of a path
+	void UpdateDestination(const std::vector<glm::i32vec2>& path);
 };
 
@@ -0,0 +1,498 @@
+/**
+ CLevelFile
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#include "LevelFile.h"
+
+// Include CLogger
+#include "System/Logger.h"
+
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static const char arrLevelFileMagic[4] = { 'T', 'L', 'V', 'L' };
+static const uint32_t uiLevelFileVersion = 1;
+// The tiles of each level start at a multiple of this many bytes
+static const uint64_t uiLevelFileAlignment = 16;
+
+/**
+ @brief Constructor
+ */
+CLevelFile::CLevelFile(void)
+	: pData(NULL)
+	, uiDataSize(0)
+	, pFileHandle(NULL)
+	, pMappingHandle(NULL)
+	, pLevelEntry(NULL)
+	, uiNumLevels(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CLevelFile::~CLevelFile(void)
+{
+	Close();
+}
+
+/**
+ @brief Open a level file and map it into memory. The tiles are only read from the disk when they are used.
+ @param filename A const string& variable containing the name of the level file
+ @return true if the level file is opened and valid, else false
+ */
+bool CLevelFile::Open(const string& filename)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE hFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+								FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		LOG_ERROR(MAP, "Unable to open the level file %s", filename.c_str());
+		return false;
+	}
+	pFileHandle = hFile;
+
+	LARGE_INTEGER iFileSize;
+	if ((GetFileSizeEx(hFile, &iFileSize) == 0) || (iFileSize.QuadPart < (LONGLONG)sizeof(FileHeader)))
+	{
+		LOG_ERROR(MAP, "The level file %s is too small", filename.c_str());
+		Close();
+		return false;
+	}
+	uiDataSize = (size_t)iFileSize.QuadPart;
+
+	HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (hMapping == NULL)
+	{
+		LOG_ERROR(MAP, "Unable to map the level file %s", filename.c_str());
+		Close();
+		return false;
+	}
+	pMappingHandle = hMapping;
+
+	pData = (const unsigned char*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+#else
+	const int iFile = open(filename.c_str(), O_RDONLY);
+	if (iFile < 0)
+	{
+		LOG_ERROR(MAP, "Unable to open the level file %s", filename.c_str());
+		return false;
+	}
+
+	struct stat sFileStat;
+	if ((fstat(iFile, &sFileStat) != 0) || (sFileStat.st_size < (off_t)sizeof(FileHeader)))
+	{
+		LOG_ERROR(MAP, "The level file %s is too small", filename.c_str());
+		close(iFile);
+		return false;
+	}
+	uiDataSize = (size_t)sFileStat.st_size;
+
+	void* pMapped = mmap(NULL, uiDataSize, PROT_READ, MAP_PRIVATE, iFile, 0);
+	// The mapping stays valid after the file is closed
+	close(iFile);
+	pData = (pMapped == MAP_FAILED) ? NULL : (const unsigned char*)pMapped;
+#endif
+	if (pData == NULL)
+	{
+		LOG_ERROR(MAP, "Unable to map the level file %s", filename.c_str());
+		Close();
+		return false;
+	}
+
+	// Check the header and the table of the levels
+	const FileHeader* pHeader = (const FileHeader*)pData;
+	if ((memcmp(pHeader->arrMagic, arrLevelFileMagic, sizeof(arrLevelFileMagic)) != 0) ||
+		(pHeader->uiVersion != uiLevelFileVersion))
+	{
+		LOG_ERROR(MAP, "%s is not a level file of version %u", filename.c_str(), uiLevelFileVersion);
+		Close();
+		return false;
+	}
+	if ((uint64_t)pHeader->uiNumLevels * sizeof(LevelEntry) > uiDataSize - sizeof(FileHeader))
+	{
+		LOG_ERROR(MAP, "The table of the levels in %s is truncated", filename.c_str());
+		Close();
+		return false;
+	}
+
+	pLevelEntry = (const LevelEntry*)(pData + sizeof(FileHeader));
+	for (unsigned int uiLevel = 0; uiLevel < pHeader->uiNumLevels; uiLevel++)
+	{
+		const LevelEntry& cEntry = pLevelEntry[uiLevel];
+		const uint64_t uiNumTiles = (uint64_t)cEntry.uiNumRows * cEntry.uiNumCols;
+		if ((cEntry.uiOffset > uiDataSize) || (cEntry.uiSize > uiDataSize - cEntry.uiOffset) ||
+			(cEntry.uiEncoding >= NUM_ENCODING) ||
+			((cEntry.uiEncoding == RAW) && (cEntry.uiSize != uiNumTiles * sizeof(int32_t))) ||
+			((cEntry.uiEncoding == RAW) && ((cEntry.uiOffset % sizeof(int32_t)) != 0)))
+		{
+			LOG_ERROR(MAP, "Level %u of %s is invalid", uiLevel, filename.c_str());
+			Close();
+			return false;
+		}
+	}
+	uiNumLevels = pHeader->uiNumLevels;
+
+	return true;
+}
+
+/**
+ @brief Unmap and close the level file
+ */
+void CLevelFile::Close(void)
+{
+#ifdef _WIN32
+	if (pData)
+		UnmapViewOfFile(pData);
+	if (pMappingHandle)
+		CloseHandle((HANDLE)pMappingHandle);
+	if (pFileHandle)
+		CloseHandle((HANDLE)pFileHandle);
+#else
+	if (pData)
+		munmap((void*)pData, uiDataSize);
+#endif
+	pData = NULL;
+	uiDataSize = 0;
+	pFileHandle = NULL;
+	pMappingHandle = NULL;
+	pLevelEntry = NULL;
+	uiNumLevels = 0;
+}
+
+/**
+ @brief Get the number of levels in the level file
+ @return The number of levels
+ */
+unsigned int CLevelFile::GetNumLevels(void) const
+{
+	return uiNumLevels;
+}
+
+/**
+ @brief Get the number of rows of a level
+ @param uiLevel A const unsigned int variable containing the level
+ @return The number of rows, or 0 if there is no such level
+ */
+unsigned int CLevelFile::GetNumRows(const unsigned int uiLevel) const
+{
+	return (uiLevel < uiNumLevels) ? pLevelEntry[uiLevel].uiNumRows : 0;
+}
+
+/**
+ @brief Get the number of columns of a level
+ @param uiLevel A const unsigned int variable containing the level
+ @return The number of columns, or 0 if there is no such level
+ */
+unsigned int CLevelFile::GetNumCols(const unsigned int uiLevel) const
+{
+	return (uiLevel < uiNumLevels) ? pLevelEntry[uiLevel].uiNumCols : 0;
+}
+
+/**
+ @brief Get the tiles of a raw level in the mapped file. They are valid until the file is closed.
+ @param uiLevel A const unsigned int variable containing the level
+ @return The tiles, row by row, or NULL if the level is compressed or there is no such level
+ */
+const int32_t* CLevelFile::GetTiles(const unsigned int uiLevel) const
+{
+	if ((uiLevel >= uiNumLevels) || (pLevelEntry[uiLevel].uiEncoding != RAW))
+		return NULL;
+	return (const int32_t*)(pData + pLevelEntry[uiLevel].uiOffset);
+}
+
+/**
+ @brief Copy the tiles of a level into vTile, decompressing them if needed
+ @param uiLevel A const unsigned int variable containing the level
+ @param vTile A vector<int>& variable which receives the tiles, row by row
+ @return true if the tiles are read, else false
+ */
+bool CLevelFile::ReadTiles(const unsigned int uiLevel, vector<int>& vTile) const
+{
+	if (uiLevel >= uiNumLevels)
+		return false;
+
+	const LevelEntry& cEntry = pLevelEntry[uiLevel];
+	const size_t uiNumTiles = (size_t)cEntry.uiNumRows * cEntry.uiNumCols;
+	const int32_t* pTile = (const int32_t*)(pData + cEntry.uiOffset);
+	if (cEntry.uiEncoding == RAW)
+	{
+		vTile.assign(pTile, pTile + uiNumTiles);
+		return true;
+	}
+
+	// Expand the (count, value) pairs
+	vTile.resize(uiNumTiles);
+	const size_t uiNumPairs = (size_t)(cEntry.uiSize / (2 * sizeof(int32_t)));
+	size_t uiTile = 0;
+	for (size_t i = 0; i < uiNumPairs; i++)
+	{
+		int32_t iCount, iValue;
+		memcpy(&iCount, pTile + i * 2, sizeof(int32_t));
+		memcpy(&iValue, pTile + i * 2 + 1, sizeof(int32_t));
+		if ((iCount <= 0) || ((size_t)iCount > uiNumTiles - uiTile))
+			return false;
+		std::fill(vTile.begin() + uiTile, vTile.begin() + uiTile + iCount, iValue);
+		uiTile += iCount;
+	}
+	return uiTile == uiNumTiles;
+}
+
+/**
+ @brief Write levels into a level file
+ @param filename A const string& variable containing the name of the level file
+ @param vLevel A const vector<LevelData>& variable containing the levels
+ @param eEncoding A const ENCODING variable containing how the tiles are stored
+ @return true if the level file is written, else false
+ */
+bool CLevelFile::Write(const string& filename, const vector<LevelData>& vLevel, const ENCODING eEncoding)
+{
+	// Encode the levels and fill in the table of the levels
+	vector<vector<int32_t>> vEncoded(vLevel.size());
+	vector<LevelEntry> vEntry(vLevel.size());
+	uint64_t uiOffset = sizeof(FileHeader) + vLevel.size() * sizeof(LevelEntry);
+	for (size_t i = 0; i < vLevel.size(); i++)
+	{
+		const vector<int>& vTile = vLevel[i].vTile;
+		if (vTile.size() != (size_t)vLevel[i].uiNumRows * vLevel[i].uiNumCols)
+			return false;
+
+		vector<int32_t>& vData = vEncoded[i];
+		if (eEncoding == RLE)
+		{
+			size_t uiTile = 0;
+			while (uiTile < vTile.size())
+			{
+				size_t uiRunEnd = uiTile + 1;
+				while ((uiRunEnd < vTile.size()) && (vTile[uiRunEnd] == vTile[uiTile]) && (uiRunEnd - uiTile < 0x7FFFFFFF))
+					uiRunEnd++;
+				vData.push_back((int32_t)(uiRunEnd - uiTile));
+				vData.push_back(vTile[uiTile]);
+				uiTile = uiRunEnd;
+			}
+		}
+		else
+		{
+			vData.assign(vTile.begin(), vTile.end());
+		}
+
+		uiOffset = (uiOffset + uiLevelFileAlignment - 1) & ~(uiLevelFileAlignment - 1);
+		vEntry[i].uiNumRows = vLevel[i].uiNumRows;
+		vEntry[i].uiNumCols = vLevel[i].uiNumCols;
+		vEntry[i].uiEncoding = eEncoding;
+		vEntry[i].uiReserved = 0;
+		vEntry[i].uiOffset = uiOffset;
+		vEntry[i].uiSize = vData.size() * sizeof(int32_t);
+		uiOffset += vEntry[i].uiSize;
+	}
+
+	ofstream cFile(filename.c_str(), ios::out | ios::binary | ios::trunc);
+	if (cFile.is_open() == false)
+	{
+		LOG_ERROR(MAP, "Unable to create the level file %s", filename.c_str());
+		return false;
+	}
+
+	FileHeader sHeader;
+	memcpy(sHeader.arrMagic, arrLevelFileMagic, sizeof(arrLevelFileMagic));
+	sHeader.uiVersion = uiLevelFileVersion;
+	sHeader.uiNumLevels = (uint32_t)vLevel.size();
+	sHeader.uiReserved = 0;
+	cFile.write((const char*)&sHeader, sizeof(sHeader));
+	if (vEntry.empty() == false)
+		cFile.write((const char*)&vEntry[0], vEntry.size() * sizeof(LevelEntry));
+
+	const char arrPadding[uiLevelFileAlignment] = { 0 };
+	for (size_t i = 0; i < vLevel.size(); i++)
+	{
+		const uint64_t uiPosition = (uint64_t)cFile.tellp();
+		cFile.write(arrPadding, (streamsize)(vEntry[i].uiOffset - uiPosition));
+		if (vEncoded[i].empty() == false)
+			cFile.write((const char*)&vEncoded[i][0], (streamsize)vEntry[i].uiSize);
+	}
+
+	if (cFile.good() == false)
+	{
+		LOG_ERROR(MAP, "Unable to write the level file %s", filename.c_str());
+		return false;
+	}
+	return true;
+}
+
+/**
+ @brief Parse the text of a CSV level, whose first line is the column names. The integers are parsed in place,
+		so no memory is allocated for each cell.
+ @param pText A const char* variable containing the text of the CSV file
+ @param uiSize A const size_t variable containing the length of the text
+ @param cLevel A LevelData& variable which receives the tiles and the size of the level
+ @param psHeader A string* variable which receives the line of column names, if it is not NULL
+ @return true if the text is a valid level, else false
+ */
+bool CLevelFile::ParseCSV(const char* pText, const size_t uiSize, LevelData& cLevel, string* psHeader)
+{
+	const char* p = pText;
+	const char* const pEnd = pText + uiSize;
+
+	// Skip the UTF-8 byte order mark
+	if ((uiSize >= 3) && ((unsigned char)p[0] == 0xEF) && ((unsigned char)p[1] == 0xBB) && ((unsigned char)p[2] == 0xBF))
+		p += 3;
+
+	// The first line contains the column names
+	const char* pHeaderEnd = p;
+	while ((pHeaderEnd < pEnd) && (*pHeaderEnd != '\n'))
+		pHeaderEnd++;
+	if (psHeader)
+	{
+		const char* pHeaderTextEnd = pHeaderEnd;
+		if ((pHeaderTextEnd > p) && (pHeaderTextEnd[-1] == '\r'))
+			pHeaderTextEnd--;
+		psHeader->assign(p, pHeaderTextEnd);
+	}
+	p = (pHeaderEnd < pEnd) ? pHeaderEnd + 1 : pEnd;
+
+	cLevel.uiNumRows = 0;
+	cLevel.uiNumCols = 0;
+	cLevel.vTile.clear();
+
+	while (p < pEnd)
+	{
+		// Skip the empty lines
+		if ((*p == '\n') || (*p == '\r'))
+		{
+			p++;
+			continue;
+		}
+
+		const char* const pRowStart = p;
+		unsigned int uiNumCells = 0;
+		while (true)
+		{
+			while ((p < pEnd) && ((*p == ' ') || (*p == '\t')))
+				p++;
+
+			bool bNegative = false;
+			if ((p < pEnd) && ((*p == '-') || (*p == '+')))
+			{
+				bNegative = (*p == '-');
+				p++;
+			}
+			if ((p >= pEnd) || (*p < '0') || (*p > '9'))
+			{
+				LOG_ERROR(MAP, "Expected a number in row %u, column %u of the CSV level", cLevel.uiNumRows + 1, uiNumCells + 1);
+				return false;
+			}
+			int64_t iValue = 0;
+			while ((p < pEnd) && (*p >= '0') && (*p <= '9'))
+			{
+				iValue = iValue * 10 + (*p - '0');
+				if (iValue > (bNegative ? 0x80000000LL : 0x7FFFFFFFLL))
+				{
+					LOG_ERROR(MAP, "The number in row %u, column %u of the CSV level is too large", cLevel.uiNumRows + 1, uiNumCells + 1);
+					return false;
+				}
+				p++;
+			}
+			cLevel.vTile.push_back((int)(bNegative ? -iValue : iValue));
+			uiNumCells++;
+
+			while ((p < pEnd) && ((*p == ' ') || (*p == '\t')))
+				p++;
+			if ((p < pEnd) && (*p == ','))
+			{
+				p++;
+				continue;
+			}
+			if ((p >= pEnd) || (*p == '\r') || (*p == '\n'))
+				break;
+			LOG_ERROR(MAP, "Unexpected character '%c' in row %u of the CSV level", *p, cLevel.uiNumRows + 1);
+			return false;
+		}
+
+		if (cLevel.uiNumRows == 0)
+		{
+			// Reserve the tiles for the whole file, estimated from the length of the first row
+			cLevel.uiNumCols = uiNumCells;
+			const size_t uiRowLength = (size_t)(p - pRowStart) + 1;
+			cLevel.vTile.reserve(uiNumCells * ((size_t)(pEnd - pRowStart) / uiRowLength + 1));
+		}
+		else if (uiNumCells != cLevel.uiNumCols)
+		{
+			LOG_ERROR(MAP, "Row %u of the CSV level has %u columns instead of %u", cLevel.uiNumRows + 1, uiNumCells, cLevel.uiNumCols);
+			return false;
+		}
+		cLevel.uiNumRows++;
+	}
+
+	return true;
+}
+
+/**
+ @brief Read a CSV level in one block and parse it
+ @param filename A const string& variable containing the name of the CSV file
+ @param cLevel A LevelData& variable which receives the tiles and the size of the level
+ @param psHeader A string* variable which receives the line of column names, if it is not NULL
+ @return true if the file is read and is a valid level, else false
+ */
+bool CLevelFile::LoadCSV(const string& filename, LevelData& cLevel, string* psHeader)
+{
+	ifstream cFile(filename.c_str(), ios::in | ios::binary);
+	if (cFile.is_open() == false)
+	{
+		LOG_ERROR(MAP, "Unable to open the CSV level %s", filename.c_str());
+		return false;
+	}
+
+	cFile.seekg(0, ios::end);
+	const streamoff iSize = cFile.tellg();
+	cFile.seekg(0, ios::beg);
+	vector<char> vText((size_t)iSize);
+	if ((iSize > 0) && (cFile.read(&vText[0], iSize).good() == false))
+	{
+		LOG_ERROR(MAP, "Unable to read the CSV level %s", filename.c_str());
+		return false;
+	}
+
+	if (ParseCSV(vText.empty() ? "" : &vText[0], vText.size(), cLevel, psHeader) == false)
+	{
+		LOG_ERROR(MAP, "Unable to parse the CSV level %s", filename.c_str());
+		return false;
+	}
+	return true;
+}
+
+/**
+ @brief Convert CSV levels into one level file
+ @param vCSVFilenames A const vector<string>& variable containing the names of the CSV files, in the order of the levels
+ @param filename A const string& variable containing the name of the level file
+ @param eEncoding A const ENCODING variable containing how the tiles are stored
+ @return true if the level file is written, else false
+ */
+bool CLevelFile::ConvertCSV(const vector<string>& vCSVFilenames, const string& filename, const ENCODING eEncoding)
+{
+	vector<LevelData> vLevel(vCSVFilenames.size());
+	for (size_t i = 0; i < vCSVFilenames.size(); i++)
+	{
+		if (LoadCSV(vCSVFilenames[i], vLevel[i]) == false)
+			return false;
+	}
+
+	if (Write(filename, vLevel, eEncoding) == false)
+		return false;
+
+	LOG_INFO(MAP, "Converted %u CSV levels into %s", (unsigned int)vLevel.size(), filename.c_str());
+	return true;
+}
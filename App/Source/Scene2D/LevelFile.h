@@ -0,0 +1,104 @@
+/**
+ CLevelFile
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+using namespace std;
+
+// A binary file of 2D levels. The file starts with a header and a table of the levels, followed by the tiles of
+// each level as int32 values, row by row. A level is either stored raw, so that its tiles can be used straight
+// from the memory-mapped file, or compressed with run-length encoding, as (count, value) int32 pairs, which
+// suits the long runs of empty tiles in most levels. The values are stored in little-endian order.
+// This class also parses the CSV levels in Maps/*.csv without allocating memory for each cell, and converts
+// them into level files.
+class CLevelFile
+{
+public:
+	// How the tiles of a level are stored
+	enum ENCODING
+	{
+		RAW = 0,
+		RLE,
+		NUM_ENCODING
+	};
+
+	// The tiles of a level which is written into a level file
+	struct LevelData
+	{
+		unsigned int uiNumRows;
+		unsigned int uiNumCols;
+		vector<int> vTile;
+	};
+
+	// Constructor
+	CLevelFile(void);
+	// Destructor
+	virtual ~CLevelFile(void);
+
+	// Open a level file and map it into memory
+	bool Open(const string& filename);
+	// Unmap and close the level file
+	void Close(void);
+
+	// Get the number of levels in the level file
+	unsigned int GetNumLevels(void) const;
+	// Get the number of rows of a level
+	unsigned int GetNumRows(const unsigned int uiLevel) const;
+	// Get the number of columns of a level
+	unsigned int GetNumCols(const unsigned int uiLevel) const;
+	// Get the tiles of a raw level in the mapped file, or NULL if the level is compressed
+	const int32_t* GetTiles(const unsigned int uiLevel) const;
+	// Copy the tiles of a level into vTile, decompressing them if needed
+	bool ReadTiles(const unsigned int uiLevel, vector<int>& vTile) const;
+
+	// Write levels into a level file
+	static bool Write(const string& filename, const vector<LevelData>& vLevel, const ENCODING eEncoding = RAW);
+
+	// Parse the text of a CSV level, whose first line is the column names, without allocating memory for each cell
+	static bool ParseCSV(	const char* pText,
+							const size_t uiSize,
+							LevelData& cLevel,
+							string* psHeader = NULL);
+	// Read a CSV level in one block and parse it
+	static bool LoadCSV(const string& filename, LevelData& cLevel, string* psHeader = NULL);
+	// Convert CSV levels into one level file, in the order of vCSVFilenames
+	static bool ConvertCSV(const vector<string>& vCSVFilenames, const string& filename, const ENCODING eEncoding = RAW);
+
+protected:
+	// The header of a level file, which is followed by a LevelEntry for each level
+	struct FileHeader
+	{
+		char arrMagic[4];
+		uint32_t uiVersion;
+		uint32_t uiNumLevels;
+		uint32_t uiReserved;
+	};
+
+	// The size and position of a level in a level file
+	struct LevelEntry
+	{
+		uint32_t uiNumRows;
+		uint32_t uiNumCols;
+		uint32_t uiEncoding;
+		uint32_t uiReserved;
+		uint64_t uiOffset;
+		uint64_t uiSize;
+	};
+
+	// The mapped file
+	const unsigned char* pData;
+	size_t uiDataSize;
+	// The handles of the file and its mapping. These are void* so that this header does not need windows.h
+	void* pFileHandle;
+	void* pMappingHandle;
+
+	// The table of the levels in the mapped file
+	const LevelEntry* pLevelEntry;
+	unsigned int uiNumLevels;
+};
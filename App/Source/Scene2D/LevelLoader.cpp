@@ -0,0 +1,286 @@
+/**
+ CLevelLoader
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#include "LevelLoader.h"
+
+/**
+ @brief Constructor
+ */
+CLevelLoader::CLevelLoader(void)
+	: bRunning(false)
+	, uiNumDone(0)
+	, uiNumLoads(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CLevelLoader::~CLevelLoader(void)
+{
+	Stop();
+}
+
+/**
+ @brief Initialise this class instance and start the background thread
+ @param uiNumLevels A const unsigned int variable containing the number of levels
+ @return true if the background thread is started, else false
+ */
+bool CLevelLoader::Init(const unsigned int uiNumLevels)
+{
+	// Stop the background thread if this was initialised before
+	Stop();
+
+	vLevel.clear();
+	vLevel.resize(uiNumLevels);
+	for (unsigned int i = 0; i < uiNumLevels; i++)
+	{
+		vLevel[i].bPending = false;
+		vLevel[i].bLoading = false;
+		vLevel[i].bDone = false;
+		vLevel[i].bSuccess = false;
+		vLevel[i].uiSerial = 0;
+		vLevel[i].cLevelData.uiNumRows = 0;
+		vLevel[i].cLevelData.uiNumCols = 0;
+	}
+	uiNumDone = 0;
+
+	bRunning = true;
+	cThread = thread(&CLevelLoader::Run, this);
+	return true;
+}
+
+/**
+ @brief Stop the background thread, discarding the requests which are waiting.
+		A level which is being loaded is finished first.
+ */
+void CLevelLoader::Stop(void)
+{
+	{
+		lock_guard<mutex> cLock(cMutex);
+		if (bRunning == false)
+			return;
+		bRunning = false;
+		for (size_t i = 0; i < vLevel.size(); i++)
+			vLevel[i].bPending = false;
+	}
+	cCondition.notify_one();
+	if (cThread.joinable())
+		cThread.join();
+	cDoneCondition.notify_all();
+}
+
+/**
+ @brief Request a level to be loaded from a file, replacing any earlier request for the same level
+ @param sFilename A const string& variable containing the path of the CSV file or level file
+ @param uiLevel A const unsigned int variable containing the level
+ @return true if the request is queued, else false
+ */
+bool CLevelLoader::RequestLoad(const string& sFilename, const unsigned int uiLevel)
+{
+	{
+		lock_guard<mutex> cLock(cMutex);
+		if ((bRunning == false) || (uiLevel >= vLevel.size()))
+			return false;
+
+		Level& cLevel = vLevel[uiLevel];
+		if (cLevel.bDone)
+			uiNumDone--;
+		cLevel.bDone = false;
+		cLevel.bPending = true;
+		cLevel.sFilename = sFilename;
+		cLevel.uiSerial++;
+	}
+	cCondition.notify_one();
+	return true;
+}
+
+/**
+ @brief Discard the request of a level, and its loaded tiles if they have not been taken.
+		A load which is in progress finishes, but its tiles are thrown away.
+ @param uiLevel A const unsigned int variable containing the level
+ */
+void CLevelLoader::Cancel(const unsigned int uiLevel)
+{
+	{
+		lock_guard<mutex> cLock(cMutex);
+		if (uiLevel >= vLevel.size())
+			return;
+
+		Level& cLevel = vLevel[uiLevel];
+		if (cLevel.bDone)
+			uiNumDone--;
+		cLevel.bDone = false;
+		cLevel.bPending = false;
+		cLevel.uiSerial++;
+		cLevel.cLevelData.vTile.clear();
+	}
+	cDoneCondition.notify_all();
+}
+
+/**
+ @brief Check if a level is waiting, being loaded, or loaded but not taken yet
+ @param uiLevel A const unsigned int variable containing the level
+ @return true if the level is loading, else false
+ */
+bool CLevelLoader::IsLoading(const unsigned int uiLevel) const
+{
+	lock_guard<mutex> cLock(cMutex);
+	if (uiLevel >= vLevel.size())
+		return false;
+	return vLevel[uiLevel].bPending || vLevel[uiLevel].bLoading || vLevel[uiLevel].bDone;
+}
+
+/**
+ @brief Check if any level has been loaded and not taken yet, without locking the mutex
+ @return true if a level can be taken, else false
+ */
+bool CLevelLoader::HasLoadedLevels(void) const
+{
+	return uiNumDone > 0;
+}
+
+/**
+ @brief Wait until a level has been loaded, or its request has been cancelled
+ @param uiLevel A const unsigned int variable containing the level
+ */
+void CLevelLoader::Wait(const unsigned int uiLevel)
+{
+	unique_lock<mutex> cLock(cMutex);
+	if (uiLevel >= vLevel.size())
+		return;
+
+	while ((vLevel[uiLevel].bPending || vLevel[uiLevel].bLoading) && (bRunning || vLevel[uiLevel].bLoading))
+		cDoneCondition.wait(cLock);
+}
+
+/**
+ @brief Take the tiles of a level which has been loaded
+ @param uiLevel A const unsigned int variable containing the level
+ @param cLevelData A CLevelFile::LevelData& variable which is set to the tiles of the level
+ @param sHeader A string& variable which is set to the column names line of the level
+ @param bSuccess A bool& variable which is set to false if the file could not be loaded
+ @return true if the level was taken, else false if it has not finished loading
+ */
+bool CLevelLoader::TakeLevel(	const unsigned int uiLevel,
+								CLevelFile::LevelData& cLevelData,
+								string& sHeader,
+								bool& bSuccess)
+{
+	lock_guard<mutex> cLock(cMutex);
+	if ((uiLevel >= vLevel.size()) || (vLevel[uiLevel].bDone == false))
+		return false;
+
+	Level& cLevel = vLevel[uiLevel];
+	cLevelData.uiNumRows = cLevel.cLevelData.uiNumRows;
+	cLevelData.uiNumCols = cLevel.cLevelData.uiNumCols;
+	cLevelData.vTile.swap(cLevel.cLevelData.vTile);
+	cLevel.cLevelData.vTile.clear();
+	sHeader.swap(cLevel.sHeader);
+	bSuccess = cLevel.bSuccess;
+	cLevel.bDone = false;
+	uiNumDone--;
+	return true;
+}
+
+/**
+ @brief Get the number of levels which were loaded
+ @return The number of levels which were loaded
+ */
+unsigned int CLevelLoader::GetNumLoads(void) const
+{
+	return uiNumLoads;
+}
+
+/**
+ @brief The loop run by the background thread
+ */
+void CLevelLoader::Run(void)
+{
+	unique_lock<mutex> cLock(cMutex);
+	while (true)
+	{
+		// Find a level which is waiting
+		size_t uiLevel = vLevel.size();
+		for (size_t i = 0; i < vLevel.size(); i++)
+		{
+			if (vLevel[i].bPending)
+			{
+				uiLevel = i;
+				break;
+			}
+		}
+
+		if (uiLevel == vLevel.size())
+		{
+			if (bRunning == false)
+				break;
+			cCondition.wait(cLock);
+			continue;
+		}
+
+		// Load the level without holding the mutex
+		Level& cLevel = vLevel[uiLevel];
+		cLevel.bPending = false;
+		cLevel.bLoading = true;
+		const string sFilename = cLevel.sFilename;
+		const unsigned int uiSerial = cLevel.uiSerial;
+		cLock.unlock();
+
+		CLevelFile::LevelData cLevelData;
+		cLevelData.uiNumRows = 0;
+		cLevelData.uiNumCols = 0;
+		string sHeader;
+		const bool bSuccess = LoadLevel(sFilename, cLevelData, sHeader);
+		uiNumLoads++;
+
+		cLock.lock();
+		cLevel.bLoading = false;
+		// Keep the tiles only if the level has not been requested again or cancelled in the meantime
+		if (cLevel.uiSerial == uiSerial)
+		{
+			cLevel.cLevelData.uiNumRows = cLevelData.uiNumRows;
+			cLevel.cLevelData.uiNumCols = cLevelData.uiNumCols;
+			cLevel.cLevelData.vTile.swap(cLevelData.vTile);
+			cLevel.sHeader.swap(sHeader);
+			cLevel.bSuccess = bSuccess;
+			cLevel.bDone = true;
+			uiNumDone++;
+		}
+		cDoneCondition.notify_all();
+	}
+}
+
+/**
+ @brief Read the tiles of a level from a CSV file, or from the first level of a level file if the name ends
+		with .lvl, and the column names line which its saves start with
+ @param sFilename A const string& variable containing the path of the file
+ @param cLevelData A CLevelFile::LevelData& variable which is set to the tiles of the level
+ @param sHeader A string& variable which is set to the column names line
+ @return true if the level is loaded, else false
+ */
+bool CLevelLoader::LoadLevel(const string& sFilename, CLevelFile::LevelData& cLevelData, string& sHeader)
+{
+	if ((sFilename.size() < 4) || (sFilename.compare(sFilename.size() - 4, 4, ".lvl") != 0))
+		return CLevelFile::LoadCSV(sFilename, cLevelData, &sHeader);
+
+	CLevelFile cLevelFile;
+	if ((cLevelFile.Open(sFilename) == false) || (cLevelFile.GetNumLevels() == 0))
+		return false;
+	if (cLevelFile.ReadTiles(0, cLevelData.vTile) == false)
+		return false;
+	cLevelData.uiNumRows = cLevelFile.GetNumRows(0);
+	cLevelData.uiNumCols = cLevelFile.GetNumCols(0);
+
+	// A level file has no column names, so the saves use the same column names as the CSV maps
+	sHeader = "//";
+	for (unsigned int uiCol = 0; uiCol < cLevelData.uiNumCols; uiCol++)
+	{
+		if (uiCol > 0)
+			sHeader += ',';
+		sHeader += to_string(uiCol + 1);
+	}
+	return true;
+}
@@ -0,0 +1,93 @@
+/**
+ CLevelLoader
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include CLevelFile
+#include "LevelFile.h"
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Loads the levels of a CMap2D on a background thread, so that the next level is read and parsed while the
+// current level is played. A level is read from a CSV file or from the first level of a level file (.lvl) into
+// memory; the CMap2D then takes it and copies it into its tiles on the main thread, which is the only thread
+// that may use the CTileGrid and OpenGL. A new request or a cancel for a level discards the earlier request.
+class CLevelLoader
+{
+public:
+	// Constructor
+	CLevelLoader(void);
+	// Destructor
+	virtual ~CLevelLoader(void);
+
+	// Initialise this class instance and start the background thread
+	bool Init(const unsigned int uiNumLevels);
+	// Stop the background thread, discarding the requests which are waiting
+	void Stop(void);
+
+	// Request a level to be loaded from a file, replacing any earlier request for the same level
+	bool RequestLoad(const string& sFilename, const unsigned int uiLevel);
+	// Discard the request of a level, and its loaded tiles if they have not been taken
+	void Cancel(const unsigned int uiLevel);
+	// Check if a level is waiting, being loaded, or loaded but not taken yet
+	bool IsLoading(const unsigned int uiLevel) const;
+	// Check if any level has been loaded and not taken yet
+	bool HasLoadedLevels(void) const;
+	// Wait until a level has been loaded
+	void Wait(const unsigned int uiLevel);
+	// Take the tiles of a level which has been loaded. Returns false if the level has not finished loading.
+	bool TakeLevel(	const unsigned int uiLevel,
+					CLevelFile::LevelData& cLevelData,
+					string& sHeader,
+					bool& bSuccess);
+
+	// Get the number of levels which were loaded
+	unsigned int GetNumLoads(void) const;
+
+protected:
+	// The request of a level and its result
+	struct Level
+	{
+		// Set to true when a request is waiting for the background thread
+		bool bPending;
+		// Set to true while the background thread loads this level
+		bool bLoading;
+		// Set to true when the loaded tiles are waiting to be taken
+		bool bDone;
+		bool bSuccess;
+		string sFilename;
+		// Changes with every request and cancel, so that a load which was overtaken is discarded
+		unsigned int uiSerial;
+		CLevelFile::LevelData cLevelData;
+		string sHeader;
+	};
+
+	vector<Level> vLevel;
+
+	// Guards the levels
+	mutable mutex cMutex;
+	// Wakes the background thread when a request arrives
+	condition_variable cCondition;
+	// Wakes Wait() when a level has been loaded
+	condition_variable cDoneCondition;
+
+	// The background thread
+	thread cThread;
+	bool bRunning;
+
+	atomic<unsigned int> uiNumDone;
+	atomic<unsigned int> uiNumLoads;
+
+	// The loop run by the background thread
+	void Run(void);
+	// Read the tiles of a level from a CSV file or a level file, and the column names line for its saves
+	static bool LoadLevel(const string& sFilename, CLevelFile::LevelData& cLevelData, string& sHeader);
+};
@@ -14,8 +14,17 @@
 #include "System\ImageLoader.h"
 #include "Primitives/MeshBuilder.h"
 
+// Include CStopWatch
+#include "TimeControl/StopWatch.h"
+// Include CRandom
+#include "System/Random.h"
+
 #include <iostream>
+#include <fstream>
 #include <vector>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
 using namespace std;
 
 // For AStar PathFinding
@@ -25,8 +34,12 @@ using namespace std::placeholders;
  @brief Constructor This constructor has protected access modifier as this class will be a Singleton
  */
 CMap2D::CMap2D(void)
-	: uiCurLevel(0)
+	: arrMapInfo(NULL)
+	, uiCurLevel(0)
+	, uiBlockedVersion(0)
+	, uiSolidWordsPerRow(0)
 	, quadMesh(NULL)
+	, sTileMapShaderName("2DTileMapShader")
 {
 }
 
@@ -38,16 +51,16 @@ CMap2D::~CMap2D(void)
 	// Delete AStar lists
 	DeleteAStarLists();
 
-	// Dynamically deallocate the 3D array used to store the map information
-	for (unsigned int uiLevel = 0; uiLevel < uiNumLevels; uiLevel++)
+	// Write out the saves which are waiting, and discard the levels which are loading
+	cMapSaveWriter.Stop();
+	cLevelLoader.Stop();
+
+	// Delete the tile values of the levels. A streamed level deletes its scratch file; its chunk file is not changed.
+	if (arrMapInfo)
 	{
-		for (unsigned int iRow = 0; iRow < cSettings->NUM_TILES_YAXIS; iRow++)
-		{
-			delete[] arrMapInfo[uiLevel][iRow];
-		}
-		delete [] arrMapInfo[uiLevel];
+		delete[] arrMapInfo;
+		arrMapInfo = NULL;
 	}
-	delete[] arrMapInfo;
 
 	if (quadMesh)
 	{
@@ -75,24 +88,17 @@ bool CMap2D::Init(	const unsigned int uiNumLevels,
 	cSettings = CSettings::GetInstance();
 
 	// Create the arrMapInfo and initialise to 0
-	// Start by initialising the number of levels
-	arrMapInfo = new Grid** [uiNumLevels];
+	// Each level stores its tile values in chunks, separately from the AStar data
+	arrMapInfo = new CTileGrid[uiNumLevels];
 	for (unsigned uiLevel = 0; uiLevel < uiNumLevels; uiLevel++)
 	{
-		arrMapInfo[uiLevel] = new Grid* [uiNumRows];
-		for (unsigned uiRow = 0; uiRow < uiNumRows; uiRow++)
-		{
-			arrMapInfo[uiLevel][uiRow] = new Grid[uiNumCols];
-			for (unsigned uiCol = 0; uiCol < uiNumCols; uiCol++)
-			{
-				arrMapInfo[uiLevel][uiRow][uiCol].value = 0;
-			}
-		}
+		arrMapInfo[uiLevel].Init(uiNumRows, uiNumCols);
 	}
 
 	// Store the map sizes in cSettings
 	uiCurLevel = 0;
 	this->uiNumLevels = uiNumLevels;
+	uiBlockedVersion++;
 	cSettings->NUM_TILES_XAXIS = uiNumCols;
 	cSettings->NUM_TILES_YAXIS = uiNumRows;
 	cSettings->UpdateSpecifications();
@@ -103,6 +109,9 @@ bool CMap2D::Init(	const unsigned int uiNumLevels,
 	//CS: Create the Quad Mesh using the mesh builder
 	quadMesh = CMeshBuilder::GenerateQuad(glm::vec4(1, 1, 1, 1), cSettings->TILE_WIDTH, cSettings->TILE_HEIGHT);
 
+	// LoadTexture() also adds each texture to the cTileMapRenderer
+	cTileMapRenderer.Init(uiNumLevels);
+
 	// Load and create textures
 	// Load the ground texture
 	if (LoadTexture("Image/Scene2D_GroundTile.tga", 100) == false)
@@ -141,6 +150,18 @@ bool CMap2D::Init(	const unsigned int uiNumLevels,
 		return false;
 	}
 
+	// Pack the tile textures into one array texture, and create the vertex buffer of each level
+	if (cTileMapRenderer.BuildTextures() == false)
+	{
+		std::cout << "Failed to build the tile map textures" << std::endl;
+		return false;
+	}
+	for (unsigned int uiLevel = 0; uiLevel < uiNumLevels; uiLevel++)
+	{
+		cTileMapRenderer.SetLevelSize(uiLevel, uiNumRows, uiNumCols,
+									-1.0f, 1.0f, cSettings->TILE_WIDTH, cSettings->TILE_HEIGHT);
+	}
+
 	// Initialise the variables for AStar
 	m_weight = 1;
 	m_startPos = glm::i32vec2(0, 0);
@@ -155,6 +176,19 @@ bool CMap2D::Init(	const unsigned int uiNumLevels,
 	m_cameFromList.resize(cSettings->NUM_TILES_YAXIS * cSettings->NUM_TILES_XAXIS);
 	m_closedList.resize(cSettings->NUM_TILES_YAXIS * cSettings->NUM_TILES_XAXIS, false);
 
+	// Start the background writer of the saves, and track the changed tiles of each level
+	cMapSaveWriter.Init(uiNumLevels);
+	vSaveDirtyList.assign(uiNumLevels, vector<unsigned int>());
+	vSaveDirtyFlag.assign(uiNumLevels, vector<unsigned char>(uiNumRows * uiNumCols, 0));
+	// Start the background loader of the levels
+	cLevelLoader.Init(uiNumLevels);
+
+	// Create the solid bits of each level, which are all clear until a map is loaded
+	uiSolidWordsPerRow = (uiNumCols + 63) / 64;
+	vSolidBits.assign(uiNumLevels, vector<uint64_t>((size_t)uiNumRows * uiSolidWordsPerRow, 0));
+	// Create the lists of the tiles of each value, which are all empty until a map is loaded
+	vTileIndex.assign(uiNumLevels, unordered_map<int, vector<unsigned int>>());
+
 	//// Clear AStar memory
 	//ClearAStar();
 
@@ -166,6 +200,12 @@ bool CMap2D::Init(	const unsigned int uiNumLevels,
 */
 void CMap2D::Update(const double dElapsedTime)
 {
+	// Fill in the levels which have been loaded in the background
+	if (cLevelLoader.HasLoadedLevels())
+	{
+		for (unsigned int uiLevel = 0; uiLevel < uiNumLevels; uiLevel++)
+			ApplyPreloadedMap(uiLevel);
+	}
 }
 
 /**
@@ -181,13 +221,33 @@ void CMap2D::PreRender(void)
 	glActiveTexture(GL_TEXTURE0);
 
 	// Activate the shader
-	CShaderManager::GetInstance()->Use(sShaderName);
+	if (cSettings->bUseTileMapBatching == true)
+		CShaderManager::GetInstance()->Use(sTileMapShaderName);
+	else
+		CShaderManager::GetInstance()->Use(sShaderName);
 }
 
 /**
  @brief Render Render this instance
  */
 void CMap2D::Render(void)
+{
+	if (cSettings->bUseTileMapBatching == true)
+	{
+		// The vertices of the tiles are already in their positions, so draw the whole level at once
+		transform = glm::mat4(1.0f);
+		CShaderManager::GetInstance()->activeShader->setMat4("transform", transform);
+		cTileMapRenderer.Render(uiCurLevel);
+		return;
+	}
+
+	RenderTiles();
+}
+
+/**
+ @brief Render the tiles one at a time, with one draw call per tile
+ */
+void CMap2D::RenderTiles(void)
 {
 	// get matrix's uniform location and set matrix
 	unsigned int transformLoc = glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "transform");
@@ -290,10 +350,38 @@ void CMap2D::SetNumSteps(const CSettings::AXIS sAxis, const unsigned int uiValue
  */
 void CMap2D::SetMapInfo(const unsigned int uiRow, const unsigned int uiCol, const int iValue, const bool bInvert)
 {
-	if (bInvert)
-		arrMapInfo[uiCurLevel][cSettings->NUM_TILES_YAXIS - uiRow - 1][uiCol].value = iValue;
-	else
-		arrMapInfo[uiCurLevel][uiRow][uiCol].value = iValue;
+	const unsigned int uiMapRow = bInvert ? cSettings->NUM_TILES_YAXIS - uiRow - 1 : uiRow;
+	const int iOldValue = arrMapInfo[uiCurLevel].Get(uiMapRow, uiCol);
+	arrMapInfo[uiCurLevel].Set(uiMapRow, uiCol, iValue);
+	if (((iOldValue >= 100) && (iOldValue < 200)) != ((iValue >= 100) && (iValue < 200)))
+		uiBlockedVersion++;
+
+	// Keep the solid bit of this tile up to date
+	if ((uiMapRow < cSettings->NUM_TILES_YAXIS) && (uiCol < cSettings->NUM_TILES_XAXIS) && (uiCurLevel < vSolidBits.size()))
+	{
+		const size_t uiWord = (size_t)(cSettings->NUM_TILES_YAXIS - uiMapRow - 1) * uiSolidWordsPerRow + (uiCol >> 6);
+		const uint64_t uiBit = (uint64_t)1 << (uiCol & 63);
+		if (iValue >= 100)
+			vSolidBits[uiCurLevel][uiWord] |= uiBit;
+		else
+			vSolidBits[uiCurLevel][uiWord] &= ~uiBit;
+	}
+
+	// Keep the lists of the tiles of each value up to date
+	if ((iOldValue != iValue) && (uiMapRow < cSettings->NUM_TILES_YAXIS) && (uiCol < cSettings->NUM_TILES_XAXIS))
+		MoveInTileIndex(uiCurLevel, uiMapRow * cSettings->NUM_TILES_XAXIS + uiCol, iOldValue, iValue);
+
+	// Remember this tile, so that the next save only sends the changed tiles to the cMapSaveWriter
+	const unsigned int uiIndex = uiMapRow * cSettings->NUM_TILES_XAXIS + uiCol;
+	if ((uiCurLevel < vSaveDirtyFlag.size()) && (uiIndex < vSaveDirtyFlag[uiCurLevel].size()) &&
+		(vSaveDirtyFlag[uiCurLevel][uiIndex] == 0))
+	{
+		vSaveDirtyFlag[uiCurLevel][uiIndex] = 1;
+		vSaveDirtyList[uiCurLevel].push_back(uiIndex);
+	}
+
+	// Only this tile's row of the vertex buffer is uploaded again
+	cTileMapRenderer.SetTile(uiCurLevel, uiMapRow, uiCol, iValue);
 }
 
 /**
@@ -305,16 +393,171 @@ void CMap2D::SetMapInfo(const unsigned int uiRow, const unsigned int uiCol, cons
 int CMap2D::GetMapInfo(const unsigned int uiRow, const int unsigned uiCol, const bool bInvert) const
 {
 	if (bInvert)
-		return arrMapInfo[uiCurLevel][cSettings->NUM_TILES_YAXIS - uiRow - 1][uiCol].value;
+		return arrMapInfo[uiCurLevel].Get(cSettings->NUM_TILES_YAXIS - uiRow - 1, uiCol);
 	else
-		return arrMapInfo[uiCurLevel][uiRow][uiCol].value;
+		return arrMapInfo[uiCurLevel].Get(uiRow, uiCol);
+}
+
+/**
+ @brief Check if a tile of the current level is solid, from the solid bits instead of the tile values
+ @param iRow A const int variable containing the row index of the tile
+ @param iCol A const int variable containing the column index of the tile
+ @param bInvert A const bool variable which indicates if the row information is inverted
+ @return true if the tile is solid, else false. Tiles outside the map are not solid.
+ */
+bool CMap2D::IsSolid(const int iRow, const int iCol, const bool bInvert) const
+{
+	if ((iRow < 0) || (iRow >= (int)cSettings->NUM_TILES_YAXIS) ||
+		(iCol < 0) || (iCol >= (int)cSettings->NUM_TILES_XAXIS) ||
+		(uiCurLevel >= vSolidBits.size()))
+		return false;
+
+	const unsigned int uiRow = bInvert ? iRow : cSettings->NUM_TILES_YAXIS - iRow - 1;
+	return ((vSolidBits[uiCurLevel][(size_t)uiRow * uiSolidWordsPerRow + (iCol >> 6)] >> (iCol & 63)) & 1) != 0;
+}
+
+/**
+ @brief Sweep a box through the current level, and find the first solid tile which it hits and when.
+		The positions are in tiles, with x as the column and y as the inverted row, as in the indices of the
+		entities, so a box of one tile at i32vec2Index is (i32vec2Index, i32vec2Index + 1).
+		The tile columns and rows which the leading edges of the box cross are visited in order, as in a DDA,
+		so a fast box cannot pass through a tile. The tiles which the box overlaps at the start are ignored,
+		except those overlapped by less than a tiny margin, which are treated as touched and can be hit at time 0.
+ @param vec2BoxMin A const glm::vec2& variable containing the lower corner of the box
+ @param vec2BoxMax A const glm::vec2& variable containing the upper corner of the box
+ @param vec2Displacement A const glm::vec2& variable containing the movement of the box
+ @param i32vec2HitTile A glm::i32vec2& variable which is set to the column and inverted row of the tile hit
+ @param fTimeOfImpact A float& variable which is set to the fraction of vec2Displacement moved before the hit
+ @return true if the box hits a solid tile, else false
+ */
+bool CMap2D::SweepAABB(	const glm::vec2& vec2BoxMin,
+						const glm::vec2& vec2BoxMax,
+						const glm::vec2& vec2Displacement,
+						glm::i32vec2& i32vec2HitTile,
+						float& fTimeOfImpact) const
+{
+	// The box is shrunk slightly, so that a box which touches a tile, but does not overlap it, does not hit it
+	const float fEpsilon = 0.0001f;
+
+	// The next column and row which the leading edges of the box enter, and the time when they do
+	const int iStepX = (vec2Displacement.x > 0.0f) ? 1 : ((vec2Displacement.x < 0.0f) ? -1 : 0);
+	const int iStepY = (vec2Displacement.y > 0.0f) ? 1 : ((vec2Displacement.y < 0.0f) ? -1 : 0);
+	int iEnterCol = 0, iEnterRow = 0;
+	float fNextTimeX = 2.0f, fNextTimeY = 2.0f;
+	float fDeltaTimeX = 0.0f, fDeltaTimeY = 0.0f;
+	if (iStepX > 0)
+	{
+		iEnterCol = (int)ceil(vec2BoxMax.x - fEpsilon);
+		fNextTimeX = std::max(0.0f, (iEnterCol - vec2BoxMax.x) / vec2Displacement.x);
+	}
+	else if (iStepX < 0)
+	{
+		iEnterCol = (int)floor(vec2BoxMin.x + fEpsilon) - 1;
+		fNextTimeX = std::max(0.0f, (iEnterCol + 1 - vec2BoxMin.x) / vec2Displacement.x);
+	}
+	if (iStepY > 0)
+	{
+		iEnterRow = (int)ceil(vec2BoxMax.y - fEpsilon);
+		fNextTimeY = std::max(0.0f, (iEnterRow - vec2BoxMax.y) / vec2Displacement.y);
+	}
+	else if (iStepY < 0)
+	{
+		iEnterRow = (int)floor(vec2BoxMin.y + fEpsilon) - 1;
+		fNextTimeY = std::max(0.0f, (iEnterRow + 1 - vec2BoxMin.y) / vec2Displacement.y);
+	}
+	// A box which overlaps the entered column or row by less than fEpsilon only touches it at the start, so
+	// it enters it at once. Its time is clamped, so that a hit is never reported before the box has moved.
+	if (iStepX != 0)
+		fDeltaTimeX = 1.0f / fabs(vec2Displacement.x);
+	if (iStepY != 0)
+		fDeltaTimeY = 1.0f / fabs(vec2Displacement.y);
+
+	while (true)
+	{
+		const bool bStepX = (fNextTimeX <= fNextTimeY);
+		const float fTime = bStepX ? fNextTimeX : fNextTimeY;
+		// A box which only reaches a tile at the end of its movement touches it, but does not hit it
+		if (fTime >= 1.0f - fEpsilon)
+			return false;
+		// When both edges cross a grid line together, the tile at the corner is entered as well
+		const bool bCorner = (fabs(fNextTimeX - fNextTimeY) < fEpsilon);
+
+		// The box at the time when it enters the next column or row
+		const glm::vec2 vec2Min = vec2BoxMin + vec2Displacement * fTime;
+		const glm::vec2 vec2Max = vec2BoxMax + vec2Displacement * fTime;
+		if (bStepX == true)
+		{
+			// Check the tiles of the entered column which the box covers
+			int iFirstRow = (int)floor(vec2Min.y + fEpsilon);
+			int iLastRow = (int)ceil(vec2Max.y - fEpsilon) - 1;
+			if ((bCorner == true) && (iStepY > 0))
+				iLastRow = iEnterRow;
+			else if ((bCorner == true) && (iStepY < 0))
+				iFirstRow = iEnterRow;
+			for (int iRow = iFirstRow; iRow <= iLastRow; iRow++)
+			{
+				if (IsSolid(iRow, iEnterCol))
+				{
+					i32vec2HitTile = glm::i32vec2(iEnterCol, iRow);
+					fTimeOfImpact = fTime;
+					return true;
+				}
+			}
+			iEnterCol += iStepX;
+			fNextTimeX += fDeltaTimeX;
+		}
+		else
+		{
+			// Check the tiles of the entered row which the box covers
+			int iFirstCol = (int)floor(vec2Min.x + fEpsilon);
+			int iLastCol = (int)ceil(vec2Max.x - fEpsilon) - 1;
+			if ((bCorner == true) && (iStepX > 0))
+				iLastCol = iEnterCol;
+			else if ((bCorner == true) && (iStepX < 0))
+				iFirstCol = iEnterCol;
+			for (int iCol = iFirstCol; iCol <= iLastCol; iCol++)
+			{
+				if (IsSolid(iEnterRow, iCol))
+				{
+					i32vec2HitTile = glm::i32vec2(iCol, iEnterRow);
+					fTimeOfImpact = fTime;
+					return true;
+				}
+			}
+			iEnterRow += iStepY;
+			fNextTimeY += fDeltaTimeY;
+		}
+	}
 }
 
 /**
- @brief Load a map
+ @brief Load a map from a CSV file, or from the first level of a level file if filename ends with .lvl
+ @param filename A string variable containing the name of the map file
+ @param uiCurLevel A const unsigned int variable containing the level to load into
+ @return true if the map is loaded, else false
  */ 
 bool CMap2D::LoadMap(string filename, const unsigned int uiCurLevel)
 {
+	if (uiCurLevel >= uiNumLevels)
+		return false;
+	cLevelLoader.Cancel(uiCurLevel);
+
+	// A level file stores the tiles in binary
+	if ((filename.size() >= 4) && (filename.compare(filename.size() - 4, 4, ".lvl") == 0))
+		return LoadBinaryMap(filename, 0, uiCurLevel);
+
+	if (cSettings->bUseFastCSVLoad == true)
+	{
+		// Parse the integers in place from the whole file, instead of through rapidcsv
+		CLevelFile::LevelData cLevel;
+		if (CLevelFile::LoadCSV(FileSystem::getPath(filename), cLevel, &sCSVHeader) == false)
+		{
+			cout << "Unable to load the CSV map from " << filename << endl;
+			return false;
+		}
+		return SetLevelTiles(uiCurLevel, cLevel.uiNumRows, cLevel.uiNumCols, cLevel.vTile.empty() ? NULL : &cLevel.vTile[0]);
+	}
+
 	doc = rapidcsv::Document(FileSystem::getPath(filename).c_str());
 
 	// Check if the sizes of CSV data matches the declared arrMapInfo sizes
@@ -325,6 +568,10 @@ bool CMap2D::LoadMap(string filename, const unsigned int uiCurLevel)
 		return false;
 	}
 
+	// A streamed level holds all of its chunks in memory again
+	if (arrMapInfo[uiCurLevel].IsStreaming())
+		arrMapInfo[uiCurLevel].Init(cSettings->NUM_TILES_YAXIS, cSettings->NUM_TILES_XAXIS);
+
 	// Read the rows and columns of CSV data into arrMapInfo
 	for (unsigned int uiRow = 0; uiRow < cSettings->NUM_TILES_YAXIS; uiRow++)
 	{
@@ -334,49 +581,526 @@ bool CMap2D::LoadMap(string filename, const unsigned int uiCurLevel)
 		// Load a particular CSV value into the arrMapInfo
 		for (unsigned int uiCol = 0; uiCol < cSettings->NUM_TILES_XAXIS; ++uiCol)
 		{
-			arrMapInfo[uiCurLevel][uiRow][uiCol].value = (int)stoi(row[uiCol]);
+			arrMapInfo[uiCurLevel].Set(uiRow, uiCol, (int)stoi(row[uiCol]));
 		}
 	}
 
+	// Keep the column names line of the CSV file for the saves
+	sCSVHeader.clear();
+	vector<string> vColumnNames = doc.GetColumnNames();
+	for (unsigned int i = 0; i < vColumnNames.size(); i++)
+	{
+		if (i > 0)
+			sCSVHeader += ',';
+		sCSVHeader += vColumnNames[i];
+	}
+
+	UpdateTileMapRenderer(uiCurLevel);
+	UpdateSolidBits(uiCurLevel);
+	UpdateTileIndex(uiCurLevel);
+	ResetSaveState(uiCurLevel);
+	uiBlockedVersion++;
+
+	return true;
+}
+
+/**
+ @brief Load a level of a level file. A raw level is copied straight from the memory-mapped file.
+ @param filename A string variable containing the name of the level file
+ @param uiFileLevel A const unsigned int variable containing the level in the level file
+ @param uiLevel A const unsigned int variable containing the level to load into
+ @return true if the map is loaded, else false
+ */
+bool CMap2D::LoadBinaryMap(string filename, const unsigned int uiFileLevel, const unsigned int uiLevel)
+{
+	if (uiLevel >= uiNumLevels)
+		return false;
+	cLevelLoader.Cancel(uiLevel);
+
+	CLevelFile cLevelFile;
+	if (cLevelFile.Open(FileSystem::getPath(filename)) == false)
+	{
+		cout << "Unable to open the level file " << filename << endl;
+		return false;
+	}
+	if (uiFileLevel >= cLevelFile.GetNumLevels())
+	{
+		cout << filename << " does not have level " << uiFileLevel << endl;
+		return false;
+	}
+
+	// A level file has no column names, so the saves use the same column names as the CSV maps
+	sCSVHeader = "//";
+	for (unsigned int uiCol = 0; uiCol < cLevelFile.GetNumCols(uiFileLevel); uiCol++)
+	{
+		if (uiCol > 0)
+			sCSVHeader += ',';
+		sCSVHeader += to_string(uiCol + 1);
+	}
+
+	const int32_t* pTile = cLevelFile.GetTiles(uiFileLevel);
+	if (pTile)
+		return SetLevelTiles(uiLevel, cLevelFile.GetNumRows(uiFileLevel), cLevelFile.GetNumCols(uiFileLevel), pTile);
+
+	vector<int> vTile;
+	if (cLevelFile.ReadTiles(uiFileLevel, vTile) == false)
+	{
+		cout << "Level " << uiFileLevel << " of " << filename << " is corrupted" << endl;
+		return false;
+	}
+	return SetLevelTiles(uiLevel, cLevelFile.GetNumRows(uiFileLevel), cLevelFile.GetNumCols(uiFileLevel), vTile.empty() ? NULL : &vTile[0]);
+}
+
+/**
+ @brief Load a map into a level on a background thread, while another level is played. The file is read and
+		parsed in the background, and Update() then copies it into the level and uploads its vertex buffer, so
+		that switching to the level with SetCurrentLevel() does not load anything. The current level cannot be
+		preloaded.
+ @param filename A string variable containing the name of the CSV file, or of a level file ending with .lvl
+ @param uiLevel A const unsigned int variable containing the level to load into
+ @return true if the load has been started, else false
+ */
+bool CMap2D::PreloadMap(string filename, const unsigned int uiLevel)
+{
+	if ((uiLevel >= uiNumLevels) || (uiLevel == uiCurLevel))
+		return false;
+	return cLevelLoader.RequestLoad(FileSystem::getPath(filename), uiLevel);
+}
+
+/**
+ @brief Check if a level is still being loaded in the background, or has not been filled in yet
+ @param uiLevel A const unsigned int variable containing the level
+ @return true if the level is loading, else false
+ */
+bool CMap2D::IsPreloading(const unsigned int uiLevel) const
+{
+	return cLevelLoader.IsLoading(uiLevel);
+}
+
+/**
+ @brief Wait for the background load of a level, and fill in the level
+ @param uiLevel A const unsigned int variable containing the level
+ @return true if the level was filled in, else false
+ */
+bool CMap2D::FinishPreload(const unsigned int uiLevel)
+{
+	cLevelLoader.Wait(uiLevel);
+	return ApplyPreloadedMap(uiLevel);
+}
+
+/**
+ @brief Fill in a level which has been loaded in the background, and upload its vertex buffer
+ @param uiLevel A const unsigned int variable containing the level
+ @return true if the level was filled in, else false
+ */
+bool CMap2D::ApplyPreloadedMap(const unsigned int uiLevel)
+{
+	CLevelFile::LevelData cLevel;
+	string sHeader;
+	bool bSuccess = false;
+	if (cLevelLoader.TakeLevel(uiLevel, cLevel, sHeader, bSuccess) == false)
+		return false;
+
+	if (bSuccess == false)
+	{
+		cout << "Unable to load the map of level " << uiLevel << " in the background" << endl;
+		return false;
+	}
+
+	sCSVHeader = sHeader;
+	if (SetLevelTiles(uiLevel, cLevel.uiNumRows, cLevel.uiNumCols, cLevel.vTile.empty() ? NULL : &cLevel.vTile[0]) == false)
+		return false;
+	cTileMapRenderer.Upload(uiLevel);
+	return true;
+}
+
+/**
+ @brief Clear a level which will not be played again. Its tiles are set to 0, and a streamed level frees its
+		chunks and deletes its scratch file. The current level cannot be cleared.
+ @param uiLevel A const unsigned int variable containing the level
+ @return true if the level is cleared, else false
+ */
+bool CMap2D::UnloadMap(const unsigned int uiLevel)
+{
+	if ((uiLevel >= uiNumLevels) || (uiLevel == uiCurLevel))
+		return false;
+
+	cLevelLoader.Cancel(uiLevel);
+	arrMapInfo[uiLevel].Init(cSettings->NUM_TILES_YAXIS, cSettings->NUM_TILES_XAXIS);
+	UpdateTileMapRenderer(uiLevel);
+	UpdateSolidBits(uiLevel);
+	UpdateTileIndex(uiLevel);
+	ResetSaveState(uiLevel);
 	return true;
 }
 
 /**
- @brief Save the tilemap to a text file
+ @brief Save the tilemap to a text file. With background saving, this only takes a copy of the tiles which
+		have changed since the last save, and the cMapSaveWriter writes the file on its own thread. The saves
+		which are requested within a short time of each other are written once.
  @param filename A string variable containing the name of the text file to save the map to
+ @param uiCurLevel A const unsigned int variable containing the level to save
+ @return true if the map is saved or queued to be saved, else false
  */
 bool CMap2D::SaveMap(string filename, const unsigned int uiCurLevel)
 {
-	// Update the rapidcsv::Document from arrMapInfo
+	if (uiCurLevel >= uiNumLevels)
+		return false;
+
+	// The text file would only hold the viewport of a streamed level
+	if (arrMapInfo[uiCurLevel].IsStreaming())
+	{
+		cout << "A streamed level can only be saved with SaveChunkedMap" << endl;
+		return false;
+	}
+
+	if (cSettings->bUseBackgroundSave == false)
+		return SaveMapNow(filename, uiCurLevel);
+
+	const unsigned int uiNumRows = cSettings->NUM_TILES_YAXIS;
+	const unsigned int uiNumCols = cSettings->NUM_TILES_XAXIS;
+	vector<unsigned int>& vDirtyList = vSaveDirtyList[uiCurLevel];
+	vector<unsigned char>& vDirtyFlag = vSaveDirtyFlag[uiCurLevel];
+
+	bool bQueued = false;
+	if (cMapSaveWriter.HasSnapshot(uiCurLevel) == false)
+	{
+		// The first save of a level sends all of its tiles
+		vector<int> vTile(uiNumRows * uiNumCols);
+		for (unsigned int uiRow = 0; uiRow < uiNumRows; uiRow++)
+		{
+			for (unsigned int uiCol = 0; uiCol < uiNumCols; uiCol++)
+			{
+				vTile[uiRow * uiNumCols + uiCol] = arrMapInfo[uiCurLevel].Get(uiRow, uiCol);
+			}
+		}
+
+		bQueued = cMapSaveWriter.RequestSave(FileSystem::getPath(filename), uiCurLevel, uiNumRows, uiNumCols, sCSVHeader, vTile);
+	}
+	else
+	{
+		// Later saves only send the tiles which have changed
+		vector<CMapSaveWriter::TileChange> vChange(vDirtyList.size());
+		for (unsigned int i = 0; i < vDirtyList.size(); i++)
+		{
+			vChange[i].uiIndex = vDirtyList[i];
+			vChange[i].iValue = arrMapInfo[uiCurLevel].Get(vDirtyList[i] / uiNumCols, vDirtyList[i] % uiNumCols);
+		}
+
+		bQueued = cMapSaveWriter.RequestSave(FileSystem::getPath(filename), uiCurLevel, vChange);
+	}
+
+	if (bQueued == false)
+	{
+		// The background writer is not running, so save on this thread
+		return SaveMapNow(filename, uiCurLevel);
+	}
+
+	for (unsigned int i = 0; i < vDirtyList.size(); i++)
+		vDirtyFlag[vDirtyList[i]] = 0;
+	vDirtyList.clear();
+	return true;
+}
+
+/**
+ @brief Check if a save is waiting or being written
+ @return true if a save is waiting or being written, else false
+ */
+bool CMap2D::IsSaving(void) const
+{
+	return cMapSaveWriter.IsBusy();
+}
+
+/**
+ @brief Save a level into a CSV file on this thread
+ @param filename A const string& variable containing the name of the text file to save the map to
+ @param uiLevel A const unsigned int variable containing the level to save
+ @return true if the map is saved, else false
+ */
+bool CMap2D::SaveMapNow(const string& filename, const unsigned int uiLevel)
+{
+	// Write the column names line, followed by a line for each row of arrMapInfo
+	string sText = sCSVHeader + "\n";
 	for (unsigned int uiRow = 0; uiRow < cSettings->NUM_TILES_YAXIS; uiRow++)
 	{
 		for (unsigned int uiCol = 0; uiCol < cSettings->NUM_TILES_XAXIS; uiCol++)
 		{
-			doc.SetCell(uiCol, uiRow, arrMapInfo[uiCurLevel][uiRow][uiCol].value);
+			if (uiCol > 0)
+				sText += ',';
+			sText += to_string(arrMapInfo[uiLevel].Get(uiRow, uiCol));
 		}
-		cout << endl;
+		sText += '\n';
 	}
 
-	// Save the rapidcsv::Document to a file
-	doc.Save(FileSystem::getPath(filename).c_str());
+	// Replace the file in one step, as the cMapSaveWriter does, so that it is never half-written
+	return CMapSaveWriter::WriteFileAtomic(FileSystem::getPath(filename), sText);
+}
 
+/**
+ @brief Copy the tiles of a loaded map into a level
+ @param uiLevel A const unsigned int variable containing the level to load into
+ @param uiNumRows A const unsigned int variable containing the number of rows of the map
+ @param uiNumCols A const unsigned int variable containing the number of columns of the map
+ @param pTile A const int* variable containing the tiles of the map, row by row
+ @return true if the size of the map matches the declared arrMapInfo sizes, else false
+ */
+bool CMap2D::SetLevelTiles(const unsigned int uiLevel, const unsigned int uiNumRows, const unsigned int uiNumCols, const int* pTile)
+{
+	// Check if the sizes of the map matches the declared arrMapInfo sizes
+	if ((cSettings->NUM_TILES_XAXIS != uiNumCols) ||
+		(cSettings->NUM_TILES_YAXIS != uiNumRows) ||
+		(pTile == NULL))
+	{
+		cout << "Sizes of the map does not match declared arrMapInfo sizes." << endl;
+		return false;
+	}
+
+	// A streamed level holds all of its chunks in memory again
+	if (arrMapInfo[uiLevel].IsStreaming())
+		arrMapInfo[uiLevel].Init(uiNumRows, uiNumCols);
+
+	for (unsigned int uiRow = 0; uiRow < uiNumRows; uiRow++)
+	{
+		const int* pRow = pTile + (size_t)uiRow * uiNumCols;
+		for (unsigned int uiCol = 0; uiCol < uiNumCols; uiCol++)
+		{
+			arrMapInfo[uiLevel].Set(uiRow, uiCol, pRow[uiCol]);
+		}
+	}
+
+	UpdateTileMapRenderer(uiLevel);
+	UpdateSolidBits(uiLevel);
+	UpdateTileIndex(uiLevel);
+	ResetSaveState(uiLevel);
+	if (uiLevel == uiCurLevel)
+		uiBlockedVersion++;
 	return true;
 }
 
 /**
-@brief Find the indices of a certain value in arrMapInfo
-@param iValue A const int variable containing the row index of the found element
+ @brief Forget the changed tiles of a level, after another map is loaded into it.
+		The next save of this level sends all of its tiles to the cMapSaveWriter.
+ @param uiLevel A const unsigned int variable containing the level
+ */
+void CMap2D::ResetSaveState(const unsigned int uiLevel)
+{
+	if (uiLevel >= vSaveDirtyList.size())
+		return;
+
+	cMapSaveWriter.Invalidate(uiLevel);
+	for (unsigned int i = 0; i < vSaveDirtyList[uiLevel].size(); i++)
+		vSaveDirtyFlag[uiLevel][vSaveDirtyList[uiLevel][i]] = 0;
+	vSaveDirtyList[uiLevel].clear();
+}
+
+/**
+ @brief Save a level into a chunk file, which a large level can be streamed from. The file is replaced in one
+		step. A streamed level can be saved into its own chunk file, which keeps the changes made while playing it.
+ @param filename A string variable containing the name of the chunk file
+ @param uiLevel A const unsigned int variable containing the level to save
+ @return true if the file is saved, else false
+ */
+bool CMap2D::SaveChunkedMap(string filename, const unsigned int uiLevel)
+{
+	if (uiLevel >= uiNumLevels)
+		return false;
+	return arrMapInfo[uiLevel].SaveChunkFile(FileSystem::getPath(filename));
+}
+
+/**
+ @brief Stream a level from a chunk file, keeping only the chunks near the viewport in memory. The viewport
+		starts at the first tile of the level, and has the map size in cSettings. The chunk file is only read;
+		the changed tiles are kept in a scratch file until SaveChunkedMap() is called.
+		The level is not changed if the file cannot be opened or is smaller than the viewport.
+ @param filename A string variable containing the name of the chunk file
+ @param uiLevel A const unsigned int variable containing the level to stream into
+ @param uiMaxResidentChunks A const unsigned int variable containing the maximum number of chunks in memory
+ @return true if the file is opened, else false
+ */
+bool CMap2D::StreamMap(string filename, const unsigned int uiLevel, const unsigned int uiMaxResidentChunks)
+{
+	if (uiLevel >= uiNumLevels)
+		return false;
+
+	if (arrMapInfo[uiLevel].OpenChunkFile(FileSystem::getPath(filename), uiMaxResidentChunks,
+											cSettings->NUM_TILES_YAXIS, cSettings->NUM_TILES_XAXIS) == false)
+	{
+		cout << "Unable to stream the map from " << filename << endl;
+		return false;
+	}
+	cLevelLoader.Cancel(uiLevel);
+
+	// Load the chunks of the viewport
+	arrMapInfo[uiLevel].SetViewport(0, 0, cSettings->NUM_TILES_YAXIS, cSettings->NUM_TILES_XAXIS);
+
+	UpdateTileMapRenderer(uiLevel);
+	UpdateSolidBits(uiLevel);
+	UpdateTileIndex(uiLevel);
+	ResetSaveState(uiLevel);
+	if (uiLevel == uiCurLevel)
+		uiBlockedVersion++;
+	return true;
+}
+
+/**
+ @brief Move the viewport of the current level, which is the part of the level that is rendered and played in.
+		It has the map size in cSettings, and is clamped to the level, so only a streamed level which is larger
+		than the map size can scroll. The chunks near the viewport are kept in memory, and the tile map, solid
+		bits and tile lists are rebuilt for the tiles in it.
+ @param uiFirstRow A const unsigned int variable containing the first row of the viewport in the level
+ @param uiFirstCol A const unsigned int variable containing the first column of the viewport in the level
+ */
+void CMap2D::SetViewport(const unsigned int uiFirstRow, const unsigned int uiFirstCol)
+{
+	if (arrMapInfo[uiCurLevel].SetViewport(uiFirstRow, uiFirstCol, cSettings->NUM_TILES_YAXIS, cSettings->NUM_TILES_XAXIS) == false)
+		return;
+
+	UpdateTileMapRenderer(uiCurLevel);
+	UpdateSolidBits(uiCurLevel);
+	UpdateTileIndex(uiCurLevel);
+	ResetSaveState(uiCurLevel);
+	uiBlockedVersion++;
+}
+
+/**
+ @brief Copy the visible tiles of a level into the cTileMapRenderer
+ @param uiLevel A const unsigned int variable containing the level
+ */
+void CMap2D::UpdateTileMapRenderer(const unsigned int uiLevel)
+{
+	for (unsigned int uiRow = 0; uiRow < cSettings->NUM_TILES_YAXIS; uiRow++)
+	{
+		for (unsigned int uiCol = 0; uiCol < cSettings->NUM_TILES_XAXIS; uiCol++)
+		{
+			cTileMapRenderer.SetTile(uiLevel, uiRow, uiCol, arrMapInfo[uiLevel].Get(uiRow, uiCol));
+		}
+	}
+}
+
+/**
+ @brief Set the solid bits of a level from its tiles
+ @param uiLevel A const unsigned int variable containing the level
+ */
+void CMap2D::UpdateSolidBits(const unsigned int uiLevel)
+{
+	if (uiLevel >= vSolidBits.size())
+		return;
+
+	vector<uint64_t>& vBits = vSolidBits[uiLevel];
+	std::fill(vBits.begin(), vBits.end(), 0);
+	for (unsigned int uiRow = 0; uiRow < cSettings->NUM_TILES_YAXIS; uiRow++)
+	{
+		uint64_t* pRow = &vBits[(size_t)(cSettings->NUM_TILES_YAXIS - uiRow - 1) * uiSolidWordsPerRow];
+		for (unsigned int uiCol = 0; uiCol < cSettings->NUM_TILES_XAXIS; uiCol++)
+		{
+			if (arrMapInfo[uiLevel].Get(uiRow, uiCol) >= 100)
+				pRow[uiCol >> 6] |= (uint64_t)1 << (uiCol & 63);
+		}
+	}
+}
+
+/**
+ @brief List the tiles of each value of a level, in the order of the rows and columns in arrMapInfo
+ @param uiLevel A const unsigned int variable containing the level
+ */
+void CMap2D::UpdateTileIndex(const unsigned int uiLevel)
+{
+	if (uiLevel >= vTileIndex.size())
+		return;
+
+	unordered_map<int, vector<unsigned int>>& mapIndex = vTileIndex[uiLevel];
+	mapIndex.clear();
+	for (unsigned int uiRow = 0; uiRow < cSettings->NUM_TILES_YAXIS; uiRow++)
+	{
+		for (unsigned int uiCol = 0; uiCol < cSettings->NUM_TILES_XAXIS; uiCol++)
+		{
+			const int iValue = arrMapInfo[uiLevel].Get(uiRow, uiCol);
+			if (iValue != 0)
+				mapIndex[iValue].push_back(uiRow * cSettings->NUM_TILES_XAXIS + uiCol);
+		}
+	}
+}
+
+/**
+ @brief Move a tile of a level from the list of its old value to the list of its new value.
+		The lists stay in increasing order, so the first tile of a list is the one which a scan would find.
+ @param uiLevel A const unsigned int variable containing the level
+ @param uiIndex A const unsigned int variable containing the tile, as uiRow * NUM_TILES_XAXIS + uiCol
+ @param iOldValue A const int variable containing the old value of the tile
+ @param iNewValue A const int variable containing the new value of the tile
+ */
+void CMap2D::MoveInTileIndex(const unsigned int uiLevel, const unsigned int uiIndex, const int iOldValue, const int iNewValue)
+{
+	if (uiLevel >= vTileIndex.size())
+		return;
+
+	unordered_map<int, vector<unsigned int>>& mapIndex = vTileIndex[uiLevel];
+	if (iOldValue != 0)
+	{
+		unordered_map<int, vector<unsigned int>>::iterator it = mapIndex.find(iOldValue);
+		if (it != mapIndex.end())
+		{
+			vector<unsigned int>::iterator itTile = lower_bound(it->second.begin(), it->second.end(), uiIndex);
+			if ((itTile != it->second.end()) && (*itTile == uiIndex))
+				it->second.erase(itTile);
+			if (it->second.empty())
+				mapIndex.erase(it);
+		}
+	}
+	if (iNewValue != 0)
+	{
+		vector<unsigned int>& vTiles = mapIndex[iNewValue];
+		vector<unsigned int>::iterator itTile = lower_bound(vTiles.begin(), vTiles.end(), uiIndex);
+		if ((itTile == vTiles.end()) || (*itTile != uiIndex))
+			vTiles.insert(itTile, uiIndex);
+	}
+}
+
+/**
+ @brief Get the list of the tiles of a value in the current level
+ @param iValue A const int variable containing the value
+ @return The list of the tiles, or NULL if there are none or iValue is 0, which is not listed
+ */
+const vector<unsigned int>* CMap2D::GetTileIndex(const int iValue) const
+{
+	if ((iValue == 0) || (uiCurLevel >= vTileIndex.size()))
+		return NULL;
+
+	unordered_map<int, vector<unsigned int>>::const_iterator it = vTileIndex[uiCurLevel].find(iValue);
+	if (it == vTileIndex[uiCurLevel].end())
+		return NULL;
+	return &(it->second);
+}
+
+/**
+@brief Find the indices of the first tile of a certain value in the current level, in the order of the rows
+		in arrMapInfo. The tiles of each value are listed when the map is loaded, so only the empty tiles (0)
+		are found by scanning the level.
+@param iValue A const int variable containing the value to find
 @param iRow A const int variable containing the row index of the found element
 @param iCol A const int variable containing the column index of the found element
 @param bInvert A const bool variable which indicates if the row information is inverted
+@return true if the value is found, else false
 */
-bool CMap2D::FindValue(const int iValue, unsigned int& uirRow, unsigned int& uirCol, const bool bInvert)
+bool CMap2D::FindValue(const int iValue, unsigned int& uirRow, unsigned int& uirCol, const bool bInvert) const
 {
+	if (iValue != 0)
+	{
+		const vector<unsigned int>* pTiles = GetTileIndex(iValue);
+		if ((pTiles == NULL) || (pTiles->empty()))
+			return false;
+
+		const unsigned int uiRow = pTiles->front() / cSettings->NUM_TILES_XAXIS;
+		uirRow = bInvert ? cSettings->NUM_TILES_YAXIS - uiRow - 1 : uiRow;
+		uirCol = pTiles->front() % cSettings->NUM_TILES_XAXIS;
+		return true;
+	}
+
 	for (unsigned int uiRow = 0; uiRow < cSettings->NUM_TILES_YAXIS; uiRow++)
 	{
 		for (unsigned int uiCol = 0; uiCol < cSettings->NUM_TILES_XAXIS; uiCol++)
 		{
-			if (arrMapInfo[uiCurLevel][uiRow][uiCol].value == iValue)
+			if (arrMapInfo[uiCurLevel].Get(uiRow, uiCol) == iValue)
 			{
 				if (bInvert)
 					uirRow = cSettings->NUM_TILES_YAXIS - uiRow - 1;
@@ -390,14 +1114,80 @@ bool CMap2D::FindValue(const int iValue, unsigned int& uirRow, unsigned int& uir
 	return false;
 }
 
+/**
+ @brief Find the indices of all the tiles of a certain value in the current level, such as the spawn points
+		or the collectibles, in the order of the rows in arrMapInfo
+ @param iValue A const int variable containing the value to find
+ @param vPositions A vector<glm::i32vec2>& variable which is set to the column and row of each tile found
+ @param bInvert A const bool variable which indicates if the row information is inverted
+ @return The number of tiles found
+ */
+unsigned int CMap2D::FindAllValues(const int iValue, vector<glm::i32vec2>& vPositions, const bool bInvert) const
+{
+	vPositions.clear();
+	if (iValue != 0)
+	{
+		const vector<unsigned int>* pTiles = GetTileIndex(iValue);
+		if (pTiles == NULL)
+			return 0;
+
+		vPositions.reserve(pTiles->size());
+		for (unsigned int i = 0; i < pTiles->size(); i++)
+		{
+			const unsigned int uiRow = (*pTiles)[i] / cSettings->NUM_TILES_XAXIS;
+			vPositions.push_back(glm::i32vec2(	(*pTiles)[i] % cSettings->NUM_TILES_XAXIS,
+												bInvert ? cSettings->NUM_TILES_YAXIS - uiRow - 1 : uiRow));
+		}
+		return (unsigned int)vPositions.size();
+	}
+
+	for (unsigned int uiRow = 0; uiRow < cSettings->NUM_TILES_YAXIS; uiRow++)
+	{
+		for (unsigned int uiCol = 0; uiCol < cSettings->NUM_TILES_XAXIS; uiCol++)
+		{
+			if (arrMapInfo[uiCurLevel].Get(uiRow, uiCol) == iValue)
+				vPositions.push_back(glm::i32vec2(uiCol, bInvert ? cSettings->NUM_TILES_YAXIS - uiRow - 1 : uiRow));
+		}
+	}
+	return (unsigned int)vPositions.size();
+}
+
+/**
+ @brief Count the tiles of a certain value in the current level
+ @param iValue A const int variable containing the value to count
+ @return The number of tiles of this value
+ */
+unsigned int CMap2D::CountValue(const int iValue) const
+{
+	if (iValue != 0)
+	{
+		const vector<unsigned int>* pTiles = GetTileIndex(iValue);
+		return pTiles ? (unsigned int)pTiles->size() : 0;
+	}
+
+	// The empty tiles are all the tiles which are not listed
+	unsigned int uiNumListed = 0;
+	if (uiCurLevel < vTileIndex.size())
+	{
+		unordered_map<int, vector<unsigned int>>::const_iterator it = vTileIndex[uiCurLevel].begin();
+		for (; it != vTileIndex[uiCurLevel].end(); ++it)
+			uiNumListed += (unsigned int)it->second.size();
+	}
+	return cSettings->NUM_TILES_YAXIS * cSettings->NUM_TILES_XAXIS - uiNumListed;
+}
+
 /**
  @brief Set current level
  */
 void CMap2D::SetCurrentLevel(unsigned int uiCurLevel)
 {
-	if (uiCurLevel < uiNumLevels)
+	if ((uiCurLevel < uiNumLevels) && (uiCurLevel != this->uiCurLevel))
 	{
+		// A level which is still loading in the background is finished first
+		if (cLevelLoader.IsLoading(uiCurLevel))
+			FinishPreload(uiCurLevel);
 		this->uiCurLevel = uiCurLevel;
+		uiBlockedVersion++;
 	}
 }
 /**
@@ -445,6 +1235,9 @@ bool CMap2D::LoadTexture(const char* filename, const int iTextureCode)
 
 		// Store the texture ID into MapOfTextureIDs
 		MapOfTextureIDs.insert(pair<int, int>(iTextureCode, textureID));
+
+		// Add the image to the cTileMapRenderer, which packs it into its array texture
+		cTileMapRenderer.AddTexture(iTextureCode, data, width, height, nrChannels);
 	}
 	else
 	{
@@ -463,10 +1256,10 @@ bool CMap2D::LoadTexture(const char* filename, const int iTextureCode)
  */
 void CMap2D::RenderTile(const unsigned int uiRow, const unsigned int uiCol)
 {
-	if (arrMapInfo[uiCurLevel][uiRow][uiCol].value != 0)
+	const int iValue = arrMapInfo[uiCurLevel].Get(uiRow, uiCol);
+	if (iValue != 0)
 	{
-		//if (arrMapInfo[uiCurLevel][uiRow][uiCol].value < 3)
-		glBindTexture(GL_TEXTURE_2D, MapOfTextureIDs.at(arrMapInfo[uiCurLevel][uiRow][uiCol].value));
+		glBindTexture(GL_TEXTURE_2D, MapOfTextureIDs.at(iValue));
 
 		glBindVertexArray(VAO);
 		//CS: Render the tile
@@ -614,6 +1407,46 @@ void CMap2D::SetDiagonalMovement(const bool bEnable)
 	m_nrOfDirections = (bEnable) ? 8 : 4;
 }
 
+/**
+ @brief Check if AStar PathFinding considers diagonal movements
+ @return true if diagonal movements are considered, else false
+ */
+bool CMap2D::GetDiagonalMovement(void) const
+{
+	return (m_nrOfDirections == 8);
+}
+
+/**
+ @brief Get a number which changes whenever a tile of the current level is blocked or unblocked,
+		so that a copy of the blocked tiles is only made again when it has changed
+ @return The version of the blocked tiles
+ */
+unsigned int CMap2D::GetBlockedVersion(void) const
+{
+	return uiBlockedVersion;
+}
+
+/**
+ @brief Copy the blocked tiles of the current level into vBlocked. A tile at a PathFind position pos
+		is at vBlocked[pos.y * NUM_TILES_XAXIS + pos.x], and is 1 if it is blocked, else 0.
+ @param vBlocked A vector<unsigned char>& variable which the blocked tiles are copied into
+ */
+void CMap2D::GetBlockedTiles(vector<unsigned char>& vBlocked) const
+{
+	const unsigned int uiNumRows = cSettings->NUM_TILES_YAXIS;
+	const unsigned int uiNumCols = cSettings->NUM_TILES_XAXIS;
+	vBlocked.resize((size_t)uiNumRows * uiNumCols);
+	for (unsigned int uiRow = 0; uiRow < uiNumRows; uiRow++)
+	{
+		unsigned char* pRow = &vBlocked[(size_t)(uiNumRows - uiRow - 1) * uiNumCols];
+		for (unsigned int uiCol = 0; uiCol < uiNumCols; uiCol++)
+		{
+			const int iValue = arrMapInfo[uiCurLevel].Get(uiRow, uiCol);
+			pRow[uiCol] = ((iValue >= 100) && (iValue < 200)) ? 1 : 0;
+		}
+	}
+}
+
 /**
  @brief Print out the details about this class instance in the console
  */
@@ -630,7 +1463,7 @@ void CMap2D::PrintSelf(void) const
 			{
 				cout.fill('0');
 				cout.width(3);
-				cout << arrMapInfo[uiLevel][uiRow][uiCol].value;
+				cout << arrMapInfo[uiLevel].Get(uiRow, uiCol);
 				if (uiCol != cSettings->NUM_TILES_XAXIS - 1)
 					cout << ", ";
 				else
@@ -646,6 +1479,410 @@ void CMap2D::PrintSelf(void) const
 	cout << "===== AStar::PrintSelf() =====" << endl;
 }
 
+/**
+ @brief Compare the cost of drawing a large generated map one tile at a time against one draw call.
+		The map is drawn into the current framebuffer, and glFinish() is called after each frame so that
+		the GPU time is included.
+ @param uiNumRows A const unsigned int variable containing the number of rows of the generated map
+ @param uiNumCols A const unsigned int variable containing the number of columns of the generated map
+ @param uiNumFrames A const unsigned int variable containing the number of frames to draw with each method
+ */
+void CMap2D::Benchmark(const unsigned int uiNumRows, const unsigned int uiNumCols, const unsigned int uiNumFrames)
+{
+	// Generate a map from the texture codes, with a quarter of the tiles empty
+	vector<int> vTextureCodes;
+	for (map<int, int>::const_iterator it = MapOfTextureIDs.begin(); it != MapOfTextureIDs.end(); ++it)
+		vTextureCodes.push_back(it->first);
+	if (vTextureCodes.empty())
+		return;
+
+	vector<int> vMap(uiNumRows * uiNumCols);
+	for (unsigned int i = 0; i < vMap.size(); i++)
+		vMap[i] = ((i % 4) == 3) ? 0 : vTextureCodes[(i / 4) % vTextureCodes.size()];
+
+	const float fTileWidth = 2.0f / uiNumCols;
+	const float fTileHeight = 2.0f / uiNumRows;
+	CMesh* cBenchmarkQuad = CMeshBuilder::GenerateQuad(glm::vec4(1, 1, 1, 1), fTileWidth, fTileHeight);
+
+	// Add the generated map as a temporary level of the cTileMapRenderer
+	const unsigned int uiBenchmarkLevel = uiNumLevels;
+	cTileMapRenderer.Init(uiNumLevels + 1);
+	cTileMapRenderer.SetLevelSize(uiBenchmarkLevel, uiNumRows, uiNumCols, -1.0f, 1.0f, fTileWidth, fTileHeight);
+	for (unsigned int uiRow = 0; uiRow < uiNumRows; uiRow++)
+		for (unsigned int uiCol = 0; uiCol < uiNumCols; uiCol++)
+			cTileMapRenderer.SetTile(uiBenchmarkLevel, uiRow, uiCol, vMap[uiRow * uiNumCols + uiCol]);
+
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glActiveTexture(GL_TEXTURE0);
+
+	CStopWatch cStopWatch;
+
+	// 1. One draw call, texture bind and uniform upload per tile
+	CShaderManager::GetInstance()->Use(sShaderName);
+	unsigned int transformLoc = glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "transform");
+	glFinish();
+	cStopWatch.StartTimer();
+	for (unsigned int uiFrame = 0; uiFrame < uiNumFrames; uiFrame++)
+	{
+		for (unsigned int uiRow = 0; uiRow < uiNumRows; uiRow++)
+		{
+			for (unsigned int uiCol = 0; uiCol < uiNumCols; uiCol++)
+			{
+				const int iValue = vMap[uiRow * uiNumCols + uiCol];
+				glm::mat4 tileTransform = glm::translate(glm::mat4(1.0f),
+														glm::vec3(-1.0f + (uiCol + 0.5f) * fTileWidth,
+																	1.0f - (uiRow + 0.5f) * fTileHeight,
+																	0.0f));
+				glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(tileTransform));
+				if (iValue != 0)
+				{
+					glBindTexture(GL_TEXTURE_2D, MapOfTextureIDs.at(iValue));
+					glBindVertexArray(VAO);
+					cBenchmarkQuad->Render();
+					glBindVertexArray(0);
+				}
+			}
+		}
+		glFinish();
+	}
+	const double dPerTileTime = cStopWatch.GetElapsedTime();
+
+	// 2. One draw call for the whole map
+	CShaderManager::GetInstance()->Use(sTileMapShaderName);
+	CShaderManager::GetInstance()->activeShader->setMat4("transform", glm::mat4(1.0f));
+	cTileMapRenderer.Render(uiBenchmarkLevel);
+	glFinish();
+	cStopWatch.GetElapsedTime();
+	for (unsigned int uiFrame = 0; uiFrame < uiNumFrames; uiFrame++)
+	{
+		cTileMapRenderer.Render(uiBenchmarkLevel);
+		glFinish();
+	}
+	const double dBatchedTime = cStopWatch.GetElapsedTime();
+
+	// 3. One draw call for the whole map, with a tile changed in each frame
+	for (unsigned int uiFrame = 0; uiFrame < uiNumFrames; uiFrame++)
+	{
+		const unsigned int uiTile = (uiFrame * 7919) % vMap.size();
+		cTileMapRenderer.SetTile(uiBenchmarkLevel, uiTile / uiNumCols, uiTile % uiNumCols, vTextureCodes[uiFrame % vTextureCodes.size()]);
+		cTileMapRenderer.Render(uiBenchmarkLevel);
+		glFinish();
+	}
+	const double dEditedTime = cStopWatch.GetElapsedTime();
+
+	glDisable(GL_BLEND);
+
+	// Remove the temporary level
+	cTileMapRenderer.Init(uiNumLevels);
+	delete cBenchmarkQuad;
+
+	cout << "CMap2D::Benchmark() with " << uiNumRows << "x" << uiNumCols << " tiles, " << uiNumFrames << " frames" << endl;
+	cout << "One draw call per tile      : " << dPerTileTime * 1000.0 / uiNumFrames << " ms per frame" << endl;
+	cout << "CTileMapRenderer            : " << dBatchedTime * 1000.0 / uiNumFrames << " ms per frame" << endl;
+	cout << "CTileMapRenderer, 1 edit    : " << dEditedTime * 1000.0 / uiNumFrames << " ms per frame" << endl;
+}
+
+/**
+ @brief Compare the time to load a large generated level through rapidcsv, the fast CSV parser and level files.
+		The level is written into temporary files in Maps/, which are deleted afterwards.
+ @param uiNumRows A const unsigned int variable containing the number of rows of the generated level
+ @param uiNumCols A const unsigned int variable containing the number of columns of the generated level
+ */
+void CMap2D::BenchmarkLoad(const unsigned int uiNumRows, const unsigned int uiNumCols)
+{
+	const string sCSVFilename = FileSystem::getPath("Maps/LoadBenchmark.csv");
+	const string sRawFilename = FileSystem::getPath("Maps/LoadBenchmark_Raw.lvl");
+	const string sRLEFilename = FileSystem::getPath("Maps/LoadBenchmark_RLE.lvl");
+
+	// Generate a level with runs of ground and empty tiles, like a large procedurally generated level
+	vector<CLevelFile::LevelData> vLevel(1);
+	vLevel[0].uiNumRows = uiNumRows;
+	vLevel[0].uiNumCols = uiNumCols;
+	vLevel[0].vTile.resize((size_t)uiNumRows * uiNumCols);
+	CRandom cRandom(1);
+	for (size_t i = 0; i < vLevel[0].vTile.size(); )
+	{
+		const size_t uiRunLength = (size_t)cRandom.RangeInt(1, 24);
+		const int iValue = (cRandom.NextUInt() & 3) == 0 ? 100 : ((cRandom.NextUInt() & 15) == 0 ? 2 : 0);
+		for (size_t j = 0; (j < uiRunLength) && (i < vLevel[0].vTile.size()); j++, i++)
+			vLevel[0].vTile[i] = iValue;
+	}
+
+	{
+		ofstream cFile(sCSVFilename.c_str(), ios::out | ios::binary | ios::trunc);
+		for (unsigned int uiCol = 0; uiCol < uiNumCols; uiCol++)
+			cFile << (uiCol == 0 ? "//" : ",") << uiCol + 1;
+		cFile << "\n";
+		for (unsigned int uiRow = 0; uiRow < uiNumRows; uiRow++)
+		{
+			for (unsigned int uiCol = 0; uiCol < uiNumCols; uiCol++)
+				cFile << (uiCol == 0 ? "" : ",") << vLevel[0].vTile[(size_t)uiRow * uiNumCols + uiCol];
+			cFile << "\n";
+		}
+	}
+	CLevelFile::Write(sRawFilename, vLevel, CLevelFile::RAW);
+	CLevelFile::Write(sRLEFilename, vLevel, CLevelFile::RLE);
+
+	CStopWatch cStopWatch;
+	cStopWatch.StartTimer();
+	vector<int> vTile;
+
+	// 1. rapidcsv, with a vector<string> per row and stoi per cell, as in LoadMap()
+	cStopWatch.GetElapsedTime();
+	{
+		rapidcsv::Document cDocument(sCSVFilename.c_str());
+		vTile.resize((size_t)cDocument.GetRowCount() * cDocument.GetColumnCount());
+		for (unsigned int uiRow = 0; uiRow < cDocument.GetRowCount(); uiRow++)
+		{
+			std::vector<std::string> row = cDocument.GetRow<std::string>(uiRow);
+			for (unsigned int uiCol = 0; uiCol < row.size(); uiCol++)
+				vTile[(size_t)uiRow * row.size() + uiCol] = stoi(row[uiCol]);
+		}
+	}
+	const double dRapidCSVTime = cStopWatch.GetElapsedTime();
+	const bool bRapidCSVValid = (vTile == vLevel[0].vTile);
+
+	// 2. The fast CSV parser
+	CLevelFile::LevelData cLevel;
+	cStopWatch.GetElapsedTime();
+	CLevelFile::LoadCSV(sCSVFilename, cLevel);
+	const double dFastCSVTime = cStopWatch.GetElapsedTime();
+	const bool bFastCSVValid = (cLevel.vTile == vLevel[0].vTile);
+
+	// 3. A raw level file, whose tiles are read straight from the mapped file
+	CLevelFile cLevelFile;
+	cStopWatch.GetElapsedTime();
+	cLevelFile.Open(sRawFilename);
+	cLevelFile.ReadTiles(0, vTile);
+	cLevelFile.Close();
+	const double dRawTime = cStopWatch.GetElapsedTime();
+	const bool bRawValid = (vTile == vLevel[0].vTile);
+
+	// 4. A level file compressed with run-length encoding
+	cStopWatch.GetElapsedTime();
+	cLevelFile.Open(sRLEFilename);
+	cLevelFile.ReadTiles(0, vTile);
+	cLevelFile.Close();
+	const double dRLETime = cStopWatch.GetElapsedTime();
+	const bool bRLEValid = (vTile == vLevel[0].vTile);
+
+	// Get the sizes of the files before deleting them
+	const streamoff iCSVSize = ifstream(sCSVFilename.c_str(), ios::binary | ios::ate).tellg();
+	const streamoff iRawSize = ifstream(sRawFilename.c_str(), ios::binary | ios::ate).tellg();
+	const streamoff iRLESize = ifstream(sRLEFilename.c_str(), ios::binary | ios::ate).tellg();
+	remove(sCSVFilename.c_str());
+	remove(sRawFilename.c_str());
+	remove(sRLEFilename.c_str());
+
+	cout << "CMap2D::BenchmarkLoad() with " << uiNumRows << "x" << uiNumCols << " tiles" << endl;
+	cout << "rapidcsv                    : " << dRapidCSVTime * 1000.0 << " ms, " << iCSVSize / 1024 << " KB"
+		<< (bRapidCSVValid ? "" : ", WRONG TILES") << endl;
+	cout << "CLevelFile::LoadCSV         : " << dFastCSVTime * 1000.0 << " ms, " << iCSVSize / 1024 << " KB"
+		<< (bFastCSVValid ? "" : ", WRONG TILES") << endl;
+	cout << "CLevelFile, raw             : " << dRawTime * 1000.0 << " ms, " << iRawSize / 1024 << " KB"
+		<< (bRawValid ? "" : ", WRONG TILES") << endl;
+	cout << "CLevelFile, RLE             : " << dRLETime * 1000.0 << " ms, " << iRLESize / 1024 << " KB"
+		<< (bRLEValid ? "" : ", WRONG TILES") << endl;
+}
+
+/**
+ @brief Compare the time which a frame spends saving the map, when saving on this thread and in the background.
+		A few tiles of the current level are changed before each save, as when the player picks things up.
+		The changed tiles are set to their own values, so the map is not changed.
+ @param uiNumFrames A const unsigned int variable containing the number of frames to save in with each method
+ @param uiEditsPerFrame A const unsigned int variable containing the number of tiles changed in each frame
+ */
+void CMap2D::BenchmarkSave(const unsigned int uiNumFrames, const unsigned int uiEditsPerFrame)
+{
+	const string sFilename = "Maps/DM2213_Map_Level_01_SAVEBENCHMARK.csv";
+	const unsigned int uiNumTiles = cSettings->NUM_TILES_YAXIS * cSettings->NUM_TILES_XAXIS;
+	const bool bUseBackgroundSave = cSettings->bUseBackgroundSave;
+	unsigned int uiEdit = 0;
+
+	CStopWatch cStopWatch;
+	cStopWatch.StartTimer();
+
+	// 1. Save on this thread in every frame
+	double dSyncTotalTime = 0.0, dSyncMaxTime = 0.0;
+	for (unsigned int uiFrame = 0; uiFrame < uiNumFrames; uiFrame++)
+	{
+		for (unsigned int i = 0; i < uiEditsPerFrame; i++, uiEdit++)
+		{
+			const unsigned int uiTile = (uiEdit * 7919) % uiNumTiles;
+			const unsigned int uiRow = uiTile / cSettings->NUM_TILES_XAXIS;
+			const unsigned int uiCol = uiTile % cSettings->NUM_TILES_XAXIS;
+			SetMapInfo(uiRow, uiCol, GetMapInfo(uiRow, uiCol, false), false);
+		}
+		cStopWatch.GetElapsedTime();
+		SaveMapNow(sFilename, uiCurLevel);
+		const double dTime = cStopWatch.GetElapsedTime();
+		dSyncTotalTime += dTime;
+		if (dTime > dSyncMaxTime)
+			dSyncMaxTime = dTime;
+	}
+
+	// 2. Queue a save in every frame for the cMapSaveWriter
+	cSettings->bUseBackgroundSave = true;
+	while (IsSaving())
+		this_thread::sleep_for(chrono::milliseconds(1));
+	const unsigned int uiNumWrites = cMapSaveWriter.GetNumWrites();
+	unsigned int uiNumFramesInFlight = 0;
+	double dAsyncTotalTime = 0.0, dAsyncMaxTime = 0.0;
+	for (unsigned int uiFrame = 0; uiFrame < uiNumFrames; uiFrame++)
+	{
+		for (unsigned int i = 0; i < uiEditsPerFrame; i++, uiEdit++)
+		{
+			const unsigned int uiTile = (uiEdit * 7919) % uiNumTiles;
+			const unsigned int uiRow = uiTile / cSettings->NUM_TILES_XAXIS;
+			const unsigned int uiCol = uiTile % cSettings->NUM_TILES_XAXIS;
+			SetMapInfo(uiRow, uiCol, GetMapInfo(uiRow, uiCol, false), false);
+		}
+		cStopWatch.GetElapsedTime();
+		SaveMap(sFilename, uiCurLevel);
+		const double dTime = cStopWatch.GetElapsedTime();
+		dAsyncTotalTime += dTime;
+		if (dTime > dAsyncMaxTime)
+			dAsyncMaxTime = dTime;
+		if (IsSaving())
+			uiNumFramesInFlight++;
+
+		// Let the frames take about as long as a real frame, so that the requests are spread over time
+		this_thread::sleep_for(chrono::milliseconds(cSettings->frameTime));
+	}
+	cStopWatch.GetElapsedTime();
+	while (IsSaving())
+		this_thread::sleep_for(chrono::milliseconds(1));
+	const double dDrainTime = cStopWatch.GetElapsedTime();
+	cSettings->bUseBackgroundSave = bUseBackgroundSave;
+
+	remove(FileSystem::getPath(sFilename).c_str());
+
+	cout << "CMap2D::BenchmarkSave() with " << cSettings->NUM_TILES_YAXIS << "x" << cSettings->NUM_TILES_XAXIS
+		<< " tiles, " << uiNumFrames << " frames, " << uiEditsPerFrame << " changed tiles per frame" << endl;
+	cout << "Save on this thread         : " << dSyncTotalTime * 1000.0 / uiNumFrames << " ms per frame, "
+		<< dSyncMaxTime * 1000.0 << " ms max, " << uiNumFrames << " writes" << endl;
+	cout << "CMapSaveWriter              : " << dAsyncTotalTime * 1000.0 / uiNumFrames << " ms per frame, "
+		<< dAsyncMaxTime * 1000.0 << " ms max, " << cMapSaveWriter.GetNumWrites() - uiNumWrites << " writes, "
+		<< uiNumFramesInFlight << " frames with a save in flight, "
+		<< dDrainTime * 1000.0 << " ms to finish" << endl;
+}
+
+/**
+ @brief Measure the frames and the memory of a large generated level, which is streamed into the current level
+		while the viewport scrolls across it, as a player would move through it. A tile is changed in each
+		frame, so the changed chunks go into the scratch file. The level is written into a temporary chunk file
+		in Maps/, which is deleted afterwards, and the current level is left empty, so a map must be loaded
+		into it after this.
+ @param uiNumRows A const unsigned int variable containing the number of rows of the generated level
+ @param uiNumCols A const unsigned int variable containing the number of columns of the generated level
+ @param uiNumFrames A const unsigned int variable containing the number of frames to scroll for
+ */
+void CMap2D::BenchmarkStreaming(const unsigned int uiNumRows, const unsigned int uiNumCols, const unsigned int uiNumFrames)
+{
+	const string sFilename = "Maps/StreamBenchmark.chunks";
+	const unsigned int uiMaxResidentChunks = 64;
+	const unsigned int uiViewRows = cSettings->NUM_TILES_YAXIS;
+	const unsigned int uiViewCols = cSettings->NUM_TILES_XAXIS;
+	if ((uiNumRows < uiViewRows) || (uiNumCols < uiViewCols))
+		return;
+
+	// Generate a level with runs of ground and empty tiles, like a large procedurally generated level
+	{
+		CTileGrid cGrid;
+		cGrid.Init(uiNumRows, uiNumCols);
+		CRandom cRandom(1);
+		for (unsigned int uiRow = 0; uiRow < uiNumRows; uiRow++)
+		{
+			for (unsigned int uiCol = 0; uiCol < uiNumCols; )
+			{
+				const unsigned int uiRunLength = (unsigned int)cRandom.RangeInt(1, 24);
+				const int iValue = (cRandom.NextUInt() & 3) == 0 ? 100 : ((cRandom.NextUInt() & 15) == 0 ? 2 : 0);
+				for (unsigned int j = 0; (j < uiRunLength) && (uiCol < uiNumCols); j++, uiCol++)
+					cGrid.Set(uiRow, uiCol, iValue);
+			}
+		}
+		if (cGrid.SaveChunkFile(FileSystem::getPath(sFilename)) == false)
+			return;
+	}
+	if (StreamMap(sFilename, uiCurLevel, uiMaxResidentChunks) == false)
+	{
+		remove(FileSystem::getPath(sFilename).c_str());
+		return;
+	}
+	CTileGrid& cLevel = arrMapInfo[uiCurLevel];
+	const int iOriginalValue = cLevel.Get(0, 0);
+
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glActiveTexture(GL_TEXTURE0);
+	CShaderManager::GetInstance()->Use(sTileMapShaderName);
+	CShaderManager::GetInstance()->activeShader->setMat4("transform", glm::mat4(1.0f));
+
+	// Scroll the viewport from side to side, moving down by a viewport at each side
+	CStopWatch cStopWatch;
+	cStopWatch.StartTimer();
+	unsigned int uiViewRow = 0;
+	int iViewCol = 0, iStep = 4;
+	unsigned int uiMaxResident = 0;
+	double dTotalTime = 0.0, dMaxTime = 0.0;
+	for (unsigned int uiFrame = 0; uiFrame < uiNumFrames; uiFrame++)
+	{
+		iViewCol += iStep;
+		if ((iViewCol < 0) || (iViewCol > (int)(uiNumCols - uiViewCols)))
+		{
+			iStep = -iStep;
+			iViewCol += iStep;
+			uiViewRow = (uiViewRow + uiViewRows) % (uiNumRows - uiViewRows + 1);
+		}
+
+		cStopWatch.GetElapsedTime();
+		SetViewport(uiViewRow, iViewCol);
+		SetMapInfo(uiFrame % uiViewRows, uiFrame % uiViewCols, 2, false);
+		cTileMapRenderer.Render(uiCurLevel);
+		glFinish();
+		const double dTime = cStopWatch.GetElapsedTime();
+		dTotalTime += dTime;
+		if (dTime > dMaxTime)
+			dMaxTime = dTime;
+		if (cLevel.GetNumResidentChunks() > uiMaxResident)
+			uiMaxResident = cLevel.GetNumResidentChunks();
+	}
+	glDisable(GL_BLEND);
+
+	const unsigned int uiNumChunks = ((uiNumRows + CTileGrid::CHUNK_MASK) >> CTileGrid::CHUNK_SHIFT) *
+										((uiNumCols + CTileGrid::CHUNK_MASK) >> CTileGrid::CHUNK_SHIFT);
+	const unsigned int uiChunkKB = CTileGrid::CHUNK_TILES * sizeof(int) / 1024;
+	const unsigned int uiNumChunkLoads = cLevel.GetNumChunkLoads();
+	const unsigned int uiNumScratchChunks = cLevel.GetNumScratchChunks();
+
+	// The changes went into the scratch file, so the chunk file must still hold the first tile as it was generated
+	bool bFileUnchanged = false;
+	{
+		CTileGrid cGrid;
+		if (cGrid.OpenChunkFile(FileSystem::getPath(sFilename), 1))
+			bFileUnchanged = (cGrid.Get(0, 0) == iOriginalValue);
+	}
+
+	// Leave the current level empty, and delete the chunk file
+	cLevel.Init(uiViewRows, uiViewCols);
+	UpdateTileMapRenderer(uiCurLevel);
+	UpdateSolidBits(uiCurLevel);
+	UpdateTileIndex(uiCurLevel);
+	ResetSaveState(uiCurLevel);
+	uiBlockedVersion++;
+	remove(FileSystem::getPath(sFilename).c_str());
+
+	cout << "CMap2D::BenchmarkStreaming() with " << uiNumRows << "x" << uiNumCols << " tiles, a "
+		<< uiViewRows << "x" << uiViewCols << " viewport, " << uiNumFrames << " frames" << endl;
+	cout << "Frame time                  : " << dTotalTime * 1000.0 / uiNumFrames << " ms per frame, "
+		<< dMaxTime * 1000.0 << " ms max" << endl;
+	cout << "Chunks in memory            : " << uiMaxResident << " of " << uiNumChunks << " at most, "
+		<< uiMaxResident * uiChunkKB << " KB instead of " << uiNumChunks * uiChunkKB << " KB" << endl;
+	cout << "Chunk loads                 : " << uiNumChunkLoads << ", " << uiNumScratchChunks
+		<< " changed chunks in the scratch file" << (bFileUnchanged ? "" : ", CHUNK FILE CHANGED") << endl;
+}
+
 /**
  @brief Check if a position is valid
  */
@@ -664,16 +1901,16 @@ bool CMap2D::isBlocked(const unsigned int uiRow, const unsigned int uiCol, const
 {
 	if (bInvert == true)
 	{
-		if ((arrMapInfo[uiCurLevel][cSettings->NUM_TILES_YAXIS - uiRow - 1][uiCol].value >= 100) &&
-			(arrMapInfo[uiCurLevel][cSettings->NUM_TILES_YAXIS - uiRow - 1][uiCol].value < 200))
+		const int iValue = arrMapInfo[uiCurLevel].Get(cSettings->NUM_TILES_YAXIS - uiRow - 1, uiCol);
+		if ((iValue >= 100) && (iValue < 200))
 			return true;
 		else
 			return false;
 	}
 	else
 	{
-		if ((arrMapInfo[uiCurLevel][uiRow][uiCol].value >= 100) &&
-			(arrMapInfo[uiCurLevel][uiRow][uiCol].value < 200))
+		const int iValue = arrMapInfo[uiCurLevel].Get(uiRow, uiCol);
+		if ((iValue >= 100) && (iValue < 200))
 			return true;
 		else
 			return false;
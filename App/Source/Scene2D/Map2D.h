@@ -23,6 +23,7 @@
 #include "System/rapidcsv.h"
 // Include map storage
 #include <map>
+#include <unordered_map>
 
 // Include Settings
 #include "GameControl\Settings.h"
@@ -30,6 +31,18 @@
 // Include Entity2D
 #include "Primitives/Entity2D.h"
 
+// Include CTileMapRenderer
+#include "RenderControl/TileMapRenderer.h"
+
+// Include CTileGrid
+#include "TileGrid.h"
+// Include CMapSaveWriter
+#include "MapSaveWriter.h"
+// Include CLevelFile
+#include "LevelFile.h"
+// Include CLevelLoader
+#include "LevelLoader.h"
+
 // Include files for AStar
 #include <queue>
 #include <functional>
@@ -40,18 +53,16 @@ struct MapSize {
 	unsigned int uiColSize;
 };
 
-// A structure storing information about a map grid
-// It includes data to be used for A* Path Finding
+// A structure storing the A* Path Finding data of a map grid.
+// The tile values are stored separately in a CTileGrid for each level.
 struct Grid {
-	unsigned int value;
-
 	Grid() 
-		: value(0), pos(0, 0), parent(-1, -1), f(0), g(0), h(0) {}
+		: pos(0, 0), parent(-1, -1), f(0), g(0), h(0) {}
 	Grid(	const glm::i32vec2& pos, unsigned int f) 
-		: value(0), pos(pos), parent(-1, 1), f(f), g(0), h(0) {}
+		: pos(pos), parent(-1, 1), f(f), g(0), h(0) {}
 	Grid(	const glm::i32vec2& pos, const glm::i32vec2& parent, 
 			unsigned int f, unsigned int g, unsigned int h) 
-		: value(0), pos(pos), parent(parent), f(f), g(g), h(h) {}
+		: pos(pos), parent(parent), f(f), g(g), h(h) {}
 
 	glm::i32vec2 pos;
 	glm::i32vec2 parent;
@@ -102,14 +113,47 @@ public:
 	// Get the value at certain indices in the arrMapInfo
 	int GetMapInfo(const unsigned int uiRow, const unsigned int uiCol, const bool bInvert = true) const;
 
-	// Load a map
-	bool LoadMap(string filename, const unsigned int uiLevel = 0);
+	// Check if a tile of the current level is solid, which is a value of 100 or more. Tiles outside the map are not solid.
+	bool IsSolid(const int iRow, const int iCol, const bool bInvert = true) const;
+	// Sweep a box, in tiles, through the current level, and find the first solid tile which it hits and when
+	bool SweepAABB(	const glm::vec2& vec2BoxMin,
+					const glm::vec2& vec2BoxMax,
+					const glm::vec2& vec2Displacement,
+					glm::i32vec2& i32vec2HitTile,
+					float& fTimeOfImpact) const;
 
-	// Save a tilemap
+	// Load a map from a CSV file, or from the first level of a level file if filename ends with .lvl
+	bool LoadMap(string filename, const unsigned int uiLevel = 0);
+	// Load a level of a level file
+	bool LoadBinaryMap(string filename, const unsigned int uiFileLevel = 0, const unsigned int uiLevel = 0);
+
+	// Load a map into a level on a background thread, while another level is played. Update() fills in the level.
+	bool PreloadMap(string filename, const unsigned int uiLevel);
+	// Check if a level is still being loaded in the background
+	bool IsPreloading(const unsigned int uiLevel) const;
+	// Wait for the background load of a level, and fill in the level
+	bool FinishPreload(const unsigned int uiLevel);
+	// Clear a level which will not be played again, and free its streamed chunks
+	bool UnloadMap(const unsigned int uiLevel);
+
+	// Save a tilemap. With background saving, this only queues the changed tiles for the CMapSaveWriter.
 	bool SaveMap(string filename, const unsigned int uiLevel = 0);
-
-	// Find the indices of a certain value in arrMapInfo
-	bool FindValue(const int iValue, unsigned int& uirRow, unsigned int& uirCol, const bool bInvert = true);
+	// Check if a save is waiting or being written
+	bool IsSaving(void) const;
+
+	// Save a level into a chunk file, which a large level can be streamed from
+	bool SaveChunkedMap(string filename, const unsigned int uiLevel = 0);
+	// Stream a level from a chunk file, keeping only the chunks near the viewport in memory
+	bool StreamMap(string filename, const unsigned int uiLevel = 0, const unsigned int uiMaxResidentChunks = 256);
+	// Move the viewport of the current level, which is the part of the level that is rendered and played in
+	void SetViewport(const unsigned int uiFirstRow, const unsigned int uiFirstCol);
+
+	// Find the indices of the first tile of a certain value in the current level, in the order of the rows in arrMapInfo
+	bool FindValue(const int iValue, unsigned int& uirRow, unsigned int& uirCol, const bool bInvert = true) const;
+	// Find the indices of all the tiles of a certain value in the current level, as (column, row). Returns the number found.
+	unsigned int FindAllValues(const int iValue, vector<glm::i32vec2>& vPositions, const bool bInvert = true) const;
+	// Count the tiles of a certain value in the current level
+	unsigned int CountValue(const int iValue) const;
 
 	// Set current level
 	void SetCurrentLevel(unsigned int uiCurLevel);
@@ -123,21 +167,50 @@ public:
 										const int weight = 1);
 	// Set if AStar PathFinding will consider diagonal movements
 	void SetDiagonalMovement(const bool bEnable);
+	// Check if AStar PathFinding considers diagonal movements
+	bool GetDiagonalMovement(void) const;
+	// Get a number which changes whenever a tile of the current level is blocked or unblocked
+	unsigned int GetBlockedVersion(void) const;
+	// Copy the blocked tiles of the current level into vBlocked, indexed in the same way as PathFind positions
+	void GetBlockedTiles(vector<unsigned char>& vBlocked) const;
 	// Print out details about this class instance in the console window
 	void PrintSelf(void) const;
 
+	// Compare the cost of drawing a large generated map one tile at a time against one draw call
+	void Benchmark(const unsigned int uiNumRows = 256, const unsigned int uiNumCols = 256, const unsigned int uiNumFrames = 100);
+	// Compare the time to load a large generated level through rapidcsv, the fast CSV parser and level files
+	void BenchmarkLoad(const unsigned int uiNumRows = 1024, const unsigned int uiNumCols = 1024);
+	// Compare the time which a frame spends saving the map, when saving on this thread and in the background
+	void BenchmarkSave(const unsigned int uiNumFrames = 120, const unsigned int uiEditsPerFrame = 4);
+	// Measure the frames and the memory of a large generated level which is streamed while the viewport scrolls across it
+	void BenchmarkStreaming(const unsigned int uiNumRows = 2048, const unsigned int uiNumCols = 2048, const unsigned int uiNumFrames = 600);
+
 protected:
 	// The variable containing the rapidcsv::Document
 	// We will load the CSV file's content into this Document
 	rapidcsv::Document doc;
+	// The column names line of the last loaded map, which starts the saved CSV files
+	string sCSVHeader;
 
-	// A 3-D array which stores the values of the tile map
-	Grid*** arrMapInfo;
+	// The tile values of each level, stored in chunks
+	CTileGrid* arrMapInfo;
 
 	// The current level
 	unsigned int uiCurLevel;
 	// The number of levels
 	unsigned int uiNumLevels;
+	// Changes whenever a tile of the current level is blocked or unblocked, or the current level changes
+	unsigned int uiBlockedVersion;
+
+	// A bit for each tile of each level, which is set if the tile is solid. The rows are inverted, as in
+	// the indices of the entities, and each row starts at a new 64-bit word.
+	vector<vector<uint64_t>> vSolidBits;
+	unsigned int uiSolidWordsPerRow;
+
+	// The tiles of each value in each level, for FindValue. Each list holds the tiles as
+	// uiRow * NUM_TILES_XAXIS + uiCol, with the rows as in arrMapInfo, in increasing order.
+	// The empty tiles (0) are not listed, since most tiles are empty; they are found by scanning the level.
+	vector<unordered_map<int, vector<unsigned int>>> vTileIndex;
 
 	// A 1-D array which stores the map sizes for each level
 	MapSize* arrMapSizes;
@@ -148,6 +221,20 @@ protected:
 	//CS: The quadMesh for drawing the tiles
 	CMesh* quadMesh;
 
+	// Draws all the tiles of a level with one draw call
+	CTileMapRenderer cTileMapRenderer;
+	// The shader of the cTileMapRenderer
+	string sTileMapShaderName;
+
+	// Writes the saves in the background
+	CMapSaveWriter cMapSaveWriter;
+	// The tiles of each level which have changed since the last save, and a flag for each tile to find them quickly
+	vector<vector<unsigned int>> vSaveDirtyList;
+	vector<vector<unsigned char>> vSaveDirtyFlag;
+
+	// Loads the levels in the background
+	CLevelLoader cLevelLoader;
+
 	// Constructor
 	CMap2D(void);
 
@@ -159,6 +246,26 @@ protected:
 
 	// Render a tile
 	void RenderTile(const unsigned int uiRow, const unsigned int uiCol);
+	// Render the tiles one at a time
+	void RenderTiles(void);
+	// Copy the visible tiles of a level into the cTileMapRenderer
+	void UpdateTileMapRenderer(const unsigned int uiLevel);
+	// Set the solid bits of a level from its tiles
+	void UpdateSolidBits(const unsigned int uiLevel);
+	// List the tiles of each value of a level
+	void UpdateTileIndex(const unsigned int uiLevel);
+	// Move a tile of a level from the list of its old value to the list of its new value
+	void MoveInTileIndex(const unsigned int uiLevel, const unsigned int uiIndex, const int iOldValue, const int iNewValue);
+	// Get the list of the tiles of a value in the current level, or NULL if there are none
+	const vector<unsigned int>* GetTileIndex(const int iValue) const;
+	// Copy the tiles of a loaded map into a level
+	bool SetLevelTiles(const unsigned int uiLevel, const unsigned int uiNumRows, const unsigned int uiNumCols, const int* pTile);
+	// Fill in a level which has been loaded in the background, and upload its vertex buffer
+	bool ApplyPreloadedMap(const unsigned int uiLevel);
+	// Save a level into a CSV file on this thread
+	bool SaveMapNow(const string& filename, const unsigned int uiLevel);
+	// Forget the changed tiles of a level, after another map is loaded into it
+	void ResetSaveState(const unsigned int uiLevel);
 
 	// For A-Star PathFinding
 	// Build a path from m_cameFromList after calling PathFind()
@@ -0,0 +1,440 @@
+/**
+ CMapSaveWriter
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#include "MapSaveWriter.h"
+
+// Include CLogger
+#include "System/Logger.h"
+
+#include <fstream>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/**
+ @brief Constructor
+ */
+CMapSaveWriter::CMapSaveWriter(void)
+	: dCoalesceDuration(chrono::steady_clock::duration::zero())
+	, bRunning(false)
+	, bWriting(false)
+	, uiNumRequests(0)
+	, uiNumWrites(0)
+	, uiNumFailures(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CMapSaveWriter::~CMapSaveWriter(void)
+{
+	Stop();
+}
+
+/**
+ @brief Initialise this class instance and start the background thread
+ @param uiNumLevels A const unsigned int variable containing the number of levels
+ @param dCoalesceTime A const double variable containing the time in seconds which a request waits for more requests
+ @return true if the background thread is started, else false
+ */
+bool CMapSaveWriter::Init(const unsigned int uiNumLevels, const double dCoalesceTime)
+{
+	// Stop the background thread if this was initialised before
+	Stop();
+
+	vLevel.clear();
+	vLevel.resize(uiNumLevels);
+	for (unsigned int i = 0; i < uiNumLevels; i++)
+	{
+		vLevel[i].bHasSnapshot = false;
+		vLevel[i].uiNumRows = 0;
+		vLevel[i].uiNumCols = 0;
+		vLevel[i].bPending = false;
+		vLevel[i].bPendingFull = false;
+		vLevel[i].uiPendingRows = 0;
+		vLevel[i].uiPendingCols = 0;
+	}
+	dCoalesceDuration = chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(dCoalesceTime));
+
+	bRunning = true;
+	cThread = thread(&CMapSaveWriter::Run, this);
+	return true;
+}
+
+/**
+ @brief Stop the background thread after writing out the requests which are waiting
+ */
+void CMapSaveWriter::Stop(void)
+{
+	{
+		lock_guard<mutex> cLock(cMutex);
+		if (bRunning == false)
+			return;
+		bRunning = false;
+	}
+	cCondition.notify_one();
+	if (cThread.joinable())
+		cThread.join();
+}
+
+/**
+ @brief Check if the writer has a copy of a level, so that a request only needs the changed tiles
+ @param uiLevel A const unsigned int variable containing the level
+ @return true if the writer has a copy of the level, else false
+ */
+bool CMapSaveWriter::HasSnapshot(const unsigned int uiLevel) const
+{
+	lock_guard<mutex> cLock(cMutex);
+	if (uiLevel >= vLevel.size())
+		return false;
+	return vLevel[uiLevel].bHasSnapshot;
+}
+
+/**
+ @brief Request a save of a whole level. The requests which are waiting for this level are replaced.
+ @param sFilename A const string& variable containing the name of the file to write
+ @param uiLevel A const unsigned int variable containing the level
+ @param uiNumRows A const unsigned int variable containing the number of rows in the level
+ @param uiNumCols A const unsigned int variable containing the number of columns in the level
+ @param sHeader A const string& variable containing the first line of the file
+ @param vTile A vector<int>& variable containing the values of the tiles, row by row. It is moved away.
+ @return true if the request is queued, else false
+ */
+bool CMapSaveWriter::RequestSave(	const string& sFilename,
+									const unsigned int uiLevel,
+									const unsigned int uiNumRows,
+									const unsigned int uiNumCols,
+									const string& sHeader,
+									vector<int>& vTile)
+{
+	if (vTile.size() != (size_t)uiNumRows * uiNumCols)
+		return false;
+
+	{
+		lock_guard<mutex> cLock(cMutex);
+		if ((bRunning == false) || (uiLevel >= vLevel.size()))
+			return false;
+
+		Level& cLevel = vLevel[uiLevel];
+		if (cLevel.bPending == false)
+			cLevel.tFirstRequest = chrono::steady_clock::now();
+		cLevel.bPending = true;
+		cLevel.bPendingFull = true;
+		cLevel.sPendingFilename = sFilename;
+		cLevel.uiPendingRows = uiNumRows;
+		cLevel.uiPendingCols = uiNumCols;
+		cLevel.sPendingHeader = sHeader;
+		cLevel.vPendingTile.swap(vTile);
+		cLevel.vPendingChange.clear();
+		cLevel.bHasSnapshot = true;
+	}
+	vTile.clear();
+	uiNumRequests++;
+	cCondition.notify_one();
+	return true;
+}
+
+/**
+ @brief Request a save of a level, of which only some tiles have changed since the last request.
+		HasSnapshot() must be true for this level.
+ @param sFilename A const string& variable containing the name of the file to write
+ @param uiLevel A const unsigned int variable containing the level
+ @param vChange A vector<TileChange>& variable containing the changed tiles. It is moved away.
+ @return true if the request is queued, else false
+ */
+bool CMapSaveWriter::RequestSave(	const string& sFilename,
+									const unsigned int uiLevel,
+									vector<TileChange>& vChange)
+{
+	{
+		lock_guard<mutex> cLock(cMutex);
+		if ((bRunning == false) || (uiLevel >= vLevel.size()) || (vLevel[uiLevel].bHasSnapshot == false))
+			return false;
+
+		Level& cLevel = vLevel[uiLevel];
+		if (cLevel.bPending == false)
+			cLevel.tFirstRequest = chrono::steady_clock::now();
+		cLevel.bPending = true;
+		cLevel.sPendingFilename = sFilename;
+
+		if (cLevel.bPendingFull)
+		{
+			// Merge the changes into the whole level which is waiting
+			for (size_t i = 0; i < vChange.size(); i++)
+			{
+				if (vChange[i].uiIndex < cLevel.vPendingTile.size())
+					cLevel.vPendingTile[vChange[i].uiIndex] = vChange[i].iValue;
+			}
+		}
+		else if (cLevel.vPendingChange.empty())
+		{
+			cLevel.vPendingChange.swap(vChange);
+		}
+		else
+		{
+			// The later changes are applied after the earlier ones
+			cLevel.vPendingChange.insert(cLevel.vPendingChange.end(), vChange.begin(), vChange.end());
+		}
+	}
+	vChange.clear();
+	uiNumRequests++;
+	cCondition.notify_one();
+	return true;
+}
+
+/**
+ @brief Forget the copy of a level, such as when another map is loaded into it.
+		The next request for this level must be a whole level.
+ @param uiLevel A const unsigned int variable containing the level
+ */
+void CMapSaveWriter::Invalidate(const unsigned int uiLevel)
+{
+	lock_guard<mutex> cLock(cMutex);
+	if (uiLevel < vLevel.size())
+		vLevel[uiLevel].bHasSnapshot = false;
+}
+
+/**
+ @brief Check if any request is waiting or being written
+ @return true if the writer is busy, else false
+ */
+bool CMapSaveWriter::IsBusy(void) const
+{
+	if (bWriting)
+		return true;
+
+	lock_guard<mutex> cLock(cMutex);
+	for (size_t i = 0; i < vLevel.size(); i++)
+	{
+		if (vLevel[i].bPending)
+			return true;
+	}
+	return false;
+}
+
+/**
+ @brief Get the number of save requests
+ @return The number of save requests
+ */
+unsigned int CMapSaveWriter::GetNumRequests(void) const
+{
+	return uiNumRequests;
+}
+
+/**
+ @brief Get the number of files which were written
+ @return The number of files which were written
+ */
+unsigned int CMapSaveWriter::GetNumWrites(void) const
+{
+	return uiNumWrites;
+}
+
+/**
+ @brief Get the number of files which could not be written
+ @return The number of files which could not be written
+ */
+unsigned int CMapSaveWriter::GetNumFailures(void) const
+{
+	return uiNumFailures;
+}
+
+/**
+ @brief The loop run by the background thread
+ */
+void CMapSaveWriter::Run(void)
+{
+	unique_lock<mutex> cLock(cMutex);
+	while (true)
+	{
+		// Write the levels whose first request has waited for the coalescing time.
+		// When stopping, every waiting request is written now.
+		const chrono::steady_clock::time_point tNow = chrono::steady_clock::now();
+		bool bWaiting = false;
+		chrono::steady_clock::time_point tNextDue = chrono::steady_clock::time_point::max();
+		for (size_t i = 0; i < vLevel.size(); i++)
+		{
+			if (vLevel[i].bPending == false)
+				continue;
+
+			const chrono::steady_clock::time_point tDue = vLevel[i].tFirstRequest + dCoalesceDuration;
+			if ((bRunning == false) || (tDue <= tNow))
+			{
+				WriteLevel(vLevel[i], cLock);
+			}
+			else
+			{
+				bWaiting = true;
+				if (tDue < tNextDue)
+					tNextDue = tDue;
+			}
+		}
+
+		if (bWaiting)
+		{
+			cCondition.wait_until(cLock, tNextDue);
+		}
+		else if (bRunning)
+		{
+			// Check again if a request arrived while a level was being written
+			bool bPending = false;
+			for (size_t i = 0; i < vLevel.size(); i++)
+				bPending = bPending || vLevel[i].bPending;
+			if (bPending == false)
+				cCondition.wait(cLock);
+		}
+		else
+		{
+			// Stop once no request arrived while the last levels were being written
+			bool bPending = false;
+			for (size_t i = 0; i < vLevel.size(); i++)
+				bPending = bPending || vLevel[i].bPending;
+			if (bPending == false)
+				break;
+		}
+	}
+}
+
+/**
+ @brief Apply the waiting requests of a level to its copy and write it into its file.
+		The mutex is locked when this is called, and is unlocked while the file is written.
+ @param cLevel A Level& variable containing the level to write
+ @param cLock A unique_lock<mutex>& variable containing the lock of the mutex
+ */
+void CMapSaveWriter::WriteLevel(Level& cLevel, unique_lock<mutex>& cLock)
+{
+	// Take the waiting requests, so that new requests can be queued while this level is written
+	const bool bFull = cLevel.bPendingFull;
+	string sFilename;
+	string sHeader;
+	vector<int> vTile;
+	vector<TileChange> vChange;
+	sFilename.swap(cLevel.sPendingFilename);
+	sHeader.swap(cLevel.sPendingHeader);
+	vTile.swap(cLevel.vPendingTile);
+	vChange.swap(cLevel.vPendingChange);
+	const unsigned int uiNumRows = cLevel.uiPendingRows;
+	const unsigned int uiNumCols = cLevel.uiPendingCols;
+	cLevel.bPending = false;
+	cLevel.bPendingFull = false;
+	bWriting = true;
+	cLock.unlock();
+
+	// Only the background thread uses the copy of the level
+	if (bFull)
+	{
+		cLevel.uiNumRows = uiNumRows;
+		cLevel.uiNumCols = uiNumCols;
+		cLevel.sHeader.swap(sHeader);
+		cLevel.vTile.swap(vTile);
+		cLevel.vRowText.assign(uiNumRows, string());
+		cLevel.vDirtyRow.assign(uiNumRows, 1);
+	}
+	for (size_t i = 0; i < vChange.size(); i++)
+	{
+		if (vChange[i].uiIndex >= cLevel.vTile.size())
+			continue;
+		cLevel.vTile[vChange[i].uiIndex] = vChange[i].iValue;
+		cLevel.vDirtyRow[vChange[i].uiIndex / cLevel.uiNumCols] = 1;
+	}
+
+	// Format the rows which have changed, and join all the rows into the text of the file
+	size_t uiTextSize = cLevel.sHeader.size() + 1;
+	for (unsigned int uiRow = 0; uiRow < cLevel.uiNumRows; uiRow++)
+	{
+		if (cLevel.vDirtyRow[uiRow])
+		{
+			string& sRow = cLevel.vRowText[uiRow];
+			sRow.clear();
+			const int* pTile = &cLevel.vTile[(size_t)uiRow * cLevel.uiNumCols];
+			for (unsigned int uiCol = 0; uiCol < cLevel.uiNumCols; uiCol++)
+			{
+				if (uiCol > 0)
+					sRow += ',';
+				sRow += to_string(pTile[uiCol]);
+			}
+			cLevel.vDirtyRow[uiRow] = 0;
+		}
+		uiTextSize += cLevel.vRowText[uiRow].size() + 1;
+	}
+
+	string sText;
+	sText.reserve(uiTextSize);
+	sText += cLevel.sHeader;
+	sText += '\n';
+	for (unsigned int uiRow = 0; uiRow < cLevel.uiNumRows; uiRow++)
+	{
+		sText += cLevel.vRowText[uiRow];
+		sText += '\n';
+	}
+
+	if (WriteFileAtomic(sFilename, sText))
+	{
+		uiNumWrites++;
+		LOG_DEBUG(MAP, "Saved the map into %s", sFilename.c_str());
+	}
+	else
+	{
+		uiNumFailures++;
+		LOG_ERROR(MAP, "Unable to save the map into %s", sFilename.c_str());
+	}
+
+	cLock.lock();
+	bWriting = false;
+}
+
+/**
+ @brief Write text into a temporary file, and then replace a file with it, so that the file is never half-written
+ @param sFilename A const string& variable containing the name of the file
+ @param sText A const string& variable containing the text to write
+ @return true if the file is written, else false
+ */
+bool CMapSaveWriter::WriteFileAtomic(const string& sFilename, const string& sText)
+{
+	const string sTempFilename = sFilename + ".tmp";
+	{
+		ofstream cFile(sTempFilename.c_str(), ios::out | ios::binary | ios::trunc);
+		if (cFile.is_open() == false)
+			return false;
+		cFile.write(sText.data(), sText.size());
+		cFile.flush();
+		if (cFile.good() == false)
+		{
+			cFile.close();
+			remove(sTempFilename.c_str());
+			return false;
+		}
+	}
+
+	return ReplaceFile(sTempFilename, sFilename);
+}
+
+/**
+ @brief Replace a file with a temporary file in one step. The temporary file is deleted if this fails.
+ @param sTempFilename A const string& variable containing the name of the temporary file
+ @param sFilename A const string& variable containing the name of the file to replace
+ @return true if the file is replaced, else false
+ */
+bool CMapSaveWriter::ReplaceFile(const string& sTempFilename, const string& sFilename)
+{
+#ifdef _WIN32
+	// rename() fails on Windows if the file exists
+	if (MoveFileExA(sTempFilename.c_str(), sFilename.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) == 0)
+	{
+		remove(sTempFilename.c_str());
+		return false;
+	}
+#else
+	if (rename(sTempFilename.c_str(), sFilename.c_str()) != 0)
+	{
+		remove(sTempFilename.c_str());
+		return false;
+	}
+#endif
+	return true;
+}
@@ -0,0 +1,120 @@
+/**
+ CMapSaveWriter
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Writes the levels of a CMap2D into CSV files on a background thread, so that saving does not stall a frame.
+// The writer keeps its own copy of each level, so a save request only needs to carry the tiles which have
+// changed since the last request. The requests for a level which arrive within the coalescing time of the
+// first one are merged into one write. Each file is written into a temporary file first, which then replaces
+// the old file, so a crash during a save never leaves a half-written file behind.
+class CMapSaveWriter
+{
+public:
+	// A changed tile, as its index in the level (uiRow * uiNumCols + uiCol) and its new value
+	struct TileChange
+	{
+		unsigned int uiIndex;
+		int iValue;
+	};
+
+	// Constructor
+	CMapSaveWriter(void);
+	// Destructor
+	virtual ~CMapSaveWriter(void);
+
+	// Initialise this class instance and start the background thread
+	bool Init(const unsigned int uiNumLevels, const double dCoalesceTime = 0.5);
+	// Stop the background thread after writing out the requests which are waiting
+	void Stop(void);
+
+	// Check if the writer has a copy of a level, so that a request only needs the changed tiles
+	bool HasSnapshot(const unsigned int uiLevel) const;
+	// Request a save of a whole level. vTile holds uiNumRows * uiNumCols values, row by row, and is moved away.
+	bool RequestSave(	const string& sFilename,
+						const unsigned int uiLevel,
+						const unsigned int uiNumRows,
+						const unsigned int uiNumCols,
+						const string& sHeader,
+						vector<int>& vTile);
+	// Request a save of a level, of which only the tiles in vChange have changed. vChange is moved away.
+	bool RequestSave(	const string& sFilename,
+						const unsigned int uiLevel,
+						vector<TileChange>& vChange);
+	// Forget the copy of a level, such as when another map is loaded into it
+	void Invalidate(const unsigned int uiLevel);
+
+	// Check if any request is waiting or being written
+	bool IsBusy(void) const;
+	// Get the number of save requests
+	unsigned int GetNumRequests(void) const;
+	// Get the number of files which were written
+	unsigned int GetNumWrites(void) const;
+	// Get the number of files which could not be written
+	unsigned int GetNumFailures(void) const;
+
+	// Write text into a temporary file, and then replace a file with it. This can be used from any thread.
+	static bool WriteFileAtomic(const string& sFilename, const string& sText);
+	// Replace a file with a temporary file in one step. This can be used from any thread.
+	static bool ReplaceFile(const string& sTempFilename, const string& sFilename);
+
+protected:
+	// The copy of a level, and the requests which are waiting to be written
+	struct Level
+	{
+		// Set to true once the writer has a whole copy of this level
+		bool bHasSnapshot;
+		unsigned int uiNumRows;
+		unsigned int uiNumCols;
+		string sHeader;
+		vector<int> vTile;
+		// The CSV text of each row, which is only formatted again when a tile in its row changes
+		vector<string> vRowText;
+		vector<unsigned char> vDirtyRow;
+
+		// The requests which are waiting. These are guarded by the mutex.
+		bool bPending;
+		bool bPendingFull;
+		string sPendingFilename;
+		unsigned int uiPendingRows;
+		unsigned int uiPendingCols;
+		string sPendingHeader;
+		vector<int> vPendingTile;
+		vector<TileChange> vPendingChange;
+		// The time when the first waiting request arrived
+		chrono::steady_clock::time_point tFirstRequest;
+	};
+
+	vector<Level> vLevel;
+	chrono::steady_clock::duration dCoalesceDuration;
+
+	// Guards the waiting requests of the levels
+	mutable mutex cMutex;
+	condition_variable cCondition;
+
+	// The background thread
+	thread cThread;
+	bool bRunning;
+	atomic<bool> bWriting;
+
+	atomic<unsigned int> uiNumRequests;
+	atomic<unsigned int> uiNumWrites;
+	atomic<unsigned int> uiNumFailures;
+
+	// The loop run by the background thread
+	void Run(void);
+	// Apply the waiting requests of a level to its copy and write it into its file.
+	// The mutex is locked when this is called, and is unlocked while the file is written.
+	void WriteLevel(Level& cLevel, unique_lock<mutex>& cLock);
+};
@@ -0,0 +1,719 @@
+/**
+ CPathRequestService
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#include "PathRequestService.h"
+
+// Include CSettings
+#include "GameControl\Settings.h"
+
+#include <algorithm>
+#include <climits>
+
+// A search with more agents than this does not use the heuristic
+const unsigned int CPathRequestService::uiMaxHeuristicStarts = 8;
+// The background thread checks for new requests after each slice of this many nodes
+const unsigned int CPathRequestService::uiNodesPerSlice = 256;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CPathRequestService::CPathRequestService(void)
+	: iWeight(1)
+	, uiNodeBudget(4096)
+	, uiBlockedVersion(0)
+	, bNewGrid(false)
+	, uiNewNumRows(0)
+	, uiNewNumCols(0)
+	, uiNewNumDirections(4)
+	, uiFrameBudget(0)
+	, uiFrame(0)
+	, bRunning(false)
+	, uiNumRequests(0)
+	, uiNumSearches(0)
+	, uiNumExpandedNodes(0)
+	, uiLastNumExpandedNodes(0)
+	, uiNumRows(0)
+	, uiNumCols(0)
+	, uiNumDirections(4)
+	, iCurrentGroup(-1)
+{
+	cScratch.uiStamp = 0;
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CPathRequestService::~CPathRequestService(void)
+{
+	Stop();
+}
+
+/**
+ @brief Initialise this class instance, copy the blocked tiles of the CMap2D and start the background thread
+ @param heuristicFunc A HeuristicFunction variable containing the heuristic of the searches
+ @param iWeight A const int variable containing the weight of the heuristic
+ @param uiNodeBudget A const unsigned int variable containing the number of nodes which may be expanded in each frame
+ @return true if the background thread is started, else false
+ */
+bool CPathRequestService::Init(	HeuristicFunction heuristicFunc,
+								const int iWeight,
+								const unsigned int uiNodeBudget)
+{
+	// Stop the background thread if this was initialised before
+	Stop();
+
+	this->heuristicFunc = heuristicFunc;
+	this->iWeight = iWeight;
+	this->uiNodeBudget = uiNodeBudget;
+
+	vAgent.clear();
+	vFreeAgentID.clear();
+	vNewRequest.clear();
+	vNewResult.clear();
+	vGroup.clear();
+	iCurrentGroup = -1;
+	uiFrameBudget = 0;
+	uiNumRequests = 0;
+	uiNumSearches = 0;
+	uiNumExpandedNodes = 0;
+	uiLastNumExpandedNodes = 0;
+
+	// Copy the blocked tiles, which the background thread takes when it starts
+	CMap2D* cMap2D = CMap2D::GetInstance();
+	cMap2D->GetBlockedTiles(vNewBlocked);
+	uiNewNumRows = CSettings::GetInstance()->NUM_TILES_YAXIS;
+	uiNewNumCols = CSettings::GetInstance()->NUM_TILES_XAXIS;
+	uiNewNumDirections = cMap2D->GetDiagonalMovement() ? 8 : 4;
+	uiBlockedVersion = cMap2D->GetBlockedVersion();
+	bNewGrid = true;
+
+	bRunning = true;
+	cThread = thread(&CPathRequestService::Run, this);
+	return true;
+}
+
+/**
+ @brief Stop the background thread. The requests which are waiting are dropped.
+ */
+void CPathRequestService::Stop(void)
+{
+	{
+		lock_guard<mutex> cLock(cMutex);
+		if (bRunning == false)
+			return;
+		bRunning = false;
+	}
+	cCondition.notify_one();
+	if (cThread.joinable())
+		cThread.join();
+}
+
+/**
+ @brief Start a frame. Copy the blocked tiles of the CMap2D if they have changed, collect the paths which were
+		found since the last frame, and give the background thread the node budget of this frame.
+		Call this once per frame, before the agents update.
+ */
+void CPathRequestService::Update(void)
+{
+	if (bRunning == false)
+		return;
+
+	// Copy the blocked tiles outside of the lock, since a large map takes a while
+	CMap2D* cMap2D = CMap2D::GetInstance();
+	const bool bGridChanged = (cMap2D->GetBlockedVersion() != uiBlockedVersion);
+	vector<unsigned char> vBlockedCopy;
+	if (bGridChanged == true)
+	{
+		cMap2D->GetBlockedTiles(vBlockedCopy);
+		uiBlockedVersion = cMap2D->GetBlockedVersion();
+	}
+
+	vector<PathResult> vResult;
+	{
+		lock_guard<mutex> cLock(cMutex);
+		if (bGridChanged == true)
+		{
+			vNewBlocked.swap(vBlockedCopy);
+			uiNewNumRows = CSettings::GetInstance()->NUM_TILES_YAXIS;
+			uiNewNumCols = CSettings::GetInstance()->NUM_TILES_XAXIS;
+			uiNewNumDirections = cMap2D->GetDiagonalMovement() ? 8 : 4;
+			bNewGrid = true;
+		}
+		vResult.swap(vNewResult);
+		// The budget of the last frame is not carried over
+		uiFrameBudget = uiNodeBudget;
+		uiFrame++;
+	}
+	cCondition.notify_one();
+
+	// Keep the paths of the latest request of each agent
+	for (unsigned int i = 0; i < vResult.size(); i++)
+	{
+		PathResult& cResult = vResult[i];
+		if (cResult.uiAgentID >= vAgent.size())
+			continue;
+		Agent& cAgent = vAgent[cResult.uiAgentID];
+		if ((cAgent.bActive == false) || (cAgent.uiSerial != cResult.uiSerial))
+			continue;
+		cAgent.vPath.swap(cResult.vPath);
+		cAgent.bHasPath = true;
+		cAgent.bPending = false;
+	}
+
+	uiLastNumExpandedNodes = uiNumExpandedNodes.exchange(0);
+}
+
+/**
+ @brief Add an agent and get its ID
+ @return The ID of the agent
+ */
+unsigned int CPathRequestService::AddAgent(void)
+{
+	unsigned int uiAgentID;
+	if (vFreeAgentID.empty() == false)
+	{
+		uiAgentID = vFreeAgentID.back();
+		vFreeAgentID.pop_back();
+	}
+	else
+	{
+		uiAgentID = (unsigned int)vAgent.size();
+		vAgent.push_back(Agent());
+		vAgent[uiAgentID].uiSerial = 0;
+	}
+
+	// The serial is not reset, so that the late paths of an earlier agent with this ID are ignored
+	Agent& cAgent = vAgent[uiAgentID];
+	cAgent.bActive = true;
+	cAgent.bRequested = false;
+	cAgent.bPending = false;
+	cAgent.bHasPath = false;
+	cAgent.i32vec2Start = glm::i32vec2(0, 0);
+	cAgent.i32vec2Target = glm::i32vec2(0, 0);
+	cAgent.uiBlockedVersion = 0;
+	cAgent.vPath.clear();
+	return uiAgentID;
+}
+
+/**
+ @brief Remove an agent, and cancel its request
+ @param uiAgentID A const unsigned int variable containing the ID of the agent
+ */
+void CPathRequestService::RemoveAgent(const unsigned int uiAgentID)
+{
+	if ((uiAgentID >= vAgent.size()) || (vAgent[uiAgentID].bActive == false))
+		return;
+
+	Agent& cAgent = vAgent[uiAgentID];
+	cAgent.bActive = false;
+	cAgent.vPath.clear();
+	vFreeAgentID.push_back(uiAgentID);
+
+	if (cAgent.bPending == true)
+	{
+		PathRequest cRequest;
+		cRequest.uiAgentID = uiAgentID;
+		cRequest.uiSerial = cAgent.uiSerial;
+		cRequest.i32vec2Start = cAgent.i32vec2Start;
+		cRequest.i32vec2Target = cAgent.i32vec2Target;
+		cRequest.iPriority = 0;
+		cRequest.bCancel = true;
+		{
+			lock_guard<mutex> cLock(cMutex);
+			vNewRequest.push_back(cRequest);
+		}
+		cCondition.notify_one();
+	}
+	cAgent.bPending = false;
+}
+
+/**
+ @brief Request a path for an agent. The earlier request of the agent is replaced.
+		A request between the same tiles as the last one is ignored, unless the blocked tiles have changed.
+ @param uiAgentID A const unsigned int variable containing the ID of the agent
+ @param i32vec2Start A const glm::i32vec2& variable containing the start position, as in CMap2D::PathFind
+ @param i32vec2Target A const glm::i32vec2& variable containing the target position, as in CMap2D::PathFind
+ @param iPriority A const int variable containing the priority. A lower iPriority is searched first.
+ @return true if the request is sent to the background thread, else false
+ */
+bool CPathRequestService::RequestPath(	const unsigned int uiAgentID,
+										const glm::i32vec2& i32vec2Start,
+										const glm::i32vec2& i32vec2Target,
+										const int iPriority)
+{
+	if ((bRunning == false) || (uiAgentID >= vAgent.size()) || (vAgent[uiAgentID].bActive == false))
+		return false;
+
+	Agent& cAgent = vAgent[uiAgentID];
+	if ((cAgent.bRequested == true) &&
+		(cAgent.i32vec2Start == i32vec2Start) &&
+		(cAgent.i32vec2Target == i32vec2Target) &&
+		(cAgent.uiBlockedVersion == uiBlockedVersion))
+		return false;
+
+	cAgent.bRequested = true;
+	cAgent.bPending = true;
+	cAgent.uiSerial++;
+	cAgent.i32vec2Start = i32vec2Start;
+	cAgent.i32vec2Target = i32vec2Target;
+	cAgent.uiBlockedVersion = uiBlockedVersion;
+
+	PathRequest cRequest;
+	cRequest.uiAgentID = uiAgentID;
+	cRequest.uiSerial = cAgent.uiSerial;
+	cRequest.i32vec2Start = i32vec2Start;
+	cRequest.i32vec2Target = i32vec2Target;
+	cRequest.iPriority = iPriority;
+	cRequest.bCancel = false;
+	{
+		lock_guard<mutex> cLock(cMutex);
+		vNewRequest.push_back(cRequest);
+	}
+	uiNumRequests++;
+	cCondition.notify_one();
+	return true;
+}
+
+/**
+ @brief Get the path of an agent which was found since the last call
+ @param uiAgentID A const unsigned int variable containing the ID of the agent
+ @param vPath A vector<glm::i32vec2>& variable which the path is moved into. It is empty if there is no path.
+ @return true if a path was found since the last call, else false and vPath is not changed
+ */
+bool CPathRequestService::GetPath(const unsigned int uiAgentID, vector<glm::i32vec2>& vPath)
+{
+	if ((uiAgentID >= vAgent.size()) || (vAgent[uiAgentID].bHasPath == false))
+		return false;
+
+	vPath.swap(vAgent[uiAgentID].vPath);
+	vAgent[uiAgentID].vPath.clear();
+	vAgent[uiAgentID].bHasPath = false;
+	return true;
+}
+
+/**
+ @brief Check if an agent is waiting for a path
+ @param uiAgentID A const unsigned int variable containing the ID of the agent
+ @return true if the agent is waiting for a path, else false
+ */
+bool CPathRequestService::IsPending(const unsigned int uiAgentID) const
+{
+	if (uiAgentID >= vAgent.size())
+		return false;
+	return vAgent[uiAgentID].bPending;
+}
+
+/**
+ @brief Set the number of nodes which the searches may expand in each frame
+ @param uiNodeBudget A const unsigned int variable containing the number of nodes
+ */
+void CPathRequestService::SetNodeBudget(const unsigned int uiNodeBudget)
+{
+	this->uiNodeBudget = uiNodeBudget;
+}
+
+/**
+ @brief Get the number of nodes which the searches may expand in each frame
+ @return The number of nodes
+ */
+unsigned int CPathRequestService::GetNodeBudget(void) const
+{
+	return uiNodeBudget;
+}
+
+/**
+ @brief Get the number of requests which were posted
+ @return The number of requests
+ */
+unsigned int CPathRequestService::GetNumRequests(void) const
+{
+	return uiNumRequests;
+}
+
+/**
+ @brief Get the number of searches which were run for the requests. This is less than the number of
+		requests when requests were coalesced.
+ @return The number of searches
+ */
+unsigned int CPathRequestService::GetNumSearches(void) const
+{
+	return uiNumSearches;
+}
+
+/**
+ @brief Get the number of nodes which were expanded in the last frame
+ @return The number of nodes
+ */
+unsigned int CPathRequestService::GetNumExpandedNodes(void) const
+{
+	return uiLastNumExpandedNodes;
+}
+
+/**
+ @brief The loop run by the background thread. It takes the new requests, and expands the searches in slices
+		of nodes from the budget of the frame, sending back the paths after each slice.
+ */
+void CPathRequestService::Run(void)
+{
+	vector<PathRequest> vRequest;
+	vector<PathResult> vResult;
+
+	unique_lock<mutex> cLock(cMutex);
+	while (true)
+	{
+		// Wait for new requests or tiles, or for a budget if there is a search to run
+		cCondition.wait(cLock, [this] { return (bRunning == false) ||
+												(vNewRequest.empty() == false) ||
+												(bNewGrid == true) ||
+												((uiFrameBudget > 0) && (vGroup.empty() == false)); });
+		if (bRunning == false)
+			break;
+
+		vRequest.swap(vNewRequest);
+		const bool bGridChanged = bNewGrid;
+		if (bGridChanged == true)
+		{
+			vBlocked.swap(vNewBlocked);
+			uiNumRows = uiNewNumRows;
+			uiNumCols = uiNewNumCols;
+			uiNumDirections = uiNewNumDirections;
+			bNewGrid = false;
+		}
+		const unsigned int uiSlice = min(uiFrameBudget, uiNodesPerSlice);
+		uiFrameBudget -= uiSlice;
+		const unsigned int uiSliceFrame = uiFrame;
+		cLock.unlock();
+
+		if (bGridChanged == true)
+		{
+			// Resize the search lists, and start the searches again on the new tiles
+			const size_t uiNumTiles = (size_t)uiNumRows * uiNumCols;
+			cScratch.vStamp.assign(uiNumTiles, 0);
+			cScratch.vClosedStamp.assign(uiNumTiles, 0);
+			cScratch.vStartStamp.assign(uiNumTiles, 0);
+			cScratch.vG.assign(uiNumTiles, 0);
+			cScratch.vNext.assign(uiNumTiles, -1);
+			cScratch.uiStamp = 0;
+			vDirections = { { -1, 0 }, { 1, 0 }, { 0, 1 }, { 0, -1 },
+							{ -1, -1 }, { 1, 1 }, { -1, 1 }, { 1, -1 } };
+			for (unsigned int i = 0; i < vGroup.size(); i++)
+				vGroup[i].bStarted = false;
+			iCurrentGroup = -1;
+		}
+
+		AddRequests(vRequest);
+		vRequest.clear();
+
+		unsigned int uiNumNodes = 0;
+		while ((uiNumNodes < uiSlice) && (vGroup.empty() == false))
+		{
+			// Start the search of the group with the lowest priority value
+			if (iCurrentGroup < 0)
+			{
+				iCurrentGroup = 0;
+				for (unsigned int i = 1; i < vGroup.size(); i++)
+				{
+					if (vGroup[i].iPriority < vGroup[iCurrentGroup].iPriority)
+						iCurrentGroup = i;
+				}
+				StartSearch(vGroup[iCurrentGroup], vResult);
+				uiNumSearches++;
+			}
+
+			uiNumNodes += ContinueSearch(vGroup[iCurrentGroup], uiSlice - uiNumNodes, vResult);
+			if (vGroup[iCurrentGroup].vRequest.empty() == true)
+			{
+				vGroup.erase(vGroup.begin() + iCurrentGroup);
+				iCurrentGroup = -1;
+			}
+		}
+		uiNumExpandedNodes += uiNumNodes;
+
+		cLock.lock();
+		// Give back the unused nodes of the slice, unless a new frame has started
+		if (uiSliceFrame == uiFrame)
+			uiFrameBudget += uiSlice - uiNumNodes;
+		if (vResult.empty() == false)
+		{
+			for (unsigned int i = 0; i < vResult.size(); i++)
+				vNewResult.push_back(std::move(vResult[i]));
+			vResult.clear();
+		}
+	}
+}
+
+/**
+ @brief Add the new requests into the groups. An older request of the same agent is removed, and a request
+		joins the group of its target tile if the search of that group has not started yet.
+ @param vRequest A const vector<PathRequest>& variable containing the new requests
+ */
+void CPathRequestService::AddRequests(const vector<PathRequest>& vRequest)
+{
+	for (unsigned int i = 0; i < vRequest.size(); i++)
+	{
+		const PathRequest& cRequest = vRequest[i];
+
+		// Remove the older request of this agent
+		for (unsigned int j = 0; j < vGroup.size(); j++)
+		{
+			vector<PathRequest>& vGroupRequest = vGroup[j].vRequest;
+			for (unsigned int k = 0; k < vGroupRequest.size(); k++)
+			{
+				if (vGroupRequest[k].uiAgentID == cRequest.uiAgentID)
+				{
+					vGroupRequest[k] = vGroupRequest.back();
+					vGroupRequest.pop_back();
+					break;
+				}
+			}
+		}
+		if (cRequest.bCancel == true)
+			continue;
+
+		// Join the group of the target tile, or start a new group
+		bool bJoined = false;
+		for (unsigned int j = 0; j < vGroup.size(); j++)
+		{
+			PathGroup& cGroup = vGroup[j];
+			if ((cGroup.bStarted == false) && (cGroup.i32vec2Target == cRequest.i32vec2Target))
+			{
+				cGroup.vRequest.push_back(cRequest);
+				cGroup.iPriority = min(cGroup.iPriority, cRequest.iPriority);
+				bJoined = true;
+				break;
+			}
+		}
+		if (bJoined == false)
+		{
+			PathGroup cGroup;
+			cGroup.i32vec2Target = cRequest.i32vec2Target;
+			cGroup.iPriority = cRequest.iPriority;
+			cGroup.vRequest.push_back(cRequest);
+			cGroup.bStarted = false;
+			vGroup.push_back(cGroup);
+		}
+	}
+
+	// Remove the groups whose requests were all replaced
+	for (int j = (int)vGroup.size() - 1; j >= 0; j--)
+	{
+		if (vGroup[j].vRequest.empty() == false)
+			continue;
+		vGroup.erase(vGroup.begin() + j);
+		if (iCurrentGroup == j)
+			iCurrentGroup = -1;
+		else if (iCurrentGroup > j)
+			iCurrentGroup--;
+	}
+}
+
+/**
+ @brief Start the search of a group from its target tile. The requests whose start or target is blocked
+		are sent back with an empty path, as CMap2D::PathFind does.
+ @param cGroup A PathGroup& variable containing the group
+ @param vResult A vector<PathResult>& variable which the paths are added into
+ */
+void CPathRequestService::StartSearch(PathGroup& cGroup, vector<PathResult>& vResult)
+{
+	cGroup.bStarted = true;
+
+	// Use a new stamp instead of clearing the lists, and clear them only when the stamp wraps around
+	cScratch.uiStamp++;
+	if (cScratch.uiStamp == 0)
+	{
+		std::fill(cScratch.vStamp.begin(), cScratch.vStamp.end(), 0);
+		std::fill(cScratch.vClosedStamp.begin(), cScratch.vClosedStamp.end(), 0);
+		std::fill(cScratch.vStartStamp.begin(), cScratch.vStartStamp.end(), 0);
+		cScratch.uiStamp = 1;
+	}
+	cScratch.vOpen.clear();
+
+	if (IsOpen(cGroup.i32vec2Target) == false)
+	{
+		for (unsigned int i = 0; i < cGroup.vRequest.size(); i++)
+			FinishRequest(cGroup.vRequest[i], false, vResult);
+		cGroup.vRequest.clear();
+		return;
+	}
+
+	// Mark the start tiles, so that the search knows when it has reached one
+	for (int i = (int)cGroup.vRequest.size() - 1; i >= 0; i--)
+	{
+		const glm::i32vec2& i32vec2Start = cGroup.vRequest[i].i32vec2Start;
+		if (IsOpen(i32vec2Start) == false)
+		{
+			FinishRequest(cGroup.vRequest[i], false, vResult);
+			cGroup.vRequest[i] = cGroup.vRequest.back();
+			cGroup.vRequest.pop_back();
+			continue;
+		}
+		cScratch.vStartStamp[i32vec2Start.y * uiNumCols + i32vec2Start.x] = cScratch.uiStamp;
+	}
+	if (cGroup.vRequest.empty() == true)
+		return;
+
+	const int iTarget = cGroup.i32vec2Target.y * uiNumCols + cGroup.i32vec2Target.x;
+	cScratch.vStamp[iTarget] = cScratch.uiStamp;
+	cScratch.vG[iTarget] = 0;
+	cScratch.vNext[iTarget] = iTarget;
+
+	OpenNode cNode;
+	cNode.f = GetHeuristic(cGroup, cGroup.i32vec2Target);
+	cNode.g = 0;
+	cNode.iIndex = iTarget;
+	cScratch.vOpen.push_back(cNode);
+}
+
+/**
+ @brief Continue the search of a group. When a start tile is closed, the path of its request is sent back.
+ @param cGroup A PathGroup& variable containing the group
+ @param uiMaxNodes A const unsigned int variable containing the most nodes to expand
+ @param vResult A vector<PathResult>& variable which the paths are added into
+ @return The number of nodes which were expanded
+ */
+unsigned int CPathRequestService::ContinueSearch(PathGroup& cGroup, const unsigned int uiMaxNodes, vector<PathResult>& vResult)
+{
+	vector<OpenNode>& vOpen = cScratch.vOpen;
+	const unsigned int uiStamp = cScratch.uiStamp;
+
+	unsigned int uiNumNodes = 0;
+	while ((vOpen.empty() == false) && (uiNumNodes < uiMaxNodes) && (cGroup.vRequest.empty() == false))
+	{
+		// Get the node with the least f value
+		std::pop_heap(vOpen.begin(), vOpen.end(), CompareOpenNodes);
+		const OpenNode cNode = vOpen.back();
+		vOpen.pop_back();
+
+		// A node can be in the open list more than once, if a shorter route to it was found later
+		if (cScratch.vClosedStamp[cNode.iIndex] == uiStamp)
+			continue;
+		cScratch.vClosedStamp[cNode.iIndex] = uiStamp;
+		uiNumNodes++;
+
+		// Send back the paths of the requests which start at this node
+		if (cScratch.vStartStamp[cNode.iIndex] == uiStamp)
+		{
+			for (int i = (int)cGroup.vRequest.size() - 1; i >= 0; i--)
+			{
+				const glm::i32vec2& i32vec2Start = cGroup.vRequest[i].i32vec2Start;
+				if (i32vec2Start.y * (int)uiNumCols + i32vec2Start.x == cNode.iIndex)
+				{
+					FinishRequest(cGroup.vRequest[i], true, vResult);
+					cGroup.vRequest[i] = cGroup.vRequest.back();
+					cGroup.vRequest.pop_back();
+				}
+			}
+			if (cGroup.vRequest.empty() == true)
+				break;
+		}
+
+		// Check the neighbours of the current node
+		const glm::i32vec2 i32vec2Pos(cNode.iIndex % uiNumCols, cNode.iIndex / uiNumCols);
+		for (unsigned int i = 0; i < uiNumDirections; i++)
+		{
+			const glm::i32vec2 i32vec2Neighbour = i32vec2Pos + vDirections[i];
+			if (IsOpen(i32vec2Neighbour) == false)
+				continue;
+			const int iNeighbour = i32vec2Neighbour.y * uiNumCols + i32vec2Neighbour.x;
+			if (cScratch.vClosedStamp[iNeighbour] == uiStamp)
+				continue;
+
+			const unsigned int gNew = cNode.g + 1;
+			if ((cScratch.vStamp[iNeighbour] != uiStamp) || (gNew < cScratch.vG[iNeighbour]))
+			{
+				cScratch.vStamp[iNeighbour] = uiStamp;
+				cScratch.vG[iNeighbour] = gNew;
+				cScratch.vNext[iNeighbour] = cNode.iIndex;
+
+				OpenNode cNeighbour;
+				cNeighbour.f = gNew + GetHeuristic(cGroup, i32vec2Neighbour);
+				cNeighbour.g = gNew;
+				cNeighbour.iIndex = iNeighbour;
+				vOpen.push_back(cNeighbour);
+				std::push_heap(vOpen.begin(), vOpen.end(), CompareOpenNodes);
+			}
+		}
+	}
+
+	// The starts which were not reached cannot reach the target
+	if (vOpen.empty() == true)
+	{
+		for (unsigned int i = 0; i < cGroup.vRequest.size(); i++)
+			FinishRequest(cGroup.vRequest[i], false, vResult);
+		cGroup.vRequest.clear();
+	}
+
+	return uiNumNodes;
+}
+
+/**
+ @brief Send back the path of a request, by following the nodes from its start towards the target
+ @param cRequest A const PathRequest& variable containing the request
+ @param bFound A const bool variable which is true if the start was reached by the search, else the path is empty
+ @param vResult A vector<PathResult>& variable which the path is added into
+ */
+void CPathRequestService::FinishRequest(const PathRequest& cRequest, const bool bFound, vector<PathResult>& vResult) const
+{
+	vResult.push_back(PathResult());
+	PathResult& cResult = vResult.back();
+	cResult.uiAgentID = cRequest.uiAgentID;
+	cResult.uiSerial = cRequest.uiSerial;
+	if (bFound == false)
+		return;
+
+	const int iTarget = cRequest.i32vec2Target.y * uiNumCols + cRequest.i32vec2Target.x;
+	int iIndex = cRequest.i32vec2Start.y * uiNumCols + cRequest.i32vec2Start.x;
+	const size_t uiMaxLength = (size_t)uiNumRows * uiNumCols;
+	while ((iIndex != iTarget) && (cResult.vPath.size() < uiMaxLength))
+	{
+		iIndex = cScratch.vNext[iIndex];
+		cResult.vPath.push_back(glm::i32vec2(iIndex % uiNumCols, iIndex / uiNumCols));
+	}
+}
+
+/**
+ @brief Get the heuristic of a position towards the nearest start of a group. A group with many requests
+		uses no heuristic, since its search has to cover the area around the target anyway.
+ @param cGroup A const PathGroup& variable containing the group
+ @param i32vec2Pos A const glm::i32vec2& variable containing the position
+ @return The heuristic
+ */
+unsigned int CPathRequestService::GetHeuristic(const PathGroup& cGroup, const glm::i32vec2& i32vec2Pos) const
+{
+	if ((!heuristicFunc) || (cGroup.vRequest.size() > uiMaxHeuristicStarts))
+		return 0;
+
+	unsigned int uiHeuristic = UINT_MAX;
+	for (unsigned int i = 0; i < cGroup.vRequest.size(); i++)
+		uiHeuristic = min(uiHeuristic, heuristicFunc(i32vec2Pos, cGroup.vRequest[i].i32vec2Start, iWeight));
+	return uiHeuristic;
+}
+
+/**
+ @brief Check if a position is within the copied tiles and not blocked
+ @param i32vec2Pos A const glm::i32vec2& variable containing the position
+ @return true if the position can be moved into, else false
+ */
+bool CPathRequestService::IsOpen(const glm::i32vec2& i32vec2Pos) const
+{
+	if ((i32vec2Pos.x < 0) || (i32vec2Pos.x >= (int)uiNumCols) ||
+		(i32vec2Pos.y < 0) || (i32vec2Pos.y >= (int)uiNumRows))
+		return false;
+	return (vBlocked[i32vec2Pos.y * uiNumCols + i32vec2Pos.x] == 0);
+}
+
+/**
+ @brief Order the open list so that the node with the least f is on top. Of two nodes with the same f,
+		the one further from the target is on top, since it is nearer to a start.
+ @param a A const OpenNode& variable containing a node
+ @param b A const OpenNode& variable containing a node
+ @return true if a is below b in the open list, else false
+ */
+bool CPathRequestService::CompareOpenNodes(const OpenNode& a, const OpenNode& b)
+{
+	if (a.f != b.f)
+		return a.f > b.f;
+	return a.g < b.g;
+}
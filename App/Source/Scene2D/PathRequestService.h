@@ -0,0 +1,219 @@
+/**
+ CPathRequestService
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include CMap2D for the HeuristicFunction
+#include "Map2D.h"
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+using namespace std;
+
+// Finds the A* paths of the 2D agents on a background thread, so that many agents can chase a target without
+// a frame spending its time in CMap2D::PathFind. An agent posts a request with a priority, and its path is
+// returned by GetPath() from the next frame on. The requests towards the same target tile are coalesced into
+// one search, which starts from the target and ends when the start tiles of all its agents are reached.
+// The searches expand at most a budget of nodes in each frame; a search which is over the budget continues in
+// the next frame. The background thread keeps its own copy of the blocked tiles and its own search lists,
+// which are separate from the lists used by CMap2D::PathFind.
+class CPathRequestService : public CSingletonTemplate<CPathRequestService>
+{
+	friend CSingletonTemplate<CPathRequestService>;
+
+public:
+	// The most agents in a search whose starts are used for the heuristic. A search with more agents
+	// expands the nodes in the order of their distance from the target instead.
+	static const unsigned int uiMaxHeuristicStarts;
+	// The number of nodes which the background thread expands before it checks for new requests
+	static const unsigned int uiNodesPerSlice;
+
+	// Initialise this class instance and start the background thread
+	bool Init(	HeuristicFunction heuristicFunc,
+				const int iWeight = 1,
+				const unsigned int uiNodeBudget = 4096);
+	// Stop the background thread
+	void Stop(void);
+
+	// Start a frame: copy the blocked tiles of the CMap2D if they have changed, collect the paths
+	// which were found, and give the background thread the node budget of this frame
+	void Update(void);
+
+	// Add an agent and get its ID
+	unsigned int AddAgent(void);
+	// Remove an agent, and cancel its request
+	void RemoveAgent(const unsigned int uiAgentID);
+
+	// Request a path for an agent. A lower iPriority is searched first.
+	// Returns false if the agent already has a request or a path between the same tiles.
+	bool RequestPath(	const unsigned int uiAgentID,
+						const glm::i32vec2& i32vec2Start,
+						const glm::i32vec2& i32vec2Target,
+						const int iPriority = 0);
+	// Get the path of an agent which was found since the last call. The path does not include the start tile.
+	bool GetPath(const unsigned int uiAgentID, vector<glm::i32vec2>& vPath);
+	// Check if an agent is waiting for a path
+	bool IsPending(const unsigned int uiAgentID) const;
+
+	// Set the number of nodes which the searches may expand in each frame
+	void SetNodeBudget(const unsigned int uiNodeBudget);
+	// Get the number of nodes which the searches may expand in each frame
+	unsigned int GetNodeBudget(void) const;
+
+	// Get the number of requests which were posted
+	unsigned int GetNumRequests(void) const;
+	// Get the number of searches which were run for the requests
+	unsigned int GetNumSearches(void) const;
+	// Get the number of nodes which were expanded in the last frame
+	unsigned int GetNumExpandedNodes(void) const;
+
+protected:
+	// A request which is sent to the background thread
+	struct PathRequest
+	{
+		unsigned int uiAgentID;
+		unsigned int uiSerial;
+		glm::i32vec2 i32vec2Start;
+		glm::i32vec2 i32vec2Target;
+		int iPriority;
+		// Set to true to only cancel the earlier request of the agent
+		bool bCancel;
+	};
+
+	// A path which is sent back from the background thread
+	struct PathResult
+	{
+		unsigned int uiAgentID;
+		unsigned int uiSerial;
+		vector<glm::i32vec2> vPath;
+	};
+
+	// The requests towards one target tile, which are served by one search
+	struct PathGroup
+	{
+		glm::i32vec2 i32vec2Target;
+		int iPriority;
+		vector<PathRequest> vRequest;
+		// Set to true once the search has started, after which no more requests join this group
+		bool bStarted;
+	};
+
+	// A node in the open list of a search
+	struct OpenNode
+	{
+		unsigned int f;
+		unsigned int g;
+		int iIndex;
+	};
+
+	// The lists of a search, which belong to the background thread.
+	// A node has been reached in the current search if its vStamp is uiStamp, so the lists are not cleared.
+	struct SearchScratch
+	{
+		vector<unsigned int> vStamp;
+		vector<unsigned int> vClosedStamp;
+		vector<unsigned int> vStartStamp;
+		vector<unsigned int> vG;
+		// The index of the next node towards the target
+		vector<int> vNext;
+		// A binary heap, with the least f on top
+		vector<OpenNode> vOpen;
+		unsigned int uiStamp;
+	};
+
+	// The state of an agent, which is only used on the main thread
+	struct Agent
+	{
+		bool bActive;
+		bool bRequested;
+		bool bPending;
+		bool bHasPath;
+		unsigned int uiSerial;
+		// The tiles of the last request, and the version of the blocked tiles when it was posted
+		glm::i32vec2 i32vec2Start;
+		glm::i32vec2 i32vec2Target;
+		unsigned int uiBlockedVersion;
+		vector<glm::i32vec2> vPath;
+	};
+
+	vector<Agent> vAgent;
+	vector<unsigned int> vFreeAgentID;
+
+	// The search settings
+	HeuristicFunction heuristicFunc;
+	int iWeight;
+	unsigned int uiNodeBudget;
+
+	// The version of the blocked tiles which were last copied from the CMap2D
+	unsigned int uiBlockedVersion;
+
+	// Guards the data which is shared with the background thread
+	mutable mutex cMutex;
+	condition_variable cCondition;
+	// The requests which have not been taken by the background thread
+	vector<PathRequest> vNewRequest;
+	// The paths which have not been collected by Update()
+	vector<PathResult> vNewResult;
+	// The blocked tiles which have not been taken by the background thread
+	bool bNewGrid;
+	unsigned int uiNewNumRows;
+	unsigned int uiNewNumCols;
+	vector<unsigned char> vNewBlocked;
+	unsigned int uiNewNumDirections;
+	// The nodes which may still be expanded in this frame, and the number of frames started by Update()
+	unsigned int uiFrameBudget;
+	unsigned int uiFrame;
+
+	// The background thread
+	thread cThread;
+	bool bRunning;
+
+	atomic<unsigned int> uiNumRequests;
+	atomic<unsigned int> uiNumSearches;
+	atomic<unsigned int> uiNumExpandedNodes;
+	unsigned int uiLastNumExpandedNodes;
+
+	// The data of the background thread
+	unsigned int uiNumRows;
+	unsigned int uiNumCols;
+	vector<unsigned char> vBlocked;
+	vector<glm::i32vec2> vDirections;
+	unsigned int uiNumDirections;
+	vector<PathGroup> vGroup;
+	// The group whose search is in cScratch, or -1
+	int iCurrentGroup;
+	SearchScratch cScratch;
+
+	// Constructor
+	CPathRequestService(void);
+	// Destructor
+	virtual ~CPathRequestService(void);
+
+	// The loop run by the background thread
+	void Run(void);
+	// Add the new requests into the groups, replacing the older requests of their agents
+	void AddRequests(const vector<PathRequest>& vRequest);
+	// Start the search of a group
+	void StartSearch(PathGroup& cGroup, vector<PathResult>& vResult);
+	// Continue the search of a group for up to uiMaxNodes nodes. Returns the number of nodes expanded.
+	unsigned int ContinueSearch(PathGroup& cGroup, const unsigned int uiMaxNodes, vector<PathResult>& vResult);
+	// Send back the path of a request whose start has been reached, or an empty path
+	void FinishRequest(const PathRequest& cRequest, const bool bFound, vector<PathResult>& vResult) const;
+	// Get the heuristic of a node towards the nearest start of a group
+	unsigned int GetHeuristic(const PathGroup& cGroup, const glm::i32vec2& i32vec2Pos) const;
+	// Check if a position is within the copied tiles and not blocked
+	bool IsOpen(const glm::i32vec2& i32vec2Pos) const;
+	// Order the open list so that the node with the least f is on top
+	static bool CompareOpenNodes(const OpenNode& a, const OpenNode& b);
+};
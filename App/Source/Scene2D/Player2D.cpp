@@ -21,12 +21,22 @@ using namespace std;
 // Include Game Manager
 #include "GameManager.h"
 
+// Include CSpriteBatcher
+#include "RenderControl\SpriteBatcher.h"
+// Include CStopWatch
+#include "TimeControl\StopWatch.h"
+// Include CRandom
+#include "System\Random.h"
+
 /**
  @brief Constructor This constructor has protected access modifier as this class will be a Singleton
  */
 CPlayer2D::CPlayer2D(void)
 	: cMap2D(NULL)
 	, cKeyboardController(NULL)
+	, iIdleAnimation(-1)
+	, iLeftAnimation(-1)
+	, iRightAnimation(-1)
 	, cInventoryManager(NULL)
 	, cInventoryItem(NULL)
 	, cSoundController(NULL)
@@ -108,8 +118,11 @@ bool CPlayer2D::Init(void)
 	animatedSprites->AddAnimation("idle", 0, 2);
 	animatedSprites->AddAnimation("right", 3, 5);
 	animatedSprites->AddAnimation("left", 6, 8);
+	iIdleAnimation = animatedSprites->GetAnimationID("idle");
+	iLeftAnimation = animatedSprites->GetAnimationID("left");
+	iRightAnimation = animatedSprites->GetAnimationID("right");
 	//CS: Play the "idle" animation as default
-	animatedSprites->PlayAnimation("idle", -1, 1.0f);
+	animatedSprites->PlayAnimation(iIdleAnimation, -1, 1.0f);
 
 	//CS: Init the color to white
 	currentColor = glm::vec4(1.0, 1.0, 1.0, 1.0);
@@ -161,7 +174,7 @@ bool CPlayer2D::Reset()
 	jumpCount = 0;
 
 	//CS: Play the "idle" animation as default
-	animatedSprites->PlayAnimation("idle", -1, 1.0f);
+	animatedSprites->PlayAnimation(iIdleAnimation, -1, 1.0f);
 
 	//CS: Init the color to white
 	currentColor = glm::vec4(1.0, 1.0, 1.0, 1.0);
@@ -209,7 +222,7 @@ void CPlayer2D::Update(const double dElapsedTime)
 		}
 
 		//CS: Play the "left" animation
-		animatedSprites->PlayAnimation("left", -1, 1.0f);
+		animatedSprites->PlayAnimation(iLeftAnimation, -1, 1.0f);
 
 		//CS: Change Color
 		currentColor = glm::vec4(1.0, 0.0, 0.0, 1.0);
@@ -245,7 +258,7 @@ void CPlayer2D::Update(const double dElapsedTime)
 		}
 
 		//CS: Play the "right" animation
-		animatedSprites->PlayAnimation("right", -1, 1.0f);
+		animatedSprites->PlayAnimation(iRightAnimation, -1, 1.0f);
 
 		//CS: Change Color
 		currentColor = glm::vec4(1.0, 1.0, 0.0, 1.0);
@@ -273,7 +286,7 @@ void CPlayer2D::Update(const double dElapsedTime)
 		}
 
 		//CS: Play the "idle" animation
-		animatedSprites->PlayAnimation("idle", -1, 1.0f);
+		animatedSprites->PlayAnimation(iIdleAnimation, -1, 1.0f);
 
 		//CS: Change Color
 		currentColor = glm::vec4(0.0, 1.0, 1.0, 0.5);
@@ -302,7 +315,7 @@ void CPlayer2D::Update(const double dElapsedTime)
 		}
 
 		//CS: Play the "idle" animation
-		animatedSprites->PlayAnimation("idle", -1, 1.0f);
+		animatedSprites->PlayAnimation(iIdleAnimation, -1, 1.0f);
 
 		//CS: Change Color
 		currentColor = glm::vec4(1.0, 0.0, 1.0, 0.5);
@@ -340,8 +353,9 @@ void CPlayer2D::Update(const double dElapsedTime)
 	// Update the Health and Lives
 	UpdateHealthLives();
 
-	//CS: Update the animated sprite
-	animatedSprites->Update(dElapsedTime);
+	//CS: Update the animated sprite, unless CScene2D updates all of them together through the CAnimationSystem
+	if (cSettings->bUseAnimationSystem == false)
+		animatedSprites->Update(dElapsedTime);
 
 	// Update the UV Coordinates
 	vec2UVCoordinate.x = cSettings->ConvertIndexToUVSpace(cSettings->x, i32vec2Index.x, false, i32vec2NumMicroSteps.x*cSettings->MICRO_STEP_XAXIS);
@@ -369,6 +383,18 @@ void CPlayer2D::PreRender(void)
  */
 void CPlayer2D::Render(void)
 {
+	if (cSettings->bUseSpriteBatching == true)
+	{
+		// Add the current frame of the sprite sheet to the CSpriteBatcher, above the enemies
+		CSpriteBatcher::GetInstance()->Submit(	iTextureID,
+												animatedSprites->GetCurrentFrameUV(),
+												vec2UVCoordinate,
+												glm::vec2(cSettings->TILE_WIDTH, cSettings->TILE_HEIGHT),
+												currentColor,
+												1);
+		return;
+	}
+
 	glBindVertexArray(VAO);
 	// get matrix's uniform location and set matrix
 	unsigned int transformLoc = glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "transform");
@@ -402,6 +428,79 @@ void CPlayer2D::PostRender(void)
 	glDisable(GL_BLEND);
 }
 
+/**
+ @brief Compare the time to draw many copies of this player's animated sprite, at random positions and frames,
+		with one draw call each and through the CSpriteBatcher.
+ @param uiNumSprites A const unsigned int variable containing the number of sprites to draw in each frame
+ @param uiNumFrames A const unsigned int variable containing the number of frames to draw
+ */
+void CPlayer2D::BenchmarkSprites(const unsigned int uiNumSprites, const unsigned int uiNumFrames)
+{
+	CSpriteBatcher* cSpriteBatcher = CSpriteBatcher::GetInstance();
+	if ((uiNumFrames == 0) || (cSpriteBatcher->IsInitialised() == false))
+		return;
+
+	// Generate the positions and animation frames of the sprites
+	CRandom cRandom(1);
+	vector<glm::vec2> vPosition(uiNumSprites);
+	vector<int> vFrame(uiNumSprites);
+	for (unsigned int i = 0; i < uiNumSprites; i++)
+	{
+		vPosition[i] = glm::vec2(cRandom.RangeFloat(-1.0f, 1.0f), cRandom.RangeFloat(-1.0f, 1.0f));
+		vFrame[i] = cRandom.RangeInt(0, 8);
+	}
+	const glm::vec2 vec2Size(cSettings->TILE_WIDTH, cSettings->TILE_HEIGHT);
+
+	CStopWatch cStopWatch;
+
+	// 1. One draw call, texture bind and uniform upload per sprite
+	PreRender();
+	unsigned int transformLoc = glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "transform");
+	unsigned int colorLoc = glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "runtime_color");
+	glFinish();
+	cStopWatch.StartTimer();
+	for (unsigned int uiFrame = 0; uiFrame < uiNumFrames; uiFrame++)
+	{
+		for (unsigned int i = 0; i < uiNumSprites; i++)
+		{
+			glm::mat4 spriteTransform = glm::translate(glm::mat4(1.0f), glm::vec3(vPosition[i], 0.0f));
+			glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(spriteTransform));
+			glUniform4fv(colorLoc, 1, glm::value_ptr(currentColor));
+			glBindTexture(GL_TEXTURE_2D, iTextureID);
+			glBindVertexArray(VAO);
+			animatedSprites->Render();
+			glBindVertexArray(0);
+		}
+		glFinish();
+	}
+	const double dPerSpriteTime = cStopWatch.GetElapsedTime();
+	PostRender();
+
+	// 2. Through the CSpriteBatcher
+	unsigned int uiNumDrawCalls = 0;
+	cSpriteBatcher->PreRender();
+	glFinish();
+	cStopWatch.GetElapsedTime();
+	for (unsigned int uiFrame = 0; uiFrame < uiNumFrames; uiFrame++)
+	{
+		cSpriteBatcher->Begin();
+		for (unsigned int i = 0; i < uiNumSprites; i++)
+		{
+			cSpriteBatcher->Submit(iTextureID, animatedSprites->GetFrameUV(vFrame[i]), vPosition[i], vec2Size, currentColor, 1);
+		}
+		uiNumDrawCalls = cSpriteBatcher->Flush();
+		glFinish();
+	}
+	const double dBatchedTime = cStopWatch.GetElapsedTime();
+	cSpriteBatcher->PostRender();
+
+	cout << "CPlayer2D::BenchmarkSprites() with " << uiNumSprites << " sprites, " << uiNumFrames << " frames" << endl;
+	cout << "One draw call per sprite    : " << dPerSpriteTime * 1000.0 / uiNumFrames << " ms per frame, "
+		<< uiNumSprites << " draw calls" << endl;
+	cout << "CSpriteBatcher              : " << dBatchedTime * 1000.0 / uiNumFrames << " ms per frame, "
+		<< uiNumDrawCalls << " draw calls" << endl;
+}
+
 /**
 @brief Load a texture, assign it a code and store it in MapOfTextureIDs.
 @param filename A const char* variable which contains the file name of the texture
@@ -500,7 +599,7 @@ bool CPlayer2D::CheckPosition(DIRECTION eDirection)
 		if (i32vec2NumMicroSteps.y == 0)
 		{
 			// If the grid is not accessible, then return false
-			if (cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x) >= 100)
+			if (cMap2D->IsSolid(i32vec2Index.y, i32vec2Index.x))
 			{
 				return false;
 			}
@@ -509,8 +608,8 @@ bool CPlayer2D::CheckPosition(DIRECTION eDirection)
 		else if (i32vec2NumMicroSteps.y != 0)
 		{
 			// If the 2 grids are not accessible, then return false
-			if ((cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x) >= 100) ||
-				(cMap2D->GetMapInfo(i32vec2Index.y + 1, i32vec2Index.x) >= 100))
+			if (cMap2D->IsSolid(i32vec2Index.y, i32vec2Index.x) ||
+				cMap2D->IsSolid(i32vec2Index.y + 1, i32vec2Index.x))
 			{
 				return false;
 			}
@@ -529,7 +628,7 @@ bool CPlayer2D::CheckPosition(DIRECTION eDirection)
 		if (i32vec2NumMicroSteps.y == 0)
 		{
 			// If the grid is not accessible, then return false
-			if (cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x + 1) >= 100)
+			if (cMap2D->IsSolid(i32vec2Index.y, i32vec2Index.x + 1))
 			{
 				return false;
 			}
@@ -538,8 +637,8 @@ bool CPlayer2D::CheckPosition(DIRECTION eDirection)
 		else if (i32vec2NumMicroSteps.y != 0)
 		{
 			// If the 2 grids are not accessible, then return false
-			if ((cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x + 1) >= 100) ||
-				(cMap2D->GetMapInfo(i32vec2Index.y + 1, i32vec2Index.x + 1) >= 100))
+			if (cMap2D->IsSolid(i32vec2Index.y, i32vec2Index.x + 1) ||
+				cMap2D->IsSolid(i32vec2Index.y + 1, i32vec2Index.x + 1))
 			{
 				return false;
 			}
@@ -559,7 +658,7 @@ bool CPlayer2D::CheckPosition(DIRECTION eDirection)
 		if (i32vec2NumMicroSteps.x == 0)
 		{
 			// If the grid is not accessible, then return false
-			if (cMap2D->GetMapInfo(i32vec2Index.y + 1, i32vec2Index.x) >= 100)
+			if (cMap2D->IsSolid(i32vec2Index.y + 1, i32vec2Index.x))
 			{
 				return false;
 			}
@@ -568,8 +667,8 @@ bool CPlayer2D::CheckPosition(DIRECTION eDirection)
 		else if (i32vec2NumMicroSteps.x != 0)
 		{
 			// If the 2 grids are not accessible, then return false
-			if ((cMap2D->GetMapInfo(i32vec2Index.y + 1, i32vec2Index.x) >= 100) ||
-				(cMap2D->GetMapInfo(i32vec2Index.y + 1, i32vec2Index.x + 1) >= 100))
+			if (cMap2D->IsSolid(i32vec2Index.y + 1, i32vec2Index.x) ||
+				cMap2D->IsSolid(i32vec2Index.y + 1, i32vec2Index.x + 1))
 			{
 				return false;
 			}
@@ -581,7 +680,7 @@ bool CPlayer2D::CheckPosition(DIRECTION eDirection)
 		if (i32vec2NumMicroSteps.x == 0)
 		{
 			// If the grid is not accessible, then return false
-			if (cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x) >= 100)
+			if (cMap2D->IsSolid(i32vec2Index.y, i32vec2Index.x))
 			{
 				return false;
 			}
@@ -590,8 +689,8 @@ bool CPlayer2D::CheckPosition(DIRECTION eDirection)
 		else if (i32vec2NumMicroSteps.x != 0)
 		{
 			// If the 2 grids are not accessible, then return false
-			if ((cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x) >= 100) ||
-				(cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x + 1) >= 100))
+			if (cMap2D->IsSolid(i32vec2Index.y, i32vec2Index.x) ||
+				cMap2D->IsSolid(i32vec2Index.y, i32vec2Index.x + 1))
 			{
 				return false;
 			}
@@ -634,43 +733,40 @@ void CPlayer2D::UpdateJumpFall(const double dElapsedTime)
 		// Get the displacement from the physics engine
 		glm::vec2 v2Displacement = cPhysics2D.GetDeltaDisplacement();
 
-		// Store the current i32vec2Index.y
-		int iIndex_YAxis_OLD = i32vec2Index.y;
-
+		// Translate the displacement from pixels to micro steps
 		int iDisplacement_MicroSteps = (int)(v2Displacement.y / cSettings->MICRO_STEP_YAXIS); //DIsplacement divide by distance for 1 microstep
-		if (i32vec2Index.y < (int)cSettings->NUM_TILES_YAXIS)
+
+		// Sweep the player up through the map, so that a fast jump cannot pass through a tile
+		const glm::vec2 vec2Position(	i32vec2Index.x + (float)i32vec2NumMicroSteps.x / cSettings->NUM_STEPS_PER_TILE_XAXIS,
+										i32vec2Index.y + (float)i32vec2NumMicroSteps.y / cSettings->NUM_STEPS_PER_TILE_YAXIS);
+		glm::i32vec2 i32vec2HitTile;
+		float fTimeOfImpact;
+		if ((iDisplacement_MicroSteps > 0) &&
+			(cMap2D->SweepAABB(	vec2Position,
+								vec2Position + glm::vec2(1.0f, 1.0f),
+								glm::vec2(0.0f, (float)iDisplacement_MicroSteps / cSettings->NUM_STEPS_PER_TILE_YAXIS),
+								i32vec2HitTile,
+								fTimeOfImpact) == true))
+		{
+			// Stop below the tile which was hit, aligned with the row
+			i32vec2Index.y = i32vec2HitTile.y - 1;
+			i32vec2NumMicroSteps.y = 0;
+			// Set the Physics to fall status
+			cPhysics2D.SetStatus(CPhysics2D::STATUS::FALL);
+		}
+		else
 		{
-			i32vec2NumMicroSteps.y += iDisplacement_MicroSteps;
-			if (i32vec2NumMicroSteps.y > cSettings->NUM_STEPS_PER_TILE_YAXIS)
-			{
-				i32vec2NumMicroSteps.y -= cSettings->NUM_STEPS_PER_TILE_YAXIS;
-				if (i32vec2NumMicroSteps.y < 0)
-					i32vec2NumMicroSteps.y = 0;
-				i32vec2Index.y++;
-			}
+			// Move by the whole displacement
+			int iMicroSteps = i32vec2Index.y * (int)cSettings->NUM_STEPS_PER_TILE_YAXIS + i32vec2NumMicroSteps.y + iDisplacement_MicroSteps;
+			if (iMicroSteps < 0)
+				iMicroSteps = 0;
+			i32vec2Index.y = iMicroSteps / (int)cSettings->NUM_STEPS_PER_TILE_YAXIS;
+			i32vec2NumMicroSteps.y = iMicroSteps % (int)cSettings->NUM_STEPS_PER_TILE_YAXIS;
 		}
 
 		// Constraint the player's position within the screen boundary
 		Constraint(UP);
 
-		// Iterate through all rows until the proposed row
-		// Check if the player will hit a tile; stop jump if so.
-		int iIndex_YAxis_Proposed = i32vec2Index.y;
-		for (int i = iIndex_YAxis_OLD; i <= iIndex_YAxis_Proposed; i++)
-		{
-			// Change the player's index to the current i value
-			i32vec2Index.y = i;
-			// If the new position is not feasible, then revert to old position
-			if (CheckPosition(UP) == false)
-			{
-				// Align with the row
-				i32vec2NumMicroSteps.y = 0;
-				// Set the Physics to fall status
-				cPhysics2D.SetStatus(CPhysics2D::STATUS::FALL);
-				break;
-			}
-		}
-
 		// If the player is still jumping and the initial velocity has reached zero or below zero, 
 		// then it has reach the peak of its jump
 		if ((cPhysics2D.GetStatus() == CPhysics2D::STATUS::JUMP) && (cPhysics2D.GetDeltaDisplacement().y <= 0.0f))
@@ -688,45 +784,40 @@ void CPlayer2D::UpdateJumpFall(const double dElapsedTime)
 		// Get the displacement from the physics engine
 		glm::vec2 v2Displacement = cPhysics2D.GetDeltaDisplacement();
 
-		// Store the current i32vec2Index.y
-		int iIndex_YAxis_OLD = i32vec2Index.y;
-
 		// Translate the displacement from pixels to indices
-		int iDisplacement_MicroSteps = (int)(v2Displacement.y / cSettings->MICRO_STEP_YAXIS);
-
-		if (i32vec2Index.y >= 0)
+		int iDisplacement_MicroSteps = abs((int)(v2Displacement.y / cSettings->MICRO_STEP_YAXIS));
+
+		// Sweep the player down through the map, so that a fast fall cannot pass through a tile
+		const glm::vec2 vec2Position(	i32vec2Index.x + (float)i32vec2NumMicroSteps.x / cSettings->NUM_STEPS_PER_TILE_XAXIS,
+										i32vec2Index.y + (float)i32vec2NumMicroSteps.y / cSettings->NUM_STEPS_PER_TILE_YAXIS);
+		glm::i32vec2 i32vec2HitTile;
+		float fTimeOfImpact;
+		if ((iDisplacement_MicroSteps > 0) &&
+			(cMap2D->SweepAABB(	vec2Position,
+								vec2Position + glm::vec2(1.0f, 1.0f),
+								glm::vec2(0.0f, -(float)iDisplacement_MicroSteps / cSettings->NUM_STEPS_PER_TILE_YAXIS),
+								i32vec2HitTile,
+								fTimeOfImpact) == true))
+		{
+			// Land on top of the tile which was hit
+			i32vec2Index.y = i32vec2HitTile.y + 1;
+			// Set the Physics to idle status
+			cPhysics2D.SetStatus(CPhysics2D::STATUS::IDLE);
+			jumpCount = 0;
+			i32vec2NumMicroSteps.y = 0;
+		}
+		else
 		{
-			i32vec2NumMicroSteps.y -= fabs(iDisplacement_MicroSteps);
-			if (i32vec2NumMicroSteps.y < 0)
-			{
-				i32vec2NumMicroSteps.y = ((int)cSettings->NUM_STEPS_PER_TILE_YAXIS) - 1;
-				i32vec2Index.y--;
-			}
+			// Move by the whole displacement
+			int iMicroSteps = i32vec2Index.y * (int)cSettings->NUM_STEPS_PER_TILE_YAXIS + i32vec2NumMicroSteps.y - iDisplacement_MicroSteps;
+			if (iMicroSteps < 0)
+				iMicroSteps = 0;
+			i32vec2Index.y = iMicroSteps / (int)cSettings->NUM_STEPS_PER_TILE_YAXIS;
+			i32vec2NumMicroSteps.y = iMicroSteps % (int)cSettings->NUM_STEPS_PER_TILE_YAXIS;
 		}
 
 		// Constraint the player's position within the screen boundary
 		Constraint(DOWN);
-
-		// Iterate through all rows until the proposed row
-		// Check if the player will hit a tile; stop fall if so.
-		int iIndex_YAxis_Proposed = i32vec2Index.y;
-		for (int i = iIndex_YAxis_OLD; i >= iIndex_YAxis_Proposed; i--)
-		{
-			// Change the player's index to the current i value
-			i32vec2Index.y = i;
-			// If the new position is not feasible, then revert to old position
-			if (CheckPosition(DOWN) == false)
-			{
-				// Revert to the previous position
-				if (i != iIndex_YAxis_OLD)
-					i32vec2Index.y = i + 1;
-				// Set the Physics to idle status
-				cPhysics2D.SetStatus(CPhysics2D::STATUS::IDLE);
-				jumpCount = 0;
-				i32vec2NumMicroSteps.y = 0;
-				break;
-			}
-		}
 	}
 }
 
@@ -63,6 +63,9 @@ public:
 	// PostRender
 	void PostRender(void);
 
+	// Compare the time to draw many animated sprites one draw call at a time and through the CSpriteBatcher
+	void BenchmarkSprites(const unsigned int uiNumSprites = 50000, const unsigned int uiNumFrames = 60);
+
 protected:
 	enum DIRECTION
 	{
@@ -86,6 +89,10 @@ protected:
 
 	//CS: Animated Sprite
 	CSpriteAnimation* animatedSprites;
+	//CS: The IDs of the animations, so that they are played without looking up their names
+	int iIdleAnimation;
+	int iLeftAnimation;
+	int iRightAnimation;
 
 	// Current color
 	glm::vec4 currentColor;
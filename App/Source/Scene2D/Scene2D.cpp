@@ -7,12 +7,30 @@ using namespace std;
 
 #include "System\filesystem.h"
 
+// Include CSpriteBatcher
+#include "RenderControl\SpriteBatcher.h"
+// Include CAnimationSystem
+#include "Primitives\AnimationSystem.h"
+
+// Set this to true to benchmark the rendering of the CMap2D when this scene is initialised
+#define _BENCHMARK_TILEMAP false
+// Set this to true to benchmark the saving of the CMap2D when this scene is initialised
+#define _BENCHMARK_SAVEGAME false
+// Set this to true to benchmark the loading of a large level when this scene is initialised
+#define _BENCHMARK_LEVELLOAD false
+// Set this to true to benchmark the streaming of a large level while the viewport scrolls across it
+#define _BENCHMARK_STREAMING false
+// Set this to true to benchmark the drawing of many animated sprites when this scene is initialised
+#define _BENCHMARK_SPRITES false
+
 /**
  @brief Constructor This constructor has protected access modifier as this class will be a Singleton
  */
 CScene2D::CScene2D(void)
 	: cMap2D(NULL)
 	, cPlayer2D(NULL)
+	, cPathRequestService(NULL)
+	, uiLevelIndex(0)
 	, cKeyboardController(NULL)
 	, cGUI_Scene2D(NULL)
 	, cGameManager(NULL)
@@ -57,12 +75,22 @@ CScene2D::~CScene2D(void)
 	}
 	enemyVector.clear();
 
+	// Stop the path finding of the enemies after they are destroyed
+	if (cPathRequestService)
+	{
+		cPathRequestService->Destroy();
+		cPathRequestService = NULL;
+	}
+
 	if (cPlayer2D)
 	{
 		cPlayer2D->Destroy();
 		cPlayer2D = NULL;
 	}
 
+	// Destroy the animations after the entities which play them
+	CAnimationSystem::Destroy();
+
 	if (cMap2D)
 	{
 		cMap2D->Destroy();
@@ -82,32 +110,68 @@ bool CScene2D::Init(void)
 	//CShaderManager::GetInstance()->Add("2DShader", "Shader//Scene2D.vs", "Shader//Scene2D.fs");
 	CShaderManager::GetInstance()->Use("2DShader");
 	CShaderManager::GetInstance()->activeShader->setInt("texture1", 0);
+	CShaderManager::GetInstance()->Use("2DTileMapShader");
+	CShaderManager::GetInstance()->activeShader->setInt("texture1", 0);
+	CShaderManager::GetInstance()->Use("2DSpriteShader");
+	CShaderManager::GetInstance()->activeShader->setInt("texture1", 0);
+	CShaderManager::GetInstance()->activeShader->setMat4("transform", glm::mat4(1.0f));
+
+	// The levels, in the order in which they are played
+	vLevelFilenames.clear();
+	vLevelFilenames.push_back("Maps/DM2213_Map_Level_01.csv");
+	vLevelFilenames.push_back("Maps/DM2213_Map_Level_02.csv");
+	uiLevelIndex = 0;
 
 	// Create and initialise the Map 2D
 	cMap2D = CMap2D::GetInstance();
 	// Set a shader to this class
 	cMap2D->SetShader("2DShader");
-	// Initialise the instance
-	if (cMap2D->Init(2, 24, 32) == false)
+	// Initialise the instance. With level streaming, the cMap2D only holds the current level and the next one.
+	const bool bUseLevelStreaming = CSettings::GetInstance()->bUseLevelStreaming;
+	if (cMap2D->Init(bUseLevelStreaming ? 2 : (unsigned int)vLevelFilenames.size(), 24, 32) == false)
 	{
 		cout << "Failed to load CMap2D" << endl;
 		return false;
 	}
+	// This leaves the first level empty, so it is run before the first map is loaded
+	if (_BENCHMARK_STREAMING == true)
+		cMap2D->BenchmarkStreaming(2048, 2048, 600);
 	// Load the map into an array
-	if (cMap2D->LoadMap("Maps/DM2213_Map_Level_01.csv") == false)
+	if (cMap2D->LoadMap(vLevelFilenames[0], GetMapLevel(0)) == false)
 	{
 		// The loading of a map has failed. Return false
 		return false;
 	}
-	// Load the map into an array
-	if (cMap2D->LoadMap("Maps/DM2213_Map_Level_02.csv", 1) == false)
+	if (bUseLevelStreaming == true)
 	{
-		// The loading of a map has failed. Return false
-		return false;
+		// Load the next level in the background while the first level is played
+		if (vLevelFilenames.size() > 1)
+			cMap2D->PreloadMap(vLevelFilenames[1], GetMapLevel(1));
+	}
+	else
+	{
+		for (unsigned int i = 1; i < vLevelFilenames.size(); i++)
+		{
+			// Load the map into an array
+			if (cMap2D->LoadMap(vLevelFilenames[i], GetMapLevel(i)) == false)
+			{
+				// The loading of a map has failed. Return false
+				return false;
+			}
+		}
 	}
 
 	// Activate diagonal movement
 	cMap2D->SetDiagonalMovement(false);
+	// Start the background path finding of the enemies, which have to be created after this
+	cPathRequestService = CPathRequestService::GetInstance();
+	cPathRequestService->Init(heuristic::euclidean, 10, CSettings::GetInstance()->uiPathNodeBudget);
+	if (_BENCHMARK_TILEMAP == true)
+		cMap2D->Benchmark(256, 256, 100);
+	if (_BENCHMARK_SAVEGAME == true)
+		cMap2D->BenchmarkSave(120, 4);
+	if (_BENCHMARK_LEVELLOAD == true)
+		cMap2D->BenchmarkLoad(1024, 1024);
 
 	// Load Scene2DColor into ShaderManager
 	//CShaderManager::GetInstance()->Add("2DColorShader", "Shader//Scene2DColor.vs", "Shader//Scene2DColor.fs");
@@ -123,9 +187,12 @@ bool CScene2D::Init(void)
 		cout << "Failed to load CPlayer2D" << endl;
 		return false;
 	}
+	if (_BENCHMARK_SPRITES == true)
+		cPlayer2D->BenchmarkSprites(50000, 60);
 
-	// Create and initialise the CEnemy2D
+	// Create and initialise the CEnemy2D, one for each of their start positions (300) in the map
 	enemyVector.clear();
+	enemyVector.reserve(cMap2D->CountValue(300));
 	while (true)
 	{
 		CEnemy2D* cEnemy2D = new CEnemy2D();
@@ -169,6 +236,9 @@ bool CScene2D::Init(void)
 */
 bool CScene2D::Update(const double dElapsedTime)
 {
+	// Collect the paths which were found for the enemies since the last frame
+	cPathRequestService->Update();
+
 	// Call the cPlayer2D's update method before Map2D as we want to capture the inputs before map2D update
 	cPlayer2D->Update(dElapsedTime);
 
@@ -178,14 +248,18 @@ bool CScene2D::Update(const double dElapsedTime)
 	{
 		enemyVector[i]->Update(dElapsedTime);
 	}
+
+	// Advance the animations of all the sprites together, after the entities have chosen them
+	if (CSettings::GetInstance()->bUseAnimationSystem == true)
+		CAnimationSystem::GetInstance()->Update(dElapsedTime);
 	 
 	// Call the Map2D's update method
 	cMap2D->Update(dElapsedTime);
 
 	// Get keyboard updates
-	if (cKeyboardController->IsKeyDown(GLFW_KEY_F6))
+	if (cKeyboardController->IsKeyPressed(GLFW_KEY_F6))
 	{
-		// Save the current game to a save file
+		// Save the current game to a save file. The file is written in the background.
 		// Make sure the file is open
 		try {
 			if (cMap2D->SaveMap("Maps/DM2213_Map_Level_01_SAVEGAMEtest.csv") == false)
@@ -206,7 +280,23 @@ bool CScene2D::Update(const double dElapsedTime)
 	// Check if the game should go to the next level
 	if (cGameManager->bLevelCompleted == true)
 	{
-		cMap2D->SetCurrentLevel(cMap2D->GetCurrentLevel()+1);
+		if (uiLevelIndex + 1 < vLevelFilenames.size())
+		{
+			// The next level has been loaded in the background, unless it was completed very quickly,
+			// in which case SetCurrentLevel waits for it
+			const unsigned int uiLastLevel = cMap2D->GetCurrentLevel();
+			uiLevelIndex++;
+			cMap2D->SetCurrentLevel(GetMapLevel(uiLevelIndex));
+
+			// The last level cannot be played again, so the level after this one is loaded in its place
+			if (CSettings::GetInstance()->bUseLevelStreaming == true)
+			{
+				if (uiLevelIndex + 1 < vLevelFilenames.size())
+					cMap2D->PreloadMap(vLevelFilenames[uiLevelIndex + 1], uiLastLevel);
+				else
+					cMap2D->UnloadMap(uiLastLevel);
+			}
+		}
 		cPlayer2D->Reset();
 		cGameManager->bLevelCompleted = false;
 	}
@@ -226,6 +316,19 @@ bool CScene2D::Update(const double dElapsedTime)
 	return true;
 }
 
+/**
+ @brief Get the level of the cMap2D which a level in vLevelFilenames is loaded into. With level streaming,
+		the levels take turns to use the 2 levels of the cMap2D.
+ @param uiLevelIndex A const unsigned int variable containing the index of the level in vLevelFilenames
+ @return The level of the cMap2D
+ */
+unsigned int CScene2D::GetMapLevel(const unsigned int uiLevelIndex) const
+{
+	if (CSettings::GetInstance()->bUseLevelStreaming == true)
+		return uiLevelIndex % 2;
+	return uiLevelIndex;
+}
+
 /**
  @brief PreRender Set up the OpenGL display environment before rendering
  */
@@ -247,22 +350,39 @@ void CScene2D::PreRender(void)
  */
 void CScene2D::Render(void)
 {
-	for (int i = 0; i < enemyVector.size(); i++)
+	if (CSettings::GetInstance()->bUseSpriteBatching == true)
 	{
-		// Call the CEnemy2D's PreRender()
-		enemyVector[i]->PreRender();
-		// Call the CEnemy2D's Render()
-		enemyVector[i]->Render();
-		// Call the CEnemy2D's PostRender()
-		enemyVector[i]->PostRender();
+		// The entities submit their sprites, which are then drawn together
+		CSpriteBatcher* cSpriteBatcher = CSpriteBatcher::GetInstance();
+		cSpriteBatcher->Begin();
+		for (int i = 0; i < enemyVector.size(); i++)
+		{
+			enemyVector[i]->Render();
+		}
+		cPlayer2D->Render();
+		cSpriteBatcher->PreRender();
+		cSpriteBatcher->Flush();
+		cSpriteBatcher->PostRender();
 	}
+	else
+	{
+		for (int i = 0; i < enemyVector.size(); i++)
+		{
+			// Call the CEnemy2D's PreRender()
+			enemyVector[i]->PreRender();
+			// Call the CEnemy2D's Render()
+			enemyVector[i]->Render();
+			// Call the CEnemy2D's PostRender()
+			enemyVector[i]->PostRender();
+		}
 
-	// Call the CPlayer2D's PreRender()
-	cPlayer2D->PreRender();
-	// Call the CPlayer2D's Render()
-	cPlayer2D->Render();
-	// Call the CPlayer2D's PostRender()
-	cPlayer2D->PostRender();
+		// Call the CPlayer2D's PreRender()
+		cPlayer2D->PreRender();
+		// Call the CPlayer2D's Render()
+		cPlayer2D->Render();
+		// Call the CPlayer2D's PostRender()
+		cPlayer2D->PostRender();
+	}
 	
 	// Call the Map2D's PreRender()
 	cMap2D->PreRender();
@@ -28,6 +28,8 @@
 #include "Player2D.h"
 // Include CEnemy2D
 #include "Enemy2D.h"
+// Include CPathRequestService
+#include "PathRequestService.h"
 
 // Include vector
 #include <vector>
@@ -72,6 +74,13 @@ protected:
 	CPlayer2D* cPlayer2D;
 	// A vector containing the instance of CEnemy2Ds
 	vector<CEntity2D*> enemyVector;
+	// The handler containing the instance of the CPathRequestService, which finds the paths of the CEnemy2Ds
+	CPathRequestService* cPathRequestService;
+
+	// The map files of the levels, in the order in which they are played
+	vector<string> vLevelFilenames;
+	// The level being played, as an index into vLevelFilenames
+	unsigned int uiLevelIndex;
 
 	// Keyboard Controller singleton instance
 	CKeyboardController* cKeyboardController;
@@ -92,5 +101,8 @@ protected:
 	CScene2D(void);
 	// Destructor
 	virtual ~CScene2D(void);
+
+	// Get the level of the cMap2D which a level in vLevelFilenames is loaded into
+	unsigned int GetMapLevel(const unsigned int uiLevelIndex) const;
 };
 
@@ -0,0 +1,534 @@
+/**
+ CTileGrid
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#include "TileGrid.h"
+
+// Include CMapSaveWriter
+#include "MapSaveWriter.h"
+// Include CLogger
+#include "System/Logger.h"
+
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+
+// The header of a chunk file, which is followed by the chunks in order, each as CHUNK_TILES int32 values
+struct ChunkFileHeader
+{
+	char arrMagic[4];
+	uint32_t uiVersion;
+	uint32_t uiNumRows;
+	uint32_t uiNumCols;
+	uint32_t uiChunkSize;
+};
+static const char arrChunkFileMagic[4] = { 'T', 'C', 'H', 'K' };
+static const uint32_t uiChunkFileVersion = 1;
+
+// Numbers the scratch files, so that a chunk file which is opened again does not share the scratch file
+// of the grid which had it open before
+static unsigned int uiNextScratchID = 0;
+
+/**
+ @brief Constructor
+ */
+CTileGrid::CTileGrid(void)
+	: uiNumRows(0)
+	, uiNumCols(0)
+	, uiNumChunkRows(0)
+	, uiNumChunkCols(0)
+	, uiViewportRow(0)
+	, uiViewportCol(0)
+	, uiUseCounter(0)
+	, uiNumChunkLoads(0)
+	, bStreaming(false)
+	, uiMaxResidentChunks(0)
+	, uiNumScratchChunks(0)
+	, uiKeepChunkRow0(0)
+	, uiKeepChunkRow1(0)
+	, uiKeepChunkCol0(0)
+	, uiKeepChunkCol1(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CTileGrid::~CTileGrid(void)
+{
+	Clear();
+}
+
+/**
+ @brief Initialise this grid with all its chunks in memory, and every tile set to 0
+ @param uiNumRows A const unsigned int variable containing the number of rows
+ @param uiNumCols A const unsigned int variable containing the number of columns
+ @return true if the initialisation is successful, else false
+ */
+bool CTileGrid::Init(const unsigned int uiNumRows, const unsigned int uiNumCols)
+{
+	Clear();
+
+	this->uiNumRows = uiNumRows;
+	this->uiNumCols = uiNumCols;
+	uiNumChunkRows = (uiNumRows + CHUNK_MASK) >> CHUNK_SHIFT;
+	uiNumChunkCols = (uiNumCols + CHUNK_MASK) >> CHUNK_SHIFT;
+
+	vChunk.assign(uiNumChunkRows * uiNumChunkCols, NULL);
+	for (unsigned int i = 0; i < vChunk.size(); i++)
+		LoadChunk(i);
+	return true;
+}
+
+/**
+ @brief Stream this grid from a chunk file, keeping at most uiMaxResidentChunks chunks in memory.
+		The file is opened and checked before this grid is changed, so the current tiles are kept if this fails.
+		The chunk file is only read. The changed chunks which are freed are written into a scratch file next to
+		it, which is deleted when the grid is cleared, so the changes are only kept if SaveChunkFile() is called.
+ @param filename A const string& variable containing the path of the chunk file
+ @param uiMaxResidentChunks A const unsigned int variable containing the maximum number of chunks in memory
+ @param uiMinRows A const unsigned int variable containing the least number of rows which the level must have
+ @param uiMinCols A const unsigned int variable containing the least number of columns which the level must have
+ @return true if the file is opened, else false
+ */
+bool CTileGrid::OpenChunkFile(	const string& filename,
+								const unsigned int uiMaxResidentChunks,
+								const unsigned int uiMinRows,
+								const unsigned int uiMinCols)
+{
+	ifstream cNewFile(filename.c_str(), ios::in | ios::binary);
+	if (cNewFile.is_open() == false)
+	{
+		LOG_ERROR(MAP, "CTileGrid::OpenChunkFile - Unable to open %s", filename.c_str());
+		return false;
+	}
+
+	ChunkFileHeader cHeader;
+	cNewFile.read((char*)&cHeader, sizeof(cHeader));
+	if ((cNewFile.good() == false) ||
+		(memcmp(cHeader.arrMagic, arrChunkFileMagic, sizeof(arrChunkFileMagic)) != 0) ||
+		(cHeader.uiVersion != uiChunkFileVersion) ||
+		(cHeader.uiChunkSize != CHUNK_SIZE))
+	{
+		LOG_ERROR(MAP, "CTileGrid::OpenChunkFile - %s is not a chunk file of this version", filename.c_str());
+		return false;
+	}
+	if ((cHeader.uiNumRows < uiMinRows) || (cHeader.uiNumCols < uiMinCols))
+	{
+		LOG_ERROR(MAP, "CTileGrid::OpenChunkFile - %s has %ux%u tiles, but at least %ux%u are needed",
+					filename.c_str(), cHeader.uiNumRows, cHeader.uiNumCols, uiMinRows, uiMinCols);
+		return false;
+	}
+
+	// The file must hold every chunk, so that a chunk which is loaded later cannot fail to be read
+	const unsigned int uiNewChunkRows = (cHeader.uiNumRows + CHUNK_MASK) >> CHUNK_SHIFT;
+	const unsigned int uiNewChunkCols = (cHeader.uiNumCols + CHUNK_MASK) >> CHUNK_SHIFT;
+	cNewFile.seekg(0, ios::end);
+	if ((streamoff)cNewFile.tellg() <
+		(streamoff)sizeof(ChunkFileHeader) + (streamoff)uiNewChunkRows * uiNewChunkCols * CHUNK_TILES * sizeof(int32_t))
+	{
+		LOG_ERROR(MAP, "CTileGrid::OpenChunkFile - %s is truncated", filename.c_str());
+		return false;
+	}
+
+	const string sNewScratchFilename = filename + "." + to_string(uiNextScratchID++) + ".scratch";
+	fstream cNewScratchFile(sNewScratchFilename.c_str(), ios::in | ios::out | ios::binary | ios::trunc);
+	if (cNewScratchFile.is_open() == false)
+	{
+		LOG_ERROR(MAP, "CTileGrid::OpenChunkFile - Unable to create %s", sNewScratchFilename.c_str());
+		return false;
+	}
+
+	// Nothing can fail from here on, so the current tiles are replaced
+	Clear();
+	cFile.swap(cNewFile);
+	cScratchFile.swap(cNewScratchFile);
+	sFilename = filename;
+	sScratchFilename = sNewScratchFilename;
+
+	uiNumRows = cHeader.uiNumRows;
+	uiNumCols = cHeader.uiNumCols;
+	uiNumChunkRows = uiNewChunkRows;
+	uiNumChunkCols = uiNewChunkCols;
+	vChunk.assign(uiNumChunkRows * uiNumChunkCols, NULL);
+	vScratchSlot.assign(vChunk.size(), -1);
+
+	bStreaming = true;
+	this->uiMaxResidentChunks = (uiMaxResidentChunks > 0) ? uiMaxResidentChunks : 1;
+
+	LOG_INFO(MAP, "CTileGrid::OpenChunkFile - Streaming %ux%u tiles from %s", uiNumRows, uiNumCols, filename.c_str());
+	return true;
+}
+
+/**
+ @brief Write every chunk of this grid into a chunk file. The chunks are written into a temporary file, which
+		then replaces the file in one step, so the file is never half-written. A streamed grid can save into its
+		own chunk file, which then holds all the changes, and the scratch file starts again.
+ @param filename A const string& variable containing the path of the chunk file
+ @return true if the file is written, else false
+ */
+bool CTileGrid::SaveChunkFile(const string& filename)
+{
+	const string sTempFilename = filename + ".tmp";
+	{
+		ofstream cOutput(sTempFilename.c_str(), ios::out | ios::trunc | ios::binary);
+		if (cOutput.is_open() == false)
+		{
+			LOG_ERROR(MAP, "CTileGrid::SaveChunkFile - Unable to open %s", sTempFilename.c_str());
+			return false;
+		}
+
+		ChunkFileHeader cHeader;
+		memcpy(cHeader.arrMagic, arrChunkFileMagic, sizeof(arrChunkFileMagic));
+		cHeader.uiVersion = uiChunkFileVersion;
+		cHeader.uiNumRows = uiNumRows;
+		cHeader.uiNumCols = uiNumCols;
+		cHeader.uiChunkSize = CHUNK_SIZE;
+		cOutput.write((const char*)&cHeader, sizeof(cHeader));
+
+		// A chunk which is not in memory is copied from the scratch file or the chunk file, without loading it
+		bool bRead = true;
+		Chunk* cScratch = new Chunk();
+		for (unsigned int i = 0; (i < vChunk.size()) && bRead; i++)
+		{
+			const Chunk* cChunk = vChunk[i];
+			if (cChunk == NULL)
+			{
+				bRead = ReadChunk(i, cScratch);
+				cChunk = cScratch;
+			}
+			cOutput.write((const char*)cChunk->arrTile, sizeof(cChunk->arrTile));
+		}
+		delete cScratch;
+
+		cOutput.flush();
+		if ((bRead == false) || (cOutput.good() == false))
+		{
+			cOutput.close();
+			remove(sTempFilename.c_str());
+			LOG_ERROR(MAP, "CTileGrid::SaveChunkFile - Unable to write %s", sTempFilename.c_str());
+			return false;
+		}
+	}
+
+	// The chunk file cannot be replaced on Windows while it is open
+	const bool bSaveIntoOwnFile = bStreaming && (filename == sFilename);
+	if (bSaveIntoOwnFile)
+		cFile.close();
+	const bool bReplaced = CMapSaveWriter::ReplaceFile(sTempFilename, filename);
+	if (bSaveIntoOwnFile)
+	{
+		cFile.clear();
+		cFile.open(sFilename.c_str(), ios::in | ios::binary);
+		if (cFile.is_open() == false)
+			LOG_ERROR(MAP, "CTileGrid::SaveChunkFile - Unable to open %s again", sFilename.c_str());
+
+		if (bReplaced)
+		{
+			for (unsigned int i = 0; i < vResident.size(); i++)
+				vChunk[vResident[i]]->bDirty = false;
+			vScratchSlot.assign(vChunk.size(), -1);
+			uiNumScratchChunks = 0;
+			cScratchFile.close();
+			cScratchFile.clear();
+			cScratchFile.open(sScratchFilename.c_str(), ios::in | ios::out | ios::binary | ios::trunc);
+		}
+	}
+
+	if (bReplaced == false)
+	{
+		LOG_ERROR(MAP, "CTileGrid::SaveChunkFile - Unable to replace %s", filename.c_str());
+		return false;
+	}
+	return true;
+}
+
+/**
+ @brief Move the viewport, which is clamped to the level. When streaming, the chunks of the viewport and the
+		chunks within uiMargin chunks of it are loaded now, so that they are ready when used, and are the last
+		to be freed.
+ @param uiFirstRow A const unsigned int variable containing the first row of the viewport in the level
+ @param uiFirstCol A const unsigned int variable containing the first column of the viewport in the level
+ @param uiNumRows A const unsigned int variable containing the number of rows in the viewport
+ @param uiNumCols A const unsigned int variable containing the number of columns in the viewport
+ @param uiMargin A const unsigned int variable containing the number of chunks around the viewport to keep
+ @return true if the viewport has moved, else false
+ */
+bool CTileGrid::SetViewport(const unsigned int uiFirstRow,
+							const unsigned int uiFirstCol,
+							const unsigned int uiNumRows,
+							const unsigned int uiNumCols,
+							const unsigned int uiMargin)
+{
+	if ((uiNumRows == 0) || (uiNumCols == 0) || (uiNumRows > this->uiNumRows) || (uiNumCols > this->uiNumCols))
+		return false;
+
+	const unsigned int uiNewRow = min(uiFirstRow, this->uiNumRows - uiNumRows);
+	const unsigned int uiNewCol = min(uiFirstCol, this->uiNumCols - uiNumCols);
+	const bool bMoved = (uiNewRow != uiViewportRow) || (uiNewCol != uiViewportCol);
+	uiViewportRow = uiNewRow;
+	uiViewportCol = uiNewCol;
+
+	if (bStreaming == false)
+		return bMoved;
+
+	const unsigned int uiChunkRow0 = uiViewportRow >> CHUNK_SHIFT;
+	const unsigned int uiChunkCol0 = uiViewportCol >> CHUNK_SHIFT;
+	const unsigned int uiChunkRow1 = (uiViewportRow + uiNumRows - 1) >> CHUNK_SHIFT;
+	const unsigned int uiChunkCol1 = (uiViewportCol + uiNumCols - 1) >> CHUNK_SHIFT;
+
+	const unsigned int uiNewRow0 = (uiChunkRow0 > uiMargin) ? uiChunkRow0 - uiMargin : 0;
+	const unsigned int uiNewCol0 = (uiChunkCol0 > uiMargin) ? uiChunkCol0 - uiMargin : 0;
+	const unsigned int uiNewRow1 = (uiChunkRow1 + uiMargin < uiNumChunkRows) ? uiChunkRow1 + uiMargin : uiNumChunkRows - 1;
+	const unsigned int uiNewCol1 = (uiChunkCol1 + uiMargin < uiNumChunkCols) ? uiChunkCol1 + uiMargin : uiNumChunkCols - 1;
+
+	// Nothing to load if the viewport has not moved to other chunks
+	if ((uiNewRow0 == uiKeepChunkRow0) && (uiNewRow1 == uiKeepChunkRow1) &&
+		(uiNewCol0 == uiKeepChunkCol0) && (uiNewCol1 == uiKeepChunkCol1) &&
+		(vResident.empty() == false))
+		return bMoved;
+
+	uiKeepChunkRow0 = uiNewRow0;
+	uiKeepChunkRow1 = uiNewRow1;
+	uiKeepChunkCol0 = uiNewCol0;
+	uiKeepChunkCol1 = uiNewCol1;
+
+	for (unsigned int uiChunkRow = uiKeepChunkRow0; uiChunkRow <= uiKeepChunkRow1; uiChunkRow++)
+	{
+		for (unsigned int uiChunkCol = uiKeepChunkCol0; uiChunkCol <= uiKeepChunkCol1; uiChunkCol++)
+		{
+			const unsigned int uiChunkIndex = uiChunkRow * uiNumChunkCols + uiChunkCol;
+			if (vChunk[uiChunkIndex] == NULL)
+				LoadChunk(uiChunkIndex);
+		}
+	}
+	return bMoved;
+}
+
+/**
+ @brief Get the first row of the viewport
+ @return An unsigned int variable
+ */
+unsigned int CTileGrid::GetViewportRow(void) const
+{
+	return uiViewportRow;
+}
+
+/**
+ @brief Get the first column of the viewport
+ @return An unsigned int variable
+ */
+unsigned int CTileGrid::GetViewportCol(void) const
+{
+	return uiViewportCol;
+}
+
+/**
+ @brief Get the number of rows
+ @return An unsigned int variable
+ */
+unsigned int CTileGrid::GetNumRows(void) const
+{
+	return uiNumRows;
+}
+
+/**
+ @brief Get the number of columns
+ @return An unsigned int variable
+ */
+unsigned int CTileGrid::GetNumCols(void) const
+{
+	return uiNumCols;
+}
+
+/**
+ @brief Check if the chunks are streamed from a chunk file
+ @return A bool variable
+ */
+bool CTileGrid::IsStreaming(void) const
+{
+	return bStreaming;
+}
+
+/**
+ @brief Get the number of chunks in memory
+ @return An unsigned int variable
+ */
+unsigned int CTileGrid::GetNumResidentChunks(void) const
+{
+	return vResident.size();
+}
+
+/**
+ @brief Get the number of chunks which have been loaded from the chunk file or the scratch file
+ @return An unsigned int variable
+ */
+unsigned int CTileGrid::GetNumChunkLoads(void) const
+{
+	return uiNumChunkLoads;
+}
+
+/**
+ @brief Get the number of changed chunks which are in the scratch file
+ @return An unsigned int variable
+ */
+unsigned int CTileGrid::GetNumScratchChunks(void) const
+{
+	return uiNumScratchChunks;
+}
+
+/**
+ @brief Free all chunks, and close the chunk file and delete the scratch file.
+		The changes which have not been saved with SaveChunkFile() are lost; the chunk file is never changed here.
+ */
+void CTileGrid::Clear(void)
+{
+	for (unsigned int i = 0; i < vChunk.size(); i++)
+	{
+		delete vChunk[i];
+		vChunk[i] = NULL;
+	}
+	vChunk.clear();
+	vResident.clear();
+	if (cFile.is_open())
+		cFile.close();
+	cFile.clear();
+	if (cScratchFile.is_open())
+		cScratchFile.close();
+	cScratchFile.clear();
+	if (sScratchFilename.empty() == false)
+		remove(sScratchFilename.c_str());
+	sFilename.clear();
+	sScratchFilename.clear();
+	vScratchSlot.clear();
+	uiNumScratchChunks = 0;
+	bStreaming = false;
+	uiNumRows = 0;
+	uiNumCols = 0;
+	uiNumChunkRows = 0;
+	uiNumChunkCols = 0;
+	uiViewportRow = 0;
+	uiViewportCol = 0;
+	uiUseCounter = 0;
+	uiNumChunkLoads = 0;
+	uiKeepChunkRow0 = uiKeepChunkRow1 = 0;
+	uiKeepChunkCol0 = uiKeepChunkCol1 = 0;
+}
+
+/**
+ @brief Check if a chunk is in the keep region
+ @param uiChunkIndex A const unsigned int variable containing the index of the chunk
+ @return A bool variable
+ */
+bool CTileGrid::IsKept(const unsigned int uiChunkIndex) const
+{
+	const unsigned int uiChunkRow = uiChunkIndex / uiNumChunkCols;
+	const unsigned int uiChunkCol = uiChunkIndex % uiNumChunkCols;
+	return (uiChunkRow >= uiKeepChunkRow0) && (uiChunkRow <= uiKeepChunkRow1) &&
+		(uiChunkCol >= uiKeepChunkCol0) && (uiChunkCol <= uiKeepChunkCol1);
+}
+
+/**
+ @brief Load a chunk from the scratch file or the chunk file, or create it, freeing another chunk if too many
+		are in memory
+ @param uiChunkIndex A const unsigned int variable containing the index of the chunk
+ @return A Chunk* variable
+ */
+CTileGrid::Chunk* CTileGrid::LoadChunk(const unsigned int uiChunkIndex) const
+{
+	if (bStreaming && (vResident.size() >= uiMaxResidentChunks))
+	{
+		// Free the least recently used chunk, preferring one outside the keep region
+		unsigned int uiVictim = 0;
+		bool bVictimKept = true;
+		for (unsigned int i = 0; i < vResident.size(); i++)
+		{
+			const bool bKept = IsKept(vResident[i]);
+			if ((bKept < bVictimKept) ||
+				((bKept == bVictimKept) && (vChunk[vResident[i]]->uiLastUsed < vChunk[vResident[uiVictim]]->uiLastUsed)))
+			{
+				uiVictim = i;
+				bVictimKept = bKept;
+			}
+		}
+		EvictChunk(uiVictim);
+	}
+
+	// Value-initialise the chunk, so that a new grid starts with every tile set to 0
+	Chunk* cChunk = new Chunk();
+	if (bStreaming)
+	{
+		if (ReadChunk(uiChunkIndex, cChunk) == false)
+			LOG_ERROR(MAP, "CTileGrid::LoadChunk - Unable to read chunk %u", uiChunkIndex);
+		uiNumChunkLoads++;
+	}
+	cChunk->uiLastUsed = ++uiUseCounter;
+	cChunk->bDirty = false;
+
+	vChunk[uiChunkIndex] = cChunk;
+	vResident.push_back(uiChunkIndex);
+	return cChunk;
+}
+
+/**
+ @brief Write a chunk into the scratch file if it was changed, and free it. A changed chunk which cannot be
+		written is kept in memory, so that its changes are not lost.
+ @param uiResidentIndex A const unsigned int variable containing the index of the chunk in vResident
+ */
+void CTileGrid::EvictChunk(const unsigned int uiResidentIndex) const
+{
+	const unsigned int uiChunkIndex = vResident[uiResidentIndex];
+	Chunk* cChunk = vChunk[uiChunkIndex];
+	if (cChunk->bDirty && (WriteScratchChunk(uiChunkIndex, cChunk) == false))
+	{
+		LOG_ERROR(MAP, "CTileGrid::EvictChunk - Unable to write chunk %u into %s", uiChunkIndex, sScratchFilename.c_str());
+		return;
+	}
+	delete cChunk;
+	vChunk[uiChunkIndex] = NULL;
+
+	vResident[uiResidentIndex] = vResident.back();
+	vResident.pop_back();
+}
+
+/**
+ @brief Read a chunk from the scratch file if it has been changed and freed before, else from the chunk file
+ @param uiChunkIndex A const unsigned int variable containing the index of the chunk
+ @param cChunk A Chunk* variable to read the tiles into
+ @return true if the chunk is read, else false
+ */
+bool CTileGrid::ReadChunk(const unsigned int uiChunkIndex, Chunk* cChunk) const
+{
+	if (vScratchSlot[uiChunkIndex] >= 0)
+	{
+		cScratchFile.clear();
+		cScratchFile.seekg((streamoff)vScratchSlot[uiChunkIndex] * sizeof(cChunk->arrTile), ios::beg);
+		cScratchFile.read((char*)cChunk->arrTile, sizeof(cChunk->arrTile));
+		return cScratchFile.good();
+	}
+
+	cFile.clear();
+	cFile.seekg(sizeof(ChunkFileHeader) + (streamoff)uiChunkIndex * sizeof(cChunk->arrTile), ios::beg);
+	cFile.read((char*)cChunk->arrTile, sizeof(cChunk->arrTile));
+	return cFile.good();
+}
+
+/**
+ @brief Write a chunk into its slot in the scratch file. A chunk gets a slot the first time it is written.
+ @param uiChunkIndex A const unsigned int variable containing the index of the chunk
+ @param cChunk A const Chunk* variable containing the tiles to write
+ @return true if the chunk is written, else false
+ */
+bool CTileGrid::WriteScratchChunk(const unsigned int uiChunkIndex, const Chunk* cChunk) const
+{
+	if (vScratchSlot[uiChunkIndex] < 0)
+		vScratchSlot[uiChunkIndex] = (int)uiNumScratchChunks++;
+
+	cScratchFile.clear();
+	cScratchFile.seekp((streamoff)vScratchSlot[uiChunkIndex] * sizeof(cChunk->arrTile), ios::beg);
+	cScratchFile.write((const char*)cChunk->arrTile, sizeof(cChunk->arrTile));
+	cScratchFile.flush();
+	return cScratchFile.good();
+}
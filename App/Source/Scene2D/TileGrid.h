@@ -0,0 +1,157 @@
+/**
+ CTileGrid
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+using namespace std;
+
+// Stores the tile values of a level in square chunks of CHUNK_SIZE x CHUNK_SIZE tiles. Each chunk is one
+// contiguous array, so the tiles which are near each other on the map are near each other in memory, and
+// the tile values are kept apart from the A* data, which only the path finding uses.
+// By default, every chunk is kept in memory. After OpenChunkFile(), the chunks are instead loaded from the
+// file when they are first used, and the least recently used chunks outside the viewport are freed when more
+// than uiMaxResidentChunks are in memory, so a level of millions of tiles uses little memory. The chunk file
+// is only read; the changed chunks which are freed go into a scratch file until SaveChunkFile() is called.
+// Get() and Set() use the rows and columns of the viewport, which starts at the first tile of the level
+// until SetViewport() moves it.
+// This is not thread-safe; it must only be used on the main thread.
+class CTileGrid
+{
+public:
+	// The size of a chunk is 1 << CHUNK_SHIFT tiles along each side
+	static const unsigned int CHUNK_SHIFT = 5;
+	static const unsigned int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+	static const unsigned int CHUNK_MASK = CHUNK_SIZE - 1;
+	static const unsigned int CHUNK_TILES = CHUNK_SIZE * CHUNK_SIZE;
+
+	// Constructor
+	CTileGrid(void);
+	// Destructor
+	virtual ~CTileGrid(void);
+
+	// Initialise this grid with all its chunks in memory, and every tile set to 0
+	bool Init(const unsigned int uiNumRows, const unsigned int uiNumCols);
+	// Stream this grid from a chunk file, keeping at most uiMaxResidentChunks chunks in memory.
+	// The grid is not changed if the file cannot be opened or is smaller than uiMinRows x uiMinCols.
+	bool OpenChunkFile(	const string& filename,
+						const unsigned int uiMaxResidentChunks = 256,
+						const unsigned int uiMinRows = 0,
+						const unsigned int uiMinCols = 0);
+	// Write every chunk of this grid into a chunk file, replacing the file in one step
+	bool SaveChunkFile(const string& filename);
+
+	// Get the value of a tile. Row 0 is the first row of the viewport.
+	int Get(const unsigned int uiRow, const unsigned int uiCol) const
+	{
+		const unsigned int uiChunkIndex = GetChunkIndex(uiRow + uiViewportRow, uiCol + uiViewportCol);
+		Chunk* cChunk = vChunk[uiChunkIndex];
+		if (cChunk == NULL)
+			cChunk = LoadChunk(uiChunkIndex);
+		else if (bStreaming)
+			cChunk->uiLastUsed = ++uiUseCounter;
+		return cChunk->arrTile[(((uiRow + uiViewportRow) & CHUNK_MASK) << CHUNK_SHIFT) | ((uiCol + uiViewportCol) & CHUNK_MASK)];
+	}
+
+	// Set the value of a tile
+	void Set(const unsigned int uiRow, const unsigned int uiCol, const int iValue)
+	{
+		const unsigned int uiChunkIndex = GetChunkIndex(uiRow + uiViewportRow, uiCol + uiViewportCol);
+		Chunk* cChunk = vChunk[uiChunkIndex];
+		if (cChunk == NULL)
+			cChunk = LoadChunk(uiChunkIndex);
+		else if (bStreaming)
+			cChunk->uiLastUsed = ++uiUseCounter;
+		cChunk->arrTile[(((uiRow + uiViewportRow) & CHUNK_MASK) << CHUNK_SHIFT) | ((uiCol + uiViewportCol) & CHUNK_MASK)] = iValue;
+		cChunk->bDirty = true;
+	}
+
+	// Move the viewport, which is clamped to the level. When streaming, the chunks of the viewport and the
+	// chunks within uiMargin chunks of it are loaded now, and are the last to be freed.
+	// Returns true if the viewport has moved.
+	bool SetViewport(	const unsigned int uiFirstRow,
+						const unsigned int uiFirstCol,
+						const unsigned int uiNumRows,
+						const unsigned int uiNumCols,
+						const unsigned int uiMargin = 1);
+	// Get the first row of the viewport
+	unsigned int GetViewportRow(void) const;
+	// Get the first column of the viewport
+	unsigned int GetViewportCol(void) const;
+
+	// Get the number of rows
+	unsigned int GetNumRows(void) const;
+	// Get the number of columns
+	unsigned int GetNumCols(void) const;
+	// Check if the chunks are streamed from a chunk file
+	bool IsStreaming(void) const;
+	// Get the number of chunks in memory
+	unsigned int GetNumResidentChunks(void) const;
+	// Get the number of chunks which have been loaded from the chunk file or the scratch file
+	unsigned int GetNumChunkLoads(void) const;
+	// Get the number of changed chunks which are in the scratch file
+	unsigned int GetNumScratchChunks(void) const;
+
+protected:
+	// The tiles of a chunk, stored row by row
+	struct Chunk
+	{
+		int arrTile[CHUNK_TILES];
+		unsigned int uiLastUsed;
+		bool bDirty;
+	};
+
+	unsigned int uiNumRows;
+	unsigned int uiNumCols;
+	unsigned int uiNumChunkRows;
+	unsigned int uiNumChunkCols;
+
+	// The first tile of the viewport
+	unsigned int uiViewportRow;
+	unsigned int uiViewportCol;
+
+	// The chunks, or NULL if a chunk is not in memory. These are mutable because Get() loads chunks.
+	mutable vector<Chunk*> vChunk;
+	// The indices of the chunks which are in memory
+	mutable vector<unsigned int> vResident;
+	mutable unsigned int uiUseCounter;
+	mutable unsigned int uiNumChunkLoads;
+
+	// The chunk file, which is only read, when streaming
+	bool bStreaming;
+	string sFilename;
+	mutable ifstream cFile;
+	unsigned int uiMaxResidentChunks;
+
+	// The changed chunks which have been freed, and the slot of each chunk in it, or -1 if it is not in it
+	string sScratchFilename;
+	mutable fstream cScratchFile;
+	mutable vector<int> vScratchSlot;
+	mutable unsigned int uiNumScratchChunks;
+
+	// The chunks which are kept in memory, as a range of chunk rows and columns
+	unsigned int uiKeepChunkRow0, uiKeepChunkRow1;
+	unsigned int uiKeepChunkCol0, uiKeepChunkCol1;
+
+	// Free all chunks, and close the chunk file and delete the scratch file. Unsaved changes are lost.
+	void Clear(void);
+	// Get the index of the chunk of a tile of the level
+	unsigned int GetChunkIndex(const unsigned int uiRow, const unsigned int uiCol) const
+	{
+		return (uiRow >> CHUNK_SHIFT) * uiNumChunkCols + (uiCol >> CHUNK_SHIFT);
+	}
+	// Check if a chunk is in the keep region
+	bool IsKept(const unsigned int uiChunkIndex) const;
+	// Load a chunk, or create it, freeing another chunk if too many are in memory
+	Chunk* LoadChunk(const unsigned int uiChunkIndex) const;
+	// Write a chunk into the scratch file if it was changed, and free it
+	void EvictChunk(const unsigned int uiResidentIndex) const;
+	// Read a chunk from the scratch file if it is there, else from the chunk file
+	bool ReadChunk(const unsigned int uiChunkIndex, Chunk* cChunk) const;
+	// Write a chunk into its slot in the scratch file
+	bool WriteScratchChunk(const unsigned int uiChunkIndex, const Chunk* cChunk) const;
+};
@@ -0,0 +1,235 @@
+/**
+ CAIScheduler
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#include "AIScheduler.h"
+
+// Include CSettings
+#include "GameControl/Settings.h"
+
+// Include CLogger
+#include "System/Logger.h"
+
+#include <cmath>
+using namespace std;
+
+// Within fNearDistance, an NPC updates every frame
+const float CAIScheduler::fNearDistance = 40.0f;
+// Beyond fFarDistance, an NPC updates every dFarThinkInterval
+const float CAIScheduler::fFarDistance = 100.0f;
+const double CAIScheduler::dMidThinkInterval = 1.0 / 20.0;
+const double CAIScheduler::dFarThinkInterval = 1.0 / 5.0;
+const double CAIScheduler::dHiddenThinkScale = 2.0;
+const double CAIScheduler::dMaxThinkTime = 0.5;
+
+/**
+ @brief Constructor
+ */
+CAIScheduler::CAIScheduler(void)
+	: bEnabled(true)
+	, vec3CameraPosition(glm::vec3(0.0f))
+	, vec3CameraFront(glm::vec3(0.0f, 0.0f, -1.0f))
+	, fCosHalfFOV(-1.0f)
+	, uiMaxThinksPerFrame(16)
+	, uiNumStarted(0)
+	, uiNumThinks(0)
+	, uiNumBudgetThinks(0)
+	, uiNumDeferred(0)
+	, uiLastNumThinks(0)
+	, uiLastNumDeferred(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CAIScheduler::~CAIScheduler(void)
+{
+}
+
+/**
+ @brief Initialise this class instance
+ @return true if the initialisation is successful, else false
+ */
+bool CAIScheduler::Init(void)
+{
+	bEnabled = CSettings::GetInstance()->bUseAIScheduler;
+	uiNumStarted = 0;
+	uiNumThinks = 0;
+	uiNumBudgetThinks = 0;
+	uiNumDeferred = 0;
+	uiLastNumThinks = 0;
+	uiLastNumDeferred = 0;
+	return true;
+}
+
+/**
+ @brief Start a frame from the position and view of the camera
+ @param vec3CameraPosition A const glm::vec3& variable containing the position of the camera
+ @param vec3CameraFront A const glm::vec3& variable containing the front direction of the camera
+ @param fFOVY A const float variable containing the vertical field of view in degrees
+ @param fAspectRatio A const float variable containing the width divided by the height of the view
+ */
+void CAIScheduler::BeginFrame(	const glm::vec3& vec3CameraPosition,
+								const glm::vec3& vec3CameraFront,
+								const float fFOVY,
+								const float fAspectRatio)
+{
+	this->vec3CameraPosition = vec3CameraPosition;
+	this->vec3CameraFront = glm::normalize(vec3CameraFront);
+
+	// Use the angle to a corner of the view, so that a cone around the camera front contains the whole view
+	const float fTanHalfFOVY = tan(glm::radians(fFOVY) * 0.5f);
+	const float fTanHalfDiagonal = fTanHalfFOVY * sqrt(1.0f + fAspectRatio * fAspectRatio);
+	fCosHalfFOV = 1.0f / sqrt(1.0f + fTanHalfDiagonal * fTanHalfDiagonal);
+
+	uiNumThinks = 0;
+	uiNumBudgetThinks = 0;
+	uiNumDeferred = 0;
+}
+
+/**
+ @brief Decide if an NPC updates in this frame. The elapsed time is added to its think time, and if it updates,
+		dUpdateTime is set to the time to update it by, at most dMaxThinkTime, and that time is taken off its
+		think time. A long wait is thus caught up over the next updates instead of being lost.
+ @param fThinkTime A float& variable containing the seconds since the NPC was last updated
+ @param vec3Position A const glm::vec3& variable containing the position of the NPC
+ @param dElapsedTime A const double variable containing the elapsed time since the last frame
+ @param dUpdateTime A double& variable which is set to the time to update the NPC by
+ @return true if the NPC updates in this frame, else false
+ */
+bool CAIScheduler::Schedule(float& fThinkTime,
+							const glm::vec3& vec3Position,
+							const double dElapsedTime,
+							double& dUpdateTime)
+{
+	if (bEnabled == false)
+	{
+		fThinkTime = 0.0f;
+		dUpdateTime = dElapsedTime;
+		uiNumThinks++;
+		return true;
+	}
+
+	const glm::vec3 vec3ToNPC = vec3Position - vec3CameraPosition;
+	const float fDistance = glm::length(vec3ToNPC);
+
+	// A near NPC updates every frame and is not limited by the budget
+	double dThinkInterval = 0.0;
+	bool bNear = false;
+	if (fDistance < fNearDistance)
+		bNear = true;
+	else if (fDistance < fFarDistance)
+		dThinkInterval = dMidThinkInterval;
+	else
+		dThinkInterval = dFarThinkInterval;
+
+	// The stagger of a new NPC only spreads the mid and far updates, so a near NPC starts to update at once
+	if ((bNear == true) && (fThinkTime < 0.0f))
+		fThinkTime = 0.0f;
+	fThinkTime += (float)dElapsedTime;
+
+	// An NPC outside the view can wait longer
+	if ((bNear == false) && (glm::dot(vec3ToNPC, vec3CameraFront) < fCosHalfFOV * fDistance))
+		dThinkInterval *= dHiddenThinkScale;
+
+	// Wait until the think interval has passed. A new NPC starts with a negative think time.
+	if ((fThinkTime <= 0.0f) || (fThinkTime < dThinkInterval))
+		return false;
+
+	if (bNear == false)
+	{
+		// Keep the think time of an NPC which is over the budget, so that it updates by all of it later
+		if ((uiMaxThinksPerFrame > 0) && (uiNumBudgetThinks >= uiMaxThinksPerFrame))
+		{
+			uiNumDeferred++;
+			return false;
+		}
+		uiNumBudgetThinks++;
+	}
+
+	dUpdateTime = (fThinkTime < dMaxThinkTime) ? fThinkTime : dMaxThinkTime;
+	fThinkTime -= (float)dUpdateTime;
+	uiNumThinks++;
+	return true;
+}
+
+/**
+ @brief Finish a frame and record its statistics
+ */
+void CAIScheduler::EndFrame(void)
+{
+	uiLastNumThinks = uiNumThinks;
+	uiLastNumDeferred = uiNumDeferred;
+
+	LOG_DEBUG_EVERY(5.0, AI, "NPC updates in the last frame: %u (%u deferred)", uiLastNumThinks, uiLastNumDeferred);
+}
+
+/**
+ @brief Get the think time which a new NPC starts with. The new NPCs are spread over the far think interval,
+		so that a wave which is spawned together updates in different frames. Schedule() ignores this
+		delay while the NPC is near.
+ @return A float variable
+ */
+float CAIScheduler::GetStartThinkTime(void)
+{
+	const unsigned int uiNumPhases = 8;
+	const float fStartThinkTime = -(float)((uiNumStarted % uiNumPhases) * dFarThinkInterval / uiNumPhases);
+	uiNumStarted++;
+	return fStartThinkTime;
+}
+
+/**
+ @brief Set the maximum number of mid and far NPC updates per frame. 0 means no limit
+ @param uiMaxThinksPerFrame A const unsigned int variable containing the maximum number of updates
+ */
+void CAIScheduler::SetMaxThinksPerFrame(const unsigned int uiMaxThinksPerFrame)
+{
+	this->uiMaxThinksPerFrame = uiMaxThinksPerFrame;
+}
+
+/**
+ @brief Get the maximum number of mid and far NPC updates per frame
+ @return An unsigned int variable
+ */
+unsigned int CAIScheduler::GetMaxThinksPerFrame(void) const
+{
+	return uiMaxThinksPerFrame;
+}
+
+/**
+ @brief Enable or disable the scheduling. If disabled, every NPC updates every frame.
+ @param bEnabled A const bool variable which is true to enable the scheduling
+ */
+void CAIScheduler::SetEnabled(const bool bEnabled)
+{
+	this->bEnabled = bEnabled;
+}
+
+/**
+ @brief Check if the scheduling is enabled
+ @return A bool variable
+ */
+bool CAIScheduler::IsEnabled(void) const
+{
+	return bEnabled;
+}
+
+/**
+ @brief Get the number of NPC updates in the last frame
+ @return An unsigned int variable
+ */
+unsigned int CAIScheduler::GetNumThinks(void) const
+{
+	return uiLastNumThinks;
+}
+
+/**
+ @brief Get the number of NPCs which were due but over the budget in the last frame
+ @return An unsigned int variable
+ */
+unsigned int CAIScheduler::GetNumDeferred(void) const
+{
+	return uiLastNumDeferred;
+}
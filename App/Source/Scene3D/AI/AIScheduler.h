@@ -0,0 +1,98 @@
+/**
+ CAIScheduler
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns/SingletonTemplate.h"
+
+// Include GLM
+#include <includes/glm.hpp>
+#include <includes/gtc/matrix_transform.hpp>
+#include <includes/gtc/type_ptr.hpp>
+
+// Decides which NPCs update their AI in each frame. An NPC near the camera updates every frame, while
+// an NPC further away, or outside the view, waits for a longer think interval and is then updated once
+// with all the time which has passed since its last update, up to dMaxThinkTime at a time. The NPCs which are
+// not near the camera share a budget of updates per frame; an NPC which is over the budget keeps its time and
+// updates in a later frame. New NPCs which are not near start at staggered times, so that a wave which is
+// spawned together does not update together.
+class CAIScheduler : public CSingletonTemplate<CAIScheduler>
+{
+	friend CSingletonTemplate<CAIScheduler>;
+
+public:
+	// The distances from the camera which separate the near, mid and far NPCs
+	static const float fNearDistance;
+	static const float fFarDistance;
+	// The think intervals of the mid and far NPCs, in seconds
+	static const double dMidThinkInterval;
+	static const double dFarThinkInterval;
+	// The think interval of an NPC outside the view is multiplied by this
+	static const double dHiddenThinkScale;
+	// The most time an NPC is updated by at once, so that a long wait does not make it jump.
+	// The rest of the wait is kept and used by the next updates.
+	static const double dMaxThinkTime;
+
+	// Initialise this class instance
+	bool Init(void);
+
+	// Start a frame from the position and view of the camera
+	void BeginFrame(const glm::vec3& vec3CameraPosition,
+					const glm::vec3& vec3CameraFront,
+					const float fFOVY,
+					const float fAspectRatio);
+	// Decide if an NPC updates in this frame
+	bool Schedule(	float& fThinkTime,
+					const glm::vec3& vec3Position,
+					const double dElapsedTime,
+					double& dUpdateTime);
+	// Finish a frame and record its statistics
+	void EndFrame(void);
+
+	// Get the think time which a new NPC starts with, so that new NPCs are staggered
+	float GetStartThinkTime(void);
+
+	// Set the maximum number of mid and far NPC updates per frame. 0 means no limit
+	void SetMaxThinksPerFrame(const unsigned int uiMaxThinksPerFrame);
+	// Get the maximum number of mid and far NPC updates per frame
+	unsigned int GetMaxThinksPerFrame(void) const;
+
+	// Enable or disable the scheduling. If disabled, every NPC updates every frame.
+	void SetEnabled(const bool bEnabled);
+	// Check if the scheduling is enabled
+	bool IsEnabled(void) const;
+
+	// Get the number of NPC updates in the last frame
+	unsigned int GetNumThinks(void) const;
+	// Get the number of NPCs which were due but over the budget in the last frame
+	unsigned int GetNumDeferred(void) const;
+
+protected:
+	bool bEnabled;
+
+	// The camera of the current frame
+	glm::vec3 vec3CameraPosition;
+	glm::vec3 vec3CameraFront;
+	// The cosine of the angle between the camera front and the edge of the view
+	float fCosHalfFOV;
+
+	// The maximum number of mid and far NPC updates per frame
+	unsigned int uiMaxThinksPerFrame;
+	// The number of NPCs which have been given a start think time
+	unsigned int uiNumStarted;
+
+	// The statistics of the current and the last frame
+	unsigned int uiNumThinks;
+	unsigned int uiNumBudgetThinks;
+	unsigned int uiNumDeferred;
+	unsigned int uiLastNumThinks;
+	unsigned int uiLastNumDeferred;
+
+	// Constructor
+	CAIScheduler(void);
+	// Destructor
+	virtual ~CAIScheduler(void);
+};
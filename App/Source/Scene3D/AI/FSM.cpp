@@ -13,7 +13,7 @@ using namespace std;
  */
 CFSM::CFSM(void)
 	: sCurrentFSM(FSM::IDLE)
-	, iFSMCounter(0)
+	, dFSMTime(0.0)
 {
 }
 
@@ -64,5 +64,5 @@ void CFSM::PrintSelf(void) const
 		cout << "sCurrentFSM is Undefined." << endl;
 		break;
 	}
-	cout << "iFSMCounter = " << iFSMCounter << "/" << iMaxFSMCounter << endl;
+	cout << "dFSMTime = " << dFSMTime << "/" << dMaxFSMTime << endl;
 }
@@ -35,10 +35,12 @@ protected:
 	// Current FSM
 	FSM sCurrentFSM;
 
-	// FSM counter - count how many frames it has been in this FSM
-	int iFSMCounter;
+	// FSM time - how many seconds it has been in this FSM.
+	// This is time-based instead of counting frames, so the transitions do not change when the
+	// CAIScheduler updates an entity less often with a larger dElapsedTime.
+	double dFSMTime;
 
-	// Max count in a state
-	const int iMaxFSMCounter = 60;
+	// Max time in a state, which was 60 frames at 60 FPS
+	const double dMaxFSMTime = 1.0;
 };
 
@@ -17,6 +17,12 @@
 // Include CPlayer3D
 #include "../Entities/Player3D.h"
 
+// Include CLODManager
+#include "Primitives/LODManager.h"
+
+// Include CIndirectDrawBuffer
+#include "RenderControl/IndirectDrawBuffer.h"
+
 #include <iostream>
 using namespace std;
 
@@ -25,8 +31,9 @@ using namespace std;
  */
 CBuilding::CBuilding(void)
 {
+	iMeshID = -1;
 	// Set the default position to the origin
-	vec3Position = glm::vec3(0.0f, fHeightOffset, 0.0f);
+	SetPosition(glm::vec3(0.0f, fHeightOffset, 0.0f));
 }
 
 /**
@@ -37,7 +44,8 @@ CBuilding::CBuilding(void)
 CBuilding::CBuilding(	const glm::vec3 vec3Position,
 								const glm::vec3 vec3Front)
 {
-	this->vec3Position = glm::vec3(vec3Position.x, vec3Position.y + fHeightOffset, vec3Position.z);
+	iMeshID = -1;
+	SetPosition(glm::vec3(vec3Position.x, vec3Position.y + fHeightOffset, vec3Position.z));
 	this->vec3Front = vec3Front;
 }
 
@@ -46,6 +54,9 @@ CBuilding::CBuilding(	const glm::vec3 vec3Position,
  */
 CBuilding::~CBuilding(void)
 {
+	// Do not create the CLODManager again if it has already been destroyed
+	if (CLODManager::HasInstance())
+		CLODManager::GetInstance()->Erase(this);
 }
 
 /**
@@ -60,6 +71,8 @@ bool CBuilding::Init(void)
 	// Set the type
 	SetType(CEntity3D::TYPE::STRUCTURE);
 
+	// The round hangar has an arched roof, so its occluder box is kept well inside it
+	SetOccluderScale(0.7f);
 
 	switch (buildingType)
 	{
@@ -74,6 +87,10 @@ bool CBuilding::Init(void)
 		break;
 	}
 
+	// The level of details is selected by CLODManager for each render pass
+	if (m_bLODStatus)
+		CLODManager::GetInstance()->Add(this, this);
+
 	return true;
 }
 
@@ -84,7 +101,7 @@ void CBuilding::HangerRound()
 	{
 		if (LoadModelAndTexture("Models/Buildings/HangerRound.obj",
 			"Image/brick_high.png",
-			VAO, iTextureID, iIndicesSize) == false)
+			VAO, iTextureID, iIndicesSize, iMeshID) == false)
 		{
 			cout << "Unable to load model and texture" << endl;
 		}
@@ -93,19 +110,19 @@ void CBuilding::HangerRound()
 	{
 		if (LoadModelAndTexture("Models/Buildings/HangerRound.obj",
 			"Image/brick_high.png",
-			arrVAO[0], arriTextureID[0], arrIndicesSize[0]) == false)
+			arrVAO[0], arriTextureID[0], arrIndicesSize[0], arriMeshID[0]) == false)
 		{
 			cout << "Unable to load high LOD model and texture" << endl;
 		}
 		if (LoadModelAndTexture("Models/Buildings/HangerRound.obj",
 			"Image/brick_medium.png",
-			arrVAO[1], arriTextureID[1], arrIndicesSize[1]) == false)
+			arrVAO[1], arriTextureID[1], arrIndicesSize[1], arriMeshID[1]) == false)
 		{
 			cout << "Unable to load mid LOD model and texture" << endl;
 		}
 		if (LoadModelAndTexture("Models/Buildings/HangerRound.obj",
 			"Image/brick_low.png",
-			arrVAO[2], arriTextureID[2], arrIndicesSize[2]) == false)
+			arrVAO[2], arriTextureID[2], arrIndicesSize[2], arriMeshID[2]) == false)
 		{
 			cout << "Unable to load low LOD model and texture" << endl;
 		}
@@ -118,7 +135,7 @@ void CBuilding::HangerA()
 	{
 		if (LoadModelAndTexture("Models/Buildings/HangerA.obj",
 			"Image/stonebrick_high.png",
-			VAO, iTextureID, iIndicesSize) == false)
+			VAO, iTextureID, iIndicesSize, iMeshID) == false)
 		{
 			cout << "Unable to load model and texture" << endl;
 		}
@@ -127,19 +144,19 @@ void CBuilding::HangerA()
 	{
 		if (LoadModelAndTexture("Models/Buildings/HangerA.obj",
 			"Image/stonebrick_high.png",
-			arrVAO[0], arriTextureID[0], arrIndicesSize[0]) == false)
+			arrVAO[0], arriTextureID[0], arrIndicesSize[0], arriMeshID[0]) == false)
 		{
 			cout << "Unable to load high LOD model and texture" << endl;
 		}
 		if (LoadModelAndTexture("Models/Buildings/HangerA.obj",
 			"Image/stonebrick_medium.png",
-			arrVAO[1], arriTextureID[1], arrIndicesSize[1]) == false)
+			arrVAO[1], arriTextureID[1], arrIndicesSize[1], arriMeshID[1]) == false)
 		{
 			cout << "Unable to load mid LOD model and texture" << endl;
 		}
 		if (LoadModelAndTexture("Models/Buildings/HangerA.obj",
 			"Image/stonebrick_low.png",
-			arrVAO[2], arriTextureID[2], arrIndicesSize[2]) == false)
+			arrVAO[2], arriTextureID[2], arrIndicesSize[2], arriMeshID[2]) == false)
 		{
 			cout << "Unable to load low LOD model and texture" << endl;
 		}
@@ -153,13 +170,15 @@ void CBuilding::HangerA()
  @param VAO A GLuint& variable containing the VAO to be returned
  @param iTextureID A GLuint& variable containing the iTextureID to be returned
  @param iIndicesSize A GLuint& variable containing the iIndicesSize to be returned
+ @param iMeshID A int& variable containing the mesh ID in the CIndirectDrawBuffer to be returned
  @return A bool variable
  */
 bool CBuilding::LoadModelAndTexture(const char* filenameModel,
 										const char* filenameTexture,
 										GLuint& VAO,
 										GLuint& iTextureID,
-										GLuint& iIndicesSize)
+										GLuint& iIndicesSize,
+										int& iMeshID)
 {
 	std::vector<glm::vec3> vertices;
 	std::vector<glm::vec2> uvs;
@@ -175,8 +194,14 @@ bool CBuilding::LoadModelAndTexture(const char* filenameModel,
 		return false;
 	}
 
+	// Keep the bounding box of the model for the occlusion culling
+	ExpandModelBox(vertices);
+
 	CLoadOBJ::IndexVBO(vertices, uvs, normals, index_buffer_data, vertex_buffer_data);
 
+	// Add the mesh to the CIndirectDrawBuffer, which shares it among the instances using the same model
+	iMeshID = CIndirectDrawBuffer::GetInstance()->AddMesh(file_path, vertex_buffer_data, index_buffer_data);
+
 	glGenVertexArrays(1, &VAO);
 	glBindVertexArray(VAO);
 	glGenBuffers(1, &VBO);
@@ -241,19 +266,8 @@ bool CBuilding::Update(const double dElapsedTime)
 {
 	CSolidObject::Update(dElapsedTime);
 
-	if (m_bLODStatus)
-	{
-		float fDistanceToPlayer = glm::distance(vec3Position, CPlayer3D::GetInstance()->GetPosition());
-		if (fDistanceToPlayer > arrLODDistance[LOW_DETAILS])
-			eDetailLevel = LOW_DETAILS;
-		else if (fDistanceToPlayer > arrLODDistance[MID_DETAILS])
-			eDetailLevel = MID_DETAILS;
-		else
-			eDetailLevel = HIGH_DETAILS;
-	}
-
-	float fDistanceToPlayer = glm::distance(vec3Position, CPlayer3D::GetInstance()->GetPosition());
-	if (fDistanceToPlayer < 10 && CPlayer3D::GetInstance()->GetHealth() < CPlayer3D::GetInstance()->GetMaxHealth())
+	const glm::vec3 vec3ToPlayer = CPlayer3D::GetInstance()->GetPosition() - GetPosition();
+	if (glm::dot(vec3ToPlayer, vec3ToPlayer) < 10.0f * 10.0f && CPlayer3D::GetInstance()->GetHealth() < CPlayer3D::GetInstance()->GetMaxHealth())
 	{
 		CPlayer3D::GetInstance()->isHealing = true;
 	}
@@ -276,10 +290,6 @@ void CBuilding::Render(void)
 {
 	if (m_bLODStatus == false)
 	{
-		// note: currently we set the projection matrix each frame, but since the projection 
-		// matrix rarely changes it's often best practice to set it outside the main loop only once.
-		CShaderManager::GetInstance()->activeShader->setMat4("projection", projection);
-		CShaderManager::GetInstance()->activeShader->setMat4("view", view);
 		CShaderManager::GetInstance()->activeShader->setMat4("model", model);
 
 		// bind textures on corresponding texture units
@@ -293,10 +303,6 @@ void CBuilding::Render(void)
 	}
 	else
 	{
-		// note: currently we set the projection matrix each frame, but since the projection 
-		// matrix rarely changes it's often best practice to set it outside the main loop only once.
-		CShaderManager::GetInstance()->activeShader->setMat4("projection", projection);
-		CShaderManager::GetInstance()->activeShader->setMat4("view", view);
 		CShaderManager::GetInstance()->activeShader->setMat4("model", model);
 
 		// bind textures on corresponding texture units
@@ -318,6 +324,17 @@ void CBuilding::PostRender(void)
 	CSolidObject::PostRender();
 }
 
+/**
+ @brief Submit this instance to the CIndirectDrawBuffer instead of rendering it in Render()
+ @return true if this instance was submitted, else false
+ */
+bool CBuilding::SubmitDraw(void)
+{
+	if (m_bLODStatus == false)
+		return CIndirectDrawBuffer::GetInstance()->Submit(iMeshID, iTextureID, model);
+	return CIndirectDrawBuffer::GetInstance()->Submit(arriMeshID[eDetailLevel], arriTextureID[eDetailLevel], model);
+}
+
 /**
  @brief Print Self
  */
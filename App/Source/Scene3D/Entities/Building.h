@@ -50,7 +50,8 @@ public:
 								const char* filenameTexture, 
 								GLuint& VAO, 
 								GLuint& iTextureID,
-								GLuint& iIndicesSize);
+								GLuint& iIndicesSize,
+								int& iMeshID);
 
 	// Set model
 	virtual void SetModel(const glm::mat4 model);
@@ -69,6 +70,9 @@ public:
 	// PostRender
 	virtual void PostRender(void);
 
+	// Submit this instance to the CIndirectDrawBuffer instead of rendering it in Render()
+	virtual bool SubmitDraw(void);
+
 	// Print Self
 	virtual void PrintSelf(void);
 
@@ -76,4 +80,8 @@ public:
 	void HangerA();
 
 	BUILDING_TYPE buildingType;
+
+protected:
+	// The mesh ID in the CIndirectDrawBuffer when the LOD is disabled
+	int iMeshID;
 };
@@ -22,6 +22,9 @@
 #include "../../MyMath.h"
 
 #include <iostream>
+
+// Include CLogger
+#include "System/Logger.h"
 using namespace std;
 
 /**
@@ -46,7 +49,7 @@ CCar3D::CCar3D(void)
 	, thirdPersonView(true)
 {
 	// Set the default position so it is above the ground
-	vec3Position = glm::vec3(0.0f, 0.5f, 0.0f);
+	SetPosition(glm::vec3(0.0f, 0.5f, 0.0f));
 }
 
 /**
@@ -79,7 +82,7 @@ CCar3D::CCar3D(	const glm::vec3 vec3Position,
 {
 	mesh = NULL;
 
-	this->vec3Position = vec3Position;
+	SetPosition(vec3Position);
 	this->vec3Front = vec3Front;
 	this->fYaw = fYaw;
 	this->fPitch = fPitch;
@@ -129,6 +132,9 @@ bool CCar3D::Init(void)
 		return false;
 	}
 
+	// Keep the bounding box of the model for the occlusion culling
+	ExpandModelBox(vertices);
+
 	CLoadOBJ::IndexVBO(vertices, uvs, normals, index_buffer_data, vertex_buffer_data);
 
 	glGenVertexArrays(1, &VAO);
@@ -158,7 +164,9 @@ bool CCar3D::Init(void)
 	// Store the handler to the CTerrain
 	cTerrain = CTerrain::GetInstance();
 	// Update the y-axis position of the player
-	vec3Position.y = cTerrain->GetHeight(vec3Position.x, vec3Position.z);
+	glm::vec3 vec3NewPosition = GetPosition();
+	vec3NewPosition.y = cTerrain->GetHeight(vec3NewPosition.x, vec3NewPosition.z);
+	SetPosition(vec3NewPosition);
 
 	// Set the Physics to fall status by default
 	cPhysics3D.SetStatus(CPhysics3D::STATUS::IDLE);
@@ -201,7 +209,7 @@ void CCar3D::SetProjection(const glm::mat4 projection)
 */
 glm::mat4 CCar3D::GetViewMatrix(void) const
 {
-	return glm::lookAt(vec3Position, vec3Position + vec3Front, vec3Up);
+	return glm::lookAt(GetPosition(), GetPosition() + vec3Front, vec3Up);
 }
 
 CPhysics3D CCar3D::GetPhysics()
@@ -257,16 +265,16 @@ void CCar3D::ProcessMovement(double dElapsedTime)
 		velocity = glm::normalize(velocity) * 0.5f;
 
 	//predict the next pos
-	glm::vec3 predictedPos = vec3Position;
+	glm::vec3 predictedPos = GetPosition();
 	predictedPos += velocity;
 
 	//Find the tilt angle for the car
-	float fCheckHeight = cTerrain->GetHeight(predictedPos.x, predictedPos.z) + fHeightOffset - vec3Position.y;
-	float xzAxis = glm::length(glm::vec2(vec3Position.x, vec3Position.z) - glm::vec2(predictedPos.x, predictedPos.z));
+	float fCheckHeight = cTerrain->GetHeight(predictedPos.x, predictedPos.z) + fHeightOffset - GetPosition().y;
+	float xzAxis = glm::length(glm::vec2(GetPosition().x, GetPosition().z) - glm::vec2(predictedPos.x, predictedPos.z));
 	tiltAngle = glm::degrees(atan2f(fCheckHeight, xzAxis));
 
 	//set the current pos to the predicted pos
-	vec3Position = predictedPos;
+	SetPosition(predictedPos);
 }
 
 CPlayer3D* CCar3D::GetPlayer3D()
@@ -299,7 +307,7 @@ bool CCar3D::Update(const double dElapsedTime)
 	if (!cPlayer3D)
 	{
 		ProcessMovement(dElapsedTime);
-		if (glm::distance(vec3Position, CPlayer3D::GetInstance()->GetPosition()) < 5)
+		if (glm::distance(GetPosition(), CPlayer3D::GetInstance()->GetPosition()) < 5)
 		{
 			if (CKeyboardController::GetInstance()->IsKeyPressed(GLFW_KEY_E))
 			{
@@ -312,29 +320,31 @@ bool CCar3D::Update(const double dElapsedTime)
 	}
 	else
 	{
-		cout << "SPEED: " << currSpeed << std::endl;
-		if (!bStatus) {
-			cPlayer3D->SetPosition(vec3Position + vec3Right * 2.f);
+		LOG_TRACE_EVERY(0.5, PHYSICS, "Car speed: %.3f", currSpeed);
+		if (!GetStatus()) {
+			cPlayer3D->SetPosition(GetPosition() + vec3Right * 2.f);
 			cPlayer3D->isDriving = false;
 			cPlayer3D->SetVehicleWeapon(nullptr);
 			cPlayer3D = NULL;
 			cCamera = NULL;
 			return true;
 		}
-		cPlayer3D->SetPosition(vec3Position);
+		cPlayer3D->SetPosition(GetPosition());
 		StorePositionForRollback();
 		ProcessMovement(dElapsedTime);
 
-		vec3Position += vec3Vel * (float)dElapsedTime;
+		glm::vec3 vec3Velocity = GetVel();
+		SetPosition(GetPosition() + vec3Velocity * (float)dElapsedTime);
 
-		float frictionX = vec3Vel.x * -1.f;
-		vec3Vel.x += frictionX * (float)dElapsedTime;
+		float frictionX = vec3Velocity.x * -1.f;
+		vec3Velocity.x += frictionX * (float)dElapsedTime;
 
-		float frictionY = vec3Vel.y * -1.f;
-		vec3Vel.y += frictionY * (float)dElapsedTime;
+		float frictionY = vec3Velocity.y * -1.f;
+		vec3Velocity.y += frictionY * (float)dElapsedTime;
 
-		float frictionZ = vec3Vel.z * -1.f;
-		vec3Vel.z += frictionZ * (float)dElapsedTime;
+		float frictionZ = vec3Velocity.z * -1.f;
+		vec3Velocity.z += frictionZ * (float)dElapsedTime;
+		SetVel(vec3Velocity);
 
 		if (!cPlayer3D)
 			return false;
@@ -345,7 +355,7 @@ bool CCar3D::Update(const double dElapsedTime)
 			{
 				if (CMouseController::GetInstance()->IsButtonDown(CMouseController::BUTTON_TYPE::LMB))
 				{
-					bool fired = cWeapon->Discharge(vec3Position + glm::vec3(0, vec3Scale.y * 0.75f, 0), vec3Front, (CSolidObject*)this);
+					bool fired = cWeapon->Discharge(GetPosition() + glm::vec3(0, vec3Scale.y * 0.75f, 0), vec3Front, (CSolidObject*)this);
 
 					//if (fired) //if first bullet is fired, apply recoil
 					//	cPlayer3D->ApplyRecoil(cWeapon);
@@ -355,7 +365,7 @@ bool CCar3D::Update(const double dElapsedTime)
 			{
 				if (CMouseController::GetInstance()->IsButtonPressed(CMouseController::BUTTON_TYPE::LMB))
 				{
-					bool fired = cWeapon->Discharge(vec3Position + glm::vec3(0, vec3Scale.y * 0.75f, 0), vec3Front, (CSolidObject*)this);
+					bool fired = cWeapon->Discharge(GetPosition() + glm::vec3(0, vec3Scale.y * 0.75f, 0), vec3Front, (CSolidObject*)this);
 
 					//if (fired) //if first bullet is fired, apply recoil
 					//	cPlayer3D->ApplyRecoil(cWeapon);
@@ -374,7 +384,7 @@ bool CCar3D::Update(const double dElapsedTime)
 		glm::vec3 camOffset = vec3Up * 2.f + vec3Front * -5.f;
 		if (!thirdPersonView)
 			camOffset = vec3Up * 0.1f;
-		cCamera->vec3Position = vec3Position + camOffset;
+		cCamera->vec3Position = GetPosition() + camOffset;
 		cCamera->vec3Front = vec3Front;
 		cCamera->vec3Up = vec3Up;
 		cCamera->vec3Right = vec3Right;
@@ -403,7 +413,7 @@ void CCar3D::PreRender(void)
  */
 void CCar3D::Render(void)
 {
-	if (!bStatus)
+	if (!GetStatus())
 		return;
 	model = glm::rotate(model, glm::radians(torque / 2), glm::vec3(0, 1, 0));
 	model = glm::rotate(model, glm::radians(tiltAngle), glm::vec3(1, 0, 0));
@@ -423,21 +433,23 @@ void CCar3D::PostRender(void)
  */
 void CCar3D::Constraint(void)
 {
+	glm::vec3 vec3NewPosition = GetPosition();
 	// If the player is not jumping nor falling, then we snap his position to the terrain
 	if (cPhysics3D.GetStatus() == CPhysics3D::STATUS::IDLE)
 	{
-		vec3Position.y = cTerrain->GetHeight(vec3Position.x, vec3Position.z) + fHeightOffset;
+		vec3NewPosition.y = cTerrain->GetHeight(vec3NewPosition.x, vec3NewPosition.z) + fHeightOffset;
 	}
 	else
 	{
 		// If the player is jumping nor falling, then we only snap his position 
 		// if the player's y-coordinate is below the cTerrain 
-		float fCheckHeight = cTerrain->GetHeight(vec3Position.x, vec3Position.z) + fHeightOffset;
+		float fCheckHeight = cTerrain->GetHeight(vec3NewPosition.x, vec3NewPosition.z) + fHeightOffset;
 
 		// If the player is below the terrain, then snap to the terrain height
-		if (fCheckHeight > vec3Position.y)
-			vec3Position.y = fCheckHeight;
+		if (fCheckHeight > vec3NewPosition.y)
+			vec3NewPosition.y = fCheckHeight;
 	}
+	SetPosition(vec3NewPosition);
 }
 
 
@@ -446,7 +458,7 @@ void CCar3D::ProcessCarInputs(double dElapsedTime)
 	//exit car
 	if (CKeyboardController::GetInstance()->IsKeyPressed(GLFW_KEY_E))
 	{
-		cPlayer3D->SetPosition(vec3Position + vec3Right * 2.f);
+		cPlayer3D->SetPosition(GetPosition() + vec3Right * 2.f);
 		cPlayer3D->isDriving = false;
 		cPlayer3D->SetVehicleWeapon(nullptr);
 		cPlayer3D = NULL;
@@ -0,0 +1,46 @@
+/**
+ CollisionContact
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include Entity3D
+#include <Primitives/Entity3D.h>
+
+// Include EntityHandle
+#include "EntityStore.h"
+
+// Include GLM
+#include <includes/glm.hpp>
+#include <includes/gtc/matrix_transform.hpp>
+#include <includes/gtc/type_ptr.hpp>
+
+// A contact found by the collision detection pass of CSolidObjectManager.
+// The response to it is run later, in a separate pass, so that every contact of a frame is found.
+struct CollisionContact
+{
+	static const unsigned int NO_PROJECTILE = 0xFFFFFFFF;
+
+	// The 2 entities in contact. hOther is null if the other side is a projectile
+	EntityHandle hEntity;
+	EntityHandle hOther;
+	// The pair type, which selects the response in the dispatch table
+	CEntity3D::TYPE eType;
+	CEntity3D::TYPE eOtherType;
+	// The index of the projectile in CProjectileManager, if eOtherType is PROJECTILE
+	unsigned int uiProjectile;
+	// The axis along which hEntity should move to separate from the other side
+	glm::vec3 vec3Normal;
+	// The distance which hEntity has to move along vec3Normal
+	float fPenetration;
+
+	CollisionContact(void)
+		: eType(CEntity3D::TYPE::OTHERS)
+		, eOtherType(CEntity3D::TYPE::OTHERS)
+		, uiProjectile(NO_PROJECTILE)
+		, vec3Normal(0.0f)
+		, fPenetration(0.0f)
+	{
+	}
+};
@@ -21,10 +21,10 @@
 #include "SolidObjectManager.h"
 
 #include <iostream>
-using namespace std;
 
-// Set this to true if printing the debug info
-#define _DEBUG_FSM false
+// Include CLogger
+#include "System/Logger.h"
+using namespace std;
 
 /**
  @brief Default Constructor
@@ -42,9 +42,10 @@ CEnemy3D::CEnemy3D(void)
 	, iCurrentWeapon(0)
 	, cPlayer3D(NULL)
 	, cTerrain(NULL)
+	, cWaypointManager(NULL)
 {
 	// Set the default position to the origin
-	vec3Position = glm::vec3(0.0f, +fHeightOffset, 0.0f);
+	SetPosition(glm::vec3(0.0f, +fHeightOffset, 0.0f));
 
 	// Update the vectors for this enemy
 	UpdateEnemyVectors();
@@ -73,9 +74,9 @@ CEnemy3D::CEnemy3D(	const glm::vec3 vec3Position,
 	, iCurrentWeapon(0)
 	, cPlayer3D(NULL)
 	, cTerrain(NULL)
+	, cWaypointManager(NULL)
 {
-	this->vec3Position = vec3Position;
-	this->vec3Position.y += +fHeightOffset;
+	SetPosition(vec3Position + glm::vec3(0.0f, fHeightOffset, 0.0f));
 	this->vec3Front = vec3Front;
 	this->fYaw = fYaw;
 	this->fPitch = fPitch;
@@ -91,10 +92,23 @@ CEnemy3D::~CEnemy3D(void)
 {
 	if (cWaypointManager)
 	{
-		// We set it to NULL only since it was declared somewhere else
+		// Delete the cWaypointManager which was created in Init(), which returns it to its CObjectPool
+		delete cWaypointManager;
 		cWaypointManager = NULL;
 	}
 
+	// Delete the weapons which were assigned to this enemy when it was spawned
+	if (cPrimaryWeapon)
+	{
+		delete cPrimaryWeapon;
+		cPrimaryWeapon = NULL;
+	}
+	if (cSecondaryWeapon)
+	{
+		delete cSecondaryWeapon;
+		cSecondaryWeapon = NULL;
+	}
+
 	if (cTerrain)
 	{
 		// We set it to NULL only since it was declared somewhere else
@@ -117,6 +131,36 @@ CEnemy3D::~CEnemy3D(void)
 	glDeleteVertexArrays(1, &VAO);
 }
 
+/**
+ @brief Allocate an instance of this class from its CObjectPool
+ @param uiSize A size_t variable containing the size of the instance
+ @return A void* variable
+ */
+void* CEnemy3D::operator new(size_t uiSize)
+{
+	return GetPool().Allocate(uiSize);
+}
+
+/**
+ @brief Return the memory of an instance of this class to its CObjectPool
+ @param p A void* variable containing the memory of the instance
+ @param uiSize A size_t variable containing the size of the instance
+ */
+void CEnemy3D::operator delete(void* p, size_t uiSize)
+{
+	GetPool().Free(p, uiSize);
+}
+
+/**
+ @brief Get the CObjectPool which the instances of this class are allocated from
+ @return A CObjectPool<CEnemy3D>& variable
+ */
+CObjectPool<CEnemy3D>& CEnemy3D::GetPool(void)
+{
+	static CObjectPool<CEnemy3D> cPool;
+	return cPool;
+}
+
 /**
  @brief Initialise this class instance
  @return true is successfully initialised this class instance, else false
@@ -147,6 +191,9 @@ bool CEnemy3D::Init(void)
 		return false;
 	}
 
+	// Keep the bounding box of the model for the occlusion culling
+	ExpandModelBox(vertices);
+
 	CLoadOBJ::IndexVBO(vertices, uvs, normals, index_buffer_data, vertex_buffer_data);
 
 	glGenVertexArrays(1, &VAO);
@@ -198,10 +245,11 @@ bool CEnemy3D::Init(void)
 	fCheckHeight = cTerrain->GetHeight(-20.0f, -30.0f);
 	m_iWayPointID = cWaypointManager->AddWaypoint(m_iWayPointID, glm::vec3(-30.0f, fCheckHeight, 0.0f));
 
-	cWaypointManager->PrintSelf();
+	if (CLogger::IsEnabled(CLogger::AI, CLogger::LEVEL_TRACE))
+		cWaypointManager->PrintSelf();
 
 	// Let the NPC face the nearest waypoint
-	vec3Front = glm::normalize((cWaypointManager->GetNearestWaypoint(vec3Position)->GetPosition() - vec3Position));
+	vec3Front = glm::normalize((cWaypointManager->GetNearestWaypoint(GetPosition())->GetPosition() - GetPosition()));
 	UpdateFrontAndYaw();
 
 	return true;
@@ -247,7 +295,7 @@ void CEnemy3D::AttachCamera(CCamera* cCamera)
 	// Update the camera's attributes with the player's attributes
 	if (cCamera)
 	{
-		cCamera->vec3Position = vec3Position;
+		cCamera->vec3Position = GetPosition();
 		cCamera->vec3Front = vec3Front;
 	}
 }
@@ -307,11 +355,11 @@ bool CEnemy3D::DischargeWeapon(void) const
 {
 	if ((iCurrentWeapon == 0) && (cPrimaryWeapon))
 	{
-		return cPrimaryWeapon->Discharge(vec3Position, vec3Front, (CSolidObject*)this);
+		return cPrimaryWeapon->Discharge(GetPosition(), vec3Front, (CSolidObject*)this);
 	}
 	else if ((iCurrentWeapon == 1) && (cSecondaryWeapon))
 	{
-		return cSecondaryWeapon->Discharge(vec3Position, vec3Front, (CSolidObject*)this);
+		return cSecondaryWeapon->Discharge(GetPosition(), vec3Front, (CSolidObject*)this);
 	}
 	//return NULL;
 }
@@ -325,18 +373,18 @@ void CEnemy3D::ProcessMovement(const ENEMYMOVEMENT direction, const float deltaT
 {
 	float velocity = fMovementSpeed* deltaTime;
 	if (direction == ENEMYMOVEMENT::FORWARD)
-		vec3Position += vec3Front * velocity;
+		SetPosition(GetPosition() + vec3Front * velocity);
 	if (direction == ENEMYMOVEMENT::BACKWARD)
-		vec3Position -= vec3Front * velocity;
+		SetPosition(GetPosition() - vec3Front * velocity);
 	if (direction == ENEMYMOVEMENT::LEFT)
-		vec3Position -= vec3Right * velocity;
+		SetPosition(GetPosition() - vec3Right * velocity);
 	if (direction == ENEMYMOVEMENT::RIGHT)
-		vec3Position += vec3Right * velocity;
+		SetPosition(GetPosition() + vec3Right * velocity);
 
 	// If the camera is attached to this player, then update the camera
 	if (cCamera)
 	{
-		cCamera->vec3Position = vec3Position;
+		cCamera->vec3Position = GetPosition();
 	}
 
 	// Constraint the player's position
@@ -364,7 +412,7 @@ void CEnemy3D::ProcessRotate(const float fXOffset)
 bool CEnemy3D::Update(const double dElapsedTime)
 {
 	// Don't update if this entity is not active
-	if (bStatus == false)
+	if (GetStatus() == false)
 	{
 		return false;
 	}
@@ -372,66 +420,63 @@ bool CEnemy3D::Update(const double dElapsedTime)
 	// Store the enemy's current position, if rollback is needed.
 	StorePositionForRollback();
 
-	vec3Position += vec3Vel * (float)dElapsedTime;
+	glm::vec3 vec3Velocity = GetVel();
+	SetPosition(GetPosition() + vec3Velocity * (float)dElapsedTime);
 
-	float frictionX = vec3Vel.x * -1.f;
-	vec3Vel.x += frictionX * (float)dElapsedTime;
+	float frictionX = vec3Velocity.x * -1.f;
+	vec3Velocity.x += frictionX * (float)dElapsedTime;
 
-	float frictionY = vec3Vel.y * -1.f;
-	vec3Vel.y += frictionY * (float)dElapsedTime;
+	float frictionY = vec3Velocity.y * -1.f;
+	vec3Velocity.y += frictionY * (float)dElapsedTime;
 
-	float frictionZ = vec3Vel.z * -1.f;
-	vec3Vel.z += frictionZ * (float)dElapsedTime;
+	float frictionZ = vec3Velocity.z * -1.f;
+	vec3Velocity.z += frictionZ * (float)dElapsedTime;
+	SetVel(vec3Velocity);
 
 	switch (sCurrentFSM)
 	{
 	case FSM::IDLE:
-		if (iFSMCounter > iMaxFSMCounter)
+		if (dFSMTime > dMaxFSMTime)
 		{
 			sCurrentFSM = FSM::PATROL;
-			iFSMCounter = 0;
-			if (_DEBUG_FSM == true)
-				cout << "Rested: Switching to Patrol State" << endl;
+			dFSMTime = 0.0;
+			LOG_DEBUG(AI, "Rested: Switching to Patrol State");
 		}
-		iFSMCounter++;
+		dFSMTime += dElapsedTime;
 		break;
 	case FSM::PATROL:
 		// Check if the destination position has been reached
-		if (cWaypointManager->HasReachedWayPoint(vec3Position))
+		if (cWaypointManager->HasReachedWayPoint(GetPosition()))
 		{
-			vec3Front = glm::normalize((cWaypointManager->GetNextWaypoint()->GetPosition() - vec3Position));
+			vec3Front = glm::normalize((cWaypointManager->GetNextWaypoint()->GetPosition() - GetPosition()));
 			UpdateFrontAndYaw();
 
-			if (_DEBUG_FSM == true)
-				cout << "Reached waypoint: Going to next waypoint" << endl;
+			LOG_DEBUG(AI, "Reached waypoint: Going to next waypoint");
 		}
-		else if (iFSMCounter > iMaxFSMCounter)
+		else if (dFSMTime > dMaxFSMTime)
 		{
 			sCurrentFSM = FSM::IDLE;
-			iFSMCounter = 0;
-			if (_DEBUG_FSM == true)
-				cout << "FSM Counter maxed out: Switching to Idle State" << endl;
+			dFSMTime = 0.0;
+			LOG_DEBUG(AI, "FSM Counter maxed out: Switching to Idle State");
 		}
-		else if (glm::distance(vec3Position, cPlayer3D->GetPosition()) < fDetectionDistance)
+		else if (glm::distance(GetPosition(), cPlayer3D->GetPosition()) < fDetectionDistance)
 		{
 			sCurrentFSM = FSM::ATTACK;
-			iFSMCounter = 0;
-			if (_DEBUG_FSM == true)
-				cout << "Target found: Switching to Attack State" << endl;
+			dFSMTime = 0.0;
+			LOG_DEBUG(AI, "Target found: Switching to Attack State");
 		}
 		else
 		{
 			// Process the movement
 			ProcessMovement(ENEMYMOVEMENT::FORWARD, (float)dElapsedTime);
-			if (_DEBUG_FSM == true)
-				cout << "Patrolling" << endl;
+			LOG_TRACE(AI, "Patrolling");
 		}
-		iFSMCounter++;
+		dFSMTime += dElapsedTime;
 		break;
 	case FSM::ATTACK:
-		if (glm::distance(vec3Position, cPlayer3D->GetPosition()) < fDetectionDistance)
+		if (glm::distance(GetPosition(), cPlayer3D->GetPosition()) < fDetectionDistance)
 		{
-			vec3Front = glm::normalize((cPlayer3D->GetPosition() - vec3Position));
+			vec3Front = glm::normalize((cPlayer3D->GetPosition() - GetPosition()));
 			UpdateFrontAndYaw();
 
 			// Discharge weapon
@@ -450,22 +495,20 @@ bool CEnemy3D::Update(const double dElapsedTime)
 
 			// Process the movement
 			ProcessMovement(ENEMYMOVEMENT::FORWARD, (float)dElapsedTime);
-			if (_DEBUG_FSM == true)
-				cout << "Attacking now" << endl;
+			LOG_TRACE(AI, "Attacking now");
 		}
 		else
 		{
 			// If NPC loses track of player, then go back to the nearest waypoint
-			vec3Front = glm::normalize((cWaypointManager->GetNearestWaypoint(vec3Position)->GetPosition() - vec3Position));
+			vec3Front = glm::normalize((cWaypointManager->GetNearestWaypoint(GetPosition())->GetPosition() - GetPosition()));
 			UpdateFrontAndYaw();
 
 			// Swtich to patrol mode
 			sCurrentFSM = FSM::PATROL;
-			//iFSMCounter = 0;
-			if (_DEBUG_FSM == true)
-				cout << "Switching to Patrol State" << endl;
+			//dFSMTime = 0.0;
+			LOG_DEBUG(AI, "Switching to Patrol State");
 		}
-		iFSMCounter++;
+		dFSMTime += dElapsedTime;
 		break;
 	default:
 		break;
@@ -473,7 +516,7 @@ bool CEnemy3D::Update(const double dElapsedTime)
 
 	// Update the model
 	model = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
-	model = glm::translate(model, vec3Position);
+	model = glm::translate(model, GetPosition());
 	model = glm::scale(model, vec3Scale);
 	model = glm::rotate(model, glm::radians(fYaw), glm::vec3(0.0f, 1.0f, 0.0f));
 
@@ -489,7 +532,7 @@ bool CEnemy3D::Update(const double dElapsedTime)
 	}
 	if (cSecondaryWeapon)
 	{
-		cSecondaryWeapon->SetPosition(vec3Position + glm::vec3(0.05f, -0.075f, 0.5f));
+		cSecondaryWeapon->SetPosition(GetPosition() + glm::vec3(0.05f, -0.075f, 0.5f));
 		cSecondaryWeapon->SetRotation(fYaw, glm::vec3(0.0f, 1.0f, 0.0f));
 		cSecondaryWeapon->Update(dElapsedTime);
 	}
@@ -503,7 +546,7 @@ bool CEnemy3D::Update(const double dElapsedTime)
 void CEnemy3D::PreRender(void)
 {
 	// If this entity is not active, then skip this
-	if (bStatus == false)
+	if (GetStatus() == false)
 	{
 		return;
 	}
@@ -517,15 +560,13 @@ void CEnemy3D::PreRender(void)
 void CEnemy3D::Render(void)
 {
 	// If this entity is not active, then skip this
-	if (bStatus == false)
+	if (GetStatus() == false)
 	{
 		return;
 	}
 
 	CSolidObject::Render();
 
-	cPrimaryWeapon->SetView(view);
-	cPrimaryWeapon->SetProjection(projection);
 	cPrimaryWeapon->PreRender();
 	cPrimaryWeapon->Render();
 	cPrimaryWeapon->PostRender();
@@ -537,7 +578,7 @@ void CEnemy3D::Render(void)
 void CEnemy3D::PostRender(void)
 {
 	// If this entity is not active, then skip this
-	if (bStatus == false)
+	if (GetStatus() == false)
 	{
 		return;
 	}
@@ -578,10 +619,12 @@ void CEnemy3D::UpdateEnemyVectors(void)
  */
 void CEnemy3D::Constraint(void)
 {
+	glm::vec3 vec3NewPosition = GetPosition();
 	// Get the new height
-	float fNewYValue = cTerrain->GetHeight(vec3Position.x, vec3Position.z) + fHeightOffset;
+	float fNewYValue = cTerrain->GetHeight(vec3NewPosition.x, vec3NewPosition.z) + fHeightOffset;
 	// Smooth out the change in height
-	vec3Position.y += (fNewYValue - vec3Position.y) * 0.05f;
+	vec3NewPosition.y += (fNewYValue - vec3NewPosition.y) * 0.05f;
+	SetPosition(vec3NewPosition);
 }
 
 /**
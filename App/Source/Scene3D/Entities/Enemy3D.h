@@ -5,6 +5,9 @@
  */
 #pragma once
 
+// Include CObjectPool
+#include "System/ObjectPool.h"
+
 // Include CSolidObject
 #include "SolidObject.h"
 
@@ -57,6 +60,13 @@ public:
 	// Destructor
 	virtual ~CEnemy3D(void);
 
+	// Allocate the instances of this class from a CObjectPool, so that creating one reuses the memory of a deleted one
+	static void* operator new(size_t uiSize);
+	// Return the memory of an instance to the CObjectPool
+	static void operator delete(void* p, size_t uiSize);
+	// Get the CObjectPool of this class
+	static CObjectPool<CEnemy3D>& GetPool(void);
+
 	// Initialise this class instance
 	bool Init(void);
 
@@ -0,0 +1,440 @@
+/**
+ CEntityStore
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#include "EntityStore.h"
+
+// Include CSolidObject
+#include "SolidObject.h"
+
+// Include CCollisionManager
+#include "Primitives/CollisionManager.h"
+
+// Include CStopWatch
+#include "TimeControl/StopWatch.h"
+
+#include "../../MyMath.h"
+
+#include <list>
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor
+ */
+CEntityStore::CEntityStore(void)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CEntityStore::~CEntityStore(void)
+{
+	// The CSolidObject* are owned by the CSolidObjectManager, so we do not delete them here
+	Clear();
+}
+
+/**
+ @brief Add a CSolidObject* to this store and return its handle
+ @param cSolidObject A CSolidObject* variable to be added to this store
+ @param bStatic A const bool variable which is true if the entity never moves
+ @return The EntityHandle of the added entity
+ */
+EntityHandle CEntityStore::Add(CSolidObject* cSolidObject, const bool bStatic)
+{
+	// Reuse a free handle index if there is one, else create a new one
+	unsigned int uiHandleIndex;
+	if (vFreeList.empty() == false)
+	{
+		uiHandleIndex = vFreeList.back();
+		vFreeList.pop_back();
+	}
+	else
+	{
+		uiHandleIndex = vSparse.size();
+		vSparse.push_back(EntityHandle::INVALID_INDEX);
+		vGeneration.push_back(0);
+	}
+
+	EntityHandle handle(uiHandleIndex, vGeneration[uiHandleIndex]);
+
+	// Append the entity to the end of the columns
+	unsigned int uiIndex = vSolidObject.size();
+	vSparse[uiHandleIndex] = uiIndex;
+
+	vPosition.push_back(glm::vec3(0.0f));
+	vPreviousPosition.push_back(glm::vec3(0.0f));
+	vVelocity.push_back(glm::vec3(0.0f));
+	vBoxMin.push_back(glm::vec3(0.0f));
+	vBoxMax.push_back(glm::vec3(0.0f));
+	vType.push_back(CEntity3D::TYPE::OTHERS);
+	vStatus.push_back(0);
+	vHealth.push_back(0.0f);
+	vStatic.push_back(bStatic ? 1 : 0);
+	vSleepCounter.push_back(0);
+	vBatched.push_back(0);
+	vThinkTime.push_back(0.0f);
+	vSolidObject.push_back(cSolidObject);
+	vHandle.push_back(handle);
+
+	MoveIn(uiIndex);
+
+	return handle;
+}
+
+/**
+ @brief Remove an entity from this store. The CSolidObject* is not deleted.
+		The last entity is moved into the freed slot so that the columns stay densely packed.
+ @param handle A const EntityHandle& variable containing the handle of the entity to remove
+ @return true if the entity was removed, else false
+ */
+bool CEntityStore::Remove(const EntityHandle& handle)
+{
+	unsigned int uiIndex = GetIndex(handle);
+	if (uiIndex == EntityHandle::INVALID_INDEX)
+		return false;
+
+	// Give the CSolidObject its data back, as it may still be used after it is removed
+	MoveOut(uiIndex);
+
+	unsigned int uiLast = vSolidObject.size() - 1;
+	if (uiIndex != uiLast)
+	{
+		vPosition[uiIndex] = vPosition[uiLast];
+		vPreviousPosition[uiIndex] = vPreviousPosition[uiLast];
+		vVelocity[uiIndex] = vVelocity[uiLast];
+		vBoxMin[uiIndex] = vBoxMin[uiLast];
+		vBoxMax[uiIndex] = vBoxMax[uiLast];
+		vType[uiIndex] = vType[uiLast];
+		vStatus[uiIndex] = vStatus[uiLast];
+		vHealth[uiIndex] = vHealth[uiLast];
+		vStatic[uiIndex] = vStatic[uiLast];
+		vSleepCounter[uiIndex] = vSleepCounter[uiLast];
+		vBatched[uiIndex] = vBatched[uiLast];
+		vThinkTime[uiIndex] = vThinkTime[uiLast];
+		vSolidObject[uiIndex] = vSolidObject[uiLast];
+		vHandle[uiIndex] = vHandle[uiLast];
+
+		// Update the moved entity's handle, and its CSolidObject, to point to its new slot
+		vSparse[vHandle[uiIndex].uiIndex] = uiIndex;
+		vSolidObject[uiIndex]->uiStoreIndex = uiIndex;
+	}
+
+	vPosition.pop_back();
+	vPreviousPosition.pop_back();
+	vVelocity.pop_back();
+	vBoxMin.pop_back();
+	vBoxMax.pop_back();
+	vType.pop_back();
+	vStatus.pop_back();
+	vHealth.pop_back();
+	vStatic.pop_back();
+	vSleepCounter.pop_back();
+	vBatched.pop_back();
+	vThinkTime.pop_back();
+	vSolidObject.pop_back();
+	vHandle.pop_back();
+
+	// Invalidate the handle and recycle its index
+	vSparse[handle.uiIndex] = EntityHandle::INVALID_INDEX;
+	vGeneration[handle.uiIndex]++;
+	vFreeList.push_back(handle.uiIndex);
+
+	return true;
+}
+
+/**
+ @brief Remove all entities from this store. The CSolidObject* are not deleted.
+ */
+void CEntityStore::Clear(void)
+{
+	for (unsigned int i = 0; i < vSolidObject.size(); i++)
+		MoveOut(i);
+
+	vPosition.clear();
+	vPreviousPosition.clear();
+	vVelocity.clear();
+	vBoxMin.clear();
+	vBoxMax.clear();
+	vType.clear();
+	vStatus.clear();
+	vHealth.clear();
+	vStatic.clear();
+	vSleepCounter.clear();
+	vBatched.clear();
+	vThinkTime.clear();
+	vSolidObject.clear();
+	vHandle.clear();
+
+	// Keep the generations so that any handles still held elsewhere become invalid
+	vFreeList.clear();
+	for (unsigned int i = 0; i < vSparse.size(); i++)
+	{
+		vSparse[i] = EntityHandle::INVALID_INDEX;
+		vGeneration[i]++;
+		vFreeList.push_back(i);
+	}
+}
+
+/**
+ @brief Check if a handle refers to a live entity
+ @param handle A const EntityHandle& variable containing the handle to check
+ @return true if the handle is valid, else false
+ */
+bool CEntityStore::IsValid(const EntityHandle& handle) const
+{
+	return GetIndex(handle) != EntityHandle::INVALID_INDEX;
+}
+
+/**
+ @brief Get the dense index of an entity
+ @param handle A const EntityHandle& variable containing the handle of the entity
+ @return The index into the columns, or EntityHandle::INVALID_INDEX if the handle is stale
+ */
+unsigned int CEntityStore::GetIndex(const EntityHandle& handle) const
+{
+	if (handle.uiIndex >= vSparse.size())
+		return EntityHandle::INVALID_INDEX;
+	if (vGeneration[handle.uiIndex] != handle.uiGeneration)
+		return EntityHandle::INVALID_INDEX;
+	return vSparse[handle.uiIndex];
+}
+
+/**
+ @brief Find the handle of a CSolidObject*
+ @param cSolidObject A const CSolidObject* variable to search for
+ @return The EntityHandle of the CSolidObject*, or a null handle if it is not in this store
+ */
+EntityHandle CEntityStore::Find(const CSolidObject* cSolidObject) const
+{
+	for (unsigned int i = 0; i < vSolidObject.size(); i++)
+	{
+		if (vSolidObject[i] == cSolidObject)
+			return vHandle[i];
+	}
+	return EntityHandle();
+}
+
+/**
+ @brief Get the number of live entities
+ @return The number of live entities
+ */
+unsigned int CEntityStore::GetSize(void) const
+{
+	return vSolidObject.size();
+}
+
+/**
+ @brief Check if an entity never moves
+ @param handle A const EntityHandle& variable containing the handle of the entity
+ @return true if the entity is static, else false
+ */
+bool CEntityStore::IsStatic(const EntityHandle& handle) const
+{
+	unsigned int uiIndex = GetIndex(handle);
+	if (uiIndex == EntityHandle::INVALID_INDEX)
+		return false;
+	return vStatic[uiIndex] != 0;
+}
+
+/**
+ @brief Check if an entity has not moved for SLEEP_FRAMES frames
+ @param uiIndex A const unsigned int variable containing the index of the entity
+ @return true if the entity is asleep, else false
+ */
+bool CEntityStore::IsAsleep(const unsigned int uiIndex) const
+{
+	return vSleepCounter[uiIndex] >= SLEEP_FRAMES;
+}
+
+/**
+ @brief Wake up an entity so that it is tested for collisions again
+ @param uiIndex A const unsigned int variable containing the index of the entity
+ */
+void CEntityStore::Wake(const unsigned int uiIndex)
+{
+	vSleepCounter[uiIndex] = 0;
+}
+
+/**
+ @brief Count one more frame for the sleep counters. This is called once per frame, before the entities
+		are updated. An entity which moves in this frame is woken up again by SetPosition, so only the
+		entities which have not moved for SLEEP_FRAMES frames in a row are asleep.
+ */
+void CEntityStore::BeginFrame(void)
+{
+	for (unsigned int i = 0; i < vSleepCounter.size(); i++)
+	{
+		if (vSleepCounter[i] < SLEEP_FRAMES)
+			vSleepCounter[i]++;
+	}
+}
+
+/**
+ @brief Set the position of an entity, and move its bounding box with it
+ @param uiIndex A const unsigned int variable containing the index of the entity
+ @param vec3Position A const glm::vec3& variable containing the new position
+ */
+void CEntityStore::SetPosition(const unsigned int uiIndex, const glm::vec3& vec3Position)
+{
+	if (vPosition[uiIndex] == vec3Position)
+		return;
+
+	vPosition[uiIndex] = vec3Position;
+	vSleepCounter[uiIndex] = 0;
+	UpdateBox(uiIndex);
+}
+
+/**
+ @brief Recalculate the bounding box of an entity after its collider has changed
+ @param uiIndex A const unsigned int variable containing the index of the entity
+ */
+void CEntityStore::UpdateBox(const unsigned int uiIndex)
+{
+	vBoxMin[uiIndex] = vPosition[uiIndex] + vSolidObject[uiIndex]->boxMin;
+	vBoxMax[uiIndex] = vPosition[uiIndex] + vSolidObject[uiIndex]->boxMax;
+}
+
+/**
+ @brief Copy the hot data of a CSolidObject into the columns when it is added.
+		From now on, its accessors read and write the columns instead of its own members.
+ @param uiIndex A const unsigned int variable containing the index of the entity
+ */
+void CEntityStore::MoveIn(const unsigned int uiIndex)
+{
+	CSolidObject* cSolidObject = vSolidObject[uiIndex];
+
+	vPosition[uiIndex] = cSolidObject->vec3Position;
+	vPreviousPosition[uiIndex] = cSolidObject->vec3PreviousPosition;
+	vVelocity[uiIndex] = cSolidObject->vec3Vel;
+	vType[uiIndex] = cSolidObject->eType;
+	vStatus[uiIndex] = cSolidObject->bStatus ? 1 : 0;
+	vHealth[uiIndex] = cSolidObject->fHealth;
+	UpdateBox(uiIndex);
+
+	cSolidObject->cEntityStore = this;
+	cSolidObject->uiStoreIndex = uiIndex;
+}
+
+/**
+ @brief Copy the columns of an entity back into its CSolidObject when it is removed.
+		From now on, its accessors use its own members again.
+ @param uiIndex A const unsigned int variable containing the index of the entity
+ */
+void CEntityStore::MoveOut(const unsigned int uiIndex)
+{
+	CSolidObject* cSolidObject = vSolidObject[uiIndex];
+
+	cSolidObject->vec3Position = vPosition[uiIndex];
+	cSolidObject->vec3PreviousPosition = vPreviousPosition[uiIndex];
+	cSolidObject->vec3Vel = vVelocity[uiIndex];
+	cSolidObject->eType = vType[uiIndex];
+	cSolidObject->bStatus = (vStatus[uiIndex] != 0);
+	cSolidObject->fHealth = vHealth[uiIndex];
+
+	cSolidObject->cEntityStore = NULL;
+	cSolidObject->uiStoreIndex = EntityHandle::INVALID_INDEX;
+}
+
+/**
+ @brief Compare the cost of iterating a std::list of CSolidObject* against the columns.
+		Each pass moves every active entity by its velocity through its own accessors, as the entities do in
+		their Update(), and then tests its bounding box against a query box, which is what the collision loop
+		does every frame. The entities in the list keep their data in their own members. The entities in the
+		store keep it in the columns, so their accessors write the columns and nothing is copied afterwards.
+ @param uiNumEntities A const unsigned int variable containing the number of entities to create
+ */
+void CEntityStore::Benchmark(const unsigned int uiNumEntities)
+{
+	const int iNumPasses = 100;
+	const float fDeltaTime = 1.0f / 60.0f;
+	const glm::vec3 vec3QueryMin(-5.0f, -5.0f, -5.0f);
+	const glm::vec3 vec3QueryMax(5.0f, 5.0f, 5.0f);
+
+	// Create the entities. The same entities are used for both runs.
+	std::list<CSolidObject*> lSolidObject;
+	for (unsigned int i = 0; i < uiNumEntities; i++)
+	{
+		CSolidObject* cSolidObject = new CSolidObject(glm::vec3(Math::RandFloatMinMax(-125.0f, 125.0f),
+																0.0f,
+																Math::RandFloatMinMax(-125.0f, 125.0f)));
+		cSolidObject->SetVel(glm::vec3(Math::RandFloatMinMax(-1.0f, 1.0f), 0.0f, Math::RandFloatMinMax(-1.0f, 1.0f)));
+		cSolidObject->SetType(CEntity3D::TYPE::NPC);
+		cSolidObject->SetStatus(true);
+		lSolidObject.push_back(cSolidObject);
+	}
+
+	CStopWatch cStopWatch;
+	int iNumOverlaps = 0;
+	std::list<CSolidObject*>::iterator it, end;
+	end = lSolidObject.end();
+
+	// Before: iterate the std::list through the virtual accessors, which use the members of the entities
+	cStopWatch.StartTimer();
+	for (int iPass = 0; iPass < iNumPasses; iPass++)
+	{
+		for (it = lSolidObject.begin(); it != end; ++it)
+		{
+			if ((*it)->GetStatus() == false)
+				continue;
+			(*it)->SetPosition((*it)->GetPosition() + (*it)->GetVel() * fDeltaTime);
+		}
+		for (it = lSolidObject.begin(); it != end; ++it)
+		{
+			if ((*it)->GetStatus() == false)
+				continue;
+			if (CCollisionManager::BoxBoxCollision(	(*it)->GetPosition() + (*it)->boxMin,
+													(*it)->GetPosition() + (*it)->boxMax,
+													vec3QueryMin, vec3QueryMax) == true)
+				iNumOverlaps++;
+		}
+	}
+	double dListTime = cStopWatch.GetElapsedTime();
+
+	// After: add the entities to the store, so that their accessors use the columns, and iterate the columns
+	CEntityStore cEntityStore;
+	for (it = lSolidObject.begin(); it != end; ++it)
+		cEntityStore.Add(*it);
+
+	double dUpdateTime = 0.0;
+	double dStoreTime = 0.0;
+	cStopWatch.GetElapsedTime();
+	for (int iPass = 0; iPass < iNumPasses; iPass++)
+	{
+		cEntityStore.BeginFrame();
+		for (it = lSolidObject.begin(); it != end; ++it)
+		{
+			if ((*it)->GetStatus() == false)
+				continue;
+			(*it)->SetPosition((*it)->GetPosition() + (*it)->GetVel() * fDeltaTime);
+		}
+		const double dPassUpdateTime = cStopWatch.GetElapsedTime();
+		dUpdateTime += dPassUpdateTime;
+		dStoreTime += dPassUpdateTime;
+
+		const unsigned int uiSize = cEntityStore.GetSize();
+		for (unsigned int i = 0; i < uiSize; i++)
+		{
+			if (cEntityStore.vStatus[i] == 0)
+				continue;
+			if (CCollisionManager::BoxBoxCollision(	cEntityStore.vBoxMin[i], cEntityStore.vBoxMax[i],
+													vec3QueryMin, vec3QueryMax) == true)
+				iNumOverlaps++;
+		}
+		dStoreTime += cStopWatch.GetElapsedTime();
+	}
+
+	cout << "CEntityStore::Benchmark() with " << uiNumEntities << " entities, " << iNumPasses << " passes" << endl;
+	cout << "std::list<CSolidObject*> : " << dListTime * 1000.0 / iNumPasses << " ms per pass" << endl;
+	cout << "CEntityStore columns     : " << dStoreTime * 1000.0 / iNumPasses << " ms per pass, of which the updates "
+		<< dUpdateTime * 1000.0 / iNumPasses << " ms" << endl;
+	cout << "(overlaps: " << iNumOverlaps << ")" << endl;
+
+	// Clean up. Remove the entities from the store before deleting them.
+	cEntityStore.Clear();
+	for (it = lSolidObject.begin(); it != end; ++it)
+		delete *it;
+	lSolidObject.clear();
+}
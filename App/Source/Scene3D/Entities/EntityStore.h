@@ -0,0 +1,141 @@
+/**
+ CEntityStore
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include Entity3D
+#include <Primitives/Entity3D.h>
+
+// Include GLM
+#include <includes/glm.hpp>
+#include <includes/gtc/matrix_transform.hpp>
+#include <includes/gtc/type_ptr.hpp>
+
+#include <vector>
+using namespace std;
+
+class CSolidObject;
+
+// A stable reference to an entity in the CEntityStore.
+// The generation is bumped when a slot is reused, so old handles become invalid instead of aliasing a new entity.
+struct EntityHandle
+{
+	static const unsigned int INVALID_INDEX = 0xFFFFFFFF;
+
+	unsigned int uiIndex;
+	unsigned int uiGeneration;
+
+	EntityHandle(void)
+		: uiIndex(INVALID_INDEX)
+		, uiGeneration(0)
+	{
+	}
+
+	EntityHandle(const unsigned int uiIndex, const unsigned int uiGeneration)
+		: uiIndex(uiIndex)
+		, uiGeneration(uiGeneration)
+	{
+	}
+
+	bool IsNull(void) const
+	{
+		return uiIndex == INVALID_INDEX;
+	}
+
+	bool operator==(const EntityHandle& rhs) const
+	{
+		return (uiIndex == rhs.uiIndex) && (uiGeneration == rhs.uiGeneration);
+	}
+
+	bool operator!=(const EntityHandle& rhs) const
+	{
+		return !(*this == rhs);
+	}
+};
+
+// Stores the per-frame hot data of the CSolidObjects in contiguous columns (structure-of-arrays).
+// The columns are densely packed: index 0 to GetSize()-1 are all live entities.
+// While a CSolidObject is in this store, the columns are the only copy of its hot data, and its
+// accessors read and write them. Its own members are only used before it is added and after it is removed.
+class CEntityStore
+{
+public:
+	// Constructor
+	CEntityStore(void);
+	// Destructor
+	virtual ~CEntityStore(void);
+
+	// The number of frames which an entity must stay still for before it is put to sleep
+	static const unsigned int SLEEP_FRAMES = 30;
+
+	// Add a CSolidObject* to this store and return its handle
+	EntityHandle Add(CSolidObject* cSolidObject, const bool bStatic = false);
+	// Remove an entity from this store. The CSolidObject* is not deleted.
+	bool Remove(const EntityHandle& handle);
+	// Remove all entities from this store. The CSolidObject* are not deleted.
+	void Clear(void);
+
+	// Check if a handle refers to a live entity
+	bool IsValid(const EntityHandle& handle) const;
+	// Get the dense index of an entity, or EntityHandle::INVALID_INDEX if the handle is stale
+	unsigned int GetIndex(const EntityHandle& handle) const;
+	// Find the handle of a CSolidObject*
+	EntityHandle Find(const CSolidObject* cSolidObject) const;
+	// Get the number of live entities
+	unsigned int GetSize(void) const;
+	// Check if an entity never moves
+	bool IsStatic(const EntityHandle& handle) const;
+	// Check if an entity has not moved for SLEEP_FRAMES frames
+	bool IsAsleep(const unsigned int uiIndex) const;
+	// Wake up an entity so that it is tested for collisions again
+	void Wake(const unsigned int uiIndex);
+	// Count one more frame for the sleep counters. An entity which moves in this frame is woken up by SetPosition.
+	void BeginFrame(void);
+
+	// Set the position of an entity, and move its bounding box with it
+	void SetPosition(const unsigned int uiIndex, const glm::vec3& vec3Position);
+	// Recalculate the bounding box of an entity after its collider has changed
+	void UpdateBox(const unsigned int uiIndex);
+
+	// Compare the cost of iterating a std::list of CSolidObject* against the columns
+	static void Benchmark(const unsigned int uiNumEntities = 10000);
+
+	// The columns. Each column is indexed by the dense index of the entity.
+	// Use SetPosition to move an entity, so that its bounding box and sleep counter follow it.
+	vector<glm::vec3> vPosition;
+	vector<glm::vec3> vPreviousPosition;
+	vector<glm::vec3> vVelocity;
+	// Bounding box in world space
+	vector<glm::vec3> vBoxMin;
+	vector<glm::vec3> vBoxMax;
+	vector<CEntity3D::TYPE> vType;
+	vector<unsigned char> vStatus;
+	vector<float> vHealth;
+	// 1 if the entity never moves
+	vector<unsigned char> vStatic;
+	// The number of frames which the entity has not moved for
+	vector<unsigned int> vSleepCounter;
+	// 1 if the entity is rendered by a CStaticBatch instead of by itself
+	vector<unsigned char> vBatched;
+	// The seconds which have passed since the entity was last updated, if its updates are scheduled by the CAIScheduler
+	vector<float> vThinkTime;
+	// The CSolidObject which owns each entity
+	vector<CSolidObject*> vSolidObject;
+	// The handle of each entity
+	vector<EntityHandle> vHandle;
+
+protected:
+	// Copy the hot data of a CSolidObject into the columns when it is added
+	void MoveIn(const unsigned int uiIndex);
+	// Copy the columns of an entity back into its CSolidObject when it is removed
+	void MoveOut(const unsigned int uiIndex);
+
+	// Maps a handle index to a dense index
+	vector<unsigned int> vSparse;
+	// The current generation of each handle index
+	vector<unsigned int> vGeneration;
+	// Handle indices which are available for reuse
+	vector<unsigned int> vFreeList;
+};
@@ -17,6 +17,12 @@
 // Include CPlayer3D
 #include "../Entities/Player3D.h"
 
+// Include CLODManager
+#include "Primitives/LODManager.h"
+
+// Include CIndirectDrawBuffer
+#include "RenderControl/IndirectDrawBuffer.h"
+
 #include <iostream>
 using namespace std;
 
@@ -25,8 +31,9 @@ using namespace std;
  */
 CHangarA::CHangarA(void)
 {
+	iMeshID = -1;
 	// Set the default position to the origin
-	vec3Position = glm::vec3(0.0f, fHeightOffset, 0.0f);
+	SetPosition(glm::vec3(0.0f, fHeightOffset, 0.0f));
 }
 
 /**
@@ -37,7 +44,8 @@ CHangarA::CHangarA(void)
 CHangarA::CHangarA(	const glm::vec3 vec3Position,
 								const glm::vec3 vec3Front)
 {
-	this->vec3Position = glm::vec3(vec3Position.x, vec3Position.y + fHeightOffset, vec3Position.z);
+	iMeshID = -1;
+	SetPosition(glm::vec3(vec3Position.x, vec3Position.y + fHeightOffset, vec3Position.z));
 	this->vec3Front = vec3Front;
 }
 
@@ -46,6 +54,9 @@ CHangarA::CHangarA(	const glm::vec3 vec3Position,
  */
 CHangarA::~CHangarA(void)
 {
+	// Do not create the CLODManager again if it has already been destroyed
+	if (CLODManager::HasInstance())
+		CLODManager::GetInstance()->Erase(this);
 }
 
 /**
@@ -60,11 +71,14 @@ bool CHangarA::Init(void)
 	// Set the type
 	SetType(CEntity3D::TYPE::STRUCTURE);
 
+	// Keep the occluder box well inside the sloped roof
+	SetOccluderScale(0.7f);
+
 	if (m_bLODStatus == false)
 	{
 		if (LoadModelAndTexture("Models/Buildings/HangerA.obj", 
 								"Models/Hut_Concrete/Hut_Concrete_H.tga",
-								VAO, iTextureID, iIndicesSize) == false)
+								VAO, iTextureID, iIndicesSize, iMeshID) == false)
 		{
 			cout << "Unable to load model and texture" << endl;
 		}
@@ -73,22 +87,25 @@ bool CHangarA::Init(void)
 	{
 		if (LoadModelAndTexture("Models/Buildings/HangerA.obj",
 								"Models/Hut_Concrete/Hut_Concrete_H.tga",
-								arrVAO[0], arriTextureID[0], arrIndicesSize[0]) == false)
+								arrVAO[0], arriTextureID[0], arrIndicesSize[0], arriMeshID[0]) == false)
 		{
 			cout << "Unable to load high LOD model and texture" << endl;
 		}
 		if (LoadModelAndTexture("Models/Buildings/HangerA.obj",
 								"Models/Hut_Concrete/Hut_Concrete_M.tga",
-								arrVAO[1], arriTextureID[1], arrIndicesSize[1]) == false)
+								arrVAO[1], arriTextureID[1], arrIndicesSize[1], arriMeshID[1]) == false)
 		{
 			cout << "Unable to load mid LOD model and texture" << endl;
 		}
 		if (LoadModelAndTexture("Models/Buildings/HangerA.obj",
 								"Models/Hut_Concrete/Hut_Concrete_L.tga",
-								arrVAO[2], arriTextureID[2], arrIndicesSize[2]) == false)
+								arrVAO[2], arriTextureID[2], arrIndicesSize[2], arriMeshID[2]) == false)
 		{
 			cout << "Unable to load low LOD model and texture" << endl;
 		}
+
+		// The level of details is selected by CLODManager for each render pass
+		CLODManager::GetInstance()->Add(this, this);
 	}
 
 	return true;
@@ -101,13 +118,15 @@ bool CHangarA::Init(void)
  @param VAO A GLuint& variable containing the VAO to be returned
  @param iTextureID A GLuint& variable containing the iTextureID to be returned
  @param iIndicesSize A GLuint& variable containing the iIndicesSize to be returned
+ @param iMeshID A int& variable containing the mesh ID in the CIndirectDrawBuffer to be returned
  @return A bool variable
  */
 bool CHangarA::LoadModelAndTexture(const char* filenameModel,
 										const char* filenameTexture,
 										GLuint& VAO,
 										GLuint& iTextureID,
-										GLuint& iIndicesSize)
+										GLuint& iIndicesSize,
+										int& iMeshID)
 {
 	std::vector<glm::vec3> vertices;
 	std::vector<glm::vec2> uvs;
@@ -123,8 +142,14 @@ bool CHangarA::LoadModelAndTexture(const char* filenameModel,
 		return false;
 	}
 
+	// Keep the bounding box of the model for the occlusion culling
+	ExpandModelBox(vertices);
+
 	CLoadOBJ::IndexVBO(vertices, uvs, normals, index_buffer_data, vertex_buffer_data);
 
+	// Add the mesh to the CIndirectDrawBuffer, which shares it among the instances using the same model
+	iMeshID = CIndirectDrawBuffer::GetInstance()->AddMesh(file_path, vertex_buffer_data, index_buffer_data);
+
 	glGenVertexArrays(1, &VAO);
 	glBindVertexArray(VAO);
 	glGenBuffers(1, &VBO);
@@ -189,18 +214,8 @@ bool CHangarA::Update(const double dElapsedTime)
 {
 	CSolidObject::Update(dElapsedTime);
 
-	if (m_bLODStatus)
-	{
-		float fDistanceToPlayer = glm::distance(vec3Position, CPlayer3D::GetInstance()->GetPosition());
-		if (fDistanceToPlayer > arrLODDistance[LOW_DETAILS])
-			eDetailLevel = LOW_DETAILS;
-		else if (fDistanceToPlayer > arrLODDistance[MID_DETAILS])
-			eDetailLevel = MID_DETAILS;
-		else
-			eDetailLevel = HIGH_DETAILS;
-	}
-	float fDistanceToPlayer = glm::distance(vec3Position, CPlayer3D::GetInstance()->GetPosition());
-	if (fDistanceToPlayer < 10 && CPlayer3D::GetInstance()->GetHealth() < CPlayer3D::GetInstance()->GetMaxHealth())
+	const glm::vec3 vec3ToPlayer = CPlayer3D::GetInstance()->GetPosition() - GetPosition();
+	if (glm::dot(vec3ToPlayer, vec3ToPlayer) < 10.0f * 10.0f && CPlayer3D::GetInstance()->GetHealth() < CPlayer3D::GetInstance()->GetMaxHealth())
 	{
 		CPlayer3D::GetInstance()->isHealing = true;
 	}
@@ -223,10 +238,6 @@ void CHangarA::Render(void)
 {
 	if (m_bLODStatus == false)
 	{
-		// note: currently we set the projection matrix each frame, but since the projection 
-		// matrix rarely changes it's often best practice to set it outside the main loop only once.
-		CShaderManager::GetInstance()->activeShader->setMat4("projection", projection);
-		CShaderManager::GetInstance()->activeShader->setMat4("view", view);
 		CShaderManager::GetInstance()->activeShader->setMat4("model", model);
 
 		// bind textures on corresponding texture units
@@ -240,10 +251,6 @@ void CHangarA::Render(void)
 	}
 	else
 	{
-		// note: currently we set the projection matrix each frame, but since the projection 
-		// matrix rarely changes it's often best practice to set it outside the main loop only once.
-		CShaderManager::GetInstance()->activeShader->setMat4("projection", projection);
-		CShaderManager::GetInstance()->activeShader->setMat4("view", view);
 		CShaderManager::GetInstance()->activeShader->setMat4("model", model);
 
 		// bind textures on corresponding texture units
@@ -265,6 +272,17 @@ void CHangarA::PostRender(void)
 	CSolidObject::PostRender();
 }
 
+/**
+ @brief Submit this instance to the CIndirectDrawBuffer instead of rendering it in Render()
+ @return true if this instance was submitted, else false
+ */
+bool CHangarA::SubmitDraw(void)
+{
+	if (m_bLODStatus == false)
+		return CIndirectDrawBuffer::GetInstance()->Submit(iMeshID, iTextureID, model);
+	return CIndirectDrawBuffer::GetInstance()->Submit(arriMeshID[eDetailLevel], arriTextureID[eDetailLevel], model);
+}
+
 /**
  @brief Print Self
  */
@@ -44,7 +44,8 @@ public:
 								const char* filenameTexture, 
 								GLuint& VAO, 
 								GLuint& iTextureID,
-								GLuint& iIndicesSize);
+								GLuint& iIndicesSize,
+								int& iMeshID);
 
 	// Set model
 	virtual void SetModel(const glm::mat4 model);
@@ -63,6 +64,13 @@ public:
 	// PostRender
 	virtual void PostRender(void);
 
+	// Submit this instance to the CIndirectDrawBuffer instead of rendering it in Render()
+	virtual bool SubmitDraw(void);
+
 	// Print Self
 	virtual void PrintSelf(void);
+
+protected:
+	// The mesh ID in the CIndirectDrawBuffer when the LOD is disabled
+	int iMeshID;
 };
@@ -17,6 +17,9 @@
 #include "../../MyMath.h"
 
 #include <iostream>
+
+// Include CLogger
+#include "System/Logger.h"
 using namespace std;
 
 /**
@@ -55,7 +58,7 @@ CPlayer3D::CPlayer3D(void)
 	, waveCount(1)
 {
 	// Set the default position so it is above the ground
-	vec3Position = glm::vec3(0.0f, 0.5f, 0.0f);
+	SetPosition(glm::vec3(0.0f, 0.5f, 0.0f));
 
 	// Update the player vectors
 	UpdatePlayerVectors();
@@ -103,7 +106,7 @@ CPlayer3D::CPlayer3D(	const glm::vec3 vec3Position,
 {
 	mesh = NULL;
 
-	this->vec3Position = vec3Position;
+	SetPosition(vec3Position);
 	this->vec3Front = vec3Front;
 	this->fYaw = fYaw;
 	this->fPitch = fPitch;
@@ -181,14 +184,16 @@ bool CPlayer3D::Init(void)
 	// Store the handler to the CTerrain
 	cTerrain = CTerrain::GetInstance();
 	// Update the y-axis position of the player
-	vec3Position.y = cTerrain->GetHeight(vec3Position.x, vec3Position.z);
+	glm::vec3 vec3NewPosition = GetPosition();
+	vec3NewPosition.y = cTerrain->GetHeight(vec3NewPosition.x, vec3NewPosition.z);
+	SetPosition(vec3NewPosition);
 
 	// Set the Physics to fall status by default
 	cPhysics3D.SetStatus(CPhysics3D::STATUS::FALL);
 
 	fMovementSpeed = 10.f;
 
-	fHealth = 200;
+	SetHealth(200);
 	fMaxHealth = 200;
 	return true;
 }
@@ -226,7 +231,7 @@ void CPlayer3D::SetProjection(const glm::mat4 projection)
 */
 glm::mat4 CPlayer3D::GetViewMatrix(void) const
 {
-	return glm::lookAt(vec3Position, vec3Position + vec3Front, vec3Up);
+	return glm::lookAt(GetPosition(), GetPosition() + vec3Front, vec3Up);
 }
 
 /**
@@ -241,7 +246,7 @@ void CPlayer3D::AttachCamera(CCamera* cCamera)
 	// Update the camera's attributes with the player's attributes
 	if (cCamera)
 	{
-		cCamera->vec3Position = vec3Position;
+		cCamera->vec3Position = GetPosition();
 		cCamera->vec3Front = vec3Front;
 		cCamera->vec3Up = vec3Up;
 		cCamera->vec3Right = vec3Right;
@@ -317,7 +322,7 @@ bool CPlayer3D::DischargeWeapon(void)
 	}
 	if ((iCurrentWeapon == 1) && (cPrimaryWeapon))
 	{
-		bool fired = cPrimaryWeapon->Discharge(vec3Position, vec3Front, (CSolidObject*)this);
+		bool fired = cPrimaryWeapon->Discharge(GetPosition(), vec3Front, (CSolidObject*)this);
 
 		if (fired) //if first bullet is fired, apply recoil
 			ApplyRecoil(cPrimaryWeapon);
@@ -326,7 +331,7 @@ bool CPlayer3D::DischargeWeapon(void)
 	}
 	else if ((iCurrentWeapon == 2) && (cSecondaryWeapon))
 	{
-		bool fired = cSecondaryWeapon->Discharge(vec3Position, vec3Front, (CSolidObject*)this);
+		bool fired = cSecondaryWeapon->Discharge(GetPosition(), vec3Front, (CSolidObject*)this);
 		
 		if (fired)
 			ApplyRecoil(cSecondaryWeapon);
@@ -425,10 +430,10 @@ void CPlayer3D::ProcessMovement(const PLAYERMOVEMENT direction, const float delt
 	addCrouchVelocity = Math::Clamp(addCrouchVelocity, -.025f, .15f);
 
 	totalVelocity = velocity + addSprintVelocity + addCrouchVelocity;
-	std::cout << totalVelocity << std::endl;
+	LOG_TRACE_EVERY(0.5, PHYSICS, "Player velocity: %.3f", totalVelocity);
 
 	//get predicted pos
-	glm::vec3 predictedPos = vec3Position;
+	glm::vec3 predictedPos = GetPosition();
 	if (direction == PLAYERMOVEMENT::FORWARD)
 		predictedPos += vec3Front * totalVelocity;
 	if (direction == PLAYERMOVEMENT::BACKWARD)
@@ -439,9 +444,9 @@ void CPlayer3D::ProcessMovement(const PLAYERMOVEMENT direction, const float delt
 		predictedPos += vec3Right * totalVelocity * 0.5f;
 
 	//get new pos height
-	float fCheckHeight = cTerrain->GetHeight(predictedPos.x, predictedPos.z) + fHeightOffset - vec3Position.y;
+	float fCheckHeight = cTerrain->GetHeight(predictedPos.x, predictedPos.z) + fHeightOffset - GetPosition().y;
 	//get the length of xz axis
-	float xzAxis = glm::length(glm::vec2(vec3Position.x, vec3Position.z) - glm::vec2(predictedPos.x, predictedPos.z));
+	float xzAxis = glm::length(glm::vec2(GetPosition().x, GetPosition().z) - glm::vec2(predictedPos.x, predictedPos.z));
 	//get the angle based on toa cah soh
 	float angle = glm::degrees(atan2f(fCheckHeight, xzAxis));
 	//get the scale using the drag and the angle
@@ -455,7 +460,7 @@ void CPlayer3D::ProcessMovement(const PLAYERMOVEMENT direction, const float delt
 			predictedPos += vec3Front * scale;
 
 		//set player pos to the new pos
-		vec3Position = predictedPos;
+		SetPosition(predictedPos);
 	}
 	//std::cout << "ANGLE: " << angle << std::endl;
 	/*glm::vec3 n = glm::normalize(vec3Position);
@@ -536,8 +541,7 @@ bool CPlayer3D::Update(const double dElapsedTime)
 	// If the camera is attached to this player, then update the camera
 	if (cCamera)
 	{
-		std::cout << cCamera->vec3Offset.x << std::endl;
-		cCamera->vec3Position = vec3Position + cCamera->vec3Offset;
+		cCamera->vec3Position = GetPosition() + cCamera->vec3Offset;
 		cCamera->vec3Front = vec3Front;
 		cCamera->vec3Up = vec3Up;
 		cCamera->vec3Right = vec3Right;
@@ -554,7 +558,7 @@ bool CPlayer3D::Update(const double dElapsedTime)
 		velocity = 0.f;
 		break;
 	case PLAYER_STATE::CROUCH:
-		vec3Position.y -= 0.05f;
+		SetPosition(GetPosition() - glm::vec3(0.0f, 0.05f, 0.0f));
 		if (totalVelocity > 0.1f)
 			CCamera::GetInstance()->fZoom = Math::Lerp(CCamera::GetInstance()->fZoom, cSettings->FOV * 4.f, (float)dElapsedTime);
 		break;
@@ -653,21 +657,23 @@ void CPlayer3D::UpdatePlayerVectors(void)
  */
 void CPlayer3D::Constraint(void)
 {
+	glm::vec3 vec3NewPosition = GetPosition();
 	// If the player is not jumping nor falling, then we snap his position to the terrain
 	if (cPhysics3D.GetStatus() == CPhysics3D::STATUS::IDLE)
 	{
-		vec3Position.y = cTerrain->GetHeight(vec3Position.x, vec3Position.z) + fHeightOffset;
+		vec3NewPosition.y = cTerrain->GetHeight(vec3NewPosition.x, vec3NewPosition.z) + fHeightOffset;
 	}
 	else
 	{
 		// If the player is jumping nor falling, then we only snap his position 
 		// if the player's y-coordinate is below the cTerrain 
-		float fCheckHeight = cTerrain->GetHeight(vec3Position.x, vec3Position.z) + fHeightOffset;
+		float fCheckHeight = cTerrain->GetHeight(vec3NewPosition.x, vec3NewPosition.z) + fHeightOffset;
 
 		// If the player is below the terrain, then snap to the terrain height
-		if (fCheckHeight > vec3Position.y)
-			vec3Position.y = fCheckHeight;
+		if (fCheckHeight > vec3NewPosition.y)
+			vec3NewPosition.y = fCheckHeight;
 	}
+	SetPosition(vec3NewPosition);
 }
 
 /**
@@ -676,6 +682,7 @@ void CPlayer3D::Constraint(void)
  */
 void CPlayer3D::UpdateJumpFall(const double dElapsedTime)
 {
+	glm::vec3 vec3NewPosition = GetPosition();
 	if (cPhysics3D.GetStatus() == CPhysics3D::STATUS::JUMP)
 	{
 		// Update the elapsed time to the physics engine
@@ -683,7 +690,7 @@ void CPlayer3D::UpdateJumpFall(const double dElapsedTime)
 		// Call the physics engine update method to calculate the final velocity and displacement
 		cPhysics3D.Update(dElapsedTime);
 		// Get the displacement from the physics engine and update the player position
-		vec3Position = vec3Position + cPhysics3D.GetDisplacement();
+		vec3NewPosition = vec3NewPosition + cPhysics3D.GetDisplacement();
 
 		// If the player is still jumping and the initial velocity has reached zero or below zero, 
 		// then it has reach the peak of its jump
@@ -700,18 +707,19 @@ void CPlayer3D::UpdateJumpFall(const double dElapsedTime)
 		// Call the physics engine update method to calculate the final velocity and displacement
 		cPhysics3D.Update(dElapsedTime);
 		// Get the displacement from the physics engine and update the player position
-		vec3Position = vec3Position + cPhysics3D.GetDisplacement();
+		vec3NewPosition = vec3NewPosition + cPhysics3D.GetDisplacement();
 
 		// Constaint the player's position to the terrain
-		float fCheckHeight = cTerrain->GetHeight(vec3Position.x, vec3Position.z) + fHeightOffset;
+		float fCheckHeight = cTerrain->GetHeight(vec3NewPosition.x, vec3NewPosition.z) + fHeightOffset;
 
 		// Set the Physics to idle status
-		if (fCheckHeight > vec3Position.y)
+		if (fCheckHeight > vec3NewPosition.y)
 		{
-			vec3Position.y = fCheckHeight;
+			vec3NewPosition.y = fCheckHeight;
 			cPhysics3D.SetStatus(CPhysics3D::STATUS::IDLE);
 		}
 	}
+	SetPosition(vec3NewPosition);
 }
 
 /**
@@ -722,8 +730,8 @@ void CPlayer3D::UpdateJumpFall(const double dElapsedTime)
 void CPlayer3D::ApplyRecoil(CWeaponInfo* weapon)
 {
 	//Get random recoil range
-	float horizontalRecoil = Math::RandFloatMinMax(weapon->GetMinRecoil().x, weapon->GetMaxRecoil().x);
-	float verticalRecoil = Math::RandFloatMinMax(weapon->GetMinRecoil().y, weapon->GetMaxRecoil().y);
+	float horizontalRecoil = Math::RandFloatMinMax(weapon->GetMinRecoil().x, weapon->GetMaxRecoil().x, CRandomStreams::WEAPON);
+	float verticalRecoil = Math::RandFloatMinMax(weapon->GetMinRecoil().y, weapon->GetMaxRecoil().y, CRandomStreams::WEAPON);
 
 	//Update the yaw and pitch based on the recoil
 	fYaw += horizontalRecoil;
@@ -5,6 +5,9 @@
  */
 #include "SolidObject.h"
 
+// Include CEntityStore
+#include "EntityStore.h"
+
 // Include ShaderManager
 #include "RenderControl/ShaderManager.h"
 
@@ -14,6 +17,7 @@
 // Include ImageLoader
 #include "System\ImageLoader.h"
 
+#include <cfloat>
 #include <iostream>
 using namespace std;
 
@@ -21,6 +25,11 @@ using namespace std;
  @brief Default Constructor
  */
 CSolidObject::CSolidObject(void)
+	: vec3ModelBoxMin(glm::vec3(FLT_MAX))
+	, vec3ModelBoxMax(glm::vec3(-FLT_MAX))
+	, fOccluderScale(0.0f)
+	, cEntityStore(NULL)
+	, uiStoreIndex(EntityHandle::INVALID_INDEX)
 {
 	// Set the default position to the origin
 	vec3Position = glm::vec3(0.0f, 0.0f, 0.0f);
@@ -33,6 +42,11 @@ CSolidObject::CSolidObject(void)
  */
 CSolidObject::CSolidObject(	const glm::vec3 vec3Position,
 							const glm::vec3 vec3Front)
+	: vec3ModelBoxMin(glm::vec3(FLT_MAX))
+	, vec3ModelBoxMax(glm::vec3(-FLT_MAX))
+	, fOccluderScale(0.0f)
+	, cEntityStore(NULL)
+	, uiStoreIndex(EntityHandle::INVALID_INDEX)
 {
 	// Set the default position to the origin
 	this->vec3Position = vec3Position;
@@ -53,7 +67,10 @@ CSolidObject::~CSolidObject(void)
 bool CSolidObject::Init(void)
 {
 	// Call the parent's Init()
-	return CEntity3D::Init();
+	const bool bResult = CEntity3D::Init();
+	// The parent activates this instance through its member, so pass it on if the CEntityStore holds the status
+	CSolidObject::SetStatus(bStatus);
+	return bResult;
 }
 
 /**
@@ -69,7 +86,11 @@ bool CSolidObject::InitCollider(const std::string& _name,
 								glm::vec3 boxMin,
 								glm::vec3 boxMax)
 {
-	return CCollider::InitCollider(_name, boxColour, boxMin, boxMax);
+	const bool bResult = CCollider::InitCollider(_name, boxColour, boxMin, boxMax);
+	// Resize the bounding box in the CEntityStore too
+	if (cEntityStore)
+		cEntityStore->UpdateBox(uiStoreIndex);
+	return bResult;
 }
 
 /**
@@ -99,6 +120,144 @@ void CSolidObject::SetProjection(const glm::mat4 projection)
 	CEntity3D::projection = projection;
 }
 
+/**
+ @brief Set the type
+ @param eType A const TYPE variable containing the type of this instance
+ */
+void CSolidObject::SetType(const TYPE eType)
+{
+	if (cEntityStore)
+		cEntityStore->vType[uiStoreIndex] = eType;
+	else
+		this->eType = eType;
+}
+
+/**
+ @brief Set the position
+ @param vec3Position A const glm::vec3 variable containing the position of this instance
+ */
+void CSolidObject::SetPosition(const glm::vec3 vec3Position)
+{
+	if (cEntityStore)
+		cEntityStore->SetPosition(uiStoreIndex, vec3Position);
+	else
+		this->vec3Position = vec3Position;
+}
+
+/**
+ @brief Set the previous position
+ @param vec3PreviousPosition A const glm::vec3 variable containing the previous position of this instance
+ */
+void CSolidObject::SetPreviousPosition(const glm::vec3 vec3PreviousPosition)
+{
+	if (cEntityStore)
+		cEntityStore->vPreviousPosition[uiStoreIndex] = vec3PreviousPosition;
+	else
+		this->vec3PreviousPosition = vec3PreviousPosition;
+}
+
+/**
+ @brief Set the velocity
+ @param vec3Vel A const glm::vec3 variable containing the velocity of this instance
+ */
+void CSolidObject::SetVel(const glm::vec3 vec3Vel)
+{
+	if (cEntityStore)
+		cEntityStore->vVelocity[uiStoreIndex] = vec3Vel;
+	else
+		this->vec3Vel = vec3Vel;
+}
+
+/**
+ @brief Set the status
+ @param bStatus A const bool variable which is true if this instance is active, else false
+ */
+void CSolidObject::SetStatus(const bool bStatus)
+{
+	if (cEntityStore)
+		cEntityStore->vStatus[uiStoreIndex] = bStatus ? 1 : 0;
+	else
+		this->bStatus = bStatus;
+}
+
+/**
+ @brief Set the health
+ @param _fHealth A float variable containing the health of this instance
+ */
+void CSolidObject::SetHealth(float _fHealth)
+{
+	if (cEntityStore)
+		cEntityStore->vHealth[uiStoreIndex] = _fHealth;
+	else
+		fHealth = _fHealth;
+}
+
+/**
+ @brief Get the type
+ @return A const CEntity3D::TYPE variable
+ */
+const CEntity3D::TYPE CSolidObject::GetType(void) const
+{
+	if (cEntityStore)
+		return cEntityStore->vType[uiStoreIndex];
+	return eType;
+}
+
+/**
+ @brief Get the position
+ @return A const glm::vec3 variable
+ */
+const glm::vec3 CSolidObject::GetPosition(void) const
+{
+	if (cEntityStore)
+		return cEntityStore->vPosition[uiStoreIndex];
+	return vec3Position;
+}
+
+/**
+ @brief Get the previous position
+ @return A const glm::vec3 variable
+ */
+const glm::vec3 CSolidObject::GetPreviousPosition(void) const
+{
+	if (cEntityStore)
+		return cEntityStore->vPreviousPosition[uiStoreIndex];
+	return vec3PreviousPosition;
+}
+
+/**
+ @brief Get the velocity
+ @return A const glm::vec3 variable
+ */
+const glm::vec3 CSolidObject::GetVel(void) const
+{
+	if (cEntityStore)
+		return cEntityStore->vVelocity[uiStoreIndex];
+	return vec3Vel;
+}
+
+/**
+ @brief Get the status
+ @return A const bool variable which is true if this instance is active, else false
+ */
+const bool CSolidObject::GetStatus(void) const
+{
+	if (cEntityStore)
+		return cEntityStore->vStatus[uiStoreIndex] != 0;
+	return bStatus;
+}
+
+/**
+ @brief Get the health
+ @return A float variable
+ */
+float CSolidObject::GetHealth(void)
+{
+	if (cEntityStore)
+		return cEntityStore->vHealth[uiStoreIndex];
+	return fHealth;
+}
+
 /**
  @brief Update the elapsed time
  @param dt A const double variable containing the elapsed time since the last frame
@@ -108,7 +267,7 @@ bool CSolidObject::Update(const double dElapsedTime)
 {
 	// create transformations
 	model = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
-	model = glm::translate(model, vec3Position);
+	model = glm::translate(model, GetPosition());
 	model = glm::scale(model, vec3Scale);
 	//model = glm::rotate(model, glm::radians(fYaw), glm::vec3(0.0f, 1.0f, 0.0f));
 
@@ -132,10 +291,6 @@ void CSolidObject::PreRender(void)
  */
 void CSolidObject::Render(void)
 {
-	// note: currently we set the projection matrix each frame, but since the projection 
-	// matrix rarely changes it's often best practice to set it outside the main loop only once.
-	CShaderManager::GetInstance()->activeShader->setMat4("projection", projection);
-	CShaderManager::GetInstance()->activeShader->setMat4("view", view);
 	CShaderManager::GetInstance()->activeShader->setMat4("model", model);
 
 	// bind textures on corresponding texture units
@@ -151,11 +306,17 @@ void CSolidObject::Render(void)
 	glBindTexture(GL_TEXTURE_2D, 0);
 
 	// Render the CCollider if needed
+	RenderCollider();
+}
+
+/**
+ @brief Render the CCollider, if it is displayed
+ */
+void CSolidObject::RenderCollider(void)
+{
 	if (this->bIsDisplayed)
 	{
 		CCollider::colliderModel = CEntity3D::model;
-		CCollider::colliderView = CEntity3D::view;
-		CCollider::colliderProjection = CEntity3D::projection;
 		CCollider::PreRender();
 		CCollider::Render();
 		CCollider::PostRender();
@@ -170,6 +331,78 @@ void CSolidObject::PostRender(void)
 	glDepthFunc(GL_LESS); // set depth function back to default
 }
 
+/**
+ @brief Get the bounding box in world space which is tested against the COcclusionCuller.
+		It is the model bounding box transformed by the model matrix of this frame.
+ @param vec3BoxMin A glm::vec3& variable which is set to the min corner of the bounding box
+ @param vec3BoxMax A glm::vec3& variable which is set to the max corner of the bounding box
+ @return true if a model was loaded with ExpandModelBox, else false
+ */
+bool CSolidObject::GetRenderBounds(glm::vec3& vec3BoxMin, glm::vec3& vec3BoxMax) const
+{
+	if (vec3ModelBoxMin.x > vec3ModelBoxMax.x)
+		return false;
+
+	vec3BoxMin = glm::vec3(FLT_MAX);
+	vec3BoxMax = glm::vec3(-FLT_MAX);
+	for (unsigned int i = 0; i < 8; i++)
+	{
+		const glm::vec3 vec3Corner = glm::vec3(model * glm::vec4(	(i & 1) ? vec3ModelBoxMax.x : vec3ModelBoxMin.x,
+																	(i & 2) ? vec3ModelBoxMax.y : vec3ModelBoxMin.y,
+																	(i & 4) ? vec3ModelBoxMax.z : vec3ModelBoxMin.z,
+																	1.0f));
+		vec3BoxMin = glm::min(vec3BoxMin, vec3Corner);
+		vec3BoxMax = glm::max(vec3BoxMax, vec3Corner);
+	}
+	return true;
+}
+
+/**
+ @brief Get the box in world space which hides the entities behind this instance.
+		The model bounding box is shrunk by fOccluderScale towards its centre on the XZ plane,
+		and towards its base on the Y axis, so that the box also stays inside arched roofs.
+		This is only valid for entities which are not rotated.
+ @param vec3BoxMin A glm::vec3& variable which is set to the min corner of the box
+ @param vec3BoxMax A glm::vec3& variable which is set to the max corner of the box
+ @return true if this instance is an occluder, else false
+ */
+bool CSolidObject::GetOccluderBox(glm::vec3& vec3BoxMin, glm::vec3& vec3BoxMax) const
+{
+	if ((fOccluderScale <= 0.0f) || (vec3ModelBoxMin.x > vec3ModelBoxMax.x))
+		return false;
+
+	const glm::vec3 vec3Min = vec3ModelBoxMin * vec3Scale;
+	const glm::vec3 vec3Max = vec3ModelBoxMax * vec3Scale;
+	const glm::vec3 vec3Centre = (vec3Min + vec3Max) * 0.5f;
+	const glm::vec3 vec3HalfSize = (vec3Max - vec3Min) * 0.5f * fOccluderScale;
+
+	vec3BoxMin = GetPosition() + glm::vec3(vec3Centre.x - vec3HalfSize.x, vec3Min.y, vec3Centre.z - vec3HalfSize.z);
+	vec3BoxMax = GetPosition() + glm::vec3(vec3Centre.x + vec3HalfSize.x, vec3Min.y + vec3HalfSize.y * 2.0f, vec3Centre.z + vec3HalfSize.z);
+	return true;
+}
+
+/**
+ @brief Set the size of the occluder box as a fraction of the model bounding box. 0 means this is not an occluder
+ @param fOccluderScale A const float variable
+ */
+void CSolidObject::SetOccluderScale(const float fOccluderScale)
+{
+	this->fOccluderScale = fOccluderScale;
+}
+
+/**
+ @brief Expand the model bounding box to contain the vertices of a model
+ @param vVertices A const std::vector<glm::vec3>& variable containing the vertices of the model
+ */
+void CSolidObject::ExpandModelBox(const std::vector<glm::vec3>& vVertices)
+{
+	for (unsigned int i = 0; i < vVertices.size(); i++)
+	{
+		vec3ModelBoxMin = glm::min(vec3ModelBoxMin, vVertices[i]);
+		vec3ModelBoxMax = glm::max(vec3ModelBoxMax, vVertices[i]);
+	}
+}
+
 /**
  @brief Print Self
  */
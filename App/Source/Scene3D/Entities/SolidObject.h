@@ -17,8 +17,11 @@
 #include <includes/gtc/type_ptr.hpp>
 
 #include <string>
+#include <vector>
 using namespace std;
 
+class CEntityStore;
+
 // An abstract camera class that processes input and calculates the corresponding Euler Angles, Vectors and Matrices for use in OpenGL
 class CSolidObject : public CEntity3D, public CCollider
 {
@@ -48,6 +51,21 @@ public:
 	// Set projection
 	virtual void SetProjection(const glm::mat4 projection);
 
+	// The hot data is kept in the CEntityStore while this instance is added to one,
+	// so these accessors are the only way to read and write it
+	virtual void SetType(const TYPE eType);
+	virtual void SetPosition(const glm::vec3 vec3Position);
+	virtual void SetPreviousPosition(const glm::vec3 vec3PreviousPosition);
+	virtual void SetVel(const glm::vec3 vec3Vel);
+	virtual void SetStatus(const bool bStatus);
+	virtual void SetHealth(float _fHealth);
+	virtual const CEntity3D::TYPE GetType(void) const;
+	virtual const glm::vec3 GetPosition(void) const;
+	virtual const glm::vec3 GetPreviousPosition(void) const;
+	virtual const glm::vec3 GetVel(void) const;
+	virtual const bool GetStatus(void) const;
+	virtual float GetHealth(void);
+
 	// Update this class instance
 	virtual bool Update(const double dElapsedTime);
 
@@ -58,10 +76,45 @@ public:
 	// PostRender
 	virtual void PostRender(void);
 
+	// Render the CCollider, if it is displayed
+	void RenderCollider(void);
+
+	// Get the bounding box in world space which is tested against the COcclusionCuller
+	virtual bool GetRenderBounds(glm::vec3& vec3BoxMin, glm::vec3& vec3BoxMax) const;
+	// Get the box in world space which hides the entities behind this instance
+	virtual bool GetOccluderBox(glm::vec3& vec3BoxMin, glm::vec3& vec3BoxMax) const;
+	// Set the size of the occluder box as a fraction of the model bounding box. 0 means this is not an occluder
+	void SetOccluderScale(const float fOccluderScale);
+
 	// Print Self
 	virtual void PrintSelf(void);
 
 protected:
 	// The number of indices in the model loaded in
 	unsigned int iIndicesSize;
+
+	// The bounding box of the models loaded in, in model space. It is empty until ExpandModelBox is called.
+	glm::vec3 vec3ModelBoxMin;
+	glm::vec3 vec3ModelBoxMax;
+	// The size of the occluder box as a fraction of the model bounding box
+	float fOccluderScale;
+
+	// Expand the model bounding box to contain the vertices of a model
+	void ExpandModelBox(const std::vector<glm::vec3>& vVertices);
+
+private:
+	// The CEntityStore moves the hot data in and out of these members, and keeps the index of this instance up to date
+	friend class CEntityStore;
+
+	// The classes derived from this class use the accessors instead of these members
+	using CEntity3D::eType;
+	using CEntity3D::vec3Position;
+	using CEntity3D::vec3PreviousPosition;
+	using CEntity3D::vec3Vel;
+	using CEntity3D::bStatus;
+	using CEntity3D::fHealth;
+
+	// The CEntityStore which holds the hot data of this instance, or NULL if it is not in one, and its index there
+	CEntityStore* cEntityStore;
+	unsigned int uiStoreIndex;
 };
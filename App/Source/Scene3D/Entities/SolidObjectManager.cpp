@@ -11,6 +11,7 @@
 
 #include "../Entities/Player3D.h"
 #include "../Entities/Car3D.h"
+#include "../Entities/Structure3D.h"
 
 #include "../CameraEffects/CameraEffectsManager.h"
 #include "../CameraEffects/HitMarker.h"
@@ -19,6 +20,18 @@
 //#include "../CameraEffects/CameraEffectsManager.h"
 
 #include <iostream>
+
+// Include CLogger
+#include "System/Logger.h"
+
+// Include CIndirectDrawBuffer
+#include "RenderControl/IndirectDrawBuffer.h"
+
+// Include COcclusionCuller
+#include "RenderControl/OcclusionCuller.h"
+
+// Include CAIScheduler
+#include "../AI/AIScheduler.h"
 using namespace std;
 
 /**
@@ -26,10 +39,19 @@ using namespace std;
  */
 CSolidObjectManager::CSolidObjectManager(void)
 	: model(glm::mat4(1.0f))
-	, view(glm::mat4(1.0f))
-	, projection(glm::mat4(1.0f))
 	, cProjectileManager(NULL)
+	, bStaticTreeDirty(false)
+	, bStaticBatchDirty(false)
+	, bOccludersDirty(false)
+	, bHitMarker(false)
+	, fHitAngle(0.0f)
 {
+	for (int i = 0; i < CEntity3D::TYPE::NUM_TYPES; i++)
+	{
+		for (int j = 0; j < CEntity3D::TYPE::NUM_TYPES; j++)
+			arrContactResponse[i][j] = NULL;
+		arrCollisionMask[i] = 0;
+	}
 }
 
 /**
@@ -40,13 +62,12 @@ CSolidObjectManager::~CSolidObjectManager(void)
 	// We won't delete this since it was created elsewhere
 	cProjectileManager = NULL;
 
-	// Remove all CSolidObject
-	std::list<CSolidObject*>::iterator it = lSolidObject.begin(), end = lSolidObject.end();
-	while (it != end)
+	// Remove all CSolidObject. They are taken out of the store first, as it gives them back their data.
+	vector<CSolidObject*> vSolidObject = cEntityStore.vSolidObject;
+	cEntityStore.Clear();
+	for (unsigned int i = 0; i < vSolidObject.size(); i++)
 	{
-		// Delete if done
-		delete *it;
-		it = lSolidObject.erase(it);
+		delete vSolidObject[i];
 	}
 }
 
@@ -56,10 +77,36 @@ CSolidObjectManager::~CSolidObjectManager(void)
  */
 bool CSolidObjectManager::Init(void)
 {
-	lSolidObject.clear();
+	cEntityStore.Clear();
+	cStaticTree.Clear();
+	bStaticTreeDirty = false;
+	cStaticBatch.Clear();
+	bStaticBatchDirty = false;
+	COcclusionCuller::GetInstance()->ClearOccluders(OCCLUDER_GROUP);
+	bOccludersDirty = false;
 
 	cProjectileManager = CProjectileManager::GetInstance();
 
+	// Set up the dispatch table. Only the pairs with a response are tested for collisions,
+	// so pairs such as STRUCTURE vs STRUCTURE are rejected before any geometry test.
+	SetContactResponse(CEntity3D::TYPE::PLAYER, CEntity3D::TYPE::CAR, &CSolidObjectManager::OnPlayerCar);
+	SetContactResponse(CEntity3D::TYPE::PLAYER, CEntity3D::TYPE::AMMO, &CSolidObjectManager::OnPlayerAmmo);
+	SetContactResponse(CEntity3D::TYPE::PLAYER, CEntity3D::TYPE::NPC, &CSolidObjectManager::OnPlayerMovable);
+	SetContactResponse(CEntity3D::TYPE::PLAYER, CEntity3D::TYPE::OTHERS, &CSolidObjectManager::OnPlayerMovable);
+	SetContactResponse(CEntity3D::TYPE::CAR, CEntity3D::TYPE::NPC, &CSolidObjectManager::OnCarMovable);
+	SetContactResponse(CEntity3D::TYPE::CAR, CEntity3D::TYPE::OTHERS, &CSolidObjectManager::OnCarMovable);
+	SetContactResponse(CEntity3D::TYPE::NPC, CEntity3D::TYPE::NPC, &CSolidObjectManager::OnMovableMovable);
+	SetContactResponse(CEntity3D::TYPE::NPC, CEntity3D::TYPE::OTHERS, &CSolidObjectManager::OnMovableMovable);
+	SetContactResponse(CEntity3D::TYPE::OTHERS, CEntity3D::TYPE::OTHERS, &CSolidObjectManager::OnMovableMovable);
+	SetContactResponse(CEntity3D::TYPE::PLAYER, CEntity3D::TYPE::STRUCTURE, &CSolidObjectManager::OnPlayerStructure);
+	SetContactResponse(CEntity3D::TYPE::CAR, CEntity3D::TYPE::STRUCTURE, &CSolidObjectManager::OnCarStructure);
+	SetContactResponse(CEntity3D::TYPE::PLAYER, CEntity3D::TYPE::PROJECTILE, &CSolidObjectManager::OnPlayerProjectile);
+	SetContactResponse(CEntity3D::TYPE::CAR, CEntity3D::TYPE::PROJECTILE, &CSolidObjectManager::OnEntityProjectile);
+	SetContactResponse(CEntity3D::TYPE::NPC, CEntity3D::TYPE::PROJECTILE, &CSolidObjectManager::OnEntityProjectile);
+	SetContactResponse(CEntity3D::TYPE::STRUCTURE, CEntity3D::TYPE::PROJECTILE, &CSolidObjectManager::OnEntityProjectile);
+
+	vContact.reserve(256);
+
 	return true;
 }
 
@@ -73,30 +120,30 @@ void CSolidObjectManager::SetModel(const glm::mat4 model)
 }
 
 /**
- @brief Set view
- @param view A const glm::mat4 variable containing the model for this class instance
- */
-void CSolidObjectManager::SetView(const glm::mat4 view)
-{
-	this->view = view;
-}
-
-/**
- @brief Set projection
- @param projection A const glm::mat4 variable containing the model for this class instance
+ @brief Add a CSolidObject* to this class instance
+ @param cSolidObject The CSolidObject* variable to be added to this class instance
  */
-void CSolidObjectManager::SetProjection(const glm::mat4 projection)
+void CSolidObjectManager::Add(CSolidObject* cSolidObject)
 {
-	this->projection = projection;
+	EntityHandle handle = cEntityStore.Add(cSolidObject);
+	// Stagger the updates of the NPCs which are added together
+	if (cSolidObject->GetType() == CEntity3D::TYPE::NPC)
+		cEntityStore.vThinkTime[cEntityStore.GetIndex(handle)] = CAIScheduler::GetInstance()->GetStartThinkTime();
 }
 
 /**
- @brief Add a CSolidObject* to this class instance
+ @brief Add a CSolidObject* which never moves to this class instance.
+		It is placed in the static collision tree, which is rebuilt before the next collision check,
+		and merged into the CStaticBatch before the next Render if it can be batched.
+		If it is an occluder, the occluders are rebuilt before the next Render.
  @param cSolidObject The CSolidObject* variable to be added to this class instance
  */
-void CSolidObjectManager::Add(CSolidObject* cSolidObject)
+void CSolidObjectManager::AddStatic(CSolidObject* cSolidObject)
 {
-	lSolidObject.push_back(cSolidObject);
+	cEntityStore.Add(cSolidObject, true);
+	bStaticTreeDirty = true;
+	bStaticBatchDirty = true;
+	bOccludersDirty = true;
 }
 
 /**
@@ -106,20 +153,17 @@ void CSolidObjectManager::Add(CSolidObject* cSolidObject)
  */
 bool CSolidObjectManager::Erase(CSolidObject* cSolidObject)
 {
-	// Find the entity's iterator
-	std::list<CSolidObject*>::iterator findIter = std::find(lSolidObject.begin(), lSolidObject.end(), cSolidObject);
-
-	// Delete the entity if found
-	if (findIter != lSolidObject.end())
+	// Find the entity's handle and remove it from the store.
+	// The CSolidObject is not deleted here.
+	// Return false if not found
+	EntityHandle handle = cEntityStore.Find(cSolidObject);
+	if (cEntityStore.IsStatic(handle))
 	{
-		// Delete the CSolidObject
-		//delete *findIter;
-		// Go to the next iteration after erasing from the list
-findIter = lSolidObject.erase(findIter);
-return true;
+		bStaticTreeDirty = true;
+		bOccludersDirty = true;
 	}
-	// Return false if not found
-	return false;
+	cStaticBatch.Remove(handle);
+	return cEntityStore.Remove(handle);
 }
 
 /**
@@ -129,28 +173,29 @@ return true;
  */
 bool CSolidObjectManager::CollisionCheck(CSolidObject* cSolidObject)
 {
-	std::list<CSolidObject*>::iterator it, end;
-	end = lSolidObject.end();
-	for (it = lSolidObject.begin(); it != end; ++it)
+	const glm::vec3 vec3BoxMin = cSolidObject->GetPosition() + cSolidObject->boxMin;
+	const glm::vec3 vec3BoxMax = cSolidObject->GetPosition() + cSolidObject->boxMax;
+
+	for (unsigned int i = 0; i < cEntityStore.GetSize(); i++)
 	{
 		// Check for collisions between the 2 entities
-		if (CCollisionManager::BoxBoxCollision(cSolidObject->GetPosition() + cSolidObject->boxMin,
-			cSolidObject->GetPosition() + cSolidObject->boxMax,
-			(*it)->GetPosition() + (*it)->boxMin,
-			(*it)->GetPosition() + (*it)->boxMax) == true)
+		if (CCollisionManager::BoxBoxCollision(vec3BoxMin,
+			vec3BoxMax,
+			cEntityStore.vBoxMin[i],
+			cEntityStore.vBoxMax[i]) == true)
 		{
 			// Rollback the cSolidObject's position
 			cSolidObject->RollbackPosition();
 			// Rollback the NPC's position
-			(*it)->RollbackPosition();
-			if ((*it)->GetType() == CSolidObject::TYPE::NPC)
-			cout << "** Collision between this Entity and a NPC ***" << endl;
-			else if ((*it)->GetType() == CSolidObject::TYPE::OTHERS)
-			cout << "** Collision between this Entity and an OTHERS ***" << endl;
-			else if ((*it)->GetType() == CSolidObject::TYPE::STRUCTURE)
-			cout << "** Collision between this Entity and a STRUCTURE ***" << endl;
-			else if ((*it)->GetType() == CSolidObject::TYPE::PROJECTILE)
-			cout << "** Collision between this Entity and a PROJECTILE ***" << endl;
+			cEntityStore.vSolidObject[i]->RollbackPosition();
+			if (cEntityStore.vType[i] == CSolidObject::TYPE::NPC)
+				LOG_DEBUG_EVERY(0.5, COLLISION, "Collision between this Entity and a NPC");
+			else if (cEntityStore.vType[i] == CSolidObject::TYPE::OTHERS)
+				LOG_DEBUG_EVERY(0.5, COLLISION, "Collision between this Entity and an OTHERS");
+			else if (cEntityStore.vType[i] == CSolidObject::TYPE::STRUCTURE)
+				LOG_DEBUG_EVERY(0.5, COLLISION, "Collision between this Entity and a STRUCTURE");
+			else if (cEntityStore.vType[i] == CSolidObject::TYPE::PROJECTILE)
+				LOG_DEBUG_EVERY(0.5, COLLISION, "Collision between this Entity and a PROJECTILE");
 			// Quit this loop since a collision has been found
 			break;
 		}
@@ -166,21 +211,31 @@ bool CSolidObjectManager::CollisionCheck(CSolidObject* cSolidObject)
  */
 bool CSolidObjectManager::Update(const double dElapsedTime)
 {
+	CAIScheduler* cAIScheduler = CAIScheduler::GetInstance();
+
+	// The entities which do not move in this frame get closer to sleeping
+	cEntityStore.BeginFrame();
+
 	enemyCount = 0;
-	std::list<CSolidObject*>::iterator it, end;
 	// Update all CSolidObject
-	end = lSolidObject.end();
-	for (it = lSolidObject.begin(); it != end; ++it)
+	for (unsigned int i = 0; i < cEntityStore.GetSize(); i++)
 	{
-		if ((*it)->GetType() == CEntity3D::TYPE::NPC && (*it)->GetStatus())
+		if (cEntityStore.vType[i] == CEntity3D::TYPE::NPC && cEntityStore.vStatus[i])
+		{
 			enemyCount++;
-		(*it)->Update(dElapsedTime);
+			// The CAIScheduler decides when an active NPC updates, and by how much time
+			double dUpdateTime = 0.0;
+			if (cAIScheduler->Schedule(cEntityStore.vThinkTime[i], cEntityStore.vPosition[i], dElapsedTime, dUpdateTime))
+				cEntityStore.vSolidObject[i]->Update(dUpdateTime);
+			continue;
+		}
+		cEntityStore.vSolidObject[i]->Update(dElapsedTime);
 	}
 
 	if (enemyCount == 0)
 		allEnemyDied = true;
 
-	std::cout << "COIUNT: " << enemyCount << std::endl;
+	LOG_TRACE_EVERY(1.0, ENTITY, "Number of active enemies: %d", enemyCount);
 
 	return true;
 }
@@ -191,313 +246,629 @@ bool CSolidObjectManager::Update(const double dElapsedTime)
  */
 bool CSolidObjectManager::CheckForCollision(void)
 {
-	bool bResult = false;
-	bool isWallRun = false;
-	float hitAngle = 0;
+	bHitMarker = false;
+	fHitAngle = 0.0f;
 
-	std::list<CSolidObject*>::iterator it, end;
-	std::list<CSolidObject*>::iterator it_other;
+	// Find all the contacts in this frame, then run their responses
+	vContact.clear();
+	FindEntityContacts();
+	FindProjectileContacts();
+	DispatchContacts();
 
-	// Check for collisions among entities
-	end = lSolidObject.end();
-	for (it = lSolidObject.begin(); it != end; ++it)
+	if (bHitMarker == true)
 	{
-		// If the entity is not active, then skip it
-		if ((*it)->GetStatus() == false)
+		CCameraEffectsManager::GetInstance()->Get("HitMarker")->SetStatus(true);
+		((CHitMarker*)(CCameraEffectsManager::GetInstance()->Get("HitMarker")))->angle = glm::degrees(fHitAngle);
+	}
+
+	return true;
+}
+
+/**
+ @brief Find the contacts among entities.
+		Static entities are only tested against moving entities, through cStaticTree,
+		and entities which are asleep are only tested against entities which are awake.
+ */
+void CSolidObjectManager::FindEntityContacts(void)
+{
+	glm::vec3 vec3Normal;
+	float fPenetration = 0.0f;
+
+	// Rebuild the static tree if a static entity was added or removed
+	if (bStaticTreeDirty)
+	{
+		cStaticTree.Build(cEntityStore);
+		bStaticTreeDirty = false;
+	}
+
+	// Collect the active, non-static entities
+	vDynamic.clear();
+	for (unsigned int i = 0; i < cEntityStore.GetSize(); i++)
+	{
+		if ((cEntityStore.vStatus[i] != 0) && (cEntityStore.vStatic[i] == 0))
+			vDynamic.push_back(i);
+	}
+
+	for (unsigned int a = 0; a < vDynamic.size(); a++)
+	{
+		const unsigned int i = vDynamic[a];
+
+		// An entity which is asleep does not look for contacts itself
+		if (cEntityStore.IsAsleep(i))
 			continue;
 
-		for (it_other = lSolidObject.begin(); it_other != end; ++it_other)
+		const unsigned int uiMask = arrCollisionMask[cEntityStore.vType[i]];
+		if (uiMask == 0)
+			continue;
+
+		// Check against the static entities
+		if ((uiMask & cStaticTree.GetTypeMask()) != 0)
 		{
-			// If the entity is not active, then skip it
-			if ((*it_other)->GetStatus() == false)
+			vStaticResult.clear();
+			cStaticTree.Query(cEntityStore.vBoxMin[i], cEntityStore.vBoxMax[i], vStaticResult);
+			for (unsigned int k = 0; k < vStaticResult.size(); k++)
+			{
+				const unsigned int j = cEntityStore.GetIndex(vStaticResult[k]);
+				if ((j == EntityHandle::INVALID_INDEX) || (cEntityStore.vStatus[j] == 0))
+					continue;
+				if ((uiMask & (1 << cEntityStore.vType[j])) == 0)
+					continue;
+
+				// The tree only compared the boxes, so calculate the normal and penetration here
+				if (CCollisionManager::BoxBoxCollision(cEntityStore.vBoxMin[i],
+					cEntityStore.vBoxMax[i],
+					cEntityStore.vBoxMin[j],
+					cEntityStore.vBoxMax[j],
+					vec3Normal,
+					fPenetration) == true)
+					AddEntityContact(i, j, vec3Normal, fPenetration);
+			}
+		}
+
+		// Check against the other moving entities
+		for (unsigned int b = 0; b < vDynamic.size(); b++)
+		{
+			const unsigned int j = vDynamic[b];
+			if (j == i)
+				continue;
+
+			// Check each pair of awake entities once. A pair with a sleeping entity is only seen from the awake side.
+			if ((b < a) && (cEntityStore.IsAsleep(j) == false))
 				continue;
 
-			// If the 2 entities to check are the same, then skip this iteration
-			if (it_other == it)
+			// Skip the pairs which are masked out
+			if ((uiMask & (1 << cEntityStore.vType[j])) == 0)
 				continue;
 
 			// Check for collisions between the 2 entities
-			if (CCollisionManager::BoxBoxCollision((*it)->GetPosition() + (*it)->boxMin,
-				(*it)->GetPosition() + (*it)->boxMax,
-				(*it_other)->GetPosition() + (*it_other)->boxMin,
-				(*it_other)->GetPosition() + (*it_other)->boxMax) == true)
-			{
-				if ((*it)->GetType() == CSolidObject::TYPE::PLAYER &&
-					(*it_other)->GetType() == CSolidObject::TYPE::CAR)
-				{
-					if (!CPlayer3D::GetInstance()->isDriving)
-						(*it)->RollbackPosition();
-					cout << "** Collision between Player and an Entity ***" << endl;
-					break;
-				}
-				else if ((*it)->GetType() == CSolidObject::TYPE::PLAYER &&
-					(*it_other)->GetType() == CSolidObject::TYPE::AMMO)
-				{
-					//increase player ammo
-					CPlayer3D::GetInstance()->GetWeapon()->SetTotalRound(CPlayer3D::GetInstance()->GetWeapon()->GetTotalRound() + 30);
-					(*it_other)->SetStatus(false);
-					cout << "** Collision between Player and Ammo ***" << endl;
-					break;
-				}
-				// Check if a movable entity collides with another movable entity
-				else if (
-					(((*it)->GetType() >= CSolidObject::TYPE::PLAYER) &&
-						((*it)->GetType() <= CSolidObject::TYPE::CAR))
-					&&
-					(((*it_other)->GetType() >= CSolidObject::TYPE::NPC) &&
-						((*it_other)->GetType() <= CSolidObject::TYPE::OTHERS))
-					)
-				{
-
-					if ((*it)->GetType() == CSolidObject::TYPE::PLAYER)
-					{
-						(*it)->RollbackPosition();
-						(*it_other)->RollbackPosition();
-						if (CPlayer3D::GetInstance()->GetWeapon()->isMeleeAttacking)
-						{
-							//player melee attack
-							(*it_other)->SetHealth((*it_other)->GetHealth() - CPlayer3D::GetInstance()->GetWeapon()->GetDamage());
-							if ((*it_other)->GetHealth() <= 0)
-								(*it_other)->SetStatus(false);
-						}
-					}
-					else
-					{
-						//set enemy vel relative to the car's front
-						CCar3D* c = (CCar3D*)(*it);
-						(*it_other)->SetVel((*it_other)->GetVel() + (*it)->GetFront() * c->GetCurrSpeed());
-						(*it_other)->SetHealth((*it_other)->GetHealth() - c->GetCurrSpeed());
-						if ((*it_other)->GetHealth() <= 0)
-							(*it_other)->SetStatus(false);
-					}
-
-					//calculate hitmarker angle
-					glm::vec3 dist = (*it)->GetFront() - (*it_other)->GetFront();
-					hitAngle = atan2f(dist.z, dist.x);
-					bResult = true;
-					cout << "** Collision between Player and an Entity ***" << endl;
-					break;
-				}
-				else if (
-						(((*it)->GetType() >= CSolidObject::TYPE::NPC) &&
-						((*it)->GetType() <= CSolidObject::TYPE::OTHERS))
-						&&
-						(((*it_other)->GetType() >= CSolidObject::TYPE::NPC) &&
-						((*it_other)->GetType() <= CSolidObject::TYPE::OTHERS))
-					)
-				{
-					(*it)->RollbackPosition();
-					(*it_other)->RollbackPosition();
-					cout << "** Collision between 2 Entities ***" << endl;
-					break;
-				}
-				// Check if a movable entity collides with a non-movable entity
-				if (
-						(((*it)->GetType() >= CSolidObject::TYPE::PLAYER) &&
-							((*it)->GetType() <= CSolidObject::TYPE::OTHERS))
-						&&
-						((*it_other)->GetType() == CSolidObject::TYPE::STRUCTURE))
-				{
-					if (((*it)->GetType() == CSolidObject::TYPE::PLAYER))
-					{
-						(*it)->RollbackPosition();
-
-					}
-					else if ((*it)->GetType() == CSolidObject::TYPE::CAR)
-					{
-						CCar3D* c = (CCar3D*)(*it);
-						(*it)->SetVel((*it)->GetVel() - (*it)->GetFront() * c->GetCurrSpeed());
-					}
-
-					/*if (bResult)
-						CCameraEffectsManager::GetInstance()->Get("BloodScreen")->SetStatus(true);*/
-					//float dotPdt = glm::dot((*it_other)->GetFront(), (*it)->GetFront()); //wall's front dot player's front
-					//std::cout << "WALLFRONT: " << (*it_other)->GetFront().x << " " << (*it_other)->GetFront().y << " " << (*it_other)->GetFront().z <<
-					//	" PLAYERFRONT: " << (*it)->GetFront().x << " " << (*it)->GetFront().y << " " << (*it)->GetFront().z << std::endl;
-					//std::cout << "DOT: " << dotPdt << std::endl;
-					//CPlayer3D* cPlayer3D = dynamic_cast<CPlayer3D*>(*it);
-					//if ((dotPdt > 0.8f || dotPdt < -0.8f) && cPlayer3D->GetPhysics().GetStatus() != CPhysics3D::STATUS::IDLE) //check if player is looking perpendicular to the wall's front
-					//{
-					//	isWallRun = true; //tilt cam using this bool
-					//	std::cout << "Wall running" << std::endl;
-					//	cPlayer3D->GetPhysics().SetStatus(CPhysics3D::STATUS::WALL_RUN);
-					//	(*it)->SetPosition((*it)->GetPosition() + glm::vec3((*it)->GetFront().x / 10, 0, (*it)->GetFront().z / 10)); //move the player towards the direction of the wall's front
-					//}
-					cout << "** Collision between Entity and Structure ***" << endl;
-					break;
-				}
-			}
+			if (CCollisionManager::BoxBoxCollision(cEntityStore.vBoxMin[i],
+				cEntityStore.vBoxMax[i],
+				cEntityStore.vBoxMin[j],
+				cEntityStore.vBoxMax[j],
+				vec3Normal,
+				fPenetration) == true)
+				AddEntityContact(i, j, vec3Normal, fPenetration);
 		}
 	}
+}
+
+/**
+ @brief Add a contact between 2 entities, ordered to match an entry in the dispatch table
+ @param uiEntity The dense index of the first entity
+ @param uiOther The dense index of the second entity
+ @param vec3Normal The axis along which the first entity should move to separate from the second
+ @param fPenetration The penetration depth
+ */
+void CSolidObjectManager::AddEntityContact(	const unsigned int uiEntity,
+											const unsigned int uiOther,
+											const glm::vec3& vec3Normal,
+											const float fPenetration)
+{
+	CollisionContact cContact;
+	const CEntity3D::TYPE eType = cEntityStore.vType[uiEntity];
+	const CEntity3D::TYPE eOtherType = cEntityStore.vType[uiOther];
+
+	if (arrContactResponse[eType][eOtherType] != NULL)
+	{
+		cContact.hEntity = cEntityStore.vHandle[uiEntity];
+		cContact.hOther = cEntityStore.vHandle[uiOther];
+		cContact.eType = eType;
+		cContact.eOtherType = eOtherType;
+		cContact.vec3Normal = vec3Normal;
+	}
+	else
+	{
+		cContact.hEntity = cEntityStore.vHandle[uiOther];
+		cContact.hOther = cEntityStore.vHandle[uiEntity];
+		cContact.eType = eOtherType;
+		cContact.eOtherType = eType;
+		cContact.vec3Normal = -vec3Normal;
+	}
+	cContact.uiProjectile = CollisionContact::NO_PROJECTILE;
+	cContact.fPenetration = fPenetration;
+	vContact.push_back(cContact);
+}
 
-	// Check for collisions between entities and projectiles
-	end = lSolidObject.end();
-	for (it = lSolidObject.begin(); it != end; ++it)
+/**
+ @brief Find the contacts between entities and projectiles
+ */
+void CSolidObjectManager::FindProjectileContacts(void)
+{
+	CollisionContact cContact;
+	glm::vec3 vec3Normal;
+	float fPenetration = 0.0f;
+
+	cContact.hOther = EntityHandle();
+	cContact.eOtherType = CEntity3D::TYPE::PROJECTILE;
+
+	const unsigned int uiProjectileBit = (1 << CEntity3D::TYPE::PROJECTILE);
+
+	for (unsigned int k = 0; k < cProjectileManager->vProjectile.size(); k++)
 	{
-		// If the entity is not active, then skip it
-		if ((*it)->GetStatus() == false)
+		CProjectile* cProjectile = cProjectileManager->vProjectile[k];
+
+		// If the projectile is not active, then skip it
+		if (cProjectile->GetStatus() == false)
 			continue;
 
-		for (unsigned int i = 0; i < cProjectileManager->vProjectile.size(); i++)
+		cContact.uiProjectile = k;
+
+		// Check against the static entities which the projectile swept past in this frame
+		vStaticResult.clear();
+		cStaticTree.Query(	glm::min(cProjectile->GetPreviousPosition(), cProjectile->GetPosition()) + cProjectile->boxMin,
+							glm::max(cProjectile->GetPreviousPosition(), cProjectile->GetPosition()) + cProjectile->boxMax,
+							vStaticResult);
+		for (unsigned int s = 0; s < vStaticResult.size(); s++)
 		{
-			// If the entity is not active, then skip it
-			if ((cProjectileManager->vProjectile[i])->GetStatus() == false)
+			const unsigned int i = cEntityStore.GetIndex(vStaticResult[s]);
+			if ((i == EntityHandle::INVALID_INDEX) || (cEntityStore.vStatus[i] == 0))
+				continue;
+			if ((arrCollisionMask[cEntityStore.vType[i]] & uiProjectileBit) == 0)
 				continue;
 
-			// Use ray tracing to check for collisions between the 2 entities
-			if (CCollisionManager::RayBoxCollision((*it)->GetPosition() + (*it)->boxMin,
-				(*it)->GetPosition() + (*it)->boxMax,
-				(cProjectileManager->vProjectile[i])->GetPreviousPosition(),
-				(cProjectileManager->vProjectile[i])->GetPosition()))
+			if (ProjectileCollision(i, cProjectile, vec3Normal, fPenetration))
 			{
-				if ((*it)->GetType() == CSolidObject::TYPE::PLAYER)
-				{
-					// If this projectile is fired by the player, then skip it
-					if ((cProjectileManager->vProjectile[i])->GetSource() == (*it))
-						continue;
-					(cProjectileManager->vProjectile[i])->SetStatus(false);
-
-					//Damage the player health using the projectile damage
-					(*it)->SetHealth((*it)->GetHealth() - cProjectileManager->vProjectile[i]->GetDamage());
-					if ((*it)->GetHealth() <= 0)
-						(*it)->SetStatus(false);
-					
-					cout << "** RayBoxCollision between Player and Projectile ***" << endl;
-					glm::vec3 dist = (*it)->GetFront() - (cProjectileManager->vProjectile[i])->GetSource()->GetFront();
-					hitAngle = atan2f(dist.z, dist.x);
-					bResult = true;
-					break;
-				}
-				else if ((*it)->GetType() == CSolidObject::TYPE::NPC)
-				{
-					// If this projectile is fired by the NPC, then skip it
-					if ((cProjectileManager->vProjectile[i])->GetSource() == (*it))
-						continue;
-					(cProjectileManager->vProjectile[i])->SetStatus(false);
-					//Damage the player health using the projectile damage
-					(*it)->SetHealth((*it)->GetHealth() - cProjectileManager->vProjectile[i]->GetDamage());
-					if ((*it)->GetHealth() <= 0)
-						(*it)->SetStatus(false);
-					std::cout << "HEALTH: " << (*it)->GetHealth() << std::endl;
-
-					cout << "** RayBoxCollision between NPC and Projectile ***" << endl;
-					break;
-				}
-				else if ((*it)->GetType() == CSolidObject::TYPE::STRUCTURE || (*it)->GetType() == CSolidObject::TYPE::CAR)
-				{
-					(cProjectileManager->vProjectile[i])->SetStatus(false);
-
-					//Damage the player health using the projectile damage
-					(*it)->SetHealth((*it)->GetHealth() - cProjectileManager->vProjectile[i]->GetDamage());
-					if ((*it)->GetHealth() <= 0)
-						(*it)->SetStatus(false);
-
-					cout << "** RayBoxCollision between Structure and Projectile ***" << endl;
-					break;
-				}
+				cContact.hEntity = cEntityStore.vHandle[i];
+				cContact.eType = cEntityStore.vType[i];
+				cContact.vec3Normal = vec3Normal;
+				cContact.fPenetration = fPenetration;
+				vContact.push_back(cContact);
 			}
+		}
 
-			// Check for collisions between the 2 entities
-			if (CCollisionManager::BoxBoxCollision((*it)->GetPosition() + (*it)->boxMin,
-				(*it)->GetPosition() + (*it)->boxMax,
-				(cProjectileManager->vProjectile[i])->GetPosition() + (cProjectileManager->vProjectile[i])->boxMin,
-				(cProjectileManager->vProjectile[i])->GetPosition() + (cProjectileManager->vProjectile[i])->boxMax) == true)
+		// Check against the moving entities, including those which are asleep
+		for (unsigned int a = 0; a < vDynamic.size(); a++)
+		{
+			const unsigned int i = vDynamic[a];
+			if ((arrCollisionMask[cEntityStore.vType[i]] & uiProjectileBit) == 0)
+				continue;
+
+			if (ProjectileCollision(i, cProjectile, vec3Normal, fPenetration))
 			{
-				if ((*it)->GetType() == CSolidObject::TYPE::PLAYER)
-				{
-					// If this projectile is fired by the player, then skip it
-					if ((cProjectileManager->vProjectile[i])->GetSource() == (*it))
-						continue;
-
-					(cProjectileManager->vProjectile[i])->SetStatus(false);
-
-					//Damage the player health using the projectile damage
-					(*it)->SetHealth((*it)->GetHealth() - cProjectileManager->vProjectile[i]->GetDamage());
-					if ((*it)->GetHealth() <= 0)
-						(*it)->SetStatus(false);
-
-					cout << "** BoxBoxCollision between Player and Projectile ***" << endl;
-					glm::vec3 dist = (*it)->GetFront() - (cProjectileManager->vProjectile[i])->GetSource()->GetFront();
-					hitAngle = atan2f(dist.z, dist.x);
-					bResult = true;
-					break;
-				}
-				else if ((*it)->GetType() == CSolidObject::TYPE::NPC)
-				{
-					(cProjectileManager->vProjectile[i])->SetStatus(false);
-
-					//Damage the player health using the projectile damage
-					(*it)->SetHealth((*it)->GetHealth() - cProjectileManager->vProjectile[i]->GetDamage());
-					if ((*it)->GetHealth() <= 0)
-						(*it)->SetStatus(false);
-
-					cout << "** BoxBoxCollision between NPC and Projectile ***" << endl;
-					break;
-				}
-				else if ((*it)->GetType() == CSolidObject::TYPE::STRUCTURE)
-				{
-					(cProjectileManager->vProjectile[i])->SetStatus(false);
-
-					//Damage the player health using the projectile damage
-					(*it)->SetHealth((*it)->GetHealth() - cProjectileManager->vProjectile[i]->GetDamage());
-					if ((*it)->GetHealth() <= 0)
-						(*it)->SetStatus(false);
-
-					cout << "** BoxBoxCollision between Structure and Projectile ***" << endl;
-					break;
-				}
+				cContact.hEntity = cEntityStore.vHandle[i];
+				cContact.eType = cEntityStore.vType[i];
+				cContact.vec3Normal = vec3Normal;
+				cContact.fPenetration = fPenetration;
+				vContact.push_back(cContact);
 			}
 		}
 	}
-	
-	if (bResult == true)
+}
+
+/**
+ @brief Check for a collision between an entity and a projectile
+ @param uiEntity The dense index of the entity
+ @param cProjectile The projectile
+ @param vec3Normal The contact normal is returned here
+ @param fPenetration The penetration depth is returned here
+ @return true if they collide, else false
+ */
+bool CSolidObjectManager::ProjectileCollision(	const unsigned int uiEntity,
+												CProjectile* cProjectile,
+												glm::vec3& vec3Normal,
+												float& fPenetration) const
+{
+	// A projectile does not hit the entity which fired it
+	if (cProjectile->GetSource() == cEntityStore.vSolidObject[uiEntity])
+		return false;
+
+	// Use ray tracing to check for collisions between the 2 entities,
+	// so that fast projectiles do not pass through thin entities
+	const glm::vec3 vec3Ray = cProjectile->GetPosition() - cProjectile->GetPreviousPosition();
+	if (CCollisionManager::RayBoxCollision(cEntityStore.vBoxMin[uiEntity],
+		cEntityStore.vBoxMax[uiEntity],
+		cProjectile->GetPreviousPosition(),
+		cProjectile->GetPosition()))
 	{
-		CCameraEffectsManager::GetInstance()->Get("HitMarker")->SetStatus(true);
-		((CHitMarker*)(CCameraEffectsManager::GetInstance()->Get("HitMarker")))->angle = glm::degrees(hitAngle);
+		vec3Normal = (glm::length(vec3Ray) > 0.0f) ? -glm::normalize(vec3Ray) : glm::vec3(0.0f);
+		fPenetration = 0.0f;
+		return true;
 	}
 
-	return true;
+	return CCollisionManager::BoxBoxCollision(cEntityStore.vBoxMin[uiEntity],
+		cEntityStore.vBoxMax[uiEntity],
+		cProjectile->GetPosition() + cProjectile->boxMin,
+		cProjectile->GetPosition() + cProjectile->boxMax,
+		vec3Normal,
+		fPenetration);
 }
 
 /**
- @brief CleanUp all CEntity3Ds which are marked for deletion
+ @brief Run the response to each contact
  */
-void CSolidObjectManager::CleanUp(void)
+void CSolidObjectManager::DispatchContacts(void)
 {
-	std::list<CSolidObject*>::iterator it, end;
-	it = lSolidObject.begin();
-	end = lSolidObject.end();
-	while (it != end)
+	for (unsigned int i = 0; i < vContact.size(); i++)
 	{
-		if ((*it)->IsToDelete())
+		const CollisionContact& cContact = vContact[i];
+
+		ContactResponse fnResponse = arrContactResponse[cContact.eType][cContact.eOtherType];
+		if (fnResponse == NULL)
+			continue;
+
+		// An earlier response may have deactivated an entity in this contact, e.g. an ammo box which was picked up
+		const unsigned int uiEntity = cEntityStore.GetIndex(cContact.hEntity);
+		if ((uiEntity == EntityHandle::INVALID_INDEX) || (cEntityStore.vSolidObject[uiEntity]->GetStatus() == false))
+			continue;
+		CSolidObject* cEntity = cEntityStore.vSolidObject[uiEntity];
+
+		if (cContact.eOtherType == CEntity3D::TYPE::PROJECTILE)
 		{
-			// Delete the CSolidObject
-			delete *it;
-			// Go to the next iteration after erasing from the list
-			it = lSolidObject.erase(it);
+			// A projectile is used up by the first entity which it hits
+			if (cProjectileManager->vProjectile[cContact.uiProjectile]->GetStatus() == false)
+				continue;
+
+			(this->*fnResponse)(cContact, cEntity, NULL);
 		}
 		else
 		{
-			// Go to the next iteration
-			++it;
+			const unsigned int uiOther = cEntityStore.GetIndex(cContact.hOther);
+			if ((uiOther == EntityHandle::INVALID_INDEX) || (cEntityStore.vSolidObject[uiOther]->GetStatus() == false))
+				continue;
+			CSolidObject* cOther = cEntityStore.vSolidObject[uiOther];
+
+			(this->*fnResponse)(cContact, cEntity, cOther);
+		}
+	}
+}
+
+/**
+ @brief Set the response to a contact between 2 types of entities and enable their collision tests
+ @param eType The type of the entity which the response acts on
+ @param eOtherType The type of the other entity
+ @param fnResponse The response
+ */
+void CSolidObjectManager::SetContactResponse(const CEntity3D::TYPE eType, const CEntity3D::TYPE eOtherType, ContactResponse fnResponse)
+{
+	arrContactResponse[eType][eOtherType] = fnResponse;
+	SetCollisionMask(eType, eOtherType, fnResponse != NULL);
+}
+
+/**
+ @brief Enable or disable the collision tests between 2 types of entities
+ @param eTypeA The first type
+ @param eTypeB The second type
+ @param bCollide true if the 2 types are to be tested for collisions
+ */
+void CSolidObjectManager::SetCollisionMask(const CEntity3D::TYPE eTypeA, const CEntity3D::TYPE eTypeB, const bool bCollide)
+{
+	if (bCollide)
+	{
+		arrCollisionMask[eTypeA] |= (1 << eTypeB);
+		arrCollisionMask[eTypeB] |= (1 << eTypeA);
+	}
+	else
+	{
+		arrCollisionMask[eTypeA] &= ~(1 << eTypeB);
+		arrCollisionMask[eTypeB] &= ~(1 << eTypeA);
+	}
+}
+
+/**
+ @brief Check if 2 types of entities are tested for collisions
+ @param eTypeA The first type
+ @param eTypeB The second type
+ @return true if the 2 types are tested for collisions
+ */
+bool CSolidObjectManager::GetCollisionMask(const CEntity3D::TYPE eTypeA, const CEntity3D::TYPE eTypeB) const
+{
+	return (arrCollisionMask[eTypeA] & (1 << eTypeB)) != 0;
+}
+
+/**
+ @brief Get the contacts found in the last call to CheckForCollision
+ @return A const vector<CollisionContact>& variable
+ */
+const vector<CollisionContact>& CSolidObjectManager::GetContacts(void) const
+{
+	return vContact;
+}
+
+/**
+ @brief Response to a contact between the player and a car
+ */
+void CSolidObjectManager::OnPlayerCar(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther)
+{
+	if (!CPlayer3D::GetInstance()->isDriving)
+		cEntity->RollbackPosition();
+	LOG_DEBUG_EVERY(0.5, COLLISION, "Collision between Player and a Car");
+}
+
+/**
+ @brief Response to a contact between the player and an ammo box
+ */
+void CSolidObjectManager::OnPlayerAmmo(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther)
+{
+	//increase player ammo
+	CPlayer3D::GetInstance()->GetWeapon()->SetTotalRound(CPlayer3D::GetInstance()->GetWeapon()->GetTotalRound() + 30);
+	cOther->SetStatus(false);
+	LOG_DEBUG_EVERY(0.5, COLLISION, "Collision between Player and Ammo");
+}
+
+/**
+ @brief Response to a contact between the player and a movable entity
+ */
+void CSolidObjectManager::OnPlayerMovable(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther)
+{
+	cEntity->RollbackPosition();
+	if (cEntityStore.IsStatic(cContact.hOther) == false)
+		cOther->RollbackPosition();
+	if (CPlayer3D::GetInstance()->GetWeapon()->isMeleeAttacking)
+	{
+		//player melee attack
+		cOther->SetHealth(cOther->GetHealth() - CPlayer3D::GetInstance()->GetWeapon()->GetDamage());
+		if (cOther->GetHealth() <= 0)
+			cOther->SetStatus(false);
+	}
+
+	//calculate hitmarker angle
+	glm::vec3 dist = cEntity->GetFront() - cOther->GetFront();
+	fHitAngle = atan2f(dist.z, dist.x);
+	bHitMarker = true;
+	LOG_DEBUG_EVERY(0.5, COLLISION, "Collision between Player and an Entity");
+}
+
+/**
+ @brief Response to a contact between a car and a movable entity
+ */
+void CSolidObjectManager::OnCarMovable(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther)
+{
+	//set enemy vel relative to the car's front
+	CCar3D* c = (CCar3D*)cEntity;
+	cOther->SetVel(cOther->GetVel() + cEntity->GetFront() * c->GetCurrSpeed());
+	cOther->SetHealth(cOther->GetHealth() - c->GetCurrSpeed());
+	if (cOther->GetHealth() <= 0)
+		cOther->SetStatus(false);
+
+	//calculate hitmarker angle
+	glm::vec3 dist = cEntity->GetFront() - cOther->GetFront();
+	fHitAngle = atan2f(dist.z, dist.x);
+	bHitMarker = true;
+	LOG_DEBUG_EVERY(0.5, COLLISION, "Collision between Car and an Entity");
+}
+
+/**
+ @brief Response to a contact between 2 movable entities
+ */
+void CSolidObjectManager::OnMovableMovable(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther)
+{
+	// Static entities, such as the trees, are never moved
+	if (cEntityStore.IsStatic(cContact.hEntity) == false)
+		cEntity->RollbackPosition();
+	if (cEntityStore.IsStatic(cContact.hOther) == false)
+		cOther->RollbackPosition();
+	LOG_DEBUG_EVERY(0.5, COLLISION, "Collision between 2 Entities");
+}
+
+/**
+ @brief Response to a contact between the player and a structure
+ */
+void CSolidObjectManager::OnPlayerStructure(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther)
+{
+	cEntity->RollbackPosition();
+	LOG_DEBUG_EVERY(0.5, COLLISION, "Collision between Player and Structure");
+}
+
+/**
+ @brief Response to a contact between a car and a structure
+ */
+void CSolidObjectManager::OnCarStructure(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther)
+{
+	CCar3D* c = (CCar3D*)cEntity;
+	cEntity->SetVel(cEntity->GetVel() - cEntity->GetFront() * c->GetCurrSpeed());
+	LOG_DEBUG_EVERY(0.5, COLLISION, "Collision between Car and Structure");
+}
+
+/**
+ @brief Response to a contact between the player and a projectile
+ */
+void CSolidObjectManager::OnPlayerProjectile(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther)
+{
+	CProjectile* cProjectile = cProjectileManager->vProjectile[cContact.uiProjectile];
+	cProjectile->SetStatus(false);
+
+	//Damage the player health using the projectile damage
+	cEntity->SetHealth(cEntity->GetHealth() - cProjectile->GetDamage());
+	if (cEntity->GetHealth() <= 0)
+		cEntity->SetStatus(false);
+
+	glm::vec3 dist = cEntity->GetFront() - cProjectile->GetSource()->GetFront();
+	fHitAngle = atan2f(dist.z, dist.x);
+	bHitMarker = true;
+	LOG_DEBUG_EVERY(0.5, COLLISION, "Collision between Player and Projectile");
+}
+
+/**
+ @brief Response to a contact between an NPC, car or structure and a projectile
+ */
+void CSolidObjectManager::OnEntityProjectile(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther)
+{
+	CProjectile* cProjectile = cProjectileManager->vProjectile[cContact.uiProjectile];
+	cProjectile->SetStatus(false);
+
+	//Damage the entity health using the projectile damage
+	cEntity->SetHealth(cEntity->GetHealth() - cProjectile->GetDamage());
+	if (cEntity->GetHealth() <= 0)
+		cEntity->SetStatus(false);
+
+	LOG_DEBUG_EVERY(0.5, COLLISION, "Collision between Entity and Projectile: health %.1f", cEntity->GetHealth());
+}
+
+/**
+ @brief CleanUp all CEntity3Ds which are marked for deletion
+ */
+void CSolidObjectManager::CleanUp(void)
+{
+	// Iterate backwards, since removing an entity moves the last entity into its slot
+	for (int i = (int)cEntityStore.GetSize() - 1; i >= 0; i--)
+	{
+		CSolidObject* cSolidObject = cEntityStore.vSolidObject[i];
+		if (cSolidObject->IsToDelete())
+		{
+			// Remove it from the store, then delete the CSolidObject
+			if (cEntityStore.vStatic[i] != 0)
+			{
+				bStaticTreeDirty = true;
+				bOccludersDirty = true;
+			}
+			if (cEntityStore.vBatched[i] != 0)
+				cStaticBatch.Remove(cEntityStore.vHandle[i]);
+			cEntityStore.Remove(cEntityStore.vHandle[i]);
+			delete cSolidObject;
 		}
 	}
 }
 
 /**
- @brief Render this class instance
+ @brief Merge the static entities which are not batched yet into the CStaticBatch.
+		The entities which are already batched are kept, so only the batches which gain entities are uploaded again.
+ */
+void CSolidObjectManager::BuildStaticBatches(void)
+{
+	vector<Vertex> vVertices;
+	vector<unsigned int> vIndices;
+
+	for (unsigned int i = 0; i < cEntityStore.GetSize(); i++)
+	{
+		if ((cEntityStore.vStatic[i] == 0) || (cEntityStore.vBatched[i] != 0))
+			continue;
+
+		CSolidObject* cSolidObject = cEntityStore.vSolidObject[i];
+		if (cSolidObject->GetStatus() == false)
+			continue;
+
+		// Only the crates are batched. The buildings keep their own draws since CLODManager
+		// switches their textures per entity, and the ammo boxes are picked up.
+		CStructure3D* cStructure3D = dynamic_cast<CStructure3D*>(cSolidObject);
+		if ((cStructure3D == NULL) || (!cStructure3D->IsBatchable()))
+			continue;
+
+		cStructure3D->GetBatchGeometry(vVertices, vIndices);
+		if (cStaticBatch.Add(	cEntityStore.vHandle[i],
+								cStructure3D->GetShader(),
+								cStructure3D->GetTextureID(),
+								vVertices,
+								vIndices))
+			cEntityStore.vBatched[i] = 1;
+	}
+
+	cStaticBatch.Upload();
+	bStaticBatchDirty = false;
+}
+
+/**
+ @brief Add the occluder boxes of the static entities to the COcclusionCuller
+ */
+void CSolidObjectManager::BuildOccluders(void)
+{
+	COcclusionCuller* cOcclusionCuller = COcclusionCuller::GetInstance();
+	cOcclusionCuller->ClearOccluders(OCCLUDER_GROUP);
+	cOcclusionCuller->SetOccluderGroup(OCCLUDER_GROUP);
+
+	glm::vec3 vec3BoxMin, vec3BoxMax;
+	for (unsigned int i = 0; i < cEntityStore.GetSize(); i++)
+	{
+		if (cEntityStore.vStatic[i] == 0)
+			continue;
+
+		CSolidObject* cSolidObject = cEntityStore.vSolidObject[i];
+		if ((cSolidObject->GetStatus()) && (cSolidObject->GetOccluderBox(vec3BoxMin, vec3BoxMax)))
+			cOcclusionCuller->AddOccluderBox(vec3BoxMin, vec3BoxMax);
+	}
+
+	bOccludersDirty = false;
+}
+
+/**
+ @brief Render this class instance.
+		Between COcclusionCuller::BeginCulling and EndCulling, the entities which are hidden
+		behind the occluders are skipped.
  */
 void CSolidObjectManager::Render(void)
 {
-	// Render all entities
-	std::list<CSolidObject*>::iterator it, end;
-	end = lSolidObject.end();
-	for (it = lSolidObject.begin(); it != end; ++it)
+	if (bStaticBatchDirty)
+		BuildStaticBatches();
+	if (bOccludersDirty)
+		BuildOccluders();
+
+	// Render the batched static entities
+	cStaticBatch.Render();
+
+	// The entities which support it only write their draws into the CIndirectDrawBuffer,
+	// which renders them together after the other entities
+	CIndirectDrawBuffer* cIndirectDrawBuffer = CIndirectDrawBuffer::GetInstance();
+	cIndirectDrawBuffer->Begin();
+
+	COcclusionCuller* cOcclusionCuller = COcclusionCuller::GetInstance();
+	glm::vec3 vec3BoxMin, vec3BoxMax;
+
+	// Render all entities which are not batched
+	for (unsigned int i = 0; i < cEntityStore.GetSize(); i++)
 	{
-		(*it)->SetView(view);
-		(*it)->SetProjection(projection);
-		(*it)->PreRender();
-		(*it)->Render();
-		(*it)->PostRender();
+		CSolidObject* cSolidObject = cEntityStore.vSolidObject[i];
+		if (cEntityStore.vBatched[i] != 0)
+		{
+			// Patch a destroyed entity out of its batch
+			if (cSolidObject->GetStatus() == false)
+			{
+				cStaticBatch.Remove(cEntityStore.vHandle[i]);
+				cEntityStore.vBatched[i] = 0;
+			}
+			else
+				cSolidObject->RenderCollider();
+			continue;
+		}
+
+		if ((cOcclusionCuller->IsCulling()) &&
+			(cSolidObject->GetRenderBounds(vec3BoxMin, vec3BoxMax)) &&
+			(cOcclusionCuller->IsVisible(vec3BoxMin, vec3BoxMax) == false))
+			continue;
+
+		if (cSolidObject->SubmitDraw())
+			continue;
+
+		cSolidObject->PreRender();
+		cSolidObject->Render();
+		cSolidObject->PostRender();
 	}
+
+	cIndirectDrawBuffer->Flush();
+}
+
+/**
+ @brief Get the CStaticBatch which renders the static entities
+ @return A CStaticBatch& variable
+ */
+CStaticBatch& CSolidObjectManager::GetStaticBatch(void)
+{
+	return cStaticBatch;
+}
+
+/**
+ @brief Get the CEntityStore which holds the hot data of all CSolidObjects
+ @return A CEntityStore& variable
+ */
+CEntityStore& CSolidObjectManager::GetEntityStore(void)
+{
+	return cEntityStore;
 }
@@ -6,6 +6,18 @@
 // Include CSolidObject
 #include "SolidObject.h"
 
+// Include CEntityStore
+#include "EntityStore.h"
+
+// Include CollisionContact
+#include "CollisionContact.h"
+
+// Include CStaticCollisionTree
+#include "StaticCollisionTree.h"
+
+// Include CStaticBatch
+#include "StaticBatch.h"
+
 // Include CProjectileManager
 #include "../WeaponInfo/ProjectileManager.h"
 
@@ -14,9 +26,6 @@
 #include <includes/gtc/matrix_transform.hpp>
 #include <includes/gtc/type_ptr.hpp>
 
-// Include list
-#include <list>
-
 class CSolidObjectManager : public CSingletonTemplate<CSolidObjectManager>
 {
 	friend class CSingletonTemplate<CSolidObjectManager>;
@@ -27,13 +36,11 @@ public:
 
 	// Set model
 	virtual void SetModel(const glm::mat4 model);
-	// Set view
-	virtual void SetView(const glm::mat4 view);
-	// Set projection
-	virtual void SetProjection(const glm::mat4 projection);
 
 	// Add a CSolidObject* to this class instance
 	virtual void Add(CSolidObject* cSolidObject);
+	// Add a CSolidObject* which never moves to this class instance
+	virtual void AddStatic(CSolidObject* cSolidObject);
 	// Remove a CSolidObject* from this class instance
 	virtual bool Erase(CSolidObject* cSolidObject);
 
@@ -49,26 +56,108 @@ public:
 	// CleanUp all CSolidObjects which are marked for deletion
 	virtual void CleanUp(void);
 
+	// Merge the static entities which are not batched yet into the CStaticBatch
+	virtual void BuildStaticBatches(void);
+	// Add the occluder boxes of the static entities to the COcclusionCuller
+	virtual void BuildOccluders(void);
+
 	// Render this class instance
 	virtual void Render(void);
 
+	// Get the CStaticBatch which renders the static entities
+	CStaticBatch& GetStaticBatch(void);
+
+	// Get the CEntityStore which holds the hot data of all CSolidObjects
+	CEntityStore& GetEntityStore(void);
+
+	// Enable or disable the collision tests between 2 types of entities
+	void SetCollisionMask(const CEntity3D::TYPE eTypeA, const CEntity3D::TYPE eTypeB, const bool bCollide);
+	// Check if 2 types of entities are tested for collisions
+	bool GetCollisionMask(const CEntity3D::TYPE eTypeA, const CEntity3D::TYPE eTypeB) const;
+
+	// Get the contacts found in the last call to CheckForCollision
+	const vector<CollisionContact>& GetContacts(void) const;
+
 	bool allEnemyDied = false;
 protected:
 	// Render Settings
 	glm::mat4 model;
-	glm::mat4 view;
-	glm::mat4 projection;
 
-	// List of CSolidObject
-	std::list<CSolidObject*> lSolidObject;
+	// The CSolidObjects and their hot data
+	CEntityStore cEntityStore;
 
 	// Handler to the CProjectileManager
 	CProjectileManager* cProjectileManager;
 
+	// A response to a contact between 2 types of entities
+	typedef void (CSolidObjectManager::*ContactResponse)(const CollisionContact& cContact,
+														CSolidObject* cEntity,
+														CSolidObject* cOther);
+
+	// The dispatch table of responses, indexed by the pair type (eType, eOtherType) of a contact
+	ContactResponse arrContactResponse[CEntity3D::TYPE::NUM_TYPES][CEntity3D::TYPE::NUM_TYPES];
+	// The collision layer mask matrix. Bit eOtherType of arrCollisionMask[eType] is set
+	// if the 2 types are tested for collisions
+	unsigned int arrCollisionMask[CEntity3D::TYPE::NUM_TYPES];
+
+	// The contacts found in this frame
+	vector<CollisionContact> vContact;
+
+	// The static entities, and whether they must be rebuilt because one was added or removed
+	CStaticCollisionTree cStaticTree;
+	bool bStaticTreeDirty;
+	// The dense indices of the active, non-static entities in this frame
+	vector<unsigned int> vDynamic;
+	// The results of a query on cStaticTree
+	vector<EntityHandle> vStaticResult;
+
+	// The merged geometry of the static entities, and whether static entities were added since it was built
+	CStaticBatch cStaticBatch;
+	bool bStaticBatchDirty;
+
+	// The group of the occluders of the static entities in the COcclusionCuller,
+	// and whether static entities were added or removed since they were added
+	static const int OCCLUDER_GROUP = 0;
+	bool bOccludersDirty;
+
+	// The hit marker to show after the contacts are resolved
+	bool bHitMarker;
+	float fHitAngle;
+
 	// Default Constructor
 	CSolidObjectManager(void);
 	// Destructor
 	virtual ~CSolidObjectManager(void);
 
+	// Set the response to a contact between 2 types of entities and enable their collision tests
+	void SetContactResponse(const CEntity3D::TYPE eType, const CEntity3D::TYPE eOtherType, ContactResponse fnResponse);
+	// Find the contacts among entities
+	void FindEntityContacts(void);
+	// Add a contact between 2 entities, ordered to match an entry in the dispatch table
+	void AddEntityContact(	const unsigned int uiEntity,
+							const unsigned int uiOther,
+							const glm::vec3& vec3Normal,
+							const float fPenetration);
+	// Check for a collision between an entity and a projectile
+	bool ProjectileCollision(	const unsigned int uiEntity,
+								CProjectile* cProjectile,
+								glm::vec3& vec3Normal,
+								float& fPenetration) const;
+	// Find the contacts between entities and projectiles
+	void FindProjectileContacts(void);
+	// Run the response to each contact
+	void DispatchContacts(void);
+
+	// Contact responses
+	void OnPlayerCar(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther);
+	void OnPlayerAmmo(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther);
+	void OnPlayerMovable(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther);
+	void OnCarMovable(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther);
+	void OnMovableMovable(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther);
+	void OnPlayerStructure(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther);
+	void OnCarStructure(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther);
+	void OnPlayerProjectile(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther);
+	void OnEntityProjectile(const CollisionContact& cContact, CSolidObject* cEntity, CSolidObject* cOther);
+
 	int enemyCount = 0;
 };
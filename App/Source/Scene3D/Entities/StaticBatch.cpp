@@ -0,0 +1,415 @@
+/**
+ CStaticBatch
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#include "StaticBatch.h"
+
+// Include ShaderManager
+#include "RenderControl/ShaderManager.h"
+
+// Include CCameraUniformBuffer
+#include "RenderControl/CameraUniformBuffer.h"
+
+// Include COcclusionCuller
+#include "RenderControl/OcclusionCuller.h"
+
+// Include CLogger
+#include "System/Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+using namespace std;
+
+/**
+ @brief Constructor
+ */
+CStaticBatch::CStaticBatch(void)
+	: fCellSize(32.0f)
+	, uiNumDrawCalls(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CStaticBatch::~CStaticBatch(void)
+{
+	Clear();
+}
+
+/**
+ @brief Set the size of each cell of the grid. The batches must be cleared and added again for it to take effect.
+ @param fCellSize A const float variable containing the size of each cell of the grid
+ */
+void CStaticBatch::SetCellSize(const float fCellSize)
+{
+	if (fCellSize > 0.0f)
+		this->fCellSize = fCellSize;
+}
+
+/**
+ @brief Get the size of each cell of the grid
+ @return A float variable
+ */
+float CStaticBatch::GetCellSize(void) const
+{
+	return fCellSize;
+}
+
+/**
+ @brief Add the world space geometry of an entity to the batch of its cell and material.
+		The entity is placed in the cell which contains the centre of its geometry.
+		The batch is uploaded in the next call to Upload().
+ @param handle A const EntityHandle& variable containing the handle of the entity
+ @param sShaderName A const std::string& variable containing the name of the shader of the entity
+ @param iTextureID A const GLuint variable containing the texture of the entity
+ @param vVertices A const vector<Vertex>& variable containing the vertices of the entity in world space
+ @param vIndices A const vector<unsigned int>& variable containing the indices of the entity
+ @return true if the entity was added, else false
+ */
+bool CStaticBatch::Add(	const EntityHandle& handle,
+						const std::string& sShaderName,
+						const GLuint iTextureID,
+						const vector<Vertex>& vVertices,
+						const vector<unsigned int>& vIndices)
+{
+	if ((handle.IsNull()) || (vVertices.empty()) || (vIndices.empty()) || (Contains(handle)))
+		return false;
+
+	// Find the bounds of the geometry
+	glm::vec3 vec3Min(FLT_MAX), vec3Max(-FLT_MAX);
+	for (unsigned int i = 0; i < vVertices.size(); i++)
+	{
+		vec3Min = glm::min(vec3Min, vVertices[i].position);
+		vec3Max = glm::max(vec3Max, vVertices[i].position);
+	}
+	glm::vec3 vec3Centre = (vec3Min + vec3Max) * 0.5f;
+
+	unsigned int uiBatch = FindBatch(	(int)floor(vec3Centre.x / fCellSize),
+										(int)floor(vec3Centre.z / fCellSize),
+										sShaderName,
+										iTextureID);
+	Batch& cBatch = vBatch[uiBatch];
+
+	// Append the geometry, offsetting the indices by the vertices already in the batch
+	unsigned int uiBaseVertex = cBatch.vVertices.size();
+	BatchRange sRange;
+	sRange.handle = handle;
+	sRange.uiBatch = uiBatch;
+	sRange.uiFirstIndex = cBatch.vIndices.size();
+	sRange.uiNumIndices = vIndices.size();
+
+	cBatch.vVertices.insert(cBatch.vVertices.end(), vVertices.begin(), vVertices.end());
+	for (unsigned int i = 0; i < vIndices.size(); i++)
+		cBatch.vIndices.push_back(uiBaseVertex + vIndices[i]);
+
+	cBatch.vec3BoxMin = glm::min(cBatch.vec3BoxMin, vec3Min);
+	cBatch.vec3BoxMax = glm::max(cBatch.vec3BoxMax, vec3Max);
+	cBatch.bDirty = true;
+
+	mRange[handle.uiIndex] = sRange;
+
+	return true;
+}
+
+/**
+ @brief Upload the batches which were changed by Add()
+ */
+void CStaticBatch::Upload(void)
+{
+	for (unsigned int i = 0; i < vBatch.size(); i++)
+	{
+		if (vBatch[i].bDirty)
+			UploadBatch(vBatch[i]);
+	}
+
+	LOG_INFO(RENDER, "CStaticBatch: %u entities merged into %u batches", (unsigned int)mRange.size(), (unsigned int)vBatch.size());
+}
+
+/**
+ @brief Patch the geometry of an entity out of its batch.
+		Its indices are replaced with a degenerate triangle in the index buffer, so the batch is not rebuilt.
+		The index buffer is compacted once more than half of it has been patched out.
+ @param handle A const EntityHandle& variable containing the handle of the entity
+ @return true if the entity was in a batch, else false
+ */
+bool CStaticBatch::Remove(const EntityHandle& handle)
+{
+	map<unsigned int, BatchRange>::iterator it = mRange.find(handle.uiIndex);
+	if ((it == mRange.end()) || (it->second.handle != handle))
+		return false;
+
+	BatchRange sRange = it->second;
+	mRange.erase(it);
+
+	Batch& cBatch = vBatch[sRange.uiBatch];
+
+	// Collapse every index of the range onto the first vertex of the range
+	unsigned int uiDegenerate = cBatch.vIndices[sRange.uiFirstIndex];
+	for (unsigned int i = 0; i < sRange.uiNumIndices; i++)
+		cBatch.vIndices[sRange.uiFirstIndex + i] = uiDegenerate;
+	cBatch.uiDeadIndices += sRange.uiNumIndices;
+
+	if (cBatch.uiDeadIndices * 2 > cBatch.vIndices.size())
+	{
+		Compact(sRange.uiBatch);
+	}
+	else if (!cBatch.bDirty)
+	{
+		// Patch only the range of the entity
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cBatch.IBO);
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
+						sRange.uiFirstIndex * sizeof(unsigned int),
+						sRange.uiNumIndices * sizeof(unsigned int),
+						&cBatch.vIndices[sRange.uiFirstIndex]);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
+
+	return true;
+}
+
+/**
+ @brief Check if an entity is in a batch
+ @param handle A const EntityHandle& variable containing the handle of the entity
+ @return true if the entity is in a batch, else false
+ */
+bool CStaticBatch::Contains(const EntityHandle& handle) const
+{
+	map<unsigned int, BatchRange>::const_iterator it = mRange.find(handle.uiIndex);
+	return (it != mRange.end()) && (it->second.handle == handle);
+}
+
+/**
+ @brief Remove all batches
+ */
+void CStaticBatch::Clear(void)
+{
+	for (unsigned int i = 0; i < vBatch.size(); i++)
+	{
+		glDeleteVertexArrays(1, &vBatch[i].VAO);
+		glDeleteBuffers(1, &vBatch[i].VBO);
+		glDeleteBuffers(1, &vBatch[i].IBO);
+	}
+	vBatch.clear();
+	mRange.clear();
+	uiNumDrawCalls = 0;
+}
+
+/**
+ @brief Render the batches which are inside the view frustum of the current render pass
+ */
+void CStaticBatch::Render(void)
+{
+	uiNumDrawCalls = 0;
+	if (vBatch.empty())
+		return;
+
+	CCameraUniformBuffer* cCameraUniformBuffer = CCameraUniformBuffer::GetInstance();
+	glm::mat4 viewProjection = cCameraUniformBuffer->GetProjection() * cCameraUniformBuffer->GetView();
+
+	// change depth function so depth test passes when values are equal to depth buffer's content
+	glDepthFunc(GL_LEQUAL);
+	glActiveTexture(GL_TEXTURE0);
+
+	std::string sActiveShader;
+	for (unsigned int i = 0; i < vBatch.size(); i++)
+	{
+		Batch& cBatch = vBatch[i];
+
+		// Skip the batches whose entities have all been patched out, which are outside the frustum,
+		// or which are hidden behind the occluders
+		if (cBatch.uiDeadIndices >= cBatch.vIndices.size())
+			continue;
+		if (!IsBoxVisible(viewProjection, cBatch.vec3BoxMin, cBatch.vec3BoxMax))
+			continue;
+		if (!COcclusionCuller::GetInstance()->IsVisible(cBatch.vec3BoxMin, cBatch.vec3BoxMax))
+			continue;
+
+		// The batches are already in world space
+		if (cBatch.sShaderName != sActiveShader)
+		{
+			CShaderManager::GetInstance()->Use(cBatch.sShaderName);
+			CShaderManager::GetInstance()->activeShader->setMat4("model", glm::mat4(1.0f));
+			sActiveShader = cBatch.sShaderName;
+		}
+
+		glBindTexture(GL_TEXTURE_2D, cBatch.iTextureID);
+		glBindVertexArray(cBatch.VAO);
+		glDrawElements(GL_TRIANGLES, cBatch.vIndices.size(), GL_UNSIGNED_INT, 0);
+		uiNumDrawCalls++;
+	}
+
+	glBindVertexArray(0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glDepthFunc(GL_LESS); // set depth function back to default
+
+	LOG_DEBUG_EVERY(5.0, RENDER, "CStaticBatch: %u of %u batches drawn", uiNumDrawCalls, (unsigned int)vBatch.size());
+}
+
+/**
+ @brief Get the number of batches
+ @return An unsigned int variable
+ */
+unsigned int CStaticBatch::GetNumBatches(void) const
+{
+	return vBatch.size();
+}
+
+/**
+ @brief Get the number of draw calls made in the last Render
+ @return An unsigned int variable
+ */
+unsigned int CStaticBatch::GetNumDrawCalls(void) const
+{
+	return uiNumDrawCalls;
+}
+
+/**
+ @brief Find the batch of a cell and material, or create one
+ @param iCellX A const int variable containing the X index of the cell
+ @param iCellZ A const int variable containing the Z index of the cell
+ @param sShaderName A const std::string& variable containing the name of the shader
+ @param iTextureID A const GLuint variable containing the texture
+ @return The index of the batch in vBatch
+ */
+unsigned int CStaticBatch::FindBatch(	const int iCellX,
+										const int iCellZ,
+										const std::string& sShaderName,
+										const GLuint iTextureID)
+{
+	// There are only a few batches, and they are only searched when the scene is built
+	for (unsigned int i = 0; i < vBatch.size(); i++)
+	{
+		if ((vBatch[i].iCellX == iCellX) && (vBatch[i].iCellZ == iCellZ) &&
+			(vBatch[i].iTextureID == iTextureID) && (vBatch[i].sShaderName == sShaderName))
+			return i;
+	}
+
+	Batch cBatch;
+	cBatch.iCellX = iCellX;
+	cBatch.iCellZ = iCellZ;
+	cBatch.sShaderName = sShaderName;
+	cBatch.iTextureID = iTextureID;
+	cBatch.uiDeadIndices = 0;
+	cBatch.bDirty = true;
+	cBatch.vec3BoxMin = glm::vec3(FLT_MAX);
+	cBatch.vec3BoxMax = glm::vec3(-FLT_MAX);
+
+	// The vertex layout matches CMesh: position, colour and texture coordinates
+	glGenVertexArrays(1, &cBatch.VAO);
+	glGenBuffers(1, &cBatch.VBO);
+	glGenBuffers(1, &cBatch.IBO);
+
+	glBindVertexArray(cBatch.VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, cBatch.VBO);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)sizeof(glm::vec3));
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(sizeof(glm::vec3) + sizeof(glm::vec4)));
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cBatch.IBO);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	vBatch.push_back(cBatch);
+	return vBatch.size() - 1;
+}
+
+/**
+ @brief Upload the geometry of a batch
+ @param cBatch A Batch& variable containing the batch to upload
+ */
+void CStaticBatch::UploadBatch(Batch& cBatch)
+{
+	glBindBuffer(GL_ARRAY_BUFFER, cBatch.VBO);
+	glBufferData(GL_ARRAY_BUFFER, cBatch.vVertices.size() * sizeof(Vertex), &cBatch.vVertices[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glBindVertexArray(cBatch.VAO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cBatch.IBO);
+	if (cBatch.vIndices.empty())
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, 0, NULL, GL_STATIC_DRAW);
+	else
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, cBatch.vIndices.size() * sizeof(unsigned int), &cBatch.vIndices[0], GL_STATIC_DRAW);
+	glBindVertexArray(0);
+
+	cBatch.bDirty = false;
+}
+
+/**
+ @brief Remove the patched out indices of a batch and move the ranges which follow them.
+		The vertices are kept, since the live ranges still refer to them.
+ @param uiBatch A const unsigned int variable containing the index of the batch
+ */
+void CStaticBatch::Compact(const unsigned int uiBatch)
+{
+	Batch& cBatch = vBatch[uiBatch];
+
+	// Collect the live ranges of this batch in the order of their indices
+	vector<BatchRange*> vLive;
+	for (map<unsigned int, BatchRange>::iterator it = mRange.begin(); it != mRange.end(); ++it)
+	{
+		if (it->second.uiBatch == uiBatch)
+			vLive.push_back(&it->second);
+	}
+	sort(vLive.begin(), vLive.end(),
+		[](const BatchRange* a, const BatchRange* b) { return a->uiFirstIndex < b->uiFirstIndex; });
+
+	vector<unsigned int> vIndices;
+	vIndices.reserve(cBatch.vIndices.size() - cBatch.uiDeadIndices);
+	for (unsigned int i = 0; i < vLive.size(); i++)
+	{
+		unsigned int uiFirstIndex = vIndices.size();
+		vIndices.insert(vIndices.end(),
+						cBatch.vIndices.begin() + vLive[i]->uiFirstIndex,
+						cBatch.vIndices.begin() + vLive[i]->uiFirstIndex + vLive[i]->uiNumIndices);
+		vLive[i]->uiFirstIndex = uiFirstIndex;
+	}
+	cBatch.vIndices.swap(vIndices);
+	cBatch.uiDeadIndices = 0;
+
+	// Only the index buffer has changed
+	glBindVertexArray(cBatch.VAO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cBatch.IBO);
+	if (cBatch.vIndices.empty())
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, 0, NULL, GL_STATIC_DRAW);
+	else
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, cBatch.vIndices.size() * sizeof(unsigned int), &cBatch.vIndices[0], GL_STATIC_DRAW);
+	glBindVertexArray(0);
+}
+
+/**
+ @brief Check if a bounding box is inside the view frustum of a view-projection matrix.
+		The planes of the frustum are extracted from the rows of the matrix.
+ @param viewProjection A const glm::mat4& variable containing the view-projection matrix
+ @param vec3BoxMin A const glm::vec3& variable containing the minimum corner of the box
+ @param vec3BoxMax A const glm::vec3& variable containing the maximum corner of the box
+ @return true if the box is at least partly inside the frustum, else false
+ */
+bool CStaticBatch::IsBoxVisible(const glm::mat4& viewProjection,
+								const glm::vec3& vec3BoxMin,
+								const glm::vec3& vec3BoxMax)
+{
+	glm::vec4 vec4Row[4];
+	for (int i = 0; i < 4; i++)
+		vec4Row[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+
+	glm::vec4 vec4Plane[6] = {
+		vec4Row[3] + vec4Row[0], vec4Row[3] - vec4Row[0],
+		vec4Row[3] + vec4Row[1], vec4Row[3] - vec4Row[1],
+		vec4Row[3] + vec4Row[2], vec4Row[3] - vec4Row[2] };
+
+	for (int i = 0; i < 6; i++)
+	{
+		// Test the corner of the box which is furthest along the normal of the plane
+		glm::vec3 vec3Corner(	vec4Plane[i].x >= 0.0f ? vec3BoxMax.x : vec3BoxMin.x,
+								vec4Plane[i].y >= 0.0f ? vec3BoxMax.y : vec3BoxMin.y,
+								vec4Plane[i].z >= 0.0f ? vec3BoxMax.z : vec3BoxMin.z);
+		if (glm::dot(glm::vec3(vec4Plane[i]), vec3Corner) + vec4Plane[i].w < 0.0f)
+			return false;
+	}
+	return true;
+}
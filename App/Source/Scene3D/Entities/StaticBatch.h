@@ -0,0 +1,123 @@
+/**
+ CStaticBatch
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include GLEW
+#ifndef GLEW_STATIC
+#include <GL/glew.h>
+#define GLEW_STATIC
+#endif
+
+// Include CEntityStore
+#include "EntityStore.h"
+
+// Include Mesh
+#include "Primitives/Mesh.h"
+
+// Include GLM
+#include <includes/glm.hpp>
+#include <includes/gtc/matrix_transform.hpp>
+#include <includes/gtc/type_ptr.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+using namespace std;
+
+// Merges the geometry of static entities which share a shader and a texture into large
+// vertex and index buffers, which are already transformed into world space.
+// The batches are split by a grid of cells on the XZ plane, so that each batch can still be
+// frustum culled, and each visible batch is rendered with a single draw call.
+// When a batched entity is destroyed, its range of indices is patched out of the index buffer
+// instead of rebuilding the batch.
+class CStaticBatch
+{
+public:
+	// Constructor
+	CStaticBatch(void);
+	// Destructor
+	virtual ~CStaticBatch(void);
+
+	// Set the size of each cell of the grid
+	void SetCellSize(const float fCellSize);
+	// Get the size of each cell of the grid
+	float GetCellSize(void) const;
+
+	// Add the world space geometry of an entity to the batch of its cell and material
+	bool Add(	const EntityHandle& handle,
+				const std::string& sShaderName,
+				const GLuint iTextureID,
+				const vector<Vertex>& vVertices,
+				const vector<unsigned int>& vIndices);
+	// Upload the batches which were changed by Add()
+	void Upload(void);
+	// Patch the geometry of an entity out of its batch
+	bool Remove(const EntityHandle& handle);
+	// Check if an entity is in a batch
+	bool Contains(const EntityHandle& handle) const;
+	// Remove all batches
+	void Clear(void);
+
+	// Render the batches which are inside the view frustum of the current render pass and not occluded
+	void Render(void);
+
+	// Get the number of batches
+	unsigned int GetNumBatches(void) const;
+	// Get the number of draw calls made in the last Render
+	unsigned int GetNumDrawCalls(void) const;
+
+protected:
+	// The geometry of the entities in one cell which share a shader and a texture
+	struct Batch
+	{
+		int iCellX, iCellZ;
+		std::string sShaderName;
+		GLuint iTextureID;
+
+		GLuint VAO, VBO, IBO;
+		// A copy of the geometry, used to upload and to compact the index buffer
+		vector<Vertex> vVertices;
+		vector<unsigned int> vIndices;
+		// The number of indices which have been patched out
+		unsigned int uiDeadIndices;
+		// true if the geometry must be uploaded again
+		bool bDirty;
+
+		// The world space bounding box of the batch, for frustum culling
+		glm::vec3 vec3BoxMin;
+		glm::vec3 vec3BoxMax;
+	};
+
+	// The range of indices of an entity in its batch
+	struct BatchRange
+	{
+		EntityHandle handle;
+		unsigned int uiBatch;
+		unsigned int uiFirstIndex;
+		unsigned int uiNumIndices;
+	};
+
+	// The size of each cell of the grid
+	float fCellSize;
+
+	vector<Batch> vBatch;
+	// The ranges of the entities, keyed by the index of their handle
+	map<unsigned int, BatchRange> mRange;
+
+	// The number of draw calls made in the last Render
+	unsigned int uiNumDrawCalls;
+
+	// Find the batch of a cell and material, or create one
+	unsigned int FindBatch(const int iCellX, const int iCellZ, const std::string& sShaderName, const GLuint iTextureID);
+	// Upload the geometry of a batch
+	void UploadBatch(Batch& cBatch);
+	// Remove the patched out indices of a batch and move the ranges which follow them
+	void Compact(const unsigned int uiBatch);
+	// Check if a bounding box is inside the view frustum of a view-projection matrix
+	static bool IsBoxVisible(	const glm::mat4& viewProjection,
+								const glm::vec3& vec3BoxMin,
+								const glm::vec3& vec3BoxMax);
+};
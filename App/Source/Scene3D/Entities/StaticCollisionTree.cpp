@@ -0,0 +1,183 @@
+/**
+ CStaticCollisionTree
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#include "StaticCollisionTree.h"
+
+// Include CCollisionManager
+#include "Primitives/CollisionManager.h"
+
+#include <algorithm>
+using namespace std;
+
+/**
+ @brief Constructor
+ */
+CStaticCollisionTree::CStaticCollisionTree(void)
+	: uiTypeMask(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CStaticCollisionTree::~CStaticCollisionTree(void)
+{
+	Clear();
+}
+
+/**
+ @brief Build the tree from the static entities in a CEntityStore
+ @param cEntityStore A const CEntityStore& variable containing the entities
+ */
+void CStaticCollisionTree::Build(const CEntityStore& cEntityStore)
+{
+	Clear();
+
+	for (unsigned int i = 0; i < cEntityStore.GetSize(); i++)
+	{
+		if (cEntityStore.vStatic[i] == 0)
+			continue;
+
+		Item sItem;
+		sItem.vec3BoxMin = cEntityStore.vBoxMin[i];
+		sItem.vec3BoxMax = cEntityStore.vBoxMax[i];
+		sItem.vec3Centre = (sItem.vec3BoxMin + sItem.vec3BoxMax) * 0.5f;
+		sItem.handle = cEntityStore.vHandle[i];
+		vItem.push_back(sItem);
+
+		uiTypeMask |= (1 << cEntityStore.vType[i]);
+	}
+
+	if (vItem.empty())
+		return;
+
+	// A binary tree with leaves of at least 1 item has fewer than 2 * N nodes
+	vNode.reserve(vItem.size() * 2);
+	vNode.push_back(Node());
+	BuildNode(0, 0, vItem.size());
+}
+
+/**
+ @brief Remove all entities from the tree
+ */
+void CStaticCollisionTree::Clear(void)
+{
+	vNode.clear();
+	vItem.clear();
+	uiTypeMask = 0;
+}
+
+/**
+ @brief Find the static entities whose bounding box overlaps a query box
+ @param vec3BoxMin The minimum corner of the query box
+ @param vec3BoxMax The maximum corner of the query box
+ @param vResult The handles of the overlapping entities are appended to this
+ */
+void CStaticCollisionTree::Query(	const glm::vec3& vec3BoxMin,
+									const glm::vec3& vec3BoxMax,
+									vector<EntityHandle>& vResult) const
+{
+	if (vNode.empty())
+		return;
+
+	// The tree is balanced, so its depth is about log2(N / uiMaxLeafSize)
+	unsigned int arrStack[64];
+	int iStackSize = 0;
+	arrStack[iStackSize++] = 0;
+
+	while (iStackSize > 0)
+	{
+		const Node& sNode = vNode[arrStack[--iStackSize]];
+		if (CCollisionManager::BoxBoxCollision(sNode.vec3BoxMin, sNode.vec3BoxMax, vec3BoxMin, vec3BoxMax) == false)
+			continue;
+
+		if (sNode.uiCount > 0)
+		{
+			for (unsigned int i = sNode.uiFirst; i < sNode.uiFirst + sNode.uiCount; i++)
+			{
+				if (CCollisionManager::BoxBoxCollision(vItem[i].vec3BoxMin, vItem[i].vec3BoxMax, vec3BoxMin, vec3BoxMax) == true)
+					vResult.push_back(vItem[i].handle);
+			}
+		}
+		else
+		{
+			arrStack[iStackSize++] = sNode.uiFirst;
+			arrStack[iStackSize++] = sNode.uiFirst + 1;
+		}
+	}
+}
+
+/**
+ @brief Get the number of entities in the tree
+ @return The number of entities
+ */
+unsigned int CStaticCollisionTree::GetSize(void) const
+{
+	return vItem.size();
+}
+
+/**
+ @brief Get a bitmask of the CEntity3D::TYPE of the entities in the tree
+ @return Bit n is set if the tree holds an entity of CEntity3D::TYPE n
+ */
+unsigned int CStaticCollisionTree::GetTypeMask(void) const
+{
+	return uiTypeMask;
+}
+
+/**
+ @brief Build the subtree of a node over vItem[uiFirst, uiFirst + uiCount)
+ @param uiNode The index of the node in vNode
+ @param uiFirst The index of the first item of this node
+ @param uiCount The number of items in this node
+ */
+void CStaticCollisionTree::BuildNode(const unsigned int uiNode, const unsigned int uiFirst, const unsigned int uiCount)
+{
+	// Calculate the bounds of the items and of their centres
+	glm::vec3 vec3BoxMin = vItem[uiFirst].vec3BoxMin;
+	glm::vec3 vec3BoxMax = vItem[uiFirst].vec3BoxMax;
+	glm::vec3 vec3CentreMin = vItem[uiFirst].vec3Centre;
+	glm::vec3 vec3CentreMax = vItem[uiFirst].vec3Centre;
+	for (unsigned int i = uiFirst + 1; i < uiFirst + uiCount; i++)
+	{
+		vec3BoxMin = glm::min(vec3BoxMin, vItem[i].vec3BoxMin);
+		vec3BoxMax = glm::max(vec3BoxMax, vItem[i].vec3BoxMax);
+		vec3CentreMin = glm::min(vec3CentreMin, vItem[i].vec3Centre);
+		vec3CentreMax = glm::max(vec3CentreMax, vItem[i].vec3Centre);
+	}
+	vNode[uiNode].vec3BoxMin = vec3BoxMin;
+	vNode[uiNode].vec3BoxMax = vec3BoxMax;
+
+	if (uiCount <= uiMaxLeafSize)
+	{
+		vNode[uiNode].uiFirst = uiFirst;
+		vNode[uiNode].uiCount = uiCount;
+		return;
+	}
+
+	// Split at the median centre along the longest axis
+	const glm::vec3 vec3Extent = vec3CentreMax - vec3CentreMin;
+	int iAxis = 0;
+	if (vec3Extent.y > vec3Extent[iAxis])
+		iAxis = 1;
+	if (vec3Extent.z > vec3Extent[iAxis])
+		iAxis = 2;
+
+	const unsigned int uiHalf = uiCount / 2;
+	std::nth_element(	vItem.begin() + uiFirst,
+						vItem.begin() + uiFirst + uiHalf,
+						vItem.begin() + uiFirst + uiCount,
+						[iAxis](const Item& a, const Item& b) { return a.vec3Centre[iAxis] < b.vec3Centre[iAxis]; });
+
+	// The 2 children are stored next to each other
+	const unsigned int uiLeft = vNode.size();
+	vNode.push_back(Node());
+	vNode.push_back(Node());
+	vNode[uiNode].uiFirst = uiLeft;
+	vNode[uiNode].uiCount = 0;
+
+	BuildNode(uiLeft, uiFirst, uiHalf);
+	BuildNode(uiLeft + 1, uiFirst + uiHalf, uiCount - uiHalf);
+}
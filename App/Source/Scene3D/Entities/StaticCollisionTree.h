@@ -0,0 +1,74 @@
+/**
+ CStaticCollisionTree
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include CEntityStore
+#include "EntityStore.h"
+
+// Include GLM
+#include <includes/glm.hpp>
+#include <includes/gtc/matrix_transform.hpp>
+#include <includes/gtc/type_ptr.hpp>
+
+#include <vector>
+using namespace std;
+
+// A bounding volume hierarchy over the static entities of a CEntityStore.
+// It is built once when the scene is set up and rebuilt only when a static entity is added or removed,
+// so the static entities do not need to be checked against each other or against every moving entity.
+class CStaticCollisionTree
+{
+public:
+	// Constructor
+	CStaticCollisionTree(void);
+	// Destructor
+	virtual ~CStaticCollisionTree(void);
+
+	// Build the tree from the static entities in a CEntityStore
+	void Build(const CEntityStore& cEntityStore);
+	// Remove all entities from the tree
+	void Clear(void);
+
+	// Find the static entities whose bounding box overlaps a query box
+	void Query(	const glm::vec3& vec3BoxMin,
+				const glm::vec3& vec3BoxMax,
+				vector<EntityHandle>& vResult) const;
+
+	// Get the number of entities in the tree
+	unsigned int GetSize(void) const;
+	// Get a bitmask of the CEntity3D::TYPE of the entities in the tree
+	unsigned int GetTypeMask(void) const;
+
+protected:
+	// The maximum number of entities in a leaf node
+	static const unsigned int uiMaxLeafSize = 4;
+
+	// A node in the tree. A leaf has uiCount > 0 and holds vItem[uiFirst, uiFirst + uiCount).
+	// An internal node has its 2 children at uiFirst and uiFirst + 1.
+	struct Node
+	{
+		glm::vec3 vec3BoxMin;
+		glm::vec3 vec3BoxMax;
+		unsigned int uiFirst;
+		unsigned int uiCount;
+	};
+
+	// An entity in the tree
+	struct Item
+	{
+		glm::vec3 vec3BoxMin;
+		glm::vec3 vec3BoxMax;
+		glm::vec3 vec3Centre;
+		EntityHandle handle;
+	};
+
+	vector<Node> vNode;
+	vector<Item> vItem;
+	unsigned int uiTypeMask;
+
+	// Build the subtree of a node over vItem[uiFirst, uiFirst + uiCount)
+	void BuildNode(const unsigned int uiNode, const unsigned int uiFirst, const unsigned int uiCount);
+};
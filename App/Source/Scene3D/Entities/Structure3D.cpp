@@ -18,13 +18,15 @@
 #include <iostream>
 using namespace std;
 
+const glm::vec4 CStructure3D::vec4BoxColour = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+
 /**
  @brief Default Constructor
  */
 CStructure3D::CStructure3D(void)
 {
 	// Set the default position to the origin
-	vec3Position = glm::vec3(0.0f, fHeightOffset, 0.0f);
+	SetPosition(glm::vec3(0.0f, fHeightOffset, 0.0f));
 }
 
 /**
@@ -37,7 +39,7 @@ CStructure3D::CStructure3D(void)
 CStructure3D::CStructure3D(	const glm::vec3 vec3Position,
 							const glm::vec3 vec3Front)
 {
-	this->vec3Position = glm::vec3(vec3Position.x, vec3Position.y + fHeightOffset, vec3Position.z);
+	SetPosition(glm::vec3(vec3Position.x, vec3Position.y + fHeightOffset, vec3Position.z));
 	this->vec3Front = vec3Front;
 }
 
@@ -48,6 +50,36 @@ CStructure3D::~CStructure3D(void)
 {
 }
 
+/**
+ @brief Allocate an instance of this class from its CObjectPool
+ @param uiSize A size_t variable containing the size of the instance
+ @return A void* variable
+ */
+void* CStructure3D::operator new(size_t uiSize)
+{
+	return GetPool().Allocate(uiSize);
+}
+
+/**
+ @brief Return the memory of an instance of this class to its CObjectPool
+ @param p A void* variable containing the memory of the instance
+ @param uiSize A size_t variable containing the size of the instance
+ */
+void CStructure3D::operator delete(void* p, size_t uiSize)
+{
+	GetPool().Free(p, uiSize);
+}
+
+/**
+ @brief Get the CObjectPool which the instances of this class are allocated from
+ @return A CObjectPool<CStructure3D>& variable
+ */
+CObjectPool<CStructure3D>& CStructure3D::GetPool(void)
+{
+	static CObjectPool<CStructure3D> cPool;
+	return cPool;
+}
+
 /**
  @brief Initialise this class instance
  @return true is successfully initialised this class instance, else false
@@ -76,6 +108,9 @@ bool CStructure3D::Init(CEntity3D::TYPE type)
 			return false;
 		}
 
+		// Keep the bounding box of the model for the occlusion culling
+		ExpandModelBox(vertices);
+
 		CLoadOBJ::IndexVBO(vertices, uvs, normals, index_buffer_data, vertex_buffer_data);
 
 		glGenVertexArrays(1, &VAO);
@@ -108,7 +143,7 @@ bool CStructure3D::Init(CEntity3D::TYPE type)
 		glGenVertexArrays(1, &VAO);
 		glBindVertexArray(VAO);
 
-		mesh = CMeshBuilder::GenerateBox(glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+		mesh = CMeshBuilder::GenerateBox(vec4BoxColour);
 
 		// load and create a texture 
 		iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/Scene3D_Structure_01.tga", false);
@@ -158,7 +193,7 @@ void CStructure3D::SetProjection(const glm::mat4 projection)
  */
 bool CStructure3D::Update(const double dElapsedTime)
 {
-	if (!bStatus)
+	if (!GetStatus())
 		return false;
 	CSolidObject::Update(dElapsedTime);
 
@@ -170,7 +205,7 @@ bool CStructure3D::Update(const double dElapsedTime)
 */
 void CStructure3D::PreRender(void)
 {
-	if (!bStatus)
+	if (!GetStatus())
 		return;
 	CSolidObject::PreRender();
 }
@@ -181,7 +216,7 @@ void CStructure3D::PreRender(void)
 */
 void CStructure3D::Render(void)
 {
-	if (!bStatus)
+	if (!GetStatus())
 		return;
 	CSolidObject::Render();
 }
@@ -191,7 +226,34 @@ void CStructure3D::Render(void)
 */
 void CStructure3D::PostRender(void)
 {
-	if (!bStatus)
+	if (!GetStatus())
 		return;
 	CSolidObject::PostRender();
 }
+
+/**
+ @brief Check if this structure can be merged into a CStaticBatch.
+		Only the crates are batched. The ammo boxes are picked up and use a model with a different vertex layout.
+ @return true if this structure can be batched, else false
+ */
+bool CStructure3D::IsBatchable(void) const
+{
+	return (GetType() == CEntity3D::TYPE::STRUCTURE) && (mesh != NULL);
+}
+
+/**
+ @brief Get the geometry of this structure in world space, to be merged into a CStaticBatch
+ @param vVertices A vector<Vertex>& variable which is filled with the vertices
+ @param vIndices A vector<unsigned int>& variable which is filled with the indices
+ */
+void CStructure3D::GetBatchGeometry(vector<Vertex>& vVertices, vector<unsigned int>& vIndices) const
+{
+	CMeshBuilder::GenerateBoxData(vVertices, vIndices, vec4BoxColour);
+
+	// Apply the same transformation as CSolidObject::Update()
+	glm::mat4 batchModel = glm::mat4(1.0f);
+	batchModel = glm::translate(batchModel, GetPosition());
+	batchModel = glm::scale(batchModel, vec3Scale);
+	for (unsigned int i = 0; i < vVertices.size(); i++)
+		vVertices[i].position = glm::vec3(batchModel * glm::vec4(vVertices[i].position, 1.0f));
+}
@@ -5,6 +5,9 @@
  */
 #pragma once
 
+// Include CObjectPool
+#include "System/ObjectPool.h"
+
 // Include CSolidObject
 #include "SolidObject.h"
 
@@ -16,7 +19,11 @@
 // Include Camera
 #include "../Camera.h"
 
+// Include Mesh
+#include "Primitives/Mesh.h"
+
 #include <string>
+#include <vector>
 using namespace std;
 
 // An abstract camera class that processes input and calculates the corresponding Euler Angles, Vectors and Matrices for use in OpenGL
@@ -33,6 +40,13 @@ public:
 	// Destructor
 	virtual ~CStructure3D(void);
 
+	// Allocate the instances of this class from a CObjectPool, so that creating one reuses the memory of a deleted one
+	static void* operator new(size_t uiSize);
+	// Return the memory of an instance to the CObjectPool
+	static void operator delete(void* p, size_t uiSize);
+	// Get the CObjectPool of this class
+	static CObjectPool<CStructure3D>& GetPool(void);
+
 	// Initialise this class instance
 	bool Init(CEntity3D::TYPE type = CEntity3D::TYPE::STRUCTURE);
 
@@ -52,4 +66,13 @@ public:
 	virtual void Render(void);
 	// PostRender
 	virtual void PostRender(void);
+
+	// Check if this structure can be merged into a CStaticBatch
+	bool IsBatchable(void) const;
+	// Get the geometry of this structure in world space, to be merged into a CStaticBatch
+	void GetBatchGeometry(vector<Vertex>& vVertices, vector<unsigned int>& vIndices) const;
+
+protected:
+	// The colour of the box of a crate
+	static const glm::vec4 vec4BoxColour;
 };
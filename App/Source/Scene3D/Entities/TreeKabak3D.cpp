@@ -15,9 +15,17 @@
 // Include CTerrain
 #include "../Terrain/Terrain.h"
 
+// Include CCameraUniformBuffer
+#include "RenderControl/CameraUniformBuffer.h"
+
+// Include CRandomStreams
+#include "System/Random.h"
+
 #include <iostream>
 using namespace std;
 
+const float CTreeKabak3D::fResplitDistance = 1.0f;
+
 /**
  @brief Default Constructor
  */
@@ -26,9 +34,24 @@ CTreeKabak3D::CTreeKabak3D(void)
 	, iNumOfInstance(10)
 	, fSpreadDistance(5.0f)
 	, iIndicesSize(0)
+	, uiNumOfNear(0)
+	, uiNumOfFar(0)
+	, vec3SplitPosition(0.0f)
+	, bSplitDirty(true)
+	, vec3ModelMin(0.0f)
+	, vec3ModelMax(0.0f)
+	, uiInstanceVBO(0)
+	, sImpostorShaderName("Shader3D_Impostor")
+	, fImpostorDistance(50.0f)
+	, bImpostorsEnabled(true)
+	, bImpostorReady(false)
+	, uiImpostorVAO(0)
+	, uiImpostorVBO(0)
+	, uiImpostorInstanceVBO(0)
+	, uiImpostorTextureID(0)
 {
 	// Set the default position to the origin
-	vec3Position = glm::vec3(0.0f, 0.0f, 0.0f);
+	SetPosition(glm::vec3(0.0f, 0.0f, 0.0f));
 }
 
 /**
@@ -46,9 +69,24 @@ CTreeKabak3D::CTreeKabak3D(	const glm::vec3 vec3Position,
 	, iNumOfInstance(10)
 	, fSpreadDistance(5.0f)
 	, iIndicesSize(0)
+	, uiNumOfNear(0)
+	, uiNumOfFar(0)
+	, vec3SplitPosition(0.0f)
+	, bSplitDirty(true)
+	, vec3ModelMin(0.0f)
+	, vec3ModelMax(0.0f)
+	, uiInstanceVBO(0)
+	, sImpostorShaderName("Shader3D_Impostor")
+	, fImpostorDistance(50.0f)
+	, bImpostorsEnabled(true)
+	, bImpostorReady(false)
+	, uiImpostorVAO(0)
+	, uiImpostorVBO(0)
+	, uiImpostorInstanceVBO(0)
+	, uiImpostorTextureID(0)
 {
 	// Set the default position to the origin
-	this->vec3Position = vec3Position;
+	SetPosition(vec3Position);
 }
 
 /**
@@ -56,6 +94,16 @@ CTreeKabak3D::CTreeKabak3D(	const glm::vec3 vec3Position,
  */
 CTreeKabak3D::~CTreeKabak3D(void)
 {
+	if (uiInstanceVBO != 0)
+		glDeleteBuffers(1, &uiInstanceVBO);
+	if (uiImpostorInstanceVBO != 0)
+		glDeleteBuffers(1, &uiImpostorInstanceVBO);
+	if (uiImpostorVBO != 0)
+		glDeleteBuffers(1, &uiImpostorVBO);
+	if (uiImpostorVAO != 0)
+		glDeleteVertexArrays(1, &uiImpostorVAO);
+	if (uiImpostorTextureID != 0)
+		glDeleteTextures(1, &uiImpostorTextureID);
 }
 
 /**
@@ -65,7 +113,7 @@ CTreeKabak3D::~CTreeKabak3D(void)
 bool CTreeKabak3D::Init(void)
 {
 	// Call the parent's Init()
-	CEntity3D::Init();
+	CSolidObject::Init();
 
 	// Set the type
 	SetType(CEntity3D::TYPE::OTHERS);
@@ -134,38 +182,41 @@ bool CTreeKabak3D::Init(void)
 	{
 		// Generate the list of transformation matrices which 
 		// indicates where each instance will be at, and its orientation
-		glm::mat4* modelMatrices = new glm::mat4[iNumOfInstance];
+		vInstanceModel.resize(iNumOfInstance);
+		vInstancePosition.resize(iNumOfInstance);
+		vNearModel.reserve(iNumOfInstance);
+		vFarPosition.reserve(iNumOfInstance);
 
-		// Initialize random seed
-		srand((unsigned int)glfwGetTime());
+		// The placement stream is seeded from the global seed, so the trees are placed the same way in a replay
+		CRandom& cRandom = CRandomStreams::GetInstance()->Get(CRandomStreams::PLACEMENT);
 
 		for (unsigned int i = 0; i < iNumOfInstance; i++)
 		{
 			glm::mat4 model = glm::mat4(1.0f);
 			// 1. Use Translation to randomly disperse the trees in a rectangular area
-			float x = vec3Position.x + (rand() % 100) * fSpreadDistance * 0.01f - fSpreadDistance * 0.5f;
-			float z = vec3Position.z + (rand() % 100) * fSpreadDistance * 0.01f - fSpreadDistance * 0.5f;
+			float x = GetPosition().x + cRandom.RangeFloat(-0.5f, 0.5f) * fSpreadDistance;
+			float z = GetPosition().z + cRandom.RangeFloat(-0.5f, 0.5f) * fSpreadDistance;
 			float y = CTerrain::GetInstance()->GetHeight(x, z);
 			model = glm::translate(model, glm::vec3(x, y, z));
 
 			// 2. Use scaling to create trees of various sizes
-			float scale = (rand() % 100) * 0.0005f + 0.01f;
+			float scale = cRandom.RangeFloat(0.01f, 0.06f);
 			model = glm::scale(model, glm::vec3(vec3Scale.x * scale,
 				vec3Scale.y * scale,
 				vec3Scale.z * scale));
 
 			// 3. Add this transformation matrix to list of matrices
-			modelMatrices[i] = model;
+			vInstanceModel[i] = model;
+			// The impostors are scaled uniformly
+			vInstancePosition[i] = glm::vec4(x, y, z, vec3Scale.y * scale);
 		}
 
 		// configure instanced array
 		// -------------------------
-		unsigned int buffer;
-		glGenBuffers(1, &buffer);
-		glBindBuffer(GL_ARRAY_BUFFER, buffer);
-		glBufferData(GL_ARRAY_BUFFER, iNumOfInstance * sizeof(glm::mat4), &modelMatrices[0], GL_STATIC_DRAW);
-		// Delete the array of modelMatrices since we had already uploaded it to the graphics card
-		delete[] modelMatrices;
+		// The buffer is refilled in Update with the instances which are near the camera
+		glGenBuffers(1, &uiInstanceVBO);
+		glBindBuffer(GL_ARRAY_BUFFER, uiInstanceVBO);
+		glBufferData(GL_ARRAY_BUFFER, iNumOfInstance * sizeof(glm::mat4), &vInstanceModel[0], GL_STREAM_DRAW);
 
 		// Set transformation matrices as an instance vertex attribute (with divisor 1)
 		// We simplify our codes by loading the VAO as well
@@ -190,6 +241,20 @@ bool CTreeKabak3D::Init(void)
 
 			glBindVertexArray(0);
 		}
+
+		// Calculate the bounds of the model for the impostors
+		vec3ModelMin = vertices[0];
+		vec3ModelMax = vertices[0];
+		for (unsigned int i = 1; i < vertices.size(); i++)
+		{
+			vec3ModelMin = glm::min(vec3ModelMin, vertices[i]);
+			vec3ModelMax = glm::max(vec3ModelMax, vertices[i]);
+		}
+
+		// Without the impostors, every instance is rendered with the full model
+		bImpostorReady = InitImpostor();
+		if (bImpostorReady == false)
+			cout << "Unable to create the impostors for CTreeKabak3D" << endl;
 	}
 
 	return true;
@@ -250,6 +315,35 @@ void CTreeKabak3D::SetSpreadDistance(const float fSpreadDistance)
 	this->fSpreadDistance = fSpreadDistance;
 }
 
+/**
+ @brief Set the distance beyond which an instance is rendered as an impostor
+ @param fImpostorDistance A const float containing the distance from the camera
+ */
+void CTreeKabak3D::SetImpostorDistance(const float fImpostorDistance)
+{
+	this->fImpostorDistance = fImpostorDistance;
+	bSplitDirty = true;
+}
+
+/**
+ @brief Set the shader for the impostors
+ @param _name A const std::string& containing the name of the shader in CShaderManager
+ */
+void CTreeKabak3D::SetImpostorShader(const std::string& _name)
+{
+	sImpostorShaderName = _name;
+}
+
+/**
+ @brief Set to false to render every instance with the full model
+ @param bImpostorsEnabled A const bool containing whether the far instances are rendered as impostors
+ */
+void CTreeKabak3D::SetImpostorsEnabled(const bool bImpostorsEnabled)
+{
+	this->bImpostorsEnabled = bImpostorsEnabled;
+	bSplitDirty = true;
+}
+
 /**
  @brief Update the elapsed time
  @param dt A const double variable containing the elapsed time since the last frame
@@ -257,12 +351,26 @@ void CTreeKabak3D::SetSpreadDistance(const float fSpreadDistance)
  */
 bool CTreeKabak3D::Update(const double dElapsedTime)
 {
-	if (!bInstancedRendering)
+	if (bInstancedRendering)
+	{
+		// Split the instances once per frame from the main camera, instead of in each render pass,
+		// and only when the camera has moved far enough for the split to change noticeably
+		const glm::vec3 vec3CameraPosition = CCamera::GetInstance()->vec3Position;
+		const glm::vec3 vec3Moved = vec3CameraPosition - vec3SplitPosition;
+		if ((bSplitDirty) || (glm::dot(vec3Moved, vec3Moved) > fResplitDistance * fResplitDistance))
+		{
+			vec3SplitPosition = vec3CameraPosition;
+			SplitInstances(vec3SplitPosition);
+			UploadInstances();
+			bSplitDirty = false;
+		}
+	}
+	else
 	{
 		// create transformations
 		model = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
 		//model = glm::rotate(model, (float)glfwGetTime()/10.0f, glm::vec3(0.0f, 0.0f, 1.0f));
-		model = glm::translate(model, vec3Position);
+		model = glm::translate(model, GetPosition());
 		model = glm::rotate(model, -1.5708f, glm::vec3(1, 0, 0));
 		model = glm::scale(model, vec3Scale);
 	}
@@ -289,30 +397,40 @@ void CTreeKabak3D::Render(void)
 {
 	if (bInstancedRendering)
 	{
-		// configure transformation matrices
-		CShaderManager::GetInstance()->activeShader->setMat4("projection", projection);
-		CShaderManager::GetInstance()->activeShader->setMat4("view", view);
-
 		// draw a tree
 		CShaderManager::GetInstance()->activeShader->setInt("texture_diffuse1", 0);
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, iTextureID); // note: we also made the textures_loaded vector public (instead of private) from the model class.
 		
-		// We instanced render the trees. if you have multiple VAOs, then you can render them using this loop
-		for (unsigned int i = 0; i < 1; i++)
+		// We instanced render the trees near the camera with the full model
+		if (uiNumOfNear > 0)
 		{
 			glBindVertexArray(VAO);
-			glDrawElementsInstanced(GL_TRIANGLES, iIndicesSize, GL_UNSIGNED_INT, 0, iNumOfInstance);
+			glDrawElementsInstanced(GL_TRIANGLES, iIndicesSize, GL_UNSIGNED_INT, 0, uiNumOfNear);
+			glBindVertexArray(0);
+		}
+
+		// and the trees far from the camera as impostors
+		if (uiNumOfFar > 0)
+		{
+			CShaderManager::GetInstance()->Use(sImpostorShaderName);
+			CShaderManager::GetInstance()->activeShader->setVec3("impostorCentre", (vec3ModelMin + vec3ModelMax) * 0.5f);
+			const glm::vec3 vec3HalfSize = (vec3ModelMax - vec3ModelMin) * 0.5f;
+			CShaderManager::GetInstance()->activeShader->setVec2("impostorHalfSize",
+				sqrt(vec3HalfSize.x * vec3HalfSize.x + vec3HalfSize.z * vec3HalfSize.z),
+				vec3HalfSize.y);
+			CShaderManager::GetInstance()->activeShader->setFloat("numViews", (float)uiImpostorViews);
+			CShaderManager::GetInstance()->activeShader->setInt("texture_diffuse1", 0);
+			glBindTexture(GL_TEXTURE_2D, uiImpostorTextureID);
+
+			glBindVertexArray(uiImpostorVAO);
+			glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, uiNumOfFar);
 			glBindVertexArray(0);
 		}
 		glBindTexture(GL_TEXTURE_2D, 0);
 	}
 	else
 	{
-		// note: currently we set the projection matrix each frame, but since the projection 
-		// matrix rarely changes it's often best practice to set it outside the main loop only once.
-		CShaderManager::GetInstance()->activeShader->setMat4("projection", projection);
-		CShaderManager::GetInstance()->activeShader->setMat4("view", view);
 		CShaderManager::GetInstance()->activeShader->setMat4("model", model);
 
 		// bind textures on corresponding texture units
@@ -334,6 +452,182 @@ void CTreeKabak3D::PostRender(void)
 	glDepthFunc(GL_LESS); // set depth function back to default
 }
 
+/**
+ @brief Create the impostor atlas and the buffers for the impostors.
+		The model is rendered once from each of uiImpostorViews angles around the up axis
+		into a row of the atlas, with an orthographic projection which fits its bounds.
+ @return true if the impostors are created, else false
+ */
+bool CTreeKabak3D::InitImpostor(void)
+{
+	if (CShaderManager::GetInstance()->Check(sImpostorShaderName) == false)
+	{
+		cout << "Unable to find the impostor shader " << sImpostorShaderName << endl;
+		return false;
+	}
+
+	const glm::vec3 vec3Centre = (vec3ModelMin + vec3ModelMax) * 0.5f;
+	const glm::vec3 vec3HalfSize = (vec3ModelMax - vec3ModelMin) * 0.5f;
+	// The half width must fit the model when it is seen from any angle around the up axis
+	const float fHalfWidth = sqrt(vec3HalfSize.x * vec3HalfSize.x + vec3HalfSize.z * vec3HalfSize.z);
+	const float fRadius = glm::length(vec3HalfSize);
+	if (fRadius <= 0.0f)
+		return false;
+
+	// Create the atlas
+	const GLsizei iAtlasWidth = uiImpostorViews * uiImpostorViewSize;
+	const GLsizei iAtlasHeight = uiImpostorViewSize;
+	glGenTextures(1, &uiImpostorTextureID);
+	glBindTexture(GL_TEXTURE_2D, uiImpostorTextureID);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, iAtlasWidth, iAtlasHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// Keep the current framebuffer and viewport, as the atlas may be created in the middle of a frame
+	GLint iPrevFramebuffer = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &iPrevFramebuffer);
+	GLint arrPrevViewport[4];
+	glGetIntegerv(GL_VIEWPORT, arrPrevViewport);
+
+	// Framebuffer configuration
+	GLuint uiFBO = 0, uiRBO = 0;
+	glGenFramebuffers(1, &uiFBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, uiFBO);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, uiImpostorTextureID, 0);
+	glGenRenderbuffers(1, &uiRBO);
+	glBindRenderbuffer(GL_RENDERBUFFER, uiRBO);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, iAtlasWidth, iAtlasHeight);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, uiRBO);
+	const bool bComplete = (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+
+	if (bComplete)
+	{
+		// The atlas is transparent around the model
+		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		// Render a single instance at the origin
+		const glm::mat4 matIdentity = glm::mat4(1.0f);
+		glBindBuffer(GL_ARRAY_BUFFER, uiInstanceVBO);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::mat4), &matIdentity);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		CShaderManager::GetInstance()->Use(sShaderName);
+		CShaderManager::GetInstance()->activeShader->setInt("texture_diffuse1", 0);
+		const glm::mat4 matProjection = glm::ortho(-fHalfWidth, fHalfWidth, -vec3HalfSize.y, vec3HalfSize.y, fRadius, fRadius * 3.0f);
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, iTextureID);
+		glBindVertexArray(VAO);
+
+		for (unsigned int i = 0; i < uiImpostorViews; i++)
+		{
+			// The view i is seen from the angle i * 360 / uiImpostorViews degrees around the up axis,
+			// measured from the +z axis towards the +x axis. This must match Impostor.vs
+			const float fAngle = glm::two_pi<float>() * i / uiImpostorViews;
+			const glm::vec3 vec3Direction = glm::vec3(sin(fAngle), 0.0f, cos(fAngle));
+			CCameraUniformBuffer::GetInstance()->BeginPass(
+				glm::lookAt(vec3Centre + vec3Direction * fRadius * 2.0f, vec3Centre, glm::vec3(0.0f, 1.0f, 0.0f)),
+				matProjection);
+
+			glViewport(i * uiImpostorViewSize, 0, uiImpostorViewSize, uiImpostorViewSize);
+			glDrawElementsInstanced(GL_TRIANGLES, iIndicesSize, GL_UNSIGNED_INT, 0, 1);
+		}
+
+		glBindVertexArray(0);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+	else
+		cout << "ERROR::FRAMEBUFFER:: Impostor framebuffer is not complete!" << endl;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, iPrevFramebuffer);
+	glViewport(arrPrevViewport[0], arrPrevViewport[1], arrPrevViewport[2], arrPrevViewport[3]);
+	glDeleteRenderbuffers(1, &uiRBO);
+	glDeleteFramebuffers(1, &uiFBO);
+
+	if (bComplete == false)
+		return false;
+
+	// The impostors are minified a lot, so use mipmaps
+	glBindTexture(GL_TEXTURE_2D, uiImpostorTextureID);
+	glGenerateMipmap(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// A quad with corners from (-1, -1) to (1, 1), rendered as a triangle strip
+	const float arrCorner[] = {
+		-1.0f, -1.0f,
+		 1.0f, -1.0f,
+		-1.0f,  1.0f,
+		 1.0f,  1.0f
+	};
+	glGenVertexArrays(1, &uiImpostorVAO);
+	glBindVertexArray(uiImpostorVAO);
+	glGenBuffers(1, &uiImpostorVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, uiImpostorVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(arrCorner), arrCorner, GL_STATIC_DRAW);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+
+	// The position and scale of each impostor, as an instance vertex attribute
+	glGenBuffers(1, &uiImpostorInstanceVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, uiImpostorInstanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, iNumOfInstance * sizeof(glm::vec4), NULL, GL_STREAM_DRAW);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+	glVertexAttribDivisor(1, 1);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	return true;
+}
+
+/**
+ @brief Split the instances into those near the camera and those rendered as impostors
+ @param vec3CameraPosition A const glm::vec3& containing the position of the camera in this frame
+ */
+void CTreeKabak3D::SplitInstances(const glm::vec3& vec3CameraPosition)
+{
+	vNearModel.clear();
+	vFarPosition.clear();
+
+	const float fImpostorDistance2 = fImpostorDistance * fImpostorDistance;
+	for (unsigned int i = 0; i < vInstancePosition.size(); i++)
+	{
+		const glm::vec3 vec3Offset = glm::vec3(vInstancePosition[i]) - vec3CameraPosition;
+		if ((bImpostorReady) && (bImpostorsEnabled) && (glm::dot(vec3Offset, vec3Offset) > fImpostorDistance2))
+			vFarPosition.push_back(vInstancePosition[i]);
+		else
+			vNearModel.push_back(vInstanceModel[i]);
+	}
+
+	uiNumOfNear = vNearModel.size();
+	uiNumOfFar = vFarPosition.size();
+}
+
+/**
+ @brief Upload the split instances to the instance buffers
+ */
+void CTreeKabak3D::UploadInstances(void)
+{
+	// Orphan the buffers so that the driver does not wait for the previous frame's draws
+	if (uiNumOfNear > 0)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, uiInstanceVBO);
+		glBufferData(GL_ARRAY_BUFFER, iNumOfInstance * sizeof(glm::mat4), NULL, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, uiNumOfNear * sizeof(glm::mat4), &vNearModel[0]);
+	}
+	if (uiNumOfFar > 0)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, uiImpostorInstanceVBO);
+		glBufferData(GL_ARRAY_BUFFER, iNumOfInstance * sizeof(glm::vec4), NULL, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, uiNumOfFar * sizeof(glm::vec4), &vFarPosition[0]);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 /**
  @brief Print Self
  */
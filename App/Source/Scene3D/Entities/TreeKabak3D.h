@@ -18,6 +18,7 @@
 #include "../Camera.h"
 
 #include <string>
+#include <vector>
 using namespace std;
 
 // An abstract camera class that processes input and calculates the corresponding Euler Angles, Vectors and Matrices for use in OpenGL
@@ -52,6 +53,12 @@ public:
 	virtual void SetNumOfInstance(const unsigned int iNumOfInstance);
 	// Set the spread distance
 	virtual void SetSpreadDistance(const float fSpreadDistance);
+	// Set the distance beyond which an instance is rendered as an impostor
+	virtual void SetImpostorDistance(const float fImpostorDistance);
+	// Set the shader for the impostors
+	virtual void SetImpostorShader(const std::string& _name);
+	// Set to false to render every instance with the full model
+	virtual void SetImpostorsEnabled(const bool bImpostorsEnabled);
 
 	// Update this class instance
 	virtual bool Update(const double dElapsedTime);
@@ -66,6 +73,11 @@ public:
 	// Get the bInstancedRendering
 	bool IsInstancedRendering(void) { return bInstancedRendering; }
 
+	// Get the number of instances rendered with the full model in this frame
+	unsigned int GetNumOfNearInstance(void) const { return uiNumOfNear; }
+	// Get the number of instances rendered as impostors in this frame
+	unsigned int GetNumOfFarInstance(void) const { return uiNumOfFar; }
+
 	// Print Self
 	virtual void PrintSelf(void);
 
@@ -78,4 +90,46 @@ protected:
 	// Bool flag to indicate if you want to use Instanced Rendering, or use normal rendering for debugging purpose.
 	// true == Instanced Rendering, false == normal rendering.
 	bool bInstancedRendering;
+
+	// The number of view angles, and the size in pixels of each view, in the impostor atlas
+	static const unsigned int uiImpostorViews = 8;
+	static const unsigned int uiImpostorViewSize = 256;
+
+	// The transformation of each instance, and its position (xyz) and scale (w) for the impostors
+	vector<glm::mat4> vInstanceModel;
+	vector<glm::vec4> vInstancePosition;
+	// The instances split for the current frame. Every render pass of the frame draws the same split.
+	vector<glm::mat4> vNearModel;
+	vector<glm::vec4> vFarPosition;
+	unsigned int uiNumOfNear;
+	unsigned int uiNumOfFar;
+	// The camera position of the last split, and whether the split must be redone
+	glm::vec3 vec3SplitPosition;
+	bool bSplitDirty;
+	// The instances are split again only when the camera has moved this far since the last split
+	static const float fResplitDistance;
+
+	// The bounds of the model
+	glm::vec3 vec3ModelMin;
+	glm::vec3 vec3ModelMax;
+
+	// The buffer of the transformations of the instances rendered with the full model
+	GLuint uiInstanceVBO;
+
+	// The impostors are camera-facing quads textured from an atlas of the model rendered from several view angles
+	std::string sImpostorShaderName;
+	float fImpostorDistance;
+	bool bImpostorsEnabled;
+	bool bImpostorReady;
+	GLuint uiImpostorVAO;
+	GLuint uiImpostorVBO;
+	GLuint uiImpostorInstanceVBO;
+	GLuint uiImpostorTextureID;
+
+	// Create the impostor atlas and the buffers for the impostors
+	bool InitImpostor(void);
+	// Split the instances into those near the camera and those rendered as impostors
+	void SplitInstances(const glm::vec3& vec3CameraPosition);
+	// Upload the split instances to the instance buffers
+	void UploadInstances(void);
 };
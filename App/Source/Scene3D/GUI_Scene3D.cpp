@@ -18,8 +18,15 @@
 #include "CameraEffects/HitMarker.h"
 #include "Entities/SolidObjectManager.h"
 
+// Include CCameraUniformBuffer
+#include "RenderControl/CameraUniformBuffer.h"
+
+// Include CLogger
+#include "System/Logger.h"
+
 
 #include <iostream>
+#include <cstdio>
 using namespace std;
 
 /**
@@ -37,6 +44,7 @@ CGUI_Scene3D::CGUI_Scene3D(void)
 	, cInventoryManager(NULL)
 	, cInventoryItem(NULL)
 	, cPlayer3D(NULL)
+	, cTextRenderer(NULL)
 {
 }
 
@@ -47,6 +55,13 @@ CGUI_Scene3D::~CGUI_Scene3D(void)
 {
 	// Set the cPlayer3D to NULL since it was initialised elsewhere
 	cPlayer3D = NULL;
+
+	// Destroy the cTextRenderer and set it to NULL
+	if (cTextRenderer)
+	{
+		cTextRenderer->Destroy();
+		cTextRenderer = NULL;
+	}
 	
 	// Destroy the cInventoryManager and set it to NULL
 	if (cInventoryManager)
@@ -131,6 +146,19 @@ bool CGUI_Scene3D::Init(void)
 	cMinimap->SetShader("cRenderToTextureShader");
 	cMinimap->Init();
 
+	// Load the CTextRenderer for the HUD text
+	if (cSettings->bUseTextRenderer == true)
+	{
+		cTextRenderer = CTextRenderer::GetInstance();
+		// Set a shader to this class instance of CTextRenderer
+		cTextRenderer->SetShader("textShader");
+		if (cTextRenderer->Init() == false)
+		{
+			cout << "Failed to load CTextRenderer" << endl;
+			return false;
+		}
+	}
+
 	// Setup Dear ImGui context
 	IMGUI_CHECKVERSION();
 	ImGui::CreateContext();
@@ -226,10 +254,13 @@ void CGUI_Scene3D::Update(const double dElapsedTime)
 	ImGui::SetWindowSize(ImVec2((float)cSettings->iWindowWidth, (float)cSettings->iWindowHeight));
 	ImGui::SetWindowFontScale(1.5f * relativeScale_y);
 
-	// Display the FPS
-	ImGui::TextColored(ImVec4(1, 1, 0, 1), "FPS: %d", cFPSCounter->GetFrameRate());
-	ImGui::TextColored(ImVec4(1, 1, 0, 1), "Timer: %3.2f", cPlayer3D->timer);
-	ImGui::TextColored(ImVec4(1, 1, 0, 1), "WaveCount: %d", cPlayer3D->waveCount);
+	// Display the FPS, unless the CTextRenderer draws it in Render()
+	if (cTextRenderer == NULL)
+	{
+		ImGui::TextColored(ImVec4(1, 1, 0, 1), "FPS: %d", cFPSCounter->GetFrameRate());
+		ImGui::TextColored(ImVec4(1, 1, 0, 1), "Timer: %3.2f", cPlayer3D->timer);
+		ImGui::TextColored(ImVec4(1, 1, 0, 1), "WaveCount: %d", cPlayer3D->waveCount);
+	}
 
 	// Render the Health
 	ImGuiWindowFlags healthWindowFlags = ImGuiWindowFlags_AlwaysAutoResize |
@@ -419,16 +450,61 @@ void CGUI_Scene3D::Render(void)
 	if (!cPlayer3D->isDriving)
 	{
 		glEnable(GL_DEPTH_TEST); // enable depth testing (is disabled for rendering screen-space quad)
-		cPlayer3D->GetWeapon()->SetProjection(projection);
+		// The weapon is modelled in the camera space, so render it in a pass with no view transformation
+		CCameraUniformBuffer::GetInstance()->BeginPass(glm::mat4(1.0f), projection);
 		cPlayer3D->GetWeapon()->PreRender();
 		cPlayer3D->GetWeapon()->Render();
 		cPlayer3D->GetWeapon()->PostRender();
 		glDisable(GL_DEPTH_TEST); // disable depth test so screen-space quad isn't discarded due to depth test.
 	}
 
+	// Render the HUD text before ImGui, so that the wave screens of ImGui cover it
+	if (cTextRenderer)
+		RenderHUDText();
+
 	// Rendering
 	ImGui::Render();
-	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+	ImDrawData* cDrawData = ImGui::GetDrawData();
+	ImGui_ImplOpenGL3_RenderDrawData(cDrawData);
+
+	// Measure the draw calls of the HUD. ImGui issues one draw call per command of its command lists.
+	unsigned int uiNumImGuiDrawCalls = 0;
+	for (int i = 0; i < cDrawData->CmdListsCount; i++)
+		uiNumImGuiDrawCalls += (unsigned int)cDrawData->CmdLists[i]->CmdBuffer.Size;
+	const unsigned int uiNumTextDrawCalls = cTextRenderer ? cTextRenderer->GetNumDrawCalls() : 0;
+	const unsigned int uiNumGlyphs = cTextRenderer ? cTextRenderer->GetNumGlyphs() : 0;
+	LOG_TRACE_EVERY(1.0, RENDER, "HUD: %u draw calls, %u for ImGui and %u for %u glyphs of CTextRenderer text",
+					uiNumImGuiDrawCalls + uiNumTextDrawCalls, uiNumImGuiDrawCalls, uiNumTextDrawCalls, uiNumGlyphs);
+}
+
+/**
+ @brief Render the FPS, timer and wave count with the CTextRenderer, at the top left corner of the window
+ */
+void CGUI_Scene3D::RenderHUDText(void)
+{
+	// Calculate the relative scale to our default windows width
+	const float relativeScale_y = cSettings->iWindowHeight / 600.0f;
+	// The glyphs are rasterized 40 pixels high, so this is about the size of the ImGui text in Update()
+	const float fScale = 0.5f * relativeScale_y;
+	const float fLineHeight = 24.0f * relativeScale_y;
+	const glm::vec3 vec3Colour = glm::vec3(1.0f, 1.0f, 0.0f);
+
+	// The CTextRenderer places its text from the bottom left corner of the window
+	const float fX = 10.0f * relativeScale_y;
+	float fY = cSettings->iWindowHeight - fLineHeight;
+
+	char szText[64];
+	cTextRenderer->PreRender();
+	snprintf(szText, sizeof(szText), "FPS: %d", cFPSCounter->GetFrameRate());
+	cTextRenderer->Render(szText, fX, fY, fScale, vec3Colour);
+	fY -= fLineHeight;
+	snprintf(szText, sizeof(szText), "Timer: %3.2f", cPlayer3D->timer);
+	cTextRenderer->Render(szText, fX, fY, fScale, vec3Colour);
+	fY -= fLineHeight;
+	snprintf(szText, sizeof(szText), "WaveCount: %d", cPlayer3D->waveCount);
+	cTextRenderer->Render(szText, fX, fY, fScale, vec3Colour);
+	// Draw all the lines in one draw call
+	cTextRenderer->PostRender();
 }
 
 /**
@@ -50,6 +50,9 @@
 // Include CPlayer3D
 #include "Entities\Player3D.h"
 
+// Include CTextRenderer
+#include "RenderControl/TextRenderer.h"
+
 #include <string>
 using namespace std;
 
@@ -116,4 +119,10 @@ protected:
 
 	// The handler containing the instance of CPlayer3D
 	CPlayer3D* cPlayer3D;
+
+	// The handler containing the instance of CTextRenderer, which draws the HUD text in one draw call
+	CTextRenderer* cTextRenderer;
+
+	// Render the FPS, timer and wave count with the CTextRenderer
+	void RenderHUDText(void);
 };
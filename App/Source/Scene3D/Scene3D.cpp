@@ -37,8 +37,18 @@
 #include "SceneGraph/JupiterPlanet.h"
 #include "SceneGraph/Asteroid.h"
 
+// Include CMemoryStats
+#include "System/MemoryStats.h"
+
 using namespace std;
 
+// Set this to true to benchmark the CEntityStore when this scene is initialised
+#define _BENCHMARK_ENTITYSTORE false
+// Set this to true to benchmark the updates of the CSceneNode when this scene is initialised
+#define _BENCHMARK_SCENEGRAPH false
+// Set this to true to plant 10000 trees, and time the frames with and without their impostors
+#define _BENCHMARK_TREES false
+
 /**
  @brief Constructor This constructor has protected access modifier as this class will be a Singleton
  */
@@ -53,9 +63,16 @@ CScene3D::CScene3D(void)
 	, cSkybox(NULL)
 	, cTerrain(NULL)
 	, cSolidObjectManager(NULL)
+	, cLODManager(NULL)
+	, cOcclusionCuller(NULL)
+	, cAIScheduler(NULL)
 	, cPlayer3D(NULL)
 	, cProjectileManager(NULL)
+	, cTreeKabak3D(NULL)
+	, uiBenchmarkFrame(0)
 {
+	arrBenchmarkTime[0] = 0.0;
+	arrBenchmarkTime[1] = 0.0;
 }
 
 /**
@@ -63,6 +80,9 @@ CScene3D::CScene3D(void)
  */
 CScene3D::~CScene3D(void)
 {
+	// Stop checking the frames for heap allocations
+	CMemoryStats::GetInstance()->SetExpectNoAllocations(false);
+
 	// Destroy the camera
 	if (cCamera)
 	{
@@ -106,6 +126,20 @@ CScene3D::~CScene3D(void)
 		cSolidObjectManager = NULL;
 	}
 
+	// Destroy the LOD manager after the entities which are registered with it
+	if (cLODManager)
+	{
+		cLODManager->Destroy();
+		cLODManager = NULL;
+	}
+
+	// Destroy the AI scheduler
+	if (cAIScheduler)
+	{
+		cAIScheduler->Destroy();
+		cAIScheduler = NULL;
+	}
+
 	// Destroy the projectile manager
 	if (cProjectileManager)
 	{
@@ -210,7 +244,7 @@ void CScene3D::ProcessPlayerInputs(double dElapsedTime)
 
 void CScene3D::SpawnEnemy(glm::vec3 pos)
 {
-	int random = Math::RandIntMinMax(0, 1);
+	int random = Math::RandIntMinMax(0, 1, CRandomStreams::SPAWN);
 
 	switch (random)
 	{
@@ -268,9 +302,9 @@ void CScene3D::SpawnEnemy(glm::vec3 pos)
 void CScene3D::SpawnStructure(glm::vec3 pos)
 {
 	//get random values
-	int random = Math::RandIntMinMax(2, 6);
-	int j = Math::RandIntMinMax(0, 2);
-	int k = Math::RandIntMinMax(0, 2);
+	int random = Math::RandIntMinMax(2, 6, CRandomStreams::PLACEMENT);
+	int j = Math::RandIntMinMax(0, 2, CRandomStreams::PLACEMENT);
+	int k = Math::RandIntMinMax(0, 2, CRandomStreams::PLACEMENT);
 
 	//random spawning of structures
 	for (int i = 0; i < random; i++)
@@ -283,9 +317,9 @@ void CScene3D::SpawnStructure(glm::vec3 pos)
 			cStructure3D->SetShader("Shader3D");
 			cStructure3D->Init();
 			cStructure3D->InitCollider("Shader3D_Line", glm::vec4(1.0f, 0.0f, 1.0f, 1.0f), glm::vec3(-0.5f, -0.5f, -0.5f), glm::vec3(0.5f, 0.5f, 0.5f));
-			cSolidObjectManager->Add(cStructure3D);
+			cSolidObjectManager->AddStatic(cStructure3D);
 
-			j += Math::RandIntMinMax(1, 2);
+			j += Math::RandIntMinMax(1, 2, CRandomStreams::PLACEMENT);
 		}
 		else
 		{
@@ -295,9 +329,9 @@ void CScene3D::SpawnStructure(glm::vec3 pos)
 			cStructure3D->SetShader("Shader3D");
 			cStructure3D->Init();
 			cStructure3D->InitCollider("Shader3D_Line", glm::vec4(1.0f, 0.0f, 1.0f, 1.0f), glm::vec3(-0.5f, -0.5f, -0.5f), glm::vec3(0.5f, 0.5f, 0.5f));
-			cSolidObjectManager->Add(cStructure3D);
+			cSolidObjectManager->AddStatic(cStructure3D);
 
-			k += Math::RandIntMinMax(1, 2);
+			k += Math::RandIntMinMax(1, 2, CRandomStreams::PLACEMENT);
 		}
 	}
 }
@@ -310,32 +344,67 @@ void CScene3D::SpawnAmmoBox(glm::vec3 pos)
 	cStructure3D->SetShader("Shader3D");
 	cStructure3D->Init(CEntity3D::TYPE::AMMO);
 	cStructure3D->InitCollider("Shader3D_Line", glm::vec4(1.0f, 0.0f, 1.0f, 1.0f), glm::vec3(-0.5f, -0.5f, -0.5f), glm::vec3(0.5f, 0.5f, 0.5f));
-	cSolidObjectManager->Add(cStructure3D);
+	cSolidObjectManager->AddStatic(cStructure3D);
 }
 
 void CScene3D::SpawnEnemyWave(int waveCount)
 {
+	// Loading the entities allocates from the heap, so this frame is not steady-state gameplay
+	CMemoryStats::GetInstance()->AllowFrameAllocations();
+
 	for (int i = 0; i < (3 * waveCount); i++)
 	{
-		float posX = Math::RandFloatMinMax(-125, 125);
-		float posZ = Math::RandFloatMinMax(-125, 125);
+		float posX = Math::RandFloatMinMax(-125, 125, CRandomStreams::SPAWN);
+		float posZ = Math::RandFloatMinMax(-125, 125, CRandomStreams::SPAWN);
 		SpawnEnemy(glm::vec3(posX, 0, posZ));
 	}
 	for (int i = 0; i < 3; i++)
 	{
-		float posX = Math::RandFloatMinMax(-125, 125);
-		float posZ = Math::RandFloatMinMax(-125, 125);
+		float posX = Math::RandFloatMinMax(-125, 125, CRandomStreams::SPAWN);
+		float posZ = Math::RandFloatMinMax(-125, 125, CRandomStreams::SPAWN);
 		SpawnAmmoBox(glm::vec3(posX, 0, posZ));
 	}
 }
 
+/**
+ @brief Time this frame for _BENCHMARK_TREES. After some frames to warm up, the trees are rendered with
+		their impostors for BENCHMARK_FRAMES frames, and then without them for BENCHMARK_FRAMES frames.
+		Keep the camera still while the frames are timed, so that both halves see the same view.
+ */
+void CScene3D::BenchmarkTrees(void)
+{
+	const unsigned int WARMUP_FRAMES = 60;
+	const unsigned int BENCHMARK_FRAMES = 300;
+	if ((cTreeKabak3D == NULL) || (uiBenchmarkFrame >= WARMUP_FRAMES + 2 * BENCHMARK_FRAMES))
+		return;
+
+	// Wait for the GPU, so that the time includes the rendering of this frame
+	glFinish();
+	const double dFrameTime = cBenchmarkStopWatch.GetElapsedTime();
+	if (uiBenchmarkFrame >= WARMUP_FRAMES)
+		arrBenchmarkTime[(uiBenchmarkFrame - WARMUP_FRAMES) / BENCHMARK_FRAMES] += dFrameTime;
+	uiBenchmarkFrame++;
+
+	if (uiBenchmarkFrame == WARMUP_FRAMES + BENCHMARK_FRAMES)
+	{
+		// Switch off the impostors for the second half
+		cTreeKabak3D->SetImpostorsEnabled(false);
+	}
+	else if (uiBenchmarkFrame == WARMUP_FRAMES + 2 * BENCHMARK_FRAMES)
+	{
+		cTreeKabak3D->SetImpostorsEnabled(true);
+		cout << "CScene3D::BenchmarkTrees() with 10000 trees, " << BENCHMARK_FRAMES << " frames each" << endl;
+		cout << "With impostors    : " << arrBenchmarkTime[0] * 1000.0 / BENCHMARK_FRAMES << " ms per frame" << endl;
+		cout << "Without impostors : " << arrBenchmarkTime[1] * 1000.0 / BENCHMARK_FRAMES << " ms per frame" << endl;
+	}
+}
+
 /**
  @brief Init Initialise this instance
  @return true if the initialisation is successful, else false
  */ 
 bool CScene3D::Init(void)
 {
-	srand(time(NULL));
 	cSettings = CSettings::GetInstance();
 	savedMouseScrollY = 30;
 
@@ -368,10 +437,33 @@ bool CScene3D::Init(void)
 	// Set the size of the terrain
 	cTerrain->SetRenderSize(300.f, 5.0f, 300.f);
 
+	// Add a coarse proxy of the terrain to the COcclusionCuller, so that hills hide the entities behind them
+	cOcclusionCuller = COcclusionCuller::GetInstance();
+	{
+		vector<glm::vec3> vTerrainVertices;
+		vector<unsigned int> vTerrainIndices;
+		cTerrain->GenerateOccluder(vTerrainVertices, vTerrainIndices, 32);
+		cOcclusionCuller->ClearOccluders(CTerrain::OCCLUDER_GROUP);
+		cOcclusionCuller->SetOccluderGroup(CTerrain::OCCLUDER_GROUP);
+		cOcclusionCuller->AddOccluderMesh(vTerrainVertices, vTerrainIndices);
+	}
+
+	// Init the CLODManager before the entities register with it
+	cLODManager = CLODManager::GetInstance();
+	cLODManager->Init();
+
+	// Init the CAIScheduler before the NPCs are added
+	cAIScheduler = CAIScheduler::GetInstance();
+	cAIScheduler->Init();
+
 	// Load the movable Entities
 	// Init the CSolidObjectManager
 	cSolidObjectManager = CSolidObjectManager::GetInstance();
 	cSolidObjectManager->Init();
+	if (_BENCHMARK_ENTITYSTORE == true)
+		CEntityStore::Benchmark(10000);
+	if (_BENCHMARK_SCENEGRAPH == true)
+		CSceneNode::Benchmark(1000);
 
 	// Init the cPlayer3D
 	cPlayer3D = CPlayer3D::GetInstance();
@@ -383,6 +475,14 @@ bool CScene3D::Init(void)
 	// Add the cPlayer3D to the cSolidObjectManager
 	cSolidObjectManager->Add(cPlayer3D);
 
+	// Reserve the pools of the spawned entities, so that the first waves do not allocate their memory
+	CEnemy3D::GetPool().Reserve(64);
+	CCreature3D::GetPool().Reserve(64);
+	CPistol::GetPool().Reserve(64);
+	CWaypointManager::GetPool().Reserve(128);
+	CWaypoint::GetPool().Reserve(384);
+	CStructure3D::GetPool().Reserve(64);
+
 	// Initialise a CSpinTower & CJupiterPlanet
 	COrbitPlanet::Create();
 	CJupiterPlanet::Create();
@@ -390,22 +490,22 @@ bool CScene3D::Init(void)
 
 	for (int i = 0; i < 5; i++)
 	{
-		float posX = Math::RandFloatMinMax(-125, 125);
-		float posZ = Math::RandFloatMinMax(-125, 125);
+		float posX = Math::RandFloatMinMax(-125, 125, CRandomStreams::SPAWN);
+		float posZ = Math::RandFloatMinMax(-125, 125, CRandomStreams::SPAWN);
 		SpawnEnemy(glm::vec3(posX, 0, posZ));
 	}
 	
 	for (int i = 0; i < 5; i++)
 	{
-		float posX = Math::RandFloatMinMax(-125, 125);
-		float posZ = Math::RandFloatMinMax(-125, 125);
+		float posX = Math::RandFloatMinMax(-125, 125, CRandomStreams::PLACEMENT);
+		float posZ = Math::RandFloatMinMax(-125, 125, CRandomStreams::PLACEMENT);
 		SpawnStructure(glm::vec3(posX, 0, posZ));
 	}
 	
 	for (int i = 0; i < 5; i++)
 	{
-		float posX = Math::RandFloatMinMax(-125, 125);
-		float posZ = Math::RandFloatMinMax(-125, 125);
+		float posX = Math::RandFloatMinMax(-125, 125, CRandomStreams::SPAWN);
+		float posZ = Math::RandFloatMinMax(-125, 125, CRandomStreams::SPAWN);
 		SpawnAmmoBox(glm::vec3(posX, 0, posZ));
 	}
 
@@ -491,36 +591,53 @@ bool CScene3D::Init(void)
 	cHut_Concrete->InitCollider("Shader3D_Line", glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
 
 	// Add the cHut_Concrete to the cSolidObjectManager
-	cSolidObjectManager->Add(cHut_Concrete);
+	cSolidObjectManager->AddStatic(cHut_Concrete);
 
 	for (int i = -2; i < 3; i++)
 	{
 		float fCheckHeight = cTerrain->GetHeight(20.f * i, 20.f);
 		CBuilding* cBuilding = new CBuilding(glm::vec3(20.f * i, fCheckHeight, 20.f));
-		cBuilding->buildingType = (CBuilding::BUILDING_TYPE)Math::RandIntMinMax(0, 1);
+		cBuilding->buildingType = (CBuilding::BUILDING_TYPE)Math::RandIntMinMax(0, 1, CRandomStreams::PLACEMENT);
 		cBuilding->SetShader("Shader3DNoColour");
 		cBuilding->SetLODStatus(true);
 		cBuilding->Init();
 		cBuilding->InitCollider("Shader3D_Line", glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
 
 		// Add the cHut_Concrete to the cSolidObjectManager
-		cSolidObjectManager->Add(cBuilding);
+		cSolidObjectManager->AddStatic(cBuilding);
 	}
 
 	// Initialise the CTreeKabak3D
-	CTreeKabak3D* cTreeKabak3D = new CTreeKabak3D(glm::vec3(0.0f, 0.0f, 0.0f));
+	cTreeKabak3D = new CTreeKabak3D(glm::vec3(0.0f, 0.0f, 0.0f));
 	cTreeKabak3D->SetInstancingMode(true);
 	if (cTreeKabak3D->IsInstancedRendering() == true)
 	{
 		cTreeKabak3D->SetScale(glm::vec3(1.0f));
-		cTreeKabak3D->SetNumOfInstance(100);
-		cTreeKabak3D->SetSpreadDistance(100.0f);
+		if (_BENCHMARK_TREES == true)
+		{
+			// Cover the whole terrain
+			cTreeKabak3D->SetNumOfInstance(10000);
+			cTreeKabak3D->SetSpreadDistance(300.0f);
+		}
+		else
+		{
+			cTreeKabak3D->SetNumOfInstance(100);
+			cTreeKabak3D->SetSpreadDistance(100.0f);
+		}
 		cTreeKabak3D->SetShader("Shader3D_Instancing"); // FOR INSTANCED RENDERING
+		// The trees further than this from the camera are rendered as impostors
+		cTreeKabak3D->SetImpostorDistance(40.0f);
 	}
 	if (cTreeKabak3D->Init() == true)
-		cSolidObjectManager->Add(cTreeKabak3D);
+		cSolidObjectManager->AddStatic(cTreeKabak3D);
 	else
+	{
 		delete cTreeKabak3D;
+		cTreeKabak3D = NULL;
+	}
+
+	// Merge the static crates into batches per cell, now that the static world is set up
+	cSolidObjectManager->BuildStaticBatches();
 
 	// Load the GUI Entities
 	// Store the CGUI_Scene3D singleton instance here
@@ -535,6 +652,9 @@ bool CScene3D::Init(void)
 	cSoundController->LoadSound(FileSystem::getPath("Sounds\\Sound_Jump.ogg"), 3, true);
 
 	CCameraEffectsManager::GetInstance()->Get("HitMarker")->SetStatus(false);
+
+	// The frames from here on are steady-state gameplay, except when a wave is spawned
+	CMemoryStats::GetInstance()->SetExpectNoAllocations(cSettings->bCheckFrameAllocations);
 	return true;
 }
 
@@ -545,6 +665,10 @@ bool CScene3D::Init(void)
 */
 bool CScene3D::Update(const double dElapsedTime)
 {
+	// The time of a frame for _BENCHMARK_TREES starts with its Update
+	if (_BENCHMARK_TREES == true)
+		cBenchmarkStopWatch.StartTimer();
+
 	//count wave timer
 	cPlayer3D->timer += dElapsedTime;
 
@@ -688,8 +812,13 @@ bool CScene3D::Update(const double dElapsedTime)
 
 	cPlayer3D->isHealing = false;
 
-	// Update the Solid Objects
+	// Update the Solid Objects. The NPCs update less often when they are far from the camera or outside its view.
+	cAIScheduler->BeginFrame(cCamera->vec3Position,
+							cCamera->vec3Front,
+							cCamera->fZoom,
+							(float)cSettings->iWindowWidth / (float)cSettings->iWindowHeight);
 	cSolidObjectManager->Update(dElapsedTime);
+	cAIScheduler->EndFrame();
 
 	cSolidObjectManager->CheckForCollision();
 
@@ -721,6 +850,14 @@ void CScene3D::PreRender(void)
  */
 void CScene3D::Render(void)
 {
+	// Get the camera view and projection
+	glm::mat4 view = CCamera::GetInstance()->GetViewMatrix();
+	glm::mat4 projection = glm::perspective(glm::radians(CCamera::GetInstance()->fZoom),
+		(float)cSettings->iWindowWidth / (float)cSettings->iWindowHeight,
+		0.1f, 1000.0f);
+	// Rasterise the occluders for the main view on the worker thread while the minimap is rendered
+	cOcclusionCuller->StartRasterise(projection * view);
+
 	// Part 1: Render for the minimap by binding to framebuffer and render to color texture
 		//         But the camera is move to top-view of the scene
 
@@ -758,52 +895,53 @@ void CScene3D::Render(void)
 	glEnable(GL_DEPTH_TEST); // enable depth testing (is disabled for rendering screen-space quad)
 
 							 // Part 2: Render the entire scene as per normal
+	// Upload the minimap camera once for every shader in this pass
+	CCameraUniformBuffer::GetInstance()->BeginPass(playerView, playerProjection);
 	// Render the Terrain
-	cTerrain->SetView(playerView);
-	cTerrain->SetProjection(playerProjection);
 	cTerrain->PreRender();
 	cTerrain->Render();
 	cTerrain->PostRender();
 	// Render the entities for the minimap
-	cSolidObjectManager->SetView(playerView);
-	cSolidObjectManager->SetProjection(playerProjection);
+	// The minimap image is shrunk to a circle a quarter of the window height across,
+	// so the entities in it can use coarser levels of details than in the main view
+	cLODManager->Update(CLevelOfDetails::MINIMAP_PASS,
+						glm::vec3(storePlayerPosition.x, CMinimap::GetInstance()->GetMinimapZoom(), storePlayerPosition.z),
+						100.0f,
+						(float)cSettings->iWindowHeight * 0.25f);
+	cLODManager->UsePass(CLevelOfDetails::MINIMAP_PASS);
 	cSolidObjectManager->Render();
 
 	// Deactivate the cMinimap so that we can render as per normal
 	CMinimap::GetInstance()->Deactivate();
 
 	// Part 2: Render the entire scene as per normal
-	// Get the camera view and projection
-	glm::mat4 view = CCamera::GetInstance()->GetViewMatrix();
-	glm::mat4 projection = glm::perspective(glm::radians(CCamera::GetInstance()->fZoom),
-		(float)cSettings->iWindowWidth / (float)cSettings->iWindowHeight,
-		0.1f, 1000.0f);
-
 
 	glClearColor(0.0f, 0.0f, 0.5f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+	// Upload the camera once for every shader in this pass
+	CCameraUniformBuffer::GetInstance()->BeginPass(view, projection);
 
-	cSkybox->SetView(view);
-	cSkybox->SetProjection(projection);
 	cSkybox->PreRender();
 	cSkybox->Render();
 	cSkybox->PostRender();
 
 	// Render the Terrain
-	cTerrain->SetView(view);
-	cTerrain->SetProjection(projection);
 	cTerrain->PreRender();
 	cTerrain->Render();
 	cTerrain->PostRender();
 
-	cSolidObjectManager->SetView(view);
-	cSolidObjectManager->SetProjection(projection);
+	cLODManager->Update(CLevelOfDetails::MAIN_PASS,
+						cCamera->vec3Position,
+						cCamera->fZoom,
+						(float)cSettings->iWindowHeight);
+	cLODManager->UsePass(CLevelOfDetails::MAIN_PASS);
+	// Only the main view is occlusion culled. The minimap looks down from above the occluders.
+	cOcclusionCuller->BeginCulling();
 	cSolidObjectManager->Render();
+	cOcclusionCuller->EndCulling();
 
 	//Render the projectiles
-	cProjectileManager->SetView(view);
-	cProjectileManager->SetProjection(projection);
 	cProjectileManager->PreRender();
 	cProjectileManager->Render();
 	cProjectileManager->PostRender();
@@ -818,6 +956,9 @@ void CScene3D::Render(void)
 	// Call the CGUI_Scene3D's PostRender()
 	cGUI_Scene3D->PostRender();
 
+	if (_BENCHMARK_TREES == true)
+		BenchmarkTrees();
+
 	return;
 }
 
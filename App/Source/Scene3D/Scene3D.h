@@ -20,6 +20,8 @@
 
 // Include CFPSCounter
 #include "TimeControl\FPSCounter.h"
+// Include CStopWatch
+#include "TimeControl\StopWatch.h"
 
 // Include CSoundController
 #include "..\SoundController\SoundController.h"
@@ -36,6 +38,18 @@
 // Include CSolidObjectManager
 #include "Entities/SolidObjectManager.h"
 
+// Include CLODManager
+#include "Primitives/LODManager.h"
+
+// Include CCameraUniformBuffer
+#include "RenderControl/CameraUniformBuffer.h"
+
+// Include COcclusionCuller
+#include "RenderControl/OcclusionCuller.h"
+
+// Include CAIScheduler
+#include "AI/AIScheduler.h"
+
 // Include CPlayer3D
 #include "Entities/Player3D.h"
 
@@ -61,6 +75,7 @@
 #include "WeaponInfo/Knife.h"
 
 class CSettings;
+class CTreeKabak3D;
 
 class CScene3D : public CSingletonTemplate<CScene3D>
 {
@@ -112,6 +127,15 @@ protected:
 	// Handler to the CSolidObjectManager class
 	CSolidObjectManager* cSolidObjectManager;
 
+	// Handler to the CLODManager class
+	CLODManager* cLODManager;
+
+	// Handler to the COcclusionCuller class
+	COcclusionCuller* cOcclusionCuller;
+
+	// Handler to the CAIScheduler class
+	CAIScheduler* cAIScheduler;
+
 	// Handler to the Player3D class
 	CPlayer3D* cPlayer3D;
 
@@ -121,6 +145,12 @@ protected:
 	// GUI_Scene3D
 	CGUI_Scene3D* cGUI_Scene3D;
 
+	// The trees, and the time taken by the frames with and without their impostors, for _BENCHMARK_TREES
+	CTreeKabak3D* cTreeKabak3D;
+	CStopWatch cBenchmarkStopWatch;
+	unsigned int uiBenchmarkFrame;
+	double arrBenchmarkTime[2];
+
 	// Constructor
 	CScene3D(void);
 	// Destructor
@@ -133,6 +163,9 @@ protected:
 	void SpawnAmmoBox(glm::vec3);
 
 	void SpawnEnemyWave(int waveCount);
+
+	// Time this frame for _BENCHMARK_TREES
+	void BenchmarkTrees(void);
 	float loadingWave = 0.f;
 	float loadingPlayerDied = 0.f;
 	float savedMouseScrollY;
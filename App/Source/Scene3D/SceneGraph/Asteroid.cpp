@@ -51,9 +51,9 @@ bool CAsteroid::Create(void)
 		cSceneNodeChild->SetShader("Shader3D");
 		cSceneNodeChild->Init();
 		cSceneNodeChild->bContinuousUpdate = true;
-		cSceneNodeChild->SetWorldTranslateMtx(glm::vec3(Math::RandFloatMinMax(-20, 20) * i, 0.f, Math::RandFloatMinMax(-20, 20) * i));
-		cSceneNodeChild->SetUpdateRotateMtx(glm::radians(0.25f * (i * Math::RandFloatMinMax(0.1, 0.25))), glm::vec3(0.0f, 0.0f, 1.0f));
-		cSceneNodeChild->SetLocalTranslateMtx(glm::vec3(Math::RandFloatMinMax(-10, 10) * i, 0, Math::RandFloatMinMax(-10, 10) * i));
+		cSceneNodeChild->SetWorldTranslateMtx(glm::vec3(Math::RandFloatMinMax(-20, 20, CRandomStreams::PLACEMENT) * i, 0.f, Math::RandFloatMinMax(-20, 20, CRandomStreams::PLACEMENT) * i));
+		cSceneNodeChild->SetUpdateRotateMtx(glm::radians(0.25f * (i * Math::RandFloatMinMax(0.1, 0.25, CRandomStreams::PLACEMENT))), glm::vec3(0.0f, 0.0f, 1.0f));
+		cSceneNodeChild->SetLocalTranslateMtx(glm::vec3(Math::RandFloatMinMax(-10, 10, CRandomStreams::PLACEMENT) * i, 0, Math::RandFloatMinMax(-10, 10, CRandomStreams::PLACEMENT) * i));
 		cSceneNode->AddChild(cSceneNodeChild);
 
 		for (int j = 1; j < 3; j++)
@@ -64,8 +64,8 @@ bool CAsteroid::Create(void)
 			cSceneNodeChild2->SetShader("Shader3D");
 			cSceneNodeChild2->Init();
 			cSceneNodeChild2->bContinuousUpdate = true;
-			cSceneNodeChild2->SetUpdateRotateMtx(glm::radians(0.25f * (j * i * Math::RandFloatMinMax(0.1, 0.3))), glm::vec3(1.0f, 0.0f, 0.0f));
-			cSceneNodeChild2->SetLocalTranslateMtx(glm::vec3(Math::RandFloatMinMax(-5, 5) * i * j, 0, Math::RandFloatMinMax(-10, 10) * i * j));
+			cSceneNodeChild2->SetUpdateRotateMtx(glm::radians(0.25f * (j * i * Math::RandFloatMinMax(0.1, 0.3, CRandomStreams::PLACEMENT))), glm::vec3(1.0f, 0.0f, 0.0f));
+			cSceneNodeChild2->SetLocalTranslateMtx(glm::vec3(Math::RandFloatMinMax(-5, 5, CRandomStreams::PLACEMENT) * i * j, 0, Math::RandFloatMinMax(-10, 10, CRandomStreams::PLACEMENT) * i * j));
 			cSceneNodeChild->AddChild(cSceneNodeChild2);
 		}
 
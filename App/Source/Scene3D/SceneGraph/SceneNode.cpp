@@ -20,6 +20,9 @@
 #include "System\ImageLoader.h"
 #include "System/LoadOBJ.h"
 
+// Include StopWatch
+#include "TimeControl/StopWatch.h"
+
 #include <iostream>
 using namespace std;
 
@@ -41,6 +44,14 @@ CSceneNode::CSceneNode(void)
 	, updateRotateMtx(glm::mat4(1.0f))
 	, updateScaleMtx(glm::mat4(1.0f))
 	, bContinuousUpdate(false)
+	, iIndicesSize(0)
+	, worldOffsetMtx(glm::mat4(1.0f))
+	, bLocalDirty(true)
+	, bWorldDirty(true)
+	, bDescendantDirty(true)
+	, bHierarchyDirty(true)
+	, bForceUpdate(true)
+	, uiNumUpdated(0)
 {
 }
 
@@ -63,6 +74,14 @@ CSceneNode::CSceneNode(const int snID)
 	, updateRotateMtx(glm::mat4(1.0f))
 	, updateScaleMtx(glm::mat4(1.0f))
 	, bContinuousUpdate(false)
+	, iIndicesSize(0)
+	, worldOffsetMtx(glm::mat4(1.0f))
+	, bLocalDirty(true)
+	, bWorldDirty(true)
+	, bDescendantDirty(true)
+	, bHierarchyDirty(true)
+	, bForceUpdate(true)
+	, uiNumUpdated(0)
 {
 	this->snID = snID;
 }
@@ -142,11 +161,110 @@ void CSceneNode::SetProjection(const glm::mat4 projection)
 }
 
 /**
- @brief Update this class instance
+ @brief Update this class instance. The root updates the whole hierarchy, so this does nothing in a child.
  @param dElapsedTime A const double variable contains the time since the last frame
  @return A bool variable
  */
 bool CSceneNode::Update(const double dElapsedTime)
+{
+	// The matrices of a child are computed by the root of its hierarchy
+	if (cParentNode != NULL)
+		return true;
+
+	// Rebuild the flattened hierarchy if nodes were added or removed
+	if (bHierarchyDirty == true)
+	{
+		Flatten();
+		bHierarchyDirty = false;
+		bForceUpdate = true;
+	}
+
+	UpdateFlat();
+
+	return true;
+}
+
+/**
+ @brief Compute the matrices of the nodes in vFlatNodes which changed.
+		A subtree is skipped if its parent did not change, it has no continuous updates and no dirty flags.
+ */
+void CSceneNode::UpdateFlat(void)
+{
+	uiNumUpdated = 0;
+
+	unsigned int i = 0;
+	while (i < vFlatNodes.size())
+	{
+		const FlatNode& cFlatNode = vFlatNodes[i];
+		CSceneNode* cNode = cFlatNode.cNode;
+		const bool bParentChanged = (cFlatNode.iParent >= 0) && (vChanged[cFlatNode.iParent] != 0);
+
+		// Skip the static subtrees which have not changed since the last Update
+		if ((bForceUpdate == false) && (bParentChanged == false) && (cFlatNode.bStaticSubtree == true) &&
+			(cNode->bLocalDirty == false) && (cNode->bWorldDirty == false) && (cNode->bDescendantDirty == false))
+		{
+			for (unsigned int j = i; j < cFlatNode.uiSubtreeEnd; j++)
+				vChanged[j] = 0;
+			i = cFlatNode.uiSubtreeEnd;
+			continue;
+		}
+
+		bool bChanged = (bForceUpdate == true) || (bParentChanged == true);
+
+		// Apply the update transformations to the local transformation
+		if (cNode->bContinuousUpdate == true)
+		{
+			cNode->localTranslateMtx = cNode->updateTranslateMtx * cNode->localTranslateMtx;
+			cNode->localRotateMtx = cNode->updateRotateMtx * cNode->localRotateMtx;
+			cNode->localScaleMtx = cNode->updateScaleMtx * cNode->localScaleMtx;
+			cNode->bLocalDirty = true;
+		}
+		if (cNode->bLocalDirty == true)
+		{
+			cNode->localTransformMtx =	cNode->localRotateMtx *
+										cNode->localScaleMtx *
+										cNode->localTranslateMtx;
+			// The local transformation is only used if the updates are continuous
+			if (cNode->bContinuousUpdate == true)
+				bChanged = true;
+		}
+		if (cNode->bWorldDirty == true)
+		{
+			cNode->worldOffsetMtx =	cNode->worldRotateMtx *
+									cNode->worldScaleMtx *
+									cNode->worldTranslateMtx;
+			bChanged = true;
+		}
+
+		if (bChanged == true)
+		{
+			if (cFlatNode.iParent < 0)
+				cNode->worldTransformMtx = cNode->worldOffsetMtx;
+			else
+				cNode->worldTransformMtx = cNode->worldOffsetMtx * vFlatNodes[cFlatNode.iParent].cNode->model;
+
+			if (cNode->bContinuousUpdate == true)
+				cNode->model = cNode->worldTransformMtx * cNode->localTransformMtx;
+			else
+				cNode->model = cNode->worldTransformMtx;
+			uiNumUpdated++;
+		}
+
+		cNode->bLocalDirty = false;
+		cNode->bWorldDirty = false;
+		cNode->bDescendantDirty = false;
+		vChanged[i] = bChanged ? 1 : 0;
+		i++;
+	}
+
+	bForceUpdate = false;
+}
+
+/**
+ @brief Compute the matrices of this node and its children recursively, without the dirty flags.
+		This is how every node was updated before the hierarchy was flattened, and is kept for Benchmark().
+ */
+void CSceneNode::UpdateRecursive(void)
 {
 	// create transformations
 	model = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
@@ -154,7 +272,6 @@ bool CSceneNode::Update(const double dElapsedTime)
 	// Use local transform
 	if (bContinuousUpdate == true)
 	{
-		localTransformMtx = glm::mat4(1.0f);
 		localTranslateMtx = updateTranslateMtx * localTranslateMtx;
 		localRotateMtx = updateRotateMtx * localRotateMtx;
 		localScaleMtx = updateScaleMtx * localScaleMtx;
@@ -168,36 +285,102 @@ bool CSceneNode::Update(const double dElapsedTime)
 		model = localTransformMtx * model;
 	}
 
-	if (cParentNode == NULL)
+	// Calculate the world transform
+	worldTransformMtx =	worldRotateMtx *
+						worldScaleMtx *
+						worldTranslateMtx;
+	if (cParentNode != NULL)
+		worldTransformMtx = worldTransformMtx * cParentNode->model;
+	// Calculate the model matrix
+	model = worldTransformMtx * model;
+
+	// Update the children
+	std::vector<CSceneNode*>::iterator it;
+	for (it = vChildNodes.begin(); it != vChildNodes.end(); ++it)
 	{
-		// Calculate the world transform
-		worldTransformMtx = glm::mat4(1.0f);
-		// Update the worldTransformMtx
-		worldTransformMtx =	worldRotateMtx *
-							worldScaleMtx *
-							worldTranslateMtx;
-		// Calculate the model matrix
-		model = worldTransformMtx * model;
+		(*it)->UpdateRecursive();
 	}
-	else
+}
+
+/**
+ @brief Rebuild vFlatNodes from the children of this root
+ */
+void CSceneNode::Flatten(void)
+{
+	vFlatNodes.clear();
+	FlattenNode(this, -1);
+	vChanged.assign(vFlatNodes.size(), 0);
+}
+
+/**
+ @brief Add a node and its subtree to vFlatNodes, with every parent before its children
+ @param cNode A CSceneNode* variable which is the node to add
+ @param iParent A const int variable which is the index of the parent in vFlatNodes, or -1 for the root
+ @return true if no node in the subtree has bContinuousUpdate set
+ */
+bool CSceneNode::FlattenNode(CSceneNode* cNode, const int iParent)
+{
+	const unsigned int uiIndex = vFlatNodes.size();
+	FlatNode cFlatNode;
+	cFlatNode.cNode = cNode;
+	cFlatNode.iParent = iParent;
+	cFlatNode.uiSubtreeEnd = uiIndex + 1;
+	cFlatNode.bStaticSubtree = !cNode->bContinuousUpdate;
+	vFlatNodes.push_back(cFlatNode);
+
+	// A child no longer keeps its own flattened hierarchy
+	if (cNode != this)
 	{
-		// Calculate the world transform
-		worldTransformMtx = cParentNode->model;
-		worldTransformMtx =	worldRotateMtx *
-							worldScaleMtx *
-							worldTranslateMtx * worldTransformMtx;
-		// Calculate the model matrix
-		model = worldTransformMtx * model;
+		cNode->vFlatNodes.clear();
+		cNode->vChanged.clear();
 	}
 
-	// Update the children
+	bool bStaticSubtree = !cNode->bContinuousUpdate;
 	std::vector<CSceneNode*>::iterator it;
-	for (it = vChildNodes.begin(); it != vChildNodes.end(); ++it)
+	for (it = cNode->vChildNodes.begin(); it != cNode->vChildNodes.end(); ++it)
 	{
-		(*it)->Update(dElapsedTime);
+		if (FlattenNode(*it, uiIndex) == false)
+			bStaticSubtree = false;
 	}
 
-	return true;
+	// vFlatNodes may have been reallocated by the children
+	vFlatNodes[uiIndex].uiSubtreeEnd = vFlatNodes.size();
+	vFlatNodes[uiIndex].bStaticSubtree = bStaticSubtree;
+	return bStaticSubtree;
+}
+
+/**
+ @brief Get the root of the hierarchy of this node
+ @return A CSceneNode* variable
+ */
+CSceneNode* CSceneNode::GetRoot(void)
+{
+	CSceneNode* cNode = this;
+	while (cNode->cParentNode != NULL)
+		cNode = cNode->cParentNode;
+	return cNode;
+}
+
+/**
+ @brief Tell the ancestors of this node that it has a dirty flag
+ */
+void CSceneNode::MarkAncestorsDirty(void)
+{
+	CSceneNode* cNode = cParentNode;
+	// Stop at the first ancestor which already knows
+	while ((cNode != NULL) && (cNode->bDescendantDirty == false))
+	{
+		cNode->bDescendantDirty = true;
+		cNode = cNode->cParentNode;
+	}
+}
+
+/**
+ @brief Tell the root of this node that vFlatNodes must be rebuilt
+ */
+void CSceneNode::MarkHierarchyDirty(void)
+{
+	GetRoot()->bHierarchyDirty = true;
 }
 
 /**
@@ -217,10 +400,35 @@ void CSceneNode::PreRender(void)
  */
 void CSceneNode::Render(void)
 {
-	// note: currently we set the projection matrix each frame, but since the projection 
-	// matrix rarely changes it's often best practice to set it outside the main loop only once.
-	CShaderManager::GetInstance()->activeShader->setMat4("projection", projection);
-	CShaderManager::GetInstance()->activeShader->setMat4("view", view);
+	RenderMesh();
+
+	// The root renders the flattened hierarchy, which is in the same order as the recursion below
+	if ((cParentNode == NULL) && (bHierarchyDirty == false) && (vFlatNodes.size() > 0))
+	{
+		for (unsigned int i = 1; i < vFlatNodes.size(); i++)
+		{
+			vFlatNodes[i].cNode->PreRender();
+			vFlatNodes[i].cNode->RenderMesh();
+			vFlatNodes[i].cNode->PostRender();
+		}
+		return;
+	}
+
+	// Render the children
+	std::vector<CSceneNode*>::iterator it;
+	for (it = vChildNodes.begin(); it != vChildNodes.end(); ++it)
+	{
+		(*it)->PreRender();
+		(*it)->Render();
+		(*it)->PostRender();
+	}
+}
+
+/**
+ @brief Draw the mesh of this node with the active shader
+ */
+void CSceneNode::RenderMesh(void)
+{
 	CShaderManager::GetInstance()->activeShader->setMat4("model", model);
 
 	// bind textures on corresponding texture units
@@ -231,17 +439,6 @@ void CSceneNode::Render(void)
 	glDrawElements(GL_TRIANGLES, iIndicesSize, GL_UNSIGNED_INT, 0);
 	glBindVertexArray(0);
 	glBindTexture(GL_TEXTURE_2D, 0);
-
-	// Update the children
-	std::vector<CSceneNode*>::iterator it;
-	for (it = vChildNodes.begin(); it != vChildNodes.end(); ++it)
-	{
-		(*it)->SetView(view);
-		(*it)->SetProjection(projection);
-		(*it)->PreRender();
-		(*it)->Render();
-		(*it)->PostRender();
-	}
 }
 
 /**
@@ -269,6 +466,10 @@ bool CSceneNode::AddChild(CSceneNode* s)
 	s->cParentNode = this;
 	// Add to vector list
 	this->vChildNodes.push_back(s);
+	// The child is now updated by the root of this node
+	s->vFlatNodes.clear();
+	s->vChanged.clear();
+	MarkHierarchyDirty();
 
 	return true;
 }
@@ -298,6 +499,7 @@ bool CSceneNode::DeleteChild(CSceneNode* s)
 			delete *it;
 			// Then we should proceed to removed this child from our vector of children
 			vChildNodes.erase(it);
+			MarkHierarchyDirty();
 			// Return true and Stop deleting since we have already found it
 			return true;
 		}
@@ -334,6 +536,7 @@ bool CSceneNode::DeleteChild(const int snID)
 			delete *it;
 			// Then we should proceed to removed this child from our vector of children
 			vChildNodes.erase(it);
+			MarkHierarchyDirty();
 			// Return true and Stop deleting since we have already found it
 			return true;
 		}
@@ -371,6 +574,8 @@ bool CSceneNode::DeleteAllChildren(void)
 		it = vChildNodes.erase(it);
 		bResult = true;
 	}
+	if (bResult == true)
+		MarkHierarchyDirty();
 	return bResult;
 }
 
@@ -392,6 +597,9 @@ CSceneNode* CSceneNode::DetachChild(const int snID)
 			s->cParentNode = NULL;
 			// Remove this node from the children
 			vChildNodes.erase(it);
+			MarkHierarchyDirty();
+			// The detached node is now the root of its own hierarchy
+			s->bHierarchyDirty = true;
 
 			return s;
 		}
@@ -461,6 +669,8 @@ int CSceneNode::GetNumOfChild(void)
 void CSceneNode::SetWorldTranslateMtx(const glm::vec3 vec3Translate)
 {
 	worldTranslateMtx = glm::translate(worldTranslateMtx, vec3Translate);
+	bWorldDirty = true;
+	MarkAncestorsDirty();
 }
 
 /**
@@ -471,6 +681,8 @@ void CSceneNode::SetWorldTranslateMtx(const glm::vec3 vec3Translate)
 void CSceneNode::SetWorldRotateMtx(const float fAngle, const glm::vec3 vec3RotateAxis)
 {
 	worldRotateMtx = glm::rotate(worldRotateMtx, fAngle, vec3RotateAxis);
+	bWorldDirty = true;
+	MarkAncestorsDirty();
 }
 
 /**
@@ -480,6 +692,8 @@ void CSceneNode::SetWorldRotateMtx(const float fAngle, const glm::vec3 vec3Rotat
 void CSceneNode::SetWorldScaleMtx(const glm::vec3 vec3Scale)
 {
 	worldScaleMtx = glm::scale(worldScaleMtx, vec3Scale);
+	bWorldDirty = true;
+	MarkAncestorsDirty();
 }
 
 /**
@@ -489,6 +703,8 @@ void CSceneNode::SetWorldScaleMtx(const glm::vec3 vec3Scale)
 void CSceneNode::SetLocalTranslateMtx(const glm::vec3 vec3Translate)
 {
 	localTranslateMtx = glm::translate(localTranslateMtx, vec3Translate);
+	bLocalDirty = true;
+	MarkAncestorsDirty();
 }
 
 /**
@@ -499,6 +715,8 @@ void CSceneNode::SetLocalTranslateMtx(const glm::vec3 vec3Translate)
 void CSceneNode::SetLocalRotateMtx(const float fAngle, const glm::vec3 vec3RotateAxis)
 {
 	localRotateMtx = glm::rotate(localRotateMtx, fAngle, vec3RotateAxis);
+	bLocalDirty = true;
+	MarkAncestorsDirty();
 }
 
 /**
@@ -508,6 +726,8 @@ void CSceneNode::SetLocalRotateMtx(const float fAngle, const glm::vec3 vec3Rotat
 void CSceneNode::SetLocalScaleMtx(const glm::vec3 vec3Scale)
 {
 	localScaleMtx = glm::scale(localScaleMtx, vec3Scale);
+	bLocalDirty = true;
+	MarkAncestorsDirty();
 }
 
 /**
@@ -539,6 +759,28 @@ void CSceneNode::SetUpdateScaleMtx(const glm::vec3 vec3Scale)
 	updateScaleMtx = glm::scale(updateScaleMtx, newVec3Scale);
 }
 
+/**
+ @brief Set if the update transformations are applied to the local transformation in every update
+ @param bContinuousUpdate A const bool variable which is true if the updates are continuous
+ */
+void CSceneNode::SetContinuousUpdate(const bool bContinuousUpdate)
+{
+	this->bContinuousUpdate = bContinuousUpdate;
+	bLocalDirty = true;
+	MarkAncestorsDirty();
+	// The static subtrees in the flattened hierarchy must be found again
+	MarkHierarchyDirty();
+}
+
+/**
+ @brief Get the number of nodes whose matrices were recomputed in the last Update of this root
+ @return An unsigned int variable
+ */
+unsigned int CSceneNode::GetNumUpdated(void) const
+{
+	return uiNumUpdated;
+}
+
 /**
  @brief Print Self
  */
@@ -571,6 +813,133 @@ void CSceneNode::PrintSelf(const int numTabs)
 	cout << std::string(numTabs, '\t') << "================================" << endl;
 }
 
+/**
+ @brief Create a node for Benchmark()
+ @param bContinuousUpdate A const bool variable which is true if the node is rotated in every update
+ @return A CSceneNode* variable
+ */
+static CSceneNode* CreateBenchmarkNode(const bool bContinuousUpdate)
+{
+	CSceneNode* cSceneNode = new CSceneNode(0);
+	cSceneNode->SetWorldTranslateMtx(glm::vec3(1.0f, 0.5f, 1.0f));
+	cSceneNode->SetLocalTranslateMtx(glm::vec3(0.5f, 0.0f, 0.5f));
+	cSceneNode->SetContinuousUpdate(bContinuousUpdate);
+	cSceneNode->SetUpdateRotateMtx(glm::radians(0.1f), glm::vec3(0.0f, 1.0f, 0.0f));
+	return cSceneNode;
+}
+
+/**
+ @brief Delete a hierarchy created for Benchmark(), without printing every node
+ @param cRoot A CSceneNode* variable which is the root of the hierarchy
+ */
+static void DeleteBenchmarkHierarchy(CSceneNode* cRoot)
+{
+	vector<CSceneNode*> vNodes;
+	vNodes.push_back(cRoot);
+	for (unsigned int i = 0; i < vNodes.size(); i++)
+	{
+		vNodes.insert(vNodes.end(), vNodes[i]->vChildNodes.begin(), vNodes[i]->vChildNodes.end());
+		vNodes[i]->vChildNodes.clear();
+	}
+	for (unsigned int i = 0; i < vNodes.size(); i++)
+		delete vNodes[i];
+}
+
+/**
+ @brief Compare the recursive update of every node against the flattened update with dirty flags,
+		on deep and wide synthetic hierarchies, and on copies of COrbitPlanet, CJupiterPlanet and CAsteroid.
+		The nodes have no meshes, so this only measures the matrix computations.
+ @param uiNumNodes A const unsigned int variable which is the number of nodes in the synthetic hierarchies
+ */
+void CSceneNode::Benchmark(const unsigned int uiNumNodes)
+{
+	const int iNumPasses = 100;
+
+	vector<std::string> vNames;
+	vector<CSceneNode*> vRoots;
+
+	// A chain, in which every node is the child of the previous node
+	for (int iContinuous = 0; iContinuous < 2; iContinuous++)
+	{
+		CSceneNode* cRoot = CreateBenchmarkNode(iContinuous == 1);
+		CSceneNode* cNode = cRoot;
+		for (unsigned int i = 1; i < uiNumNodes; i++)
+		{
+			CSceneNode* cChild = CreateBenchmarkNode(iContinuous == 1);
+			cNode->AddChild(cChild);
+			cNode = cChild;
+		}
+		vNames.push_back(iContinuous == 1 ? "Deep, continuous" : "Deep, static");
+		vRoots.push_back(cRoot);
+	}
+
+	// A fan, in which every node is a child of the root. Only every tenth node moves in the second one.
+	for (int iContinuous = 0; iContinuous < 2; iContinuous++)
+	{
+		CSceneNode* cRoot = CreateBenchmarkNode(false);
+		for (unsigned int i = 1; i < uiNumNodes; i++)
+			cRoot->AddChild(CreateBenchmarkNode((iContinuous == 1) && (i % 10 == 0)));
+		vNames.push_back(iContinuous == 1 ? "Wide, 10% continuous" : "Wide, static");
+		vRoots.push_back(cRoot);
+	}
+
+	// COrbitPlanet and CJupiterPlanet: a root with 2 children
+	for (int iPlanet = 0; iPlanet < 2; iPlanet++)
+	{
+		CSceneNode* cRoot = CreateBenchmarkNode(true);
+		cRoot->AddChild(CreateBenchmarkNode(true));
+		cRoot->AddChild(CreateBenchmarkNode(true));
+		vNames.push_back(iPlanet == 0 ? "COrbitPlanet" : "CJupiterPlanet");
+		vRoots.push_back(cRoot);
+	}
+
+	// CAsteroid: a root with 5 children, which have 2 children each
+	{
+		CSceneNode* cRoot = CreateBenchmarkNode(true);
+		for (int i = 0; i < 5; i++)
+		{
+			CSceneNode* cChild = CreateBenchmarkNode(true);
+			cChild->AddChild(CreateBenchmarkNode(true));
+			cChild->AddChild(CreateBenchmarkNode(true));
+			cRoot->AddChild(cChild);
+		}
+		vNames.push_back("CAsteroid");
+		vRoots.push_back(cRoot);
+	}
+
+	cout << "CSceneNode::Benchmark() with " << uiNumNodes << " nodes, " << iNumPasses << " passes" << endl;
+
+	CStopWatch cStopWatch;
+	for (unsigned int i = 0; i < vRoots.size(); i++)
+	{
+		CSceneNode* cRoot = vRoots[i];
+
+		// Before: recompute every node recursively
+		cStopWatch.StartTimer();
+		for (int iPass = 0; iPass < iNumPasses; iPass++)
+			cRoot->UpdateRecursive();
+		double dRecursiveTime = cStopWatch.GetElapsedTime();
+
+		// After: the flattened hierarchy, which is built in the first Update
+		cRoot->Update(0.0);
+		cStopWatch.GetElapsedTime();
+		unsigned int uiTotalUpdated = 0;
+		for (int iPass = 0; iPass < iNumPasses; iPass++)
+		{
+			cRoot->Update(0.0);
+			uiTotalUpdated += cRoot->GetNumUpdated();
+		}
+		double dFlatTime = cStopWatch.GetElapsedTime();
+
+		cout << vNames[i] << " (" << cRoot->vFlatNodes.size() << " nodes)" << endl;
+		cout << "\tRecursive : " << dRecursiveTime * 1000.0 / iNumPasses << " ms per pass" << endl;
+		cout << "\tFlattened : " << dFlatTime * 1000.0 / iNumPasses << " ms per pass, "
+			<< uiTotalUpdated / iNumPasses << " nodes recomputed per pass" << endl;
+
+		DeleteBenchmarkHierarchy(cRoot);
+	}
+}
+
 bool CSceneNode::LoadOrbit()
 {
 	std::vector<glm::vec3> vertices;
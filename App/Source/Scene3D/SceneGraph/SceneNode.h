@@ -16,6 +16,9 @@
 #include <vector>
 using namespace std;
 
+// A node in a scene graph. The transforms are tracked with dirty flags, and the root of each
+// hierarchy keeps its nodes in a flat array with every parent before its children, so that
+// Update computes the world matrices in one linear pass and skips the static subtrees.
 class CSceneNode : public CEntity3D
 {
 public:
@@ -45,7 +48,7 @@ public:
 	// Set projection
 	virtual void SetProjection(const glm::mat4 projection);
 
-	// Update this class instance
+	// Update this class instance. The root updates the whole hierarchy.
 	virtual bool Update(const double dElapsedTime);
 
 	// PreRender
@@ -95,9 +98,18 @@ public:
 	// Set the update transformation for scale for every update
 	void SetUpdateScaleMtx(const glm::vec3 vec3Scale);
 
+	// Set if the update transformations are applied to the local transformation in every update
+	void SetContinuousUpdate(const bool bContinuousUpdate);
+
+	// Get the number of nodes whose matrices were recomputed in the last Update of this root
+	unsigned int GetNumUpdated(void) const;
+
 	// PrintSelf for debug purposes
 	virtual void PrintSelf(const int numTabs = 0);
 
+	// Compare the recursive update of every node against the flattened update with dirty flags
+	static void Benchmark(const unsigned int uiNumNodes = 1000);
+
 	// The snID of this CSceneNode. Easier for identifying the node.
 	int	snID;
 
@@ -107,7 +119,8 @@ public:
 	// The vector containing the child nodes
 	vector<CSceneNode*> vChildNodes;
 
-	// Boolean flag to indicate if the updates to the localTransformMtx is continuous
+	// Boolean flag to indicate if the updates to the localTransformMtx is continuous.
+	// Use SetContinuousUpdate to change it after the first Update of the hierarchy.
 	bool bContinuousUpdate;
 
 	NODE_TYPE nodeType;
@@ -149,4 +162,52 @@ protected:
 	glm::mat4	updateScaleMtx;
 
 	int iIndicesSize;
+
+	// The product of the world rotate, scale and translate matrices, cached until one of them changes
+	glm::mat4 worldOffsetMtx;
+
+	// Dirty flags. bDescendantDirty is set if a node below this one has a dirty flag.
+	bool bLocalDirty;
+	bool bWorldDirty;
+	bool bDescendantDirty;
+
+	// A node in the flattened hierarchy
+	struct FlatNode
+	{
+		CSceneNode* cNode;
+		// The index of the parent, or -1 for the root
+		int iParent;
+		// The index after the last node in the subtree of this node
+		unsigned int uiSubtreeEnd;
+		// true if no node in the subtree has bContinuousUpdate set
+		bool bStaticSubtree;
+	};
+
+	// The flattened hierarchy, in which every parent is before its children. Only used in the root.
+	vector<FlatNode> vFlatNodes;
+	// Whether the model matrix of each node in vFlatNodes changed in the current Update
+	vector<unsigned char> vChanged;
+	// true if nodes were added or removed since vFlatNodes was built
+	bool bHierarchyDirty;
+	// true if every node must be recomputed in the next Update
+	bool bForceUpdate;
+	// The number of nodes whose matrices were recomputed in the last Update
+	unsigned int uiNumUpdated;
+
+	// Get the root of the hierarchy of this node
+	CSceneNode* GetRoot(void);
+	// Tell the ancestors of this node that it has a dirty flag
+	void MarkAncestorsDirty(void);
+	// Tell the root of this node that vFlatNodes must be rebuilt
+	void MarkHierarchyDirty(void);
+	// Rebuild vFlatNodes from the children of this root
+	void Flatten(void);
+	// Add a node and its subtree to vFlatNodes, and return true if the subtree is static
+	bool FlattenNode(CSceneNode* cNode, const int iParent);
+	// Compute the matrices of the nodes in vFlatNodes which changed
+	void UpdateFlat(void);
+	// Compute the matrices of this node and its children recursively, without the dirty flags
+	void UpdateRecursive(void);
+	// Draw the mesh of this node with the active shader
+	void RenderMesh(void);
 };
@@ -173,9 +173,6 @@ void CSkyBox::PreRender(void)
  */
 void CSkyBox::Render(void)
 {
-	CShaderManager::GetInstance()->activeShader->setMat4("view", view);
-	CShaderManager::GetInstance()->activeShader->setMat4("projection", projection);
-
 	// Render skybox cube
 	glBindVertexArray(VAO);
 		glBindTexture(GL_TEXTURE_CUBE_MAP, iTextureID);
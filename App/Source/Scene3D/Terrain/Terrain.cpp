@@ -1,6 +1,8 @@
 #include "Terrain.h"
 
 #include <vector>
+#include <algorithm>
+#include <cfloat>
 
 using namespace std;
 
@@ -16,6 +18,8 @@ using namespace std;
 #include "RenderControl/ShaderManager.h"
 // Include CTexture
 #include "Texture.h"
+// Include CFrameArena
+#include "System/FrameArena.h"
 
 /**
  @brief Constructor
@@ -108,9 +112,6 @@ void CTerrain::PreRender(void)
  */
 void CTerrain::Render(void)
 {
-	CShaderManager::GetInstance()->activeShader->setMat4("matrices.projMatrix", projection);
-	CShaderManager::GetInstance()->activeShader->setMat4("matrices.viewMatrix", view);
-
 	// We bind all 5 textures - 3 of them are textures for layers, 1 texture is a "path" texture, and last one is
 	// the places in heightmap where path should be and how intense should it be
 	for (int i = 0; i < 5; i++)
@@ -225,10 +226,16 @@ bool CTerrain::LoadHeightMapFromImage(const string sImagePath)
 		}
 	}
 
-	// Normals are here - the heightmap contains ( (iRows-1)*(iCols-1) quads, each one containing 2 triangles, therefore array of we have 3D array)
-	vector< vector<glm::vec3> > vNormals[2];
+	// The temporary normals are allocated from the CFrameArena, and freed when this function returns
+	CFrameArenaScope cFrameArenaScope;
+	typedef vector<glm::vec3, CFrameAllocator<glm::vec3> > TempNormalVector;
+
+	// Normals are here - the heightmap contains ( (iRows-1)*(iCols-1) quads, each one containing 2 triangles,
+	// so there are 2 arrays of (iRows-1)*(iCols-1) normals, indexed by i*(iCols-1)+j)
+	const int iQuadCols = iCols - 1;
+	TempNormalVector vNormals[2];
 	for (int i = 0; i < 2; i++)
-		vNormals[i] = vector< vector<glm::vec3> >(iRows - 1, vector<glm::vec3>(iCols - 1));
+		vNormals[i].resize((iRows - 1) * iQuadCols);
 
 	for (int i = 0; i < iRows - 1; i++)
 	{
@@ -250,12 +257,12 @@ bool CTerrain::LoadHeightMapFromImage(const string sImagePath)
 			glm::vec3 vTriangleNorm0 = glm::cross(vTriangle0[0] - vTriangle0[1], vTriangle0[1] - vTriangle0[2]);
 			glm::vec3 vTriangleNorm1 = glm::cross(vTriangle1[0] - vTriangle1[1], vTriangle1[1] - vTriangle1[2]);
 
-			vNormals[0][i][j] = glm::normalize(vTriangleNorm0);
-			vNormals[1][i][j] = glm::normalize(vTriangleNorm1);
+			vNormals[0][i * iQuadCols + j] = glm::normalize(vTriangleNorm0);
+			vNormals[1][i * iQuadCols + j] = glm::normalize(vTriangleNorm1);
 		}
 	}
 
-	vector< vector<glm::vec3> > vFinalNormals = vector< vector<glm::vec3> >(iRows, vector<glm::vec3>(iCols));
+	TempNormalVector vFinalNormals(iRows * iCols);
 
 	for (int i = 0; i < iRows; i++)
 		for (int j = 0; j < iCols; j++)
@@ -267,20 +274,20 @@ bool CTerrain::LoadHeightMapFromImage(const string sImagePath)
 			// Look for upper-left triangles
 			if (j != 0 && i != 0)
 				for (int k = 0; k < 2; k++)
-					vFinalNormal += vNormals[k][i - 1][j - 1];
+					vFinalNormal += vNormals[k][(i - 1) * iQuadCols + (j - 1)];
 			// Look for upper-right triangles
 			if (i != 0 && j != iCols - 1)
-				vFinalNormal += vNormals[0][i - 1][j];
+				vFinalNormal += vNormals[0][(i - 1) * iQuadCols + j];
 			// Look for bottom-right triangles
 			if (i != iRows - 1 && j != iCols - 1)
 				for (int k = 0; k < 2; k++)
-					vFinalNormal += vNormals[k][i][j];
+					vFinalNormal += vNormals[k][i * iQuadCols + j];
 			// Look for bottom-left triangles
 			if (i != iRows - 1 && j != 0)
-				vFinalNormal += vNormals[1][i][j - 1];
+				vFinalNormal += vNormals[1][i * iQuadCols + (j - 1)];
 			vFinalNormal = glm::normalize(vFinalNormal);
 
-			vFinalNormals[i][j] = vFinalNormal; // Store final normal of j-th vertex in i-th row
+			vFinalNormals[i * iCols + j] = vFinalNormal; // Store final normal of j-th vertex in i-th row
 		}
 
 	// First, create a VBO with only vertex data
@@ -292,7 +299,7 @@ bool CTerrain::LoadHeightMapFromImage(const string sImagePath)
 		{
 			vboHeightmapData.AddData(&vVertexData[i][j], sizeof(glm::vec3)); // Add vertex
 			vboHeightmapData.AddData(&vCoordsData[i][j], sizeof(glm::vec2)); // Add tex. coord
-			vboHeightmapData.AddData(&vFinalNormals[i][j], sizeof(glm::vec3)); // Add normal
+			vboHeightmapData.AddData(&vFinalNormals[i * iCols + j], sizeof(glm::vec3)); // Add normal
 			counter++;
 		}
 	}
@@ -467,6 +474,65 @@ glm::vec3 CTerrain::GetMaxPos(void) const
 	return vMaxPos;
 }
 
+/**
+ @brief Generate a coarse grid of triangles which stays under this terrain, for the occlusion culling.
+		Each vertex takes the lowest height sampled in the cells around it, so the grid does not
+		poke out of the terrain between its vertices and hide the entities on the slopes.
+ @param vVertices A vector<glm::vec3>& variable which is filled with the vertices in world space
+ @param vIndices A vector<unsigned int>& variable which is filled with 3 indices per triangle
+ @param iResolution A const int variable containing the number of cells along each side of the grid
+ */
+void CTerrain::GenerateOccluder(vector<glm::vec3>& vVertices, vector<unsigned int>& vIndices, const int iResolution)
+{
+	vVertices.clear();
+	vIndices.clear();
+	if (iResolution <= 0)
+		return;
+
+	const float fStepX = (vMaxPos.x - vMinPos.x) / iResolution;
+	const float fStepZ = (vMaxPos.z - vMinPos.z) / iResolution;
+	// GetHeight returns 0 at vMaxPos, so the samples are kept just inside it
+	const float fMaxX = vMaxPos.x - fStepX * 0.01f;
+	const float fMaxZ = vMaxPos.z - fStepZ * 0.01f;
+	// Lower the grid a little more, so that it is never in front of the terrain
+	const float fBias = 0.1f;
+
+	for (int iRow = 0; iRow <= iResolution; iRow++)
+	{
+		for (int iCol = 0; iCol <= iResolution; iCol++)
+		{
+			const float fX = vMinPos.x + iCol * fStepX;
+			const float fZ = vMinPos.z + iRow * fStepZ;
+
+			float fHeight = FLT_MAX;
+			for (int j = -4; j <= 4; j++)
+			{
+				for (int i = -4; i <= 4; i++)
+				{
+					const float fSampleX = glm::clamp(fX + i * fStepX * 0.25f, vMinPos.x, fMaxX);
+					const float fSampleZ = glm::clamp(fZ + j * fStepZ * 0.25f, vMinPos.z, fMaxZ);
+					fHeight = std::min(fHeight, GetHeight(fSampleX, fSampleZ));
+				}
+			}
+			vVertices.push_back(glm::vec3(fX, fHeight - fBias, fZ));
+		}
+	}
+
+	for (int iRow = 0; iRow < iResolution; iRow++)
+	{
+		for (int iCol = 0; iCol < iResolution; iCol++)
+		{
+			const unsigned int uiCorner = iRow * (iResolution + 1) + iCol;
+			vIndices.push_back(uiCorner);
+			vIndices.push_back(uiCorner + iResolution + 1);
+			vIndices.push_back(uiCorner + 1);
+			vIndices.push_back(uiCorner + 1);
+			vIndices.push_back(uiCorner + iResolution + 1);
+			vIndices.push_back(uiCorner + iResolution + 2);
+		}
+	}
+}
+
 /**
  @brief Print Self
  */
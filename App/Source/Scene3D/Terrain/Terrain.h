@@ -64,6 +64,11 @@ public:
 	// Get the vMaxPos
 	glm::vec3 GetMaxPos(void) const;
 
+	// The group of the terrain occluder in the COcclusionCuller
+	static const int OCCLUDER_GROUP = 1;
+	// Generate a coarse grid of triangles which stays under this terrain, for the occlusion culling
+	void GenerateOccluder(vector<glm::vec3>& vVertices, vector<unsigned int>& vIndices, const int iResolution);
+
 	// Print Self
 	void PrintSelf(void);
 
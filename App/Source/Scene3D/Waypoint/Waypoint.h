@@ -5,6 +5,9 @@
  */
 #pragma once
 
+// Include CObjectPool
+#include "System/ObjectPool.h"
+
 // Include GLM
 #include <includes/glm.hpp>
 #include <includes/gtc/matrix_transform.hpp>
@@ -21,6 +24,13 @@ public:
 	// Destructor
 	virtual ~CWaypoint();
 
+	// Allocate the instances of this class from a CObjectPool, so that creating one reuses the memory of a deleted one
+	static void* operator new(size_t uiSize);
+	// Return the memory of an instance to the CObjectPool
+	static void operator delete(void* p, size_t uiSize);
+	// Get the CObjectPool of this class
+	static CObjectPool<CWaypoint>& GetPool(void);
+
 	// Init this class instance
 	bool Init(void);
 	// Destroy this class instance
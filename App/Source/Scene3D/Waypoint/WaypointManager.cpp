@@ -27,6 +27,36 @@ CWaypointManager::~CWaypointManager(void)
 	Destroy();
 }
 
+/**
+ @brief Allocate an instance of this class from its CObjectPool
+ @param uiSize A size_t variable containing the size of the instance
+ @return A void* variable
+ */
+void* CWaypointManager::operator new(size_t uiSize)
+{
+	return GetPool().Allocate(uiSize);
+}
+
+/**
+ @brief Return the memory of an instance of this class to its CObjectPool
+ @param p A void* variable containing the memory of the instance
+ @param uiSize A size_t variable containing the size of the instance
+ */
+void CWaypointManager::operator delete(void* p, size_t uiSize)
+{
+	GetPool().Free(p, uiSize);
+}
+
+/**
+ @brief Get the CObjectPool which the instances of this class are allocated from
+ @return A CObjectPool<CWaypointManager>& variable
+ */
+CObjectPool<CWaypointManager>& CWaypointManager::GetPool(void)
+{
+	static CObjectPool<CWaypointManager> cPool;
+	return cPool;
+}
+
 /**
  @brief Initialise this instance to default values
  @return A bool variable
@@ -5,6 +5,9 @@
  */
 #pragma once
 
+// Include CObjectPool
+#include "System/ObjectPool.h"
+
 #include "Waypoint.h"
 
 // Include GLM
@@ -23,6 +26,13 @@ public:
 	// Destructor
 	virtual ~CWaypointManager(void);
 
+	// Allocate the instances of this class from a CObjectPool, so that creating one reuses the memory of a deleted one
+	static void* operator new(size_t uiSize);
+	// Return the memory of an instance to the CObjectPool
+	static void operator delete(void* p, size_t uiSize);
+	// Get the CObjectPool of this class
+	static CObjectPool<CWaypointManager>& GetPool(void);
+
 	// Init
 	void Init(void);
 	// Destroy the instance
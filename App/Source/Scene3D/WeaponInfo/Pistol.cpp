@@ -28,6 +28,36 @@ CPistol::~CPistol(void)
 {
 }
 
+/**
+ @brief Allocate an instance of this class from its CObjectPool
+ @param uiSize A size_t variable containing the size of the instance
+ @return A void* variable
+ */
+void* CPistol::operator new(size_t uiSize)
+{
+	return GetPool().Allocate(uiSize);
+}
+
+/**
+ @brief Return the memory of an instance of this class to its CObjectPool
+ @param p A void* variable containing the memory of the instance
+ @param uiSize A size_t variable containing the size of the instance
+ */
+void CPistol::operator delete(void* p, size_t uiSize)
+{
+	GetPool().Free(p, uiSize);
+}
+
+/**
+ @brief Get the CObjectPool which the instances of this class are allocated from
+ @return A CObjectPool<CPistol>& variable
+ */
+CObjectPool<CPistol>& CPistol::GetPool(void)
+{
+	static CObjectPool<CPistol> cPool;
+	return cPool;
+}
+
 /**
  @brief Initialise this instance to default values
  */
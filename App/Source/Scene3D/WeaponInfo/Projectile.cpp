@@ -55,7 +55,7 @@ bool CProjectile::Init(	glm::vec3 vec3Position,
 	SetType(CEntity3D::TYPE::PROJECTILE);
 
 	// Set the attributes for this projectile
-	this->vec3Position = vec3Position;
+	SetPosition(vec3Position);
 	this->vec3Front = vec3Front;
 	this->dLifetime = dLifetime;
 	this->fSpeed = fSpeed;
@@ -112,9 +112,9 @@ void CProjectile::SetProjection(glm::mat4 projection)
  */
 void CProjectile::SetStatus(const bool bStatus)
 {
-	if (bStatus == false)
+	if (GetStatus() == false)
 		dLifetime = 0.0f;
-	this->bStatus = bStatus;
+	CSolidObject::SetStatus(bStatus);
 }
 
 /** 
@@ -206,7 +206,7 @@ int CProjectile::GetDamage() const
 */
 bool CProjectile::Update(const double dElapsedTime)
 {
-	if (bStatus == false)
+	if (GetStatus() == false)
 		return false;
 
 	// Update TimeLife of projectile. Set to inactive if too long
@@ -217,15 +217,15 @@ bool CProjectile::Update(const double dElapsedTime)
 	}
 
 	// Store current position
-	vec3PreviousPosition = vec3Position;
+	SetPreviousPosition(GetPosition());
 	// Update Position
-	vec3Position = vec3Position + vec3Front * (float)dElapsedTime * fSpeed;
+	SetPosition(GetPosition() + vec3Front * (float)dElapsedTime * fSpeed);
 
 	// Render the projectile
 	// Create transformations
 	model = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
 	//model = glm::rotate(model, (float)glfwGetTime()/10.0f, glm::vec3(0.0f, 0.0f, 1.0f));
-	model = glm::translate(model, vec3Position);
+	model = glm::translate(model, GetPosition());
 	model = glm::scale(model, vec3Scale);
 
 	return true;
@@ -248,7 +248,7 @@ void CProjectile::PreRender(void)
  */
 void CProjectile::Render(void)
 {
-	if (bStatus == false)
+	if (GetStatus() == false)
 		return;
 
 	if (dLifetime < 0.0f)
@@ -273,10 +273,10 @@ void CProjectile::PostRender(void)
 void CProjectile::PrintSelf(void)
 {
 	// Display the specifications of this projectile
-	cout << "Position: [" << vec3Position.x << ", " << vec3Position.y << ", " << vec3Position.z << "], ";
+	cout << "Position: [" << GetPosition().x << ", " << GetPosition().y << ", " << GetPosition().z << "], ";
 	cout << "Direction: [" << vec3Front.x << ", " << vec3Front.y << ", " << vec3Front.z << "], ";
 	cout << "LifeTime: " << dLifetime << ", Speed: " << fSpeed << ", Status: ";
-	if (bStatus == true)
+	if (GetStatus() == true)
 		cout << "Active" << endl;
 	else
 		cout << "Inactive" << endl;
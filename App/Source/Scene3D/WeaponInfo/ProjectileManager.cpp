@@ -13,8 +13,6 @@ using namespace std;
  */
 CProjectileManager::CProjectileManager(void)
 	: model(glm::mat4(1.0f))
-	, view(glm::mat4(1.0f))
-	, projection(glm::mat4(1.0f))
 	, uiTotalElements(100)
 	, uiIndexLast(0)
 {
@@ -74,24 +72,6 @@ void CProjectileManager::SetModel(glm::mat4 model)
 	this->model = model;
 }
 
-/**
- @brief Set view
- @param view A glm::mat4 variable containing the model for this class instance
- */
-void CProjectileManager::SetView(glm::mat4 view)
-{
-	this->view = view;
-}
-
-/**
- @brief Set projection
- @param projection A glm::mat4 variable containing the model for this class instance
- */
-void CProjectileManager::SetProjection(glm::mat4 projection)
-{
-	this->projection = projection;
-}
-
 /**
  @brief Activate a CProjectile* to this class instance
  @param vec3Position A const glm::vec3 variable containing the source position of the projectile
@@ -217,8 +197,6 @@ void CProjectileManager::Render(void)
 		if (vProjectile[i]->GetStatus() == false)
 			continue;
 
-		vProjectile[i]->SetView(view);
-		vProjectile[i]->SetProjection(projection);
 		vProjectile[i]->PreRender();
 		vProjectile[i]->Render();
 		vProjectile[i]->PostRender();
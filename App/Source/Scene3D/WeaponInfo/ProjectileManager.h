@@ -32,10 +32,6 @@ public:
 
 	// Set model
 	virtual void SetModel(glm::mat4 model);
-	// Set view
-	virtual void SetView(glm::mat4 view);
-	// Set projection
-	virtual void SetProjection(glm::mat4 projection);
 
 	// Activate a CProjectile* to this class instance
 	virtual int Activate(	glm::vec3 vec3Position,
@@ -71,8 +67,6 @@ protected:
 
 	// Render Settings
 	glm::mat4 model;
-	glm::mat4 view;
-	glm::mat4 projection;
 
 	// The total number of elements to reserve for the vector
 	unsigned int uiTotalElements;
@@ -16,6 +16,9 @@
 #include "../Camera.h"
 
 #include <iostream>
+
+// Include CLogger
+#include "System/Logger.h"
 #include "../App/Source/MyMath.h"
 using namespace std;
 
@@ -381,8 +384,8 @@ bool CWeaponInfo::Discharge(glm::vec3 vec3Position,
 				if (i == 0)
 					firstBulletFired = true;
 				// Get Bullet Spread Amount
-				float randomSpreadX = Math::RandFloatMinMax(-bulletSpread, bulletSpread);
-				float randomSpreadY = Math::RandFloatMinMax(-bulletSpread, bulletSpread);
+				float randomSpreadX = Math::RandFloatMinMax(-bulletSpread, bulletSpread, CRandomStreams::WEAPON);
+				float randomSpreadY = Math::RandFloatMinMax(-bulletSpread, bulletSpread, CRandomStreams::WEAPON);
 
 				// Create a projectile. 
 				// Its position is slightly in front of the player to prevent collision
@@ -556,10 +559,6 @@ void CWeaponInfo::PreRender(void)
  */
 void CWeaponInfo::Render(void)
 {	
-	// note: currently we set the projection matrix each frame, but since the projection 
-	// matrix rarely changes it's often best practice to set it outside the main loop only once.
-	CShaderManager::GetInstance()->activeShader->setMat4("projection", projection);
-	CShaderManager::GetInstance()->activeShader->setMat4("view", view);
 	CShaderManager::GetInstance()->activeShader->setMat4("model", model);
 
 	// bind textures on corresponding texture units
@@ -604,7 +603,7 @@ void CWeaponInfo::AnimateMeleeAttack(const double dElapsedTime)
 		animateMeleeAttackDir = 1;
 	else if (animateMeleeAttackDir == 1 && animateMeleeAttackZ >= 0)
 	{
-		std::cout << "DASD" << std::endl;
+		LOG_TRACE(WEAPON, "Melee attack finished");
 		animateMeleeAttackZ = 0;
 		isMeleeAttacking = false;
 		bFire = true;
@@ -9,6 +9,14 @@
 #include <includes/gtc/matrix_transform.hpp>
 #include <includes/gtc/type_ptr.hpp>
 
+// Include CLevelFile
+#include "Scene2D/LevelFile.h"
+// Include CLogger
+#include "System/Logger.h"
+
+#include <cstring>
+#include <iostream>
+
 /**
  Boolean macro to determine if the program is in debug mode
 	0=Non-debug mode, 1=Debug mode
@@ -22,12 +30,50 @@ Boolean macro to determine if the program is in 3D or 2D mode
 */
 #define _3DMODE 1
 
+/**
+ @brief Convert CSV maps into one level file, instead of running the game. Run it as:
+		App.exe --convert-levels [--rle] Output.lvl Level_01.csv [Level_02.csv ...]
+ @param argc An int variable containing the number of command line arguments
+ @param argv A char*[] variable containing the command line arguments
+ @return This function returns the error codes
+ */
+int ConvertLevels(int argc, char* argv[])
+{
+	int iArg = 2;
+	CLevelFile::ENCODING eEncoding = CLevelFile::RAW;
+	if ((iArg < argc) && (strcmp(argv[iArg], "--rle") == 0))
+	{
+		eEncoding = CLevelFile::RLE;
+		iArg++;
+	}
+	if (argc - iArg < 2)
+	{
+		std::cout << "Usage: " << argv[0] << " --convert-levels [--rle] Output.lvl Level_01.csv [Level_02.csv ...]" << std::endl;
+		return 1;
+	}
+
+	const std::string sOutput = argv[iArg++];
+	std::vector<std::string> vInputs(argv + iArg, argv + argc);
+
+	CLogger::GetInstance()->Init(CLogger::OUTPUT_CONSOLE);
+	const bool bResult = CLevelFile::ConvertCSV(vInputs, sOutput, eEncoding);
+	CLogger::GetInstance()->Destroy();
+
+	return bResult ? 0 : 1;
+}
+
 /**
  @brief This function is the main function which is called by the operating system when you run the executables
+ @param argc An int variable containing the number of command line arguments
+ @param argv A char*[] variable containing the command line arguments
  @return This function returns the error codes
  */
-int main(void)
+int main(int argc, char* argv[])
 {
+	// Convert CSV maps into a level file, without starting the game
+	if ((argc > 1) && (strcmp(argv[1], "--convert-levels") == 0))
+		return ConvertLevels(argc, argv);
+
 	Application* pApp = Application::GetInstance();
 	// if the application is initialised properly, then run it
 	if (pApp->Init() == true)
@@ -23,6 +23,12 @@ public:
 		return s_mInstance;
 	}
 
+	// Check if the Singleton instance exists, without creating it
+	static bool HasInstance(void)
+	{
+		return s_mInstance != nullptr;
+	}
+
 	// Destroy this singleton instance
 	static void Destroy()
 	{
@@ -48,6 +48,44 @@ public:
 	
 	float FOV = 45.f;
 
+	// Render Settings
+	// Set to false to draw the solid objects with one draw call each instead of glMultiDrawElementsIndirect
+	bool bUseMultiDrawIndirect = true;
+	// Set to false to draw the solid objects which are hidden behind buildings and terrain
+	bool bUseOcclusionCulling = true;
+	// Set to false to draw the 2D tile map with one draw call per tile instead of one per level
+	bool bUseTileMapBatching = true;
+	// Set to false to draw the 2D entities with one draw call each instead of through the CSpriteBatcher
+	bool bUseSpriteBatching = true;
+	// Set to false to update each 2D animated sprite on its own instead of all of them in one pass of the CAnimationSystem
+	bool bUseAnimationSystem = true;
+	// Set to false to draw the HUD text of the 3D scene through ImGui instead of the CTextRenderer glyph atlas
+	bool bUseTextRenderer = true;
+
+	// Memory Settings
+	// Set to true to log a warning when a frame of the 3D scene allocates from the heap, other than when spawning
+	bool bCheckFrameAllocations = false;
+
+	// AI Settings
+	// Set to false to update every NPC every frame, instead of less often when it is far away or outside the view
+	bool bUseAIScheduler = true;
+	// Set to false to find the paths of the 2D enemies with CMap2D::PathFind every frame, instead of in the background
+	bool bUseAsyncPathFinding = true;
+	// The number of A* nodes which the background path searches of the 2D enemies may expand in each frame
+	unsigned int uiPathNodeBudget = 4096;
+
+	// Map File Settings
+	// Set to false to write the 2D map saves on the main thread instead of on a background thread
+	bool bUseBackgroundSave = true;
+	// Set to false to load the 2D CSV maps through rapidcsv instead of parsing the integers in place
+	bool bUseFastCSVLoad = true;
+	// Set to false to load all the 2D levels when the scene starts, instead of loading the next level in the background
+	bool bUseLevelStreaming = true;
+
+	// Random Settings
+	// The seed of all the random numbers. Set to non-zero to replay a session; 0 seeds from the clock.
+	unsigned long long uiRandomSeed = 0;
+
 	// Frame Rate Information
 	const unsigned char FPS = 60; // FPS of this game
 	const unsigned int frameTime = 1000 / FPS; // time for each frame
@@ -0,0 +1,343 @@
+/**
+ CAnimationSystem
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#include "AnimationSystem.h"
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CAnimationSystem::CAnimationSystem(void)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CAnimationSystem::~CAnimationSystem(void)
+{
+}
+
+/**
+ @brief Compile a clip of a sprite sheet into the frame table, with the texture rectangle of each frame.
+		A clip with the same frames in a sprite sheet of the same size is shared instead.
+ @param vFrames A const vector<int>& variable containing the frames of the clip, counted along the rows of
+		the sprite sheet from the top left
+ @param iNumRows A const int variable containing the number of rows in the sprite sheet
+ @param iNumCols A const int variable containing the number of columns in the sprite sheet
+ @return The ID of the clip
+ */
+int CAnimationSystem::AddClip(const vector<int>& vFrames, const int iNumRows, const int iNumCols)
+{
+	// Share an identical clip
+	for (unsigned int i = 0; i < vClipFirstFrame.size(); i++)
+	{
+		if ((vClipNumRows[i] != iNumRows) || (vClipNumCols[i] != iNumCols) || (vClipNumFrames[i] != vFrames.size()))
+			continue;
+
+		unsigned int j = 0;
+		while ((j < vFrames.size()) && (vFrameSheetFrame[vClipFirstFrame[i] + j] == vFrames[j]))
+			j++;
+		if (j == vFrames.size())
+			return (int)i;
+	}
+
+	vClipFirstFrame.push_back((unsigned int)vFrameSheetFrame.size());
+	vClipNumFrames.push_back((unsigned int)vFrames.size());
+	vClipNumRows.push_back(iNumRows);
+	vClipNumCols.push_back(iNumCols);
+	for (unsigned int j = 0; j < vFrames.size(); j++)
+	{
+		vFrameSheetFrame.push_back(vFrames[j]);
+		vFrameUV.push_back(CalculateFrameUV(vFrames[j], iNumRows, iNumCols));
+	}
+	return (int)vClipFirstFrame.size() - 1;
+}
+
+/**
+ @brief Get the number of frames in a clip
+ @param iClipID A const int variable containing the ID of the clip
+ @return The number of frames, or 0 if the clip does not exist
+ */
+unsigned int CAnimationSystem::GetNumClipFrames(const int iClipID) const
+{
+	if ((iClipID < 0) || (iClipID >= (int)vClipNumFrames.size()))
+		return 0;
+	return vClipNumFrames[iClipID];
+}
+
+/**
+ @brief Add an animated sprite. It shows frame 0 of its sprite sheet until a clip is played.
+ @return The ID of the sprite
+ */
+unsigned int CAnimationSystem::AddInstance(void)
+{
+	unsigned int uiInstanceID;
+	if (vFreeInstanceID.empty() == false)
+	{
+		uiInstanceID = vFreeInstanceID.back();
+		vFreeInstanceID.pop_back();
+	}
+	else
+	{
+		uiInstanceID = (unsigned int)vSlotOfInstance.size();
+		vSlotOfInstance.push_back(0);
+	}
+
+	vSlotOfInstance[uiInstanceID] = (unsigned int)vInstanceOfSlot.size();
+	vInstanceOfSlot.push_back(uiInstanceID);
+	vClip.push_back(-1);
+	vRepeat.push_back(0);
+	vPlayCount.push_back(0);
+	vTime.push_back(0.0f);
+	vDuration.push_back(0.0f);
+	vFrameRate.push_back(0.0f);
+	vFrame.push_back(-1);
+	vActive.push_back(0);
+	return uiInstanceID;
+}
+
+/**
+ @brief Remove an animated sprite. The last sprite in the state arrays is moved into its place.
+ @param uiInstanceID A const unsigned int variable containing the ID of the sprite
+ */
+void CAnimationSystem::RemoveInstance(const unsigned int uiInstanceID)
+{
+	const int iSlot = GetSlot(uiInstanceID);
+	if (iSlot < 0)
+		return;
+
+	const unsigned int uiLast = (unsigned int)vInstanceOfSlot.size() - 1;
+	if ((unsigned int)iSlot != uiLast)
+	{
+		vInstanceOfSlot[iSlot] = vInstanceOfSlot[uiLast];
+		vSlotOfInstance[vInstanceOfSlot[iSlot]] = iSlot;
+		vClip[iSlot] = vClip[uiLast];
+		vRepeat[iSlot] = vRepeat[uiLast];
+		vPlayCount[iSlot] = vPlayCount[uiLast];
+		vTime[iSlot] = vTime[uiLast];
+		vDuration[iSlot] = vDuration[uiLast];
+		vFrameRate[iSlot] = vFrameRate[uiLast];
+		vFrame[iSlot] = vFrame[uiLast];
+		vActive[iSlot] = vActive[uiLast];
+	}
+	vInstanceOfSlot.pop_back();
+	vClip.pop_back();
+	vRepeat.pop_back();
+	vPlayCount.pop_back();
+	vTime.pop_back();
+	vDuration.pop_back();
+	vFrameRate.pop_back();
+	vFrame.pop_back();
+	vActive.pop_back();
+
+	vSlotOfInstance[uiInstanceID] = 0xFFFFFFFF;
+	vFreeInstanceID.push_back(uiInstanceID);
+}
+
+/**
+ @brief Set the clip of a sprite without playing it or changing its frame, so that Reset() and Resume() use it
+ @param uiInstanceID A const unsigned int variable containing the ID of the sprite
+ @param iClipID A const int variable containing the ID of the clip
+ */
+void CAnimationSystem::SetClip(const unsigned int uiInstanceID, const int iClipID)
+{
+	const int iSlot = GetSlot(uiInstanceID);
+	if ((iSlot < 0) || (iClipID < 0) || (iClipID >= (int)vClipFirstFrame.size()))
+		return;
+	vClip[iSlot] = iClipID;
+}
+
+/**
+ @brief Play a clip on a sprite. The time of the sprite is not reset, so this can be called in every frame
+		while a key is held, and a switch between clips continues from the same time.
+ @param uiInstanceID A const unsigned int variable containing the ID of the sprite
+ @param iClipID A const int variable containing the ID of the clip
+ @param iRepeat A const int variable containing the number of repeats (-1 for infinite looping)
+ @param fTime A const float variable containing the total time of the clip
+ */
+void CAnimationSystem::Play(const unsigned int uiInstanceID, const int iClipID, const int iRepeat, const float fTime)
+{
+	const int iSlot = GetSlot(uiInstanceID);
+	if ((iSlot < 0) || (iClipID < 0) || (iClipID >= (int)vClipFirstFrame.size()))
+		return;
+
+	vClip[iSlot] = iClipID;
+	vRepeat[iSlot] = iRepeat;
+	vDuration[iSlot] = fTime;
+	vFrameRate[iSlot] = (fTime > 0.0f) ? vClipNumFrames[iClipID] / fTime : 0.0f;
+	vActive[iSlot] = 1;
+}
+
+/**
+ @brief Pause or resume the clip of a sprite
+ @param uiInstanceID A const unsigned int variable containing the ID of the sprite
+ @param bActive A const bool variable which is true to resume and false to pause
+ */
+void CAnimationSystem::SetActive(const unsigned int uiInstanceID, const bool bActive)
+{
+	const int iSlot = GetSlot(uiInstanceID);
+	if ((iSlot < 0) || (vClip[iSlot] < 0))
+		return;
+	vActive[iSlot] = bActive ? 1 : 0;
+}
+
+/**
+ @brief Show the first frame of the clip of a sprite again, and reset its number of repeats
+ @param uiInstanceID A const unsigned int variable containing the ID of the sprite
+ */
+void CAnimationSystem::Reset(const unsigned int uiInstanceID)
+{
+	const int iSlot = GetSlot(uiInstanceID);
+	if ((iSlot < 0) || (vClip[iSlot] < 0) || (vClipNumFrames[vClip[iSlot]] == 0))
+		return;
+	vFrame[iSlot] = vClipFirstFrame[vClip[iSlot]];
+	vPlayCount[iSlot] = 0;
+}
+
+/**
+ @brief Update the clips of all the sprites, in one pass through the state arrays
+ @param dElapsedTime A const double variable containing the elapsed time since the last frame
+ */
+void CAnimationSystem::Update(const double dElapsedTime)
+{
+	const float fElapsedTime = static_cast<float>(dElapsedTime);
+	const unsigned int uiNumSlots = (unsigned int)vInstanceOfSlot.size();
+	for (unsigned int i = 0; i < uiNumSlots; i++)
+	{
+		if (vActive[i] != 0)
+			UpdateSlot(i, fElapsedTime);
+	}
+}
+
+/**
+ @brief Update the clip of one sprite, such as when the sprites are not updated together
+ @param uiInstanceID A const unsigned int variable containing the ID of the sprite
+ @param dElapsedTime A const double variable containing the elapsed time since the last frame
+ */
+void CAnimationSystem::UpdateInstance(const unsigned int uiInstanceID, const double dElapsedTime)
+{
+	const int iSlot = GetSlot(uiInstanceID);
+	if ((iSlot >= 0) && (vActive[iSlot] != 0))
+		UpdateSlot(iSlot, static_cast<float>(dElapsedTime));
+}
+
+/**
+ @brief Get the clip of a sprite
+ @param uiInstanceID A const unsigned int variable containing the ID of the sprite
+ @return The ID of the clip, or -1 if none has been set
+ */
+int CAnimationSystem::GetClip(const unsigned int uiInstanceID) const
+{
+	const int iSlot = GetSlot(uiInstanceID);
+	if (iSlot < 0)
+		return -1;
+	return vClip[iSlot];
+}
+
+/**
+ @brief Get the current frame of a sprite
+ @param uiInstanceID A const unsigned int variable containing the ID of the sprite
+ @return The frame, counted along the rows of the sprite sheet from the top left
+ */
+int CAnimationSystem::GetFrame(const unsigned int uiInstanceID) const
+{
+	const int iSlot = GetSlot(uiInstanceID);
+	if ((iSlot < 0) || (vFrame[iSlot] < 0))
+		return 0;
+	return vFrameSheetFrame[vFrame[iSlot]];
+}
+
+/**
+ @brief Get the rectangle of the current frame of a sprite in the sprite sheet of its clip, from the frame table
+ @param uiInstanceID A const unsigned int variable containing the ID of the sprite
+ @return The rectangle of the frame: u0, v0, u1, v1
+ */
+glm::vec4 CAnimationSystem::GetFrameUV(const unsigned int uiInstanceID) const
+{
+	const int iSlot = GetSlot(uiInstanceID);
+	if ((iSlot < 0) || (vClip[iSlot] < 0))
+		return glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+	if (vFrame[iSlot] < 0)
+		return CalculateFrameUV(0, vClipNumRows[vClip[iSlot]], vClipNumCols[vClip[iSlot]]);
+	return vFrameUV[vFrame[iSlot]];
+}
+
+/**
+ @brief Get the number of animated sprites
+ @return The number of animated sprites
+ */
+unsigned int CAnimationSystem::GetNumInstances(void) const
+{
+	return (unsigned int)vInstanceOfSlot.size();
+}
+
+/**
+ @brief Get the position of a sprite in the state arrays
+ @param uiInstanceID A const unsigned int variable containing the ID of the sprite
+ @return The position, or -1 if the sprite does not exist
+ */
+int CAnimationSystem::GetSlot(const unsigned int uiInstanceID) const
+{
+	if ((uiInstanceID >= vSlotOfInstance.size()) || (vSlotOfInstance[uiInstanceID] == 0xFFFFFFFF))
+		return -1;
+	return (int)vSlotOfInstance[uiInstanceID];
+}
+
+/**
+ @brief Advance the clip of the sprite at a position in the state arrays. When the time of the clip is over,
+		the clip starts again if it has repeats left or loops for ever, else it stops at its last frame.
+ @param uiSlot A const unsigned int variable containing the position of the sprite
+ @param fElapsedTime A const float variable containing the elapsed time since the last frame
+ */
+void CAnimationSystem::UpdateSlot(const unsigned int uiSlot, const float fElapsedTime)
+{
+	const unsigned int uiNumFrames = vClipNumFrames[vClip[uiSlot]];
+	if (uiNumFrames == 0)
+		return;
+	const unsigned int uiFirstFrame = vClipFirstFrame[vClip[uiSlot]];
+
+	const float fTime = vTime[uiSlot] + fElapsedTime;
+	unsigned int uiFrame = static_cast<unsigned int>(fTime * vFrameRate[uiSlot]);
+	if (uiFrame >= uiNumFrames)
+		uiFrame = uiNumFrames - 1;
+	vFrame[uiSlot] = uiFirstFrame + uiFrame;
+	vTime[uiSlot] = fTime;
+
+	if (fTime >= vDuration[uiSlot])
+	{
+		if (vRepeat[uiSlot] == -1)
+		{
+			vTime[uiSlot] = 0.0f;
+			vFrame[uiSlot] = uiFirstFrame;
+		}
+		else if (vPlayCount[uiSlot] < vRepeat[uiSlot])
+		{
+			vPlayCount[uiSlot]++;
+			vTime[uiSlot] = 0.0f;
+			vFrame[uiSlot] = uiFirstFrame;
+		}
+		else
+		{
+			vActive[uiSlot] = 0;
+		}
+	}
+}
+
+/**
+ @brief Get the rectangle of a frame in a sprite sheet, in the same layout as
+		CMeshBuilder::GenerateSpriteAnimation
+ @param iFrame A const int variable containing the frame, counted along the rows from the top left
+ @param iNumRows A const int variable containing the number of rows in the sprite sheet
+ @param iNumCols A const int variable containing the number of columns in the sprite sheet
+ @return The rectangle of the frame: u0, v0, u1, v1
+ */
+glm::vec4 CAnimationSystem::CalculateFrameUV(const int iFrame, const int iNumRows, const int iNumCols)
+{
+	const float fWidth = 1.0f / iNumCols;
+	const float fHeight = 1.0f / iNumRows;
+	const float fU = (iFrame % iNumCols) * fWidth;
+	const float fV = 1.0f - fHeight - (iFrame / iNumCols) * fHeight;
+	return glm::vec4(fU, fV, fU + fWidth, fV + fHeight);
+}
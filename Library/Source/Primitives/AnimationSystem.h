@@ -0,0 +1,101 @@
+/**
+ CAnimationSystem
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "../DesignPatterns/SingletonTemplate.h"
+
+// Include GLM
+#include <includes/glm.hpp>
+
+#include <vector>
+using namespace std;
+
+// Updates the animations of all the CSpriteAnimations in one pass per frame.
+// A clip is compiled once, when it is added, into a range of a table of sprite sheet frames and their texture
+// rectangles, and is then referred to by its integer ID. Identical clips share their ID. The state of each
+// animated sprite is kept in a set of parallel arrays, one value per sprite, so Update() runs through them in
+// one loop without any lookup by name, and the texture rectangle of the current frame of a sprite is read
+// from the table instead of being calculated.
+class CAnimationSystem : public CSingletonTemplate<CAnimationSystem>
+{
+	friend CSingletonTemplate<CAnimationSystem>;
+
+public:
+	// Compile a clip of a sprite sheet of iNumRows x iNumCols frames, and get its ID
+	int AddClip(const vector<int>& vFrames, const int iNumRows, const int iNumCols);
+	// Get the number of frames in a clip
+	unsigned int GetNumClipFrames(const int iClipID) const;
+
+	// Add an animated sprite and get its ID. It shows frame 0 of its sprite sheet until a clip is played.
+	unsigned int AddInstance(void);
+	// Remove an animated sprite
+	void RemoveInstance(const unsigned int uiInstanceID);
+
+	// Set the clip of a sprite without playing it, so that Reset() and Resume() use it
+	void SetClip(const unsigned int uiInstanceID, const int iClipID);
+	// Play a clip on a sprite, repeating it iRepeat more times (-1 for ever), over fTime seconds each time.
+	// The time of the sprite is not reset, so this can be called in every frame.
+	void Play(const unsigned int uiInstanceID, const int iClipID, const int iRepeat, const float fTime);
+	// Pause or resume the clip of a sprite
+	void SetActive(const unsigned int uiInstanceID, const bool bActive);
+	// Show the first frame of the clip of a sprite again, and reset its number of repeats
+	void Reset(const unsigned int uiInstanceID);
+
+	// Update the clips of all the sprites
+	void Update(const double dElapsedTime);
+	// Update the clip of one sprite
+	void UpdateInstance(const unsigned int uiInstanceID, const double dElapsedTime);
+
+	// Get the clip of a sprite, or -1 if none has been played
+	int GetClip(const unsigned int uiInstanceID) const;
+	// Get the current frame of a sprite, in its sprite sheet
+	int GetFrame(const unsigned int uiInstanceID) const;
+	// Get the rectangle of the current frame of a sprite in the sprite sheet of its clip: u0, v0, u1, v1
+	glm::vec4 GetFrameUV(const unsigned int uiInstanceID) const;
+
+	// Get the number of animated sprites
+	unsigned int GetNumInstances(void) const;
+
+protected:
+	// The clips, as ranges of the frame table
+	vector<unsigned int> vClipFirstFrame;
+	vector<unsigned int> vClipNumFrames;
+	vector<int> vClipNumRows;
+	vector<int> vClipNumCols;
+	// The frame table: the frame in the sprite sheet and its texture rectangle
+	vector<int> vFrameSheetFrame;
+	vector<glm::vec4> vFrameUV;
+
+	// The state of the sprites, one value per sprite, stored without gaps
+	vector<int> vClip;
+	vector<int> vRepeat;
+	vector<int> vPlayCount;
+	vector<float> vTime;
+	vector<float> vDuration;
+	// The number of frames per second, so that a frame is found with a multiplication
+	vector<float> vFrameRate;
+	// The current frame, as an index into the frame table, or -1 to show frame 0 of the sprite sheet
+	vector<int> vFrame;
+	vector<unsigned char> vActive;
+
+	// The position of each sprite in the state arrays, by its ID, and the ID of each position
+	vector<unsigned int> vSlotOfInstance;
+	vector<unsigned int> vInstanceOfSlot;
+	vector<unsigned int> vFreeInstanceID;
+
+	// Constructor
+	CAnimationSystem(void);
+	// Destructor
+	virtual ~CAnimationSystem(void);
+
+	// Get the position of a sprite in the state arrays, or -1 if it does not exist
+	int GetSlot(const unsigned int uiInstanceID) const;
+	// Advance the clip of the sprite at a position in the state arrays
+	void UpdateSlot(const unsigned int uiSlot, const float fElapsedTime);
+	// Get the rectangle of a frame in a sprite sheet of iNumRows x iNumCols frames
+	static glm::vec4 CalculateFrameUV(const int iFrame, const int iNumRows, const int iNumCols);
+};
@@ -136,8 +136,6 @@ void CCollider::Render(void)
 		return;
 
 	CShaderManager::GetInstance()->activeShader->setMat4("model", colliderModel);
-	CShaderManager::GetInstance()->activeShader->setMat4("view", colliderView);
-	CShaderManager::GetInstance()->activeShader->setMat4("projection", colliderProjection);
 
 	// render box
 	glBindVertexArray(colliderVAO);
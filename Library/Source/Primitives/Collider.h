@@ -19,8 +19,6 @@ class CCollider
 public:
 	// Attributes of the Shader
 	glm::mat4 colliderModel; // make sure to initialize matrix to identity matrix first
-	glm::mat4 colliderView;
-	glm::mat4 colliderProjection;
 
 	// Bounding Box specifications
 	// Bounding Box bottom left position
@@ -1,6 +1,7 @@
 #include "CollisionManager.h"
 
 #include <algorithm>
+#include <cfloat>
 #include <iostream>
 using namespace std;
 
@@ -32,6 +33,46 @@ bool CCollisionManager::BoxBoxCollision(const glm::vec3 aMin,
     //            aMin.x > bMax.x || aMin.z > bMax.z      );
 }
 
+/**
+ @brief Box-Box Collision Test which also returns the contact normal and penetration depth
+ @param normal The axis along which box A should move to separate from box B
+ @param penetration The distance which box A has to move along the normal
+ */
+bool CCollisionManager::BoxBoxCollision(const glm::vec3 aMin,
+    const glm::vec3 aMax,
+    const glm::vec3 bMin,
+    const glm::vec3 bMax,
+    glm::vec3& normal,
+    float& penetration)
+{
+    if (BoxBoxCollision(aMin, aMax, bMin, bMax) == false)
+        return false;
+
+    // The overlap when pushing box A towards the negative and positive side of each axis
+    const glm::vec3 negativeOverlap = aMax - bMin;
+    const glm::vec3 positiveOverlap = bMax - aMin;
+
+    // Use the axis with the smallest overlap
+    penetration = FLT_MAX;
+    for (int i = 0; i < 3; i++)
+    {
+        if (negativeOverlap[i] < penetration)
+        {
+            penetration = negativeOverlap[i];
+            normal = glm::vec3(0.0f);
+            normal[i] = -1.0f;
+        }
+        if (positiveOverlap[i] < penetration)
+        {
+            penetration = positiveOverlap[i];
+            normal = glm::vec3(0.0f);
+            normal[i] = 1.0f;
+        }
+    }
+
+    return true;
+}
+
 /**
  @brief Ray-Sphere Collision Test
  */
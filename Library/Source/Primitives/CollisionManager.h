@@ -23,6 +23,13 @@ class CCollisionManager
 										const glm::vec3 aMax,
 										const glm::vec3 bMin, 
 										const glm::vec3 bMax);
+		// Box-Box Collision Test which also returns the contact normal and penetration depth
+		static bool BoxBoxCollision(	const glm::vec3 aMin,
+										const glm::vec3 aMax,
+										const glm::vec3 bMin,
+										const glm::vec3 bMax,
+										glm::vec3& normal,
+										float& penetration);
 		// Ray-Sphere Collision Test
 		static bool RaySphereCollision(	const glm::vec3 sphereCentre, 
 										const float sphereRadius,
@@ -96,6 +96,15 @@ void CEntity3D::SetShader(const std::string& _name)
 	this->sShaderName = _name;
 }
 
+/**
+ @brief Get the name of the shader of this class instance
+ @return A const std::string variable
+ */
+const std::string CEntity3D::GetShader(void) const
+{
+	return sShaderName;
+}
+
 // Set methods
 void CEntity3D::SetTextureID(const GLuint iTextureID)
 {
@@ -219,7 +228,7 @@ const bool CEntity3D::IsToDelete(void) const
  */
 void CEntity3D::StorePositionForRollback(void)
 {
-	vec3PreviousPosition = vec3Position;
+	SetPreviousPosition(GetPosition());
 }
 
 /**
@@ -227,7 +236,7 @@ void CEntity3D::StorePositionForRollback(void)
  */
 void CEntity3D::RollbackPosition(void)
 {
-	vec3Position = vec3PreviousPosition;
+	SetPosition(GetPreviousPosition());
 }
 
 /**
@@ -261,3 +270,38 @@ float CEntity3D::GetMaxHealth(void)
 {
 	return fMaxHealth;
 }
+
+
+/**
+ @brief Submit this instance to the CIndirectDrawBuffer instead of rendering it in Render().
+		The default is to render in Render(). An entity which overrides this must not draw in Render().
+ @return true if this instance was submitted, else false
+ */
+bool CEntity3D::SubmitDraw(void)
+{
+	return false;
+}
+
+/**
+ @brief Get the bounding box in world space which is tested against the COcclusionCuller.
+		The default is to have no bounding box, so this instance is never culled.
+ @param vec3BoxMin A glm::vec3& variable which is set to the min corner of the bounding box
+ @param vec3BoxMax A glm::vec3& variable which is set to the max corner of the bounding box
+ @return true if this instance has a bounding box, else false
+ */
+bool CEntity3D::GetRenderBounds(glm::vec3& vec3BoxMin, glm::vec3& vec3BoxMax) const
+{
+	return false;
+}
+
+/**
+ @brief Get the box in world space which hides the entities behind this instance.
+		The default is to not be an occluder.
+ @param vec3BoxMin A glm::vec3& variable which is set to the min corner of the box
+ @param vec3BoxMax A glm::vec3& variable which is set to the max corner of the box
+ @return true if this instance is an occluder, else false
+ */
+bool CEntity3D::GetOccluderBox(glm::vec3& vec3BoxMin, glm::vec3& vec3BoxMax) const
+{
+	return false;
+}
@@ -51,6 +51,8 @@ public:
 
 	// Set a shader to this class instance
 	virtual void SetShader(const std::string& _name);
+	// Get the name of the shader of this class instance
+	virtual const std::string GetShader(void) const;
 
 	// Set model
 	virtual void SetModel(glm::mat4 model) = 0;
@@ -116,6 +118,14 @@ public:
 	// PostRender
 	virtual void PostRender(void) = 0;
 
+	// Submit this instance to the CIndirectDrawBuffer instead of rendering it in Render()
+	virtual bool SubmitDraw(void);
+
+	// Get the bounding box in world space which is tested against the COcclusionCuller
+	virtual bool GetRenderBounds(glm::vec3& vec3BoxMin, glm::vec3& vec3BoxMax) const;
+	// Get the box in world space which hides the entities behind this instance
+	virtual bool GetOccluderBox(glm::vec3& vec3BoxMin, glm::vec3& vec3BoxMax) const;
+
 protected:
 	// The handle to the CSettings instance
 	CSettings* cSettings;
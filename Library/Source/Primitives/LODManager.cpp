@@ -0,0 +1,244 @@
+/**
+ CLODManager
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#include "LODManager.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ @brief Constructor
+ */
+CLODManager::CLODManager(void)
+	: fReferenceProjection(1.0f)
+	, fHysteresis(0.1f)
+	, uiMaxChangesPerFrame(8)
+{
+	for (int i = 0; i < CLevelOfDetails::NUM_LOD_PASS; i++)
+	{
+		arrStart[i] = 0;
+		arrNumChanges[i] = 0;
+	}
+}
+
+/**
+ @brief Destructor
+ */
+CLODManager::~CLODManager(void)
+{
+	vLOD.clear();
+	vEntity.clear();
+}
+
+/**
+ @brief Initialise this class instance
+ @return true if the initialisation is successful, else false
+ */
+bool CLODManager::Init(void)
+{
+	vLOD.clear();
+	vEntity.clear();
+
+	// arrLODDistance is tuned for the default field of view and window height
+	CSettings* cSettings = CSettings::GetInstance();
+	fReferenceProjection = CalculateProjection(cSettings->FOV, (float)cSettings->iWindowHeight);
+
+	for (int i = 0; i < CLevelOfDetails::NUM_LOD_PASS; i++)
+	{
+		arrStart[i] = 0;
+		arrNumChanges[i] = 0;
+	}
+	return true;
+}
+
+/**
+ @brief Add an entity whose level of details is selected by this class instance
+ @param cLOD A CLevelOfDetails* variable which contains the levels of details
+ @param cEntity A CEntity3D* variable which contains the position of the entity
+ */
+void CLODManager::Add(CLevelOfDetails* cLOD, CEntity3D* cEntity)
+{
+	if ((cLOD == NULL) || (cEntity == NULL))
+		return;
+
+	if (find(vLOD.begin(), vLOD.end(), cLOD) != vLOD.end())
+		return;
+
+	vLOD.push_back(cLOD);
+	vEntity.push_back(cEntity);
+}
+
+/**
+ @brief Remove an entity from this class instance
+ @param cLOD A CLevelOfDetails* variable which was added to this class instance
+ @return true if the entity was found and removed, else false
+ */
+bool CLODManager::Erase(CLevelOfDetails* cLOD)
+{
+	vector<CLevelOfDetails*>::iterator it = find(vLOD.begin(), vLOD.end(), cLOD);
+	if (it == vLOD.end())
+		return false;
+
+	// Swap the last entity into the empty slot
+	const unsigned int uiIndex = it - vLOD.begin();
+	vLOD[uiIndex] = vLOD.back();
+	vEntity[uiIndex] = vEntity.back();
+	vLOD.pop_back();
+	vEntity.pop_back();
+	return true;
+}
+
+/**
+ @brief Select the level of details of every entity for a render pass
+ @param ePass The render pass
+ @param vec3CameraPosition The position of the camera of the render pass
+ @param fFOVY The vertical field of view of the render pass, in degrees
+ @param fViewportHeight The height in pixels of the image of the render pass on the screen
+ */
+void CLODManager::Update(	const CLevelOfDetails::LOD_PASS ePass,
+							const glm::vec3& vec3CameraPosition,
+							const float fFOVY,
+							const float fViewportHeight)
+{
+	arrNumChanges[ePass] = 0;
+
+	const unsigned int uiSize = vLOD.size();
+	if (uiSize == 0)
+		return;
+
+	// An entity covers the same number of pixels in this pass as in the default view
+	// when its distance is scaled by the ratio of the projection factors
+	const float fScale = CalculateProjection(fFOVY, fViewportHeight) / fReferenceProjection;
+	const float fCoarsen = (1.0f + fHysteresis) * fScale;
+	const float fRefine = (1.0f - fHysteresis) * fScale;
+
+	if (arrStart[ePass] >= uiSize)
+		arrStart[ePass] = 0;
+
+	unsigned int uiIndex = arrStart[ePass];
+	for (unsigned int i = 0; i < uiSize; i++, uiIndex++)
+	{
+		if (uiIndex >= uiSize)
+			uiIndex = 0;
+
+		CLevelOfDetails* cLOD = vLOD[uiIndex];
+		if (cLOD->GetLODStatus() == false)
+			continue;
+
+		const glm::vec3 vec3Offset = vEntity[uiIndex]->GetPosition() - vec3CameraPosition;
+		const float fDistance2 = glm::dot(vec3Offset, vec3Offset);
+
+		// Move 1 level at a time; a coarser level is used only when the entity is past the band
+		// above its switching distance, and a finer one only when it is past the band below it
+		const int iCurrent = cLOD->GetPassDetailLevel(ePass);
+		int iNew = iCurrent;
+		while (iNew + 1 < CLevelOfDetails::NUM_DETAIL_LEVEL)
+		{
+			const float fSwitch = cLOD->arrLODDistance[iNew + 1] * fCoarsen;
+			if (fDistance2 <= fSwitch * fSwitch)
+				break;
+			iNew++;
+		}
+		if (iNew == iCurrent)
+		{
+			while (iNew > CLevelOfDetails::HIGH_DETAILS)
+			{
+				const float fSwitch = cLOD->arrLODDistance[iNew] * fRefine;
+				if (fDistance2 >= fSwitch * fSwitch)
+					break;
+				iNew--;
+			}
+		}
+		if (iNew == iCurrent)
+			continue;
+
+		cLOD->SetPassDetailLevel(ePass, (CLevelOfDetails::DETAIL_LEVEL)iNew);
+		arrNumChanges[ePass]++;
+
+		// Leave the rest of the changes to the next frames, starting from the next entity
+		if ((uiMaxChangesPerFrame > 0) && (arrNumChanges[ePass] >= uiMaxChangesPerFrame))
+		{
+			arrStart[ePass] = uiIndex + 1;
+			return;
+		}
+	}
+	arrStart[ePass] = 0;
+}
+
+/**
+ @brief Use the level of details of a render pass as the current level of details of every entity
+ @param ePass The render pass
+ */
+void CLODManager::UsePass(const CLevelOfDetails::LOD_PASS ePass)
+{
+	for (unsigned int i = 0; i < vLOD.size(); i++)
+		vLOD[i]->UsePass(ePass);
+}
+
+/**
+ @brief Set the width of the hysteresis band, as a fraction of the switching distance
+ @param fHysteresis A const float variable between 0 and 1
+ */
+void CLODManager::SetHysteresis(const float fHysteresis)
+{
+	this->fHysteresis = glm::clamp(fHysteresis, 0.0f, 0.9f);
+}
+
+/**
+ @brief Get the width of the hysteresis band
+ @return The width of the hysteresis band, as a fraction of the switching distance
+ */
+float CLODManager::GetHysteresis(void) const
+{
+	return fHysteresis;
+}
+
+/**
+ @brief Set the maximum number of level changes per render pass per frame
+ @param uiMaxChangesPerFrame A const unsigned int variable. 0 means no limit
+ */
+void CLODManager::SetMaxChangesPerFrame(const unsigned int uiMaxChangesPerFrame)
+{
+	this->uiMaxChangesPerFrame = uiMaxChangesPerFrame;
+}
+
+/**
+ @brief Get the maximum number of level changes per render pass per frame
+ @return The maximum number of level changes. 0 means no limit
+ */
+unsigned int CLODManager::GetMaxChangesPerFrame(void) const
+{
+	return uiMaxChangesPerFrame;
+}
+
+/**
+ @brief Get the number of entities in this class instance
+ @return The number of entities
+ */
+unsigned int CLODManager::GetSize(void) const
+{
+	return vLOD.size();
+}
+
+/**
+ @brief Get the number of level changes in the last Update of a render pass
+ @param ePass The render pass
+ @return The number of level changes
+ */
+unsigned int CLODManager::GetNumChanges(const CLevelOfDetails::LOD_PASS ePass) const
+{
+	return arrNumChanges[ePass];
+}
+
+/**
+ @brief Calculate the projection factor, which is the number of pixels covered by 1 unit at a distance of 1 unit
+ @param fFOVY The vertical field of view, in degrees
+ @param fViewportHeight The height of the viewport in pixels
+ @return The projection factor
+ */
+float CLODManager::CalculateProjection(const float fFOVY, const float fViewportHeight)
+{
+	return fViewportHeight / (2.0f * tan(glm::radians(fFOVY) * 0.5f));
+}
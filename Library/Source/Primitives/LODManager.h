@@ -0,0 +1,89 @@
+/**
+ CLODManager
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "../DesignPatterns/SingletonTemplate.h"
+
+// Include CLevelOfDetails
+#include "LevelOfDetails.h"
+
+// Include CEntity3D
+#include "Entity3D.h"
+
+// Include GLM
+#include <includes/glm.hpp>
+#include <includes/gtc/matrix_transform.hpp>
+#include <includes/gtc/type_ptr.hpp>
+
+#include <vector>
+using namespace std;
+
+// Selects the level of details of every registered entity in one pass per render pass.
+// The switching distances in CLevelOfDetails::arrLODDistance are tuned for the default field of view
+// and window height. They are scaled by the projection of each render pass, so an entity switches
+// when its size on screen is the same as it would be in the default view. A hysteresis band stops
+// an entity near a switching distance from changing its level every frame, and the number of changes
+// per frame is capped so that many entities crossing a distance together do not spike a frame.
+class CLODManager : public CSingletonTemplate<CLODManager>
+{
+	friend CSingletonTemplate<CLODManager>;
+
+public:
+	// Initialise this class instance
+	bool Init(void);
+
+	// Add an entity whose level of details is selected by this class instance
+	void Add(CLevelOfDetails* cLOD, CEntity3D* cEntity);
+	// Remove an entity from this class instance
+	bool Erase(CLevelOfDetails* cLOD);
+
+	// Select the level of details of every entity for a render pass
+	void Update(const CLevelOfDetails::LOD_PASS ePass,
+				const glm::vec3& vec3CameraPosition,
+				const float fFOVY,
+				const float fViewportHeight);
+	// Use the level of details of a render pass as the current level of details of every entity
+	void UsePass(const CLevelOfDetails::LOD_PASS ePass);
+
+	// Set the width of the hysteresis band, as a fraction of the switching distance
+	void SetHysteresis(const float fHysteresis);
+	// Get the width of the hysteresis band
+	float GetHysteresis(void) const;
+	// Set the maximum number of level changes per render pass per frame. 0 means no limit
+	void SetMaxChangesPerFrame(const unsigned int uiMaxChangesPerFrame);
+	// Get the maximum number of level changes per render pass per frame
+	unsigned int GetMaxChangesPerFrame(void) const;
+
+	// Get the number of entities in this class instance
+	unsigned int GetSize(void) const;
+	// Get the number of level changes in the last Update of a render pass
+	unsigned int GetNumChanges(const CLevelOfDetails::LOD_PASS ePass) const;
+
+protected:
+	// The entities, stored as parallel arrays so that Update walks them in order
+	vector<CLevelOfDetails*> vLOD;
+	vector<CEntity3D*> vEntity;
+
+	// The projection factor of the default view, which arrLODDistance is tuned for
+	float fReferenceProjection;
+	// The width of the hysteresis band, as a fraction of the switching distance
+	float fHysteresis;
+	// The maximum number of level changes per render pass per frame
+	unsigned int uiMaxChangesPerFrame;
+	// The entity which Update starts from in each render pass, so that no entity waits forever
+	unsigned int arrStart[CLevelOfDetails::NUM_LOD_PASS];
+	// The number of level changes in the last Update of each render pass
+	unsigned int arrNumChanges[CLevelOfDetails::NUM_LOD_PASS];
+
+	// Constructor
+	CLODManager(void);
+	// Destructor
+	virtual ~CLODManager(void);
+
+	// Calculate the projection factor, which is the number of pixels covered by 1 unit at a distance of 1 unit
+	static float CalculateProjection(const float fFOVY, const float fViewportHeight);
+};
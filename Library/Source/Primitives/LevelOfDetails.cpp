@@ -10,6 +10,12 @@ CLevelOfDetails::CLevelOfDetails(void)
 	arrLODDistance[HIGH_DETAILS]	= 0.0f;
 	arrLODDistance[MID_DETAILS]		= 15.0f;
 	arrLODDistance[LOW_DETAILS]		= 30.0f;
+
+	for (int i = 0; i < NUM_LOD_PASS; i++)
+		arrPassDetailLevel[i] = HIGH_DETAILS;
+
+	for (int i = 0; i < NUM_DETAIL_LEVEL; i++)
+		arriMeshID[i] = -1;
 }
 
 /** 
@@ -38,6 +44,8 @@ void CLevelOfDetails::SetLODStatus(const bool m_bLODStatus)
 	if (this->m_bLODStatus == false)
 	{
 		eDetailLevel = HIGH_DETAILS;
+		for (int i = 0; i < NUM_LOD_PASS; i++)
+			arrPassDetailLevel[i] = HIGH_DETAILS;
 	}
 }
 
@@ -61,3 +69,34 @@ bool CLevelOfDetails::SetDetailLevel(const DETAIL_LEVEL eDetailLevel)
 	}
 	return false;
 }
+
+/**
+@brief Set the level of details for a render pass
+*/
+bool CLevelOfDetails::SetPassDetailLevel(const LOD_PASS ePass, const DETAIL_LEVEL eDetailLevel)
+{
+	if ((ePass >= MAIN_PASS) && (ePass < NUM_LOD_PASS) &&
+		(eDetailLevel >= HIGH_DETAILS) && (eDetailLevel < NUM_DETAIL_LEVEL))
+	{
+		arrPassDetailLevel[ePass] = eDetailLevel;
+		return true;
+	}
+	return false;
+}
+
+/**
+@brief Get the level of details for a render pass
+*/
+CLevelOfDetails::DETAIL_LEVEL CLevelOfDetails::GetPassDetailLevel(const LOD_PASS ePass) const
+{
+	return arrPassDetailLevel[ePass];
+}
+
+/**
+@brief Use the level of details of a render pass as the current level of details
+*/
+void CLevelOfDetails::UsePass(const LOD_PASS ePass)
+{
+	if (m_bLODStatus)
+		eDetailLevel = arrPassDetailLevel[ePass];
+}
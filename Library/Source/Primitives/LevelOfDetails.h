@@ -17,6 +17,14 @@ public:
 		NUM_DETAIL_LEVEL
 	};
 
+	// The render passes which select their own level of details
+	enum LOD_PASS
+	{
+		MAIN_PASS,
+		MINIMAP_PASS,
+		NUM_LOD_PASS
+	};
+
 	// Array containing the distances to switch LOD
 	float arrLODDistance[3];
 
@@ -35,11 +43,20 @@ public:
 	// Get the current level of details
 	virtual DETAIL_LEVEL GetDetailLevel(void) const;
 
+	// Set the level of details for a render pass
+	virtual bool SetPassDetailLevel(const LOD_PASS ePass, const DETAIL_LEVEL eDetailLevel);
+	// Get the level of details for a render pass
+	virtual DETAIL_LEVEL GetPassDetailLevel(const LOD_PASS ePass) const;
+	// Use the level of details of a render pass as the current level of details
+	virtual void UsePass(const LOD_PASS ePass);
+
 protected:
 	// Boolean flag to indicate if this LOD is active
 	bool m_bLODStatus;
 	// Variable storing the current level of details
 	DETAIL_LEVEL eDetailLevel;
+	// The level of details selected for each render pass
+	DETAIL_LEVEL arrPassDetailLevel[NUM_LOD_PASS];
 
 	// OpenGL objects using arrays
 	GLuint arrVAO[3];
@@ -49,4 +66,7 @@ protected:
 
 	// The texture ID in OpenGL
 	GLuint arriTextureID[3];
+
+	// The mesh ID in the CIndirectDrawBuffer, or -1 if it is not in the CIndirectDrawBuffer
+	int arriMeshID[3];
 };
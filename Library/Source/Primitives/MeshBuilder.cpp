@@ -163,9 +163,39 @@ CMesh* CMeshBuilder::GenerateBox(	const glm::vec4 color,
 									const float height, 
 									const float depth)
 {
-	Vertex v;
 	std::vector<Vertex> vertex_buffer_data;
 	std::vector<GLuint> index_buffer_data;
+	GenerateBoxData(vertex_buffer_data, index_buffer_data, color, width, height, depth);
+
+	CMesh* mesh = new CMesh();
+
+	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
+
+	mesh->indexSize = index_buffer_data.size();
+	mesh->mode = CMesh::DRAW_TRIANGLES;
+
+	return mesh;
+}
+
+/**
+ @brief Fill in the vertices and indices of a box without uploading them,
+		so that the geometry can be transformed and merged with other meshes
+ @param vertex_buffer_data A std::vector<Vertex>& variable which is filled with the vertices
+ @param index_buffer_data A std::vector<GLuint>& variable which is filled with the indices
+ */
+void CMeshBuilder::GenerateBoxData(	std::vector<Vertex>& vertex_buffer_data,
+									std::vector<GLuint>& index_buffer_data,
+									const glm::vec4 color,
+									const float width,
+									const float height,
+									const float depth)
+{
+	Vertex v;
+	vertex_buffer_data.clear();
+	index_buffer_data.clear();
 
 	// 0. Left-Bottom-Rear
 	v.position = glm::vec3(-0.5f * width, -0.5f * height, -0.5f * depth);
@@ -298,16 +328,4 @@ CMesh* CMeshBuilder::GenerateBox(	const glm::vec4 color,
 	index_buffer_data.push_back(12);
 	index_buffer_data.push_back(2);
 	index_buffer_data.push_back(3);
-
-	CMesh* mesh = new CMesh();
-
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
-
-	mesh->indexSize = index_buffer_data.size();
-	mesh->mode = CMesh::DRAW_TRIANGLES;
-
-	return mesh;
 }
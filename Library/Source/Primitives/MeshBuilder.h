@@ -12,6 +12,8 @@
 #include "Mesh.h"
 #include "SpriteAnimation.h"
 
+#include <vector>
+
 class CMeshBuilder
 {
 	public:
@@ -24,6 +26,12 @@ class CMeshBuilder
 												const float width = 1.0f, 
 												const float height = 1.0f);
 		static CMesh* GenerateBox(glm::vec4 color = glm::vec4(1, 1, 1, 1), float width = 1.0f, float height = 1.0f, float depth = 1.0f);
+		static void GenerateBoxData(std::vector<Vertex>& vertex_buffer_data,
+									std::vector<unsigned int>& index_buffer_data,
+									const glm::vec4 color = glm::vec4(1, 1, 1, 1),
+									const float width = 1.0f,
+									const float height = 1.0f,
+									const float depth = 1.0f);
 };
 
 #endif
\ No newline at end of file
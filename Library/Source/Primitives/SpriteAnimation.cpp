@@ -20,10 +20,7 @@ CSpriteAnimation::CSpriteAnimation(int row, int col)
 	: CMesh()
 	, row(row)
 	, col(col)
-	, currentTime(0)
-	, currentFrame(0)
-	, playCount(0)
-	, currentAnimation("")
+	, instanceID(CAnimationSystem::GetInstance()->AddInstance())
 {
 }
 
@@ -35,15 +32,8 @@ Destructor
 /******************************************************************************/
 CSpriteAnimation::~CSpriteAnimation()
 {
-	//Loop through the animation list
-	for (auto iter = animationList.begin(); iter != animationList.end(); ++iter)
-	{
-		if (iter->second != NULL)
-		{
-			//delete the animation
-			delete iter->second;
-		}
-	}
+	//Remove this sprite from the animation system. The compiled clips are kept, as other sprites may share them.
+	CAnimationSystem::GetInstance()->RemoveInstance(instanceID);
 	//Remove everything
 	animationList.clear();
 }
@@ -61,46 +51,8 @@ param dt - the delta time
 /******************************************************************************/
 void CSpriteAnimation::Update(double dt)
 {
-	//Check if the current animation is active
-	if (animationList[currentAnimation]->animActive)
-	{
-		//Add the delta time
-		currentTime += static_cast<float>(dt);
-
-		//Get the number of frame to get the frame per second
-		int numFrame = animationList[currentAnimation]->frames.size();
-		float frameTime = animationList[currentAnimation]->animTime / numFrame;
-
-		//Set the current frame based on the current time
-		currentFrame = animationList[currentAnimation]->frames[fmin((int)animationList[currentAnimation]->frames.size() - 1 , static_cast<int>(currentTime / frameTime))];
-
-		//check if the current time is more than the total animated time
-		if (currentTime >= animationList[currentAnimation]->animTime)
-		{
-			//if it is less than the repeat count, increase the count and repeat
-			if (playCount < animationList[currentAnimation]->repeatCount)
-			{
-				++playCount;
-				currentTime = 0;
-				currentFrame = animationList[currentAnimation]->frames[0];
-			}
-			//if we repeat count is 0 or we have reach same number of play count
-			else
-			{
-				animationList[currentAnimation]->animActive = false;
-				animationList[currentAnimation]->ended = true;
-			}
-
-			//If the animaton is infinite
-			if (animationList[currentAnimation]->repeatCount == -1)
-			{
-				currentTime = 0.f;
-				currentFrame = animationList[currentAnimation]->frames[0];
-				animationList[currentAnimation]->animActive = true;
-				animationList[currentAnimation]->ended = false;
-			}
-		}
-	}
+	//The animation system keeps the time and the frame of this sprite
+	CAnimationSystem::GetInstance()->UpdateInstance(instanceID, dt);
 }
 
 /******************************************************************************/
@@ -128,6 +80,7 @@ void CSpriteAnimation::Render()
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
 
 	//Draw based on the current frame
+	const int currentFrame = GetCurrentFrame();
 	if (mode == DRAW_LINES)
 		glDrawElements(GL_LINES, 6, GL_UNSIGNED_INT, (void*)(currentFrame * 6 * sizeof(GLuint)));
 	else if (mode == DRAW_TRIANGLE_STRIP)
@@ -157,7 +110,7 @@ param end - the ending frame based on the sprite sheet
 /******************************************************************************/
 void CSpriteAnimation::AddAnimation(std::string anim_name, int start, int end)
 {
-	CAnimation* anim = new CAnimation();
+	std::vector<int> frames;
 
 	//Check if start is more than end
 	//Swap over if it is
@@ -167,17 +120,10 @@ void CSpriteAnimation::AddAnimation(std::string anim_name, int start, int end)
 	//Add in all the frames in the range
 	for (int i = start; i < end; ++i)
 	{
-		anim->AddFrame(i);
+		frames.push_back(i);
 	}
 
-	//Link the animation to the animation list
-	animationList[anim_name] = anim;
-	//Set the current animation if it does not exisit
-	if (currentAnimation == "")
-	{
-		currentAnimation = anim_name;
-	}
-	animationList[anim_name]->animActive = false;
+	AddClip(anim_name, frames);
 }
 
 /******************************************************************************/
@@ -197,7 +143,7 @@ param ... - the frames
 /******************************************************************************/
 void CSpriteAnimation::AddSequeneAnimation(std::string anim_name, int count ...)
 {
-	CAnimation* anim = new CAnimation();
+	std::vector<int> frames;
 
 	va_list args;
 	va_start(args, count);
@@ -205,18 +151,39 @@ void CSpriteAnimation::AddSequeneAnimation(std::string anim_name, int count ...)
 	for (int i = 0; i < count; ++i)
 	{
 		int value = va_arg(args, int);
-		anim->AddFrame(value);
+		frames.push_back(value);
 	}
 	va_end(args);
 
+	AddClip(anim_name, frames);
+}
+
+/******************************************************************************/
+/*!
+\brief
+Compile the frames of an animation into a clip of the CAnimationSystem, with
+the texture rectangle of each frame, and link it to its name
+
+param anim_name - the name of the animation
+
+param frames - the frames based on the sprite sheet
+
+\exception None
+\return None
+*/
+/******************************************************************************/
+void CSpriteAnimation::AddClip(const std::string& anim_name, const std::vector<int>& frames)
+{
+	CAnimationSystem* cAnimationSystem = CAnimationSystem::GetInstance();
+	const int clipID = cAnimationSystem->AddClip(frames, row, col);
+
 	//Link the animation to the animation list
-	animationList[anim_name] = anim;
-	//Set the current animation if it does not exisit
-	if (currentAnimation == "")
+	animationList[anim_name] = clipID;
+	//Set the current animation if it does not exisit, without playing it
+	if (cAnimationSystem->GetClip(instanceID) == -1)
 	{
-		currentAnimation = anim_name;
+		cAnimationSystem->SetClip(instanceID, clipID);
 	}
-	animationList[anim_name]->animActive = false;
 }
 
 /******************************************************************************/
@@ -236,14 +203,53 @@ param time - the total time of the animation
 /******************************************************************************/
 void CSpriteAnimation::PlayAnimation(std::string anim_name, int repeat, float time)
 {
-	//Check if the anim name exist 
-	if (animationList[anim_name] != nullptr)
+	PlayAnimation(GetAnimationID(anim_name), repeat, time);
+}
+
+/******************************************************************************/
+/*!
+\brief
+Play the animation based on the given ID, which is found once with
+GetAnimationID, so that no name is looked up when it is played in every frame
+
+param animationID - the ID of the animation
+
+param repeat - the number of repeats (-1 for infinite looping)
+
+param time - the total time of the animation
+
+\exception None
+\return None
+*/
+/******************************************************************************/
+void CSpriteAnimation::PlayAnimation(int animationID, int repeat, float time)
+{
+	//Check if the animation exist
+	if (animationID >= 0)
 	{
-		currentAnimation = anim_name;
-		animationList[anim_name]->Set(repeat, time, true);
+		CAnimationSystem::GetInstance()->Play(instanceID, animationID, repeat, time);
 	}
 }
 
+/******************************************************************************/
+/*!
+\brief
+Get the ID of an animation
+
+param anim_name - the name of the animation
+
+\exception None
+\return The ID of the animation, or -1 if it does not exist
+*/
+/******************************************************************************/
+int CSpriteAnimation::GetAnimationID(const std::string& anim_name) const
+{
+	auto iter = animationList.find(anim_name);
+	if (iter == animationList.end())
+		return -1;
+	return iter->second;
+}
+
 /******************************************************************************/
 /*!
 \brief
@@ -255,7 +261,7 @@ Resume the current animation if it is Paused
 /******************************************************************************/
 void CSpriteAnimation::Resume()
 {
-	animationList[currentAnimation]->animActive = true;
+	CAnimationSystem::GetInstance()->SetActive(instanceID, true);
 }
 
 /******************************************************************************/
@@ -269,7 +275,7 @@ Pause the current animation
 /******************************************************************************/
 void CSpriteAnimation::Pause()
 {
-	animationList[currentAnimation]->animActive = false;
+	CAnimationSystem::GetInstance()->SetActive(instanceID, false);
 }
 
 /******************************************************************************/
@@ -283,6 +289,59 @@ Reset the current animation
 /******************************************************************************/
 void CSpriteAnimation::Reset()
 {
-	currentFrame = animationList[currentAnimation]->frames[0];
-	playCount = 0;
-}
\ No newline at end of file
+	CAnimationSystem::GetInstance()->Reset(instanceID);
+}
+
+/******************************************************************************/
+/*!
+\brief
+Get the current frame of the sprite sheet
+
+\exception None
+\return The current frame
+*/
+/******************************************************************************/
+int CSpriteAnimation::GetCurrentFrame() const
+{
+	return CAnimationSystem::GetInstance()->GetFrame(instanceID);
+}
+
+/******************************************************************************/
+/*!
+\brief
+Get the rectangle of a frame in the sprite sheet, in the same layout as
+CMeshBuilder::GenerateSpriteAnimation, for drawing it through a CSpriteBatcher
+
+param frame - the frame, counted along the rows from the top left
+
+\exception None
+\return The rectangle of the frame: u0, v0, u1, v1
+*/
+/******************************************************************************/
+glm::vec4 CSpriteAnimation::GetFrameUV(int frame) const
+{
+	float width = 1.f / col;
+	float height = 1.f / row;
+	float u1 = (frame % col) * width;
+	float v1 = 1.f - height - (frame / col) * height;
+	return glm::vec4(u1, v1, u1 + width, v1 + height);
+}
+
+/******************************************************************************/
+/*!
+\brief
+Get the rectangle of the current frame in the sprite sheet, which is read
+from the frame table of the CAnimationSystem instead of being calculated
+
+\exception None
+\return The rectangle of the frame: u0, v0, u1, v1
+*/
+/******************************************************************************/
+glm::vec4 CSpriteAnimation::GetCurrentFrameUV() const
+{
+	CAnimationSystem* cAnimationSystem = CAnimationSystem::GetInstance();
+	//A sprite without animations shows frame 0
+	if (cAnimationSystem->GetClip(instanceID) == -1)
+		return GetFrameUV(0);
+	return cAnimationSystem->GetFrameUV(instanceID);
+}
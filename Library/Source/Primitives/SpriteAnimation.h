@@ -5,8 +5,9 @@
 \par	email: 
 \brief
 Sprite Animation that hold different classes 
--Animation Class - Managed frames and name of the animation
--Sprite Animation - Managed various animations of the sprite  
+-Sprite Animation - Managed various animations of the sprite
+The animations are compiled into clips of the CAnimationSystem, which
+keeps the state of every animated sprite and updates them together
 */
 /******************************************************************************/
 #pragma once
@@ -16,50 +17,7 @@ Sprite Animation that hold different classes
 #include <unordered_map>
 #include <stdarg.h>
 #include <math.h>
-
-struct CAnimation
-{
-	//Constructor
-	CAnimation():repeatCount(0),
-		animTime(0.0f),
-		ended(false),
-		animActive(false)
-	{
-	}
-
-	//repeat count, total animation time, 
-	void Set(int repeat, float time, bool active)
-	{
-		this->repeatCount = repeat;
-		this->animTime = time;
-		this->animActive = active;
-	}
-
-	//Adding frames to the frame vector
-	void AddFrame(int i)
-	{
-		frames.push_back(i);
-	}
-
-private:
-	//name of the animation
-	std::string animationName;
-
-	//The frames
-	std::vector<int> frames;
-
-	//How many times to repeat
-	int repeatCount;
-	//The animation time
-	float animTime;
-	//Has the animation ended
-	bool ended;
-	//Is the animation active
-	bool animActive;
-
-	//Allow the Sprite Animation class to use private variable
-	friend class CSpriteAnimation;
-};
+#include "AnimationSystem.h"
 
 //Sprite Animation that derives from Mesh for rendering
 class CSpriteAnimation : public CMesh
@@ -75,25 +33,33 @@ public:
 	void AddAnimation(std::string name, int start, int end);
 	void AddSequeneAnimation(std::string name, int count ...);
 	void PlayAnimation(std::string name, int repeat, float time);
+	//Play an animation by the ID from GetAnimationID, without looking up its name
+	void PlayAnimation(int animationID, int repeat, float time);
+	//Get the ID of an animation, or -1 if it does not exist
+	int GetAnimationID(const std::string& name) const;
 	void Pause();
 	void Resume();
 	void Reset();
 
+	//Get the current frame of the sprite sheet
+	int GetCurrentFrame() const;
+	//Get the rectangle of a frame in the sprite sheet: u0, v0, u1, v1
+	glm::vec4 GetFrameUV(int frame) const;
+	//Get the rectangle of the current frame, from the frame table of the CAnimationSystem
+	glm::vec4 GetCurrentFrameUV() const;
+
 private:
 	//number of rows
 	int row;
 	//number of columns 
 	int col;
 
-	//the current time of the animation
-	float currentTime;
-	//the current frame of the animation
-	int currentFrame;
-	//How many time it has play
-	int playCount;
+	//The ID of this sprite in the CAnimationSystem, which keeps its current animation, time and frame
+	unsigned int instanceID;
+
+	//Add a compiled animation with its name
+	void AddClip(const std::string& name, const std::vector<int>& frames);
 
-	//The name of the current animation
-	std::string currentAnimation;
-	//The list of the animations with their names
-	std::unordered_map<std::string, CAnimation*> animationList;
+	//The IDs of the animations in the CAnimationSystem, by their names
+	std::unordered_map<std::string, int> animationList;
 };
@@ -0,0 +1,136 @@
+/**
+ CCameraUniformBuffer
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#include "CameraUniformBuffer.h"
+
+#include <iostream>
+using namespace std;
+
+const char* CCameraUniformBuffer::BLOCK_NAME = "Camera";
+
+/**
+ @brief Constructor
+ */
+CCameraUniformBuffer::CCameraUniformBuffer(void)
+	: UBO(0)
+	, iSlotSize(sizeof(CameraBlock))
+	, uiNextSlot(0)
+{
+	sCurrent.view = glm::mat4(1.0f);
+	sCurrent.projection = glm::mat4(1.0f);
+	sCurrent.viewProjection = glm::mat4(1.0f);
+	sCurrent.cameraPosition = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+/**
+ @brief Destructor
+ */
+CCameraUniformBuffer::~CCameraUniformBuffer(void)
+{
+	if (UBO != 0)
+	{
+		glDeleteBuffers(1, &UBO);
+		UBO = 0;
+	}
+}
+
+/**
+ @brief Initialise this class instance
+ @return true if the initialisation is successful, else false
+ */
+bool CCameraUniformBuffer::Init(void)
+{
+	if (UBO != 0)
+		return true;
+
+	// Each slot must start at a multiple of the offset alignment for glBindBufferRange
+	GLint iAlignment = 256;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &iAlignment);
+	if (iAlignment <= 0)
+		iAlignment = 256;
+	iSlotSize = ((sizeof(CameraBlock) + iAlignment - 1) / iAlignment) * iAlignment;
+
+	glGenBuffers(1, &UBO);
+	if (UBO == 0)
+	{
+		cout << "CCameraUniformBuffer::Init() - Unable to create the uniform buffer" << endl;
+		return false;
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+	glBufferData(GL_UNIFORM_BUFFER, iSlotSize * uiNumSlots, NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	uiNextSlot = 0;
+	return true;
+}
+
+/**
+ @brief Bind the uniform block of a shader program to BINDING_POINT, if the shader has one
+ @param uiProgramID A const GLuint variable containing the ID of the shader program
+ */
+void CCameraUniformBuffer::BindShader(const GLuint uiProgramID)
+{
+	const GLuint uiBlockIndex = glGetUniformBlockIndex(uiProgramID, BLOCK_NAME);
+	if (uiBlockIndex != GL_INVALID_INDEX)
+		glUniformBlockBinding(uiProgramID, uiBlockIndex, BINDING_POINT);
+}
+
+/**
+ @brief Start a render pass by uploading its camera and binding it to BINDING_POINT
+ @param view A const glm::mat4& variable containing the view matrix of the render pass
+ @param projection A const glm::mat4& variable containing the projection matrix of the render pass
+ */
+void CCameraUniformBuffer::BeginPass(const glm::mat4& view, const glm::mat4& projection)
+{
+	sCurrent.view = view;
+	sCurrent.projection = projection;
+	sCurrent.viewProjection = projection * view;
+	// The camera is at the translation of the inverse of the view matrix
+	sCurrent.cameraPosition = glm::vec4(glm::vec3(glm::inverse(view)[3]), 1.0f);
+
+	if (UBO == 0)
+		return;
+
+	glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+	if (uiNextSlot >= uiNumSlots)
+	{
+		// Orphan the ring so that the driver gives a new buffer instead of waiting for the old one
+		glBufferData(GL_UNIFORM_BUFFER, iSlotSize * uiNumSlots, NULL, GL_STREAM_DRAW);
+		uiNextSlot = 0;
+	}
+	const GLintptr iOffset = iSlotSize * uiNextSlot;
+	glBufferSubData(GL_UNIFORM_BUFFER, iOffset, sizeof(CameraBlock), &sCurrent);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	glBindBufferRange(GL_UNIFORM_BUFFER, BINDING_POINT, UBO, iOffset, sizeof(CameraBlock));
+	uiNextSlot++;
+}
+
+/**
+ @brief Get the view matrix of the current render pass
+ @return The view matrix
+ */
+const glm::mat4& CCameraUniformBuffer::GetView(void) const
+{
+	return sCurrent.view;
+}
+
+/**
+ @brief Get the projection matrix of the current render pass
+ @return The projection matrix
+ */
+const glm::mat4& CCameraUniformBuffer::GetProjection(void) const
+{
+	return sCurrent.projection;
+}
+
+/**
+ @brief Get the camera position of the current render pass
+ @return The camera position
+ */
+glm::vec3 CCameraUniformBuffer::GetCameraPosition(void) const
+{
+	return glm::vec3(sCurrent.cameraPosition);
+}
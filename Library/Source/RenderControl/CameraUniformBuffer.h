@@ -0,0 +1,82 @@
+/**
+ CCameraUniformBuffer
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "../DesignPatterns/SingletonTemplate.h"
+
+// Include GLEW
+#ifndef GLEW_STATIC
+#include <GL/glew.h>
+#define GLEW_STATIC
+#endif
+
+// Include GLM
+#include <includes/glm.hpp>
+#include <includes/gtc/matrix_transform.hpp>
+#include <includes/gtc/type_ptr.hpp>
+
+// Holds the camera of the current render pass in a std140 uniform buffer, which every shader
+// with a "Camera" uniform block reads from. The camera is uploaded once per pass instead of
+// once per entity, so the entities only upload their model matrix.
+// The 3D vertex shaders declare the block with the same members, in the same order, as CameraBlock:
+//	layout (std140) uniform Camera { mat4 view; mat4 projection; mat4 viewProjection; vec4 cameraPosition; };
+// Each pass is written to the next slot of a ring, so the driver does not wait for earlier
+// draws which still read the previous slots.
+class CCameraUniformBuffer : public CSingletonTemplate<CCameraUniformBuffer>
+{
+	friend CSingletonTemplate<CCameraUniformBuffer>;
+
+public:
+	// The name of the uniform block in the shaders
+	static const char* BLOCK_NAME;
+	// The uniform buffer binding point of the uniform block
+	static const GLuint BINDING_POINT = 0;
+
+	// The layout of the uniform block in std140
+	struct CameraBlock
+	{
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::mat4 viewProjection;
+		glm::vec4 cameraPosition;
+	};
+
+	// Initialise this class instance
+	bool Init(void);
+
+	// Bind the uniform block of a shader program to BINDING_POINT, if the shader has one
+	static void BindShader(const GLuint uiProgramID);
+
+	// Start a render pass by uploading its camera and binding it to BINDING_POINT
+	void BeginPass(const glm::mat4& view, const glm::mat4& projection);
+
+	// Get the view matrix of the current render pass
+	const glm::mat4& GetView(void) const;
+	// Get the projection matrix of the current render pass
+	const glm::mat4& GetProjection(void) const;
+	// Get the camera position of the current render pass
+	glm::vec3 GetCameraPosition(void) const;
+
+protected:
+	// The number of render passes which can be uploaded before the ring is orphaned
+	static const unsigned int uiNumSlots = 64;
+
+	// The uniform buffer object
+	GLuint UBO;
+	// The size of each slot, rounded up to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+	GLsizeiptr iSlotSize;
+	// The next slot to write to
+	unsigned int uiNextSlot;
+
+	// A copy of the camera of the current render pass
+	CameraBlock sCurrent;
+
+	// Constructor
+	CCameraUniformBuffer(void);
+	// Destructor
+	virtual ~CCameraUniformBuffer(void);
+};
@@ -0,0 +1,458 @@
+/**
+ CIndirectDrawBuffer
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#include "IndirectDrawBuffer.h"
+
+// Include ShaderManager
+#include "ShaderManager.h"
+
+// Include Settings
+#include "../GameControl/Settings.h"
+
+// Include CLogger
+#include "../System/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor
+ */
+CIndirectDrawBuffer::CIndirectDrawBuffer(void)
+	: VAO(0)
+	, VBO(0)
+	, IBO(0)
+	, bGeometryDirty(false)
+	, uiCommandBuffer(0)
+	, uiModelBuffer(0)
+	, uiRegion(0)
+	, bInitialised(false)
+	, bIndirectSupported(false)
+	, bIndirectEnabled(true)
+	, uiNumDraws(0)
+	, uiNumDrawCalls(0)
+{
+	for (unsigned int i = 0; i < uiNumRegions; i++)
+		arrFence[i] = 0;
+}
+
+/**
+ @brief Destructor
+ */
+CIndirectDrawBuffer::~CIndirectDrawBuffer(void)
+{
+	for (unsigned int i = 0; i < uiNumRegions; i++)
+	{
+		if (arrFence[i] != 0)
+		{
+			glDeleteSync(arrFence[i]);
+			arrFence[i] = 0;
+		}
+	}
+
+	if (VAO != 0)
+		glDeleteVertexArrays(1, &VAO);
+	if (VBO != 0)
+		glDeleteBuffers(1, &VBO);
+	if (IBO != 0)
+		glDeleteBuffers(1, &IBO);
+	if (uiCommandBuffer != 0)
+		glDeleteBuffers(1, &uiCommandBuffer);
+	if (uiModelBuffer != 0)
+		glDeleteBuffers(1, &uiModelBuffer);
+}
+
+/**
+ @brief Initialise this class instance
+ @param sShaderName A const std::string& variable containing the name of the shader which reads
+		the model matrix from MODEL_ATTRIBUTE
+ @return true if the initialisation is successful, else false
+ */
+bool CIndirectDrawBuffer::Init(const std::string& sShaderName)
+{
+	if (bInitialised)
+		return true;
+
+	this->sShaderName = sShaderName;
+
+	// glMultiDrawElementsIndirect needs the base instance to select the model matrix of each draw
+	bIndirectSupported = ((GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect) &&
+						  (GLEW_VERSION_4_2 || GLEW_ARB_base_instance));
+	bIndirectEnabled = CSettings::GetInstance()->bUseMultiDrawIndirect;
+
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &IBO);
+	glGenBuffers(1, &uiCommandBuffer);
+	glGenBuffers(1, &uiModelBuffer);
+	if ((VAO == 0) || (VBO == 0) || (IBO == 0) || (uiCommandBuffer == 0) || (uiModelBuffer == 0))
+	{
+		cout << "CIndirectDrawBuffer::Init() - Unable to create the buffers" << endl;
+		return false;
+	}
+
+	const GLsizeiptr iCommandSize = sizeof(DrawElementsIndirectCommand) * uiMaxDraws * uiNumRegions;
+	const GLsizeiptr iModelSize = sizeof(glm::mat4) * uiMaxDraws * uiNumRegions;
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, uiCommandBuffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, iCommandSize, NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	glBindBuffer(GL_ARRAY_BUFFER, uiModelBuffer);
+	glBufferData(GL_ARRAY_BUFFER, iModelSize, NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// The vertex layout matches ModelVertex: position, normal and texture coordinates.
+	// The model matrix is an instanced attribute which advances once per draw.
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)(sizeof(glm::vec3) + sizeof(glm::vec3)));
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)sizeof(glm::vec3));
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+	for (GLuint i = 0; i < 4; i++)
+	{
+		glEnableVertexAttribArray(MODEL_ATTRIBUTE + i);
+		glVertexAttribDivisor(MODEL_ATTRIBUTE + i, 1);
+	}
+	SetModelAttribute(0);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	vDraw.reserve(uiMaxDraws);
+	vCommand.resize(uiMaxDraws);
+	uiRegion = 0;
+	bInitialised = true;
+
+	LOG_INFO(RENDER, "CIndirectDrawBuffer: glMultiDrawElementsIndirect is %s",
+			 (bIndirectSupported && bIndirectEnabled) ? "enabled" : "disabled, using the fallback loop");
+
+	return true;
+}
+
+/**
+ @brief Check if this class instance has been initialised
+ @return A bool variable
+ */
+bool CIndirectDrawBuffer::IsInitialised(void) const
+{
+	return bInitialised;
+}
+
+/**
+ @brief Add a mesh to the shared buffers, or get the mesh which was already added with the same key.
+		The shared buffers are uploaded again in the next Flush().
+ @param sKey A const std::string& variable containing the key of the mesh, such as the path of its model
+ @param vVertices A const vector<ModelVertex>& variable containing the vertices of the mesh
+ @param vIndices A const vector<GLuint>& variable containing the indices of the mesh
+ @return The ID of the mesh, or -1 if it could not be added
+ */
+int CIndirectDrawBuffer::AddMesh(	const std::string& sKey,
+									const vector<ModelVertex>& vVertices,
+									const vector<GLuint>& vIndices)
+{
+	int iMeshID = FindMesh(sKey);
+	if (iMeshID >= 0)
+		return iMeshID;
+
+	if ((!bInitialised) || (vVertices.empty()) || (vIndices.empty()))
+		return -1;
+
+	Mesh sMesh;
+	sMesh.uiFirstIndex = this->vIndices.size();
+	sMesh.uiNumIndices = vIndices.size();
+	sMesh.iBaseVertex = this->vVertices.size();
+
+	this->vVertices.insert(this->vVertices.end(), vVertices.begin(), vVertices.end());
+	this->vIndices.insert(this->vIndices.end(), vIndices.begin(), vIndices.end());
+	bGeometryDirty = true;
+
+	iMeshID = vMesh.size();
+	vMesh.push_back(sMesh);
+	mMeshKey[sKey] = iMeshID;
+
+	return iMeshID;
+}
+
+/**
+ @brief Get the mesh which was added with a key
+ @param sKey A const std::string& variable containing the key of the mesh
+ @return The ID of the mesh, or -1 if there is none
+ */
+int CIndirectDrawBuffer::FindMesh(const std::string& sKey) const
+{
+	map<std::string, int>::const_iterator it = mMeshKey.find(sKey);
+	if (it == mMeshKey.end())
+		return -1;
+	return it->second;
+}
+
+/**
+ @brief Start a render pass by removing the draws of the previous pass
+ */
+void CIndirectDrawBuffer::Begin(void)
+{
+	vDraw.clear();
+}
+
+/**
+ @brief Add a draw of a mesh to the current render pass. Nothing is sent to OpenGL until Flush().
+ @param iMeshID A const int variable containing the ID of the mesh
+ @param iTextureID A const GLuint variable containing the texture of the draw
+ @param model A const glm::mat4& variable containing the model matrix of the draw
+ @return true if the draw was added, else false
+ */
+bool CIndirectDrawBuffer::Submit(const int iMeshID, const GLuint iTextureID, const glm::mat4& model)
+{
+	if ((!bInitialised) || (iMeshID < 0) || (iMeshID >= (int)vMesh.size()))
+		return false;
+
+	if (vDraw.size() >= uiMaxDraws)
+	{
+		LOG_DEBUG_EVERY(1.0, RENDER, "CIndirectDrawBuffer: more than %u draws in a render pass", uiMaxDraws);
+		return false;
+	}
+
+	Draw sDraw;
+	sDraw.iTextureID = iTextureID;
+	sDraw.iMeshID = iMeshID;
+	sDraw.model = model;
+	vDraw.push_back(sDraw);
+	return true;
+}
+
+/**
+ @brief Render the draws of the current render pass.
+		The draws are sorted by texture, and each run of draws with the same texture is one
+		glMultiDrawElementsIndirect, or one glDrawElementsInstancedBaseVertex per draw in the fallback loop.
+ @return The number of OpenGL draw calls made
+ */
+unsigned int CIndirectDrawBuffer::Flush(void)
+{
+	uiNumDraws = 0;
+	uiNumDrawCalls = 0;
+	if ((!bInitialised) || (vDraw.empty()))
+		return 0;
+
+	if (bGeometryDirty)
+		UploadGeometry();
+
+	sort(vDraw.begin(), vDraw.end(), [](const Draw& a, const Draw& b)
+	{
+		if (a.iTextureID != b.iTextureID)
+			return a.iTextureID < b.iTextureID;
+		return a.iMeshID < b.iMeshID;
+	});
+
+	// Build the commands of this pass. The base instance selects the model matrix of each draw.
+	const unsigned int uiFirst = uiRegion * uiMaxDraws;
+	uiNumDraws = vDraw.size();
+	DrawElementsIndirectCommand* pCommand = &vCommand[0];
+	for (unsigned int i = 0; i < uiNumDraws; i++)
+	{
+		const Mesh& sMesh = vMesh[vDraw[i].iMeshID];
+		pCommand[i].count = sMesh.uiNumIndices;
+		pCommand[i].instanceCount = 1;
+		pCommand[i].firstIndex = sMesh.uiFirstIndex;
+		pCommand[i].baseVertex = sMesh.iBaseVertex;
+		pCommand[i].baseInstance = uiFirst + i;
+	}
+
+	// Write the commands and the model matrices straight into the next region of the ring.
+	// The region is fenced, so it is mapped unsynchronised and the driver does not stall.
+	WaitForRegion(uiRegion);
+	const GLbitfield iMapFlags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, uiCommandBuffer);
+	void* pMapped = glMapBufferRange(	GL_DRAW_INDIRECT_BUFFER,
+										uiFirst * sizeof(DrawElementsIndirectCommand),
+										uiNumDraws * sizeof(DrawElementsIndirectCommand),
+										iMapFlags);
+	if (pMapped)
+	{
+		memcpy(pMapped, pCommand, uiNumDraws * sizeof(DrawElementsIndirectCommand));
+		glUnmapBuffer(GL_DRAW_INDIRECT_BUFFER);
+	}
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	glBindBuffer(GL_ARRAY_BUFFER, uiModelBuffer);
+	glm::mat4* pModel = (glm::mat4*)glMapBufferRange(	GL_ARRAY_BUFFER,
+														uiFirst * sizeof(glm::mat4),
+														uiNumDraws * sizeof(glm::mat4),
+														iMapFlags);
+	if (pModel)
+	{
+		for (unsigned int i = 0; i < uiNumDraws; i++)
+			pModel[i] = vDraw[i].model;
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// change depth function so depth test passes when values are equal to depth buffer's content
+	glDepthFunc(GL_LEQUAL);
+	CShaderManager::GetInstance()->Use(sShaderName);
+	glActiveTexture(GL_TEXTURE0);
+	glBindVertexArray(VAO);
+
+	const bool bUseIndirect = bIndirectSupported && bIndirectEnabled;
+	if (bUseIndirect)
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, uiCommandBuffer);
+
+	unsigned int uiRunStart = 0;
+	while (uiRunStart < uiNumDraws)
+	{
+		// Find the draws which share this texture
+		unsigned int uiRunEnd = uiRunStart + 1;
+		while ((uiRunEnd < uiNumDraws) && (vDraw[uiRunEnd].iTextureID == vDraw[uiRunStart].iTextureID))
+			uiRunEnd++;
+
+		glBindTexture(GL_TEXTURE_2D, vDraw[uiRunStart].iTextureID);
+		if (bUseIndirect)
+		{
+			glMultiDrawElementsIndirect(GL_TRIANGLES,
+										GL_UNSIGNED_INT,
+										(void*)((uiFirst + uiRunStart) * sizeof(DrawElementsIndirectCommand)),
+										uiRunEnd - uiRunStart,
+										0);
+			uiNumDrawCalls++;
+		}
+		else
+		{
+			// Without the base instance, point the model matrix attribute at each draw instead
+			for (unsigned int i = uiRunStart; i < uiRunEnd; i++)
+			{
+				SetModelAttribute(pCommand[i].baseInstance);
+				glDrawElementsInstancedBaseVertex(	GL_TRIANGLES,
+													pCommand[i].count,
+													GL_UNSIGNED_INT,
+													(void*)(pCommand[i].firstIndex * sizeof(GLuint)),
+													1,
+													pCommand[i].baseVertex);
+				uiNumDrawCalls++;
+			}
+		}
+		uiRunStart = uiRunEnd;
+	}
+
+	if (bUseIndirect)
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	else
+		SetModelAttribute(0);
+
+	glBindVertexArray(0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glDepthFunc(GL_LESS); // set depth function back to default
+
+	// Fence this region so that it is not overwritten while the GPU still reads it
+	arrFence[uiRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	uiRegion = (uiRegion + 1) % uiNumRegions;
+
+	vDraw.clear();
+
+	LOG_DEBUG_EVERY(5.0, RENDER, "CIndirectDrawBuffer: %u draws in %u draw calls", uiNumDraws, uiNumDrawCalls);
+
+	return uiNumDrawCalls;
+}
+
+/**
+ @brief Enable or disable glMultiDrawElementsIndirect. It is only used if it is supported.
+ @param bIndirectEnabled A const bool variable which is false to use the fallback loop
+ */
+void CIndirectDrawBuffer::SetIndirectEnabled(const bool bIndirectEnabled)
+{
+	this->bIndirectEnabled = bIndirectEnabled;
+}
+
+/**
+ @brief Check if glMultiDrawElementsIndirect is used
+ @return A bool variable
+ */
+bool CIndirectDrawBuffer::IsIndirectEnabled(void) const
+{
+	return bIndirectSupported && bIndirectEnabled;
+}
+
+/**
+ @brief Check if glMultiDrawElementsIndirect is supported by the OpenGL context
+ @return A bool variable
+ */
+bool CIndirectDrawBuffer::IsIndirectSupported(void) const
+{
+	return bIndirectSupported;
+}
+
+/**
+ @brief Get the number of draws rendered in the last Flush
+ @return An unsigned int variable
+ */
+unsigned int CIndirectDrawBuffer::GetNumDraws(void) const
+{
+	return uiNumDraws;
+}
+
+/**
+ @brief Get the number of OpenGL draw calls made in the last Flush
+ @return An unsigned int variable
+ */
+unsigned int CIndirectDrawBuffer::GetNumDrawCalls(void) const
+{
+	return uiNumDrawCalls;
+}
+
+/**
+ @brief Upload the shared geometry
+ */
+void CIndirectDrawBuffer::UploadGeometry(void)
+{
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, vVertices.size() * sizeof(ModelVertex), &vVertices[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, vIndices.size() * sizeof(GLuint), &vIndices[0], GL_STATIC_DRAW);
+	glBindVertexArray(0);
+
+	bGeometryDirty = false;
+}
+
+/**
+ @brief Point the model matrix attribute at a draw in the model buffer. The VAO must be bound.
+ @param uiFirstModel A const GLuint variable containing the index of the model matrix of the draw
+ */
+void CIndirectDrawBuffer::SetModelAttribute(const GLuint uiFirstModel)
+{
+	glBindBuffer(GL_ARRAY_BUFFER, uiModelBuffer);
+	for (GLuint i = 0; i < 4; i++)
+	{
+		glVertexAttribPointer(	MODEL_ATTRIBUTE + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+								(void*)(uiFirstModel * sizeof(glm::mat4) + i * sizeof(glm::vec4)));
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/**
+ @brief Wait until the GPU has finished the last pass which used a region
+ @param uiRegion A const unsigned int variable containing the region
+ */
+void CIndirectDrawBuffer::WaitForRegion(const unsigned int uiRegion)
+{
+	if (arrFence[uiRegion] == 0)
+		return;
+
+	GLenum eResult = glClientWaitSync(arrFence[uiRegion], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+	while (eResult == GL_TIMEOUT_EXPIRED)
+	{
+		// 1 millisecond
+		eResult = glClientWaitSync(arrFence[uiRegion], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+	}
+	glDeleteSync(arrFence[uiRegion]);
+	arrFence[uiRegion] = 0;
+}
@@ -0,0 +1,150 @@
+/**
+ CIndirectDrawBuffer
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "../DesignPatterns/SingletonTemplate.h"
+
+// Include GLEW
+#ifndef GLEW_STATIC
+#include <GL/glew.h>
+#define GLEW_STATIC
+#endif
+
+// Include GLM
+#include <includes/glm.hpp>
+#include <includes/gtc/matrix_transform.hpp>
+#include <includes/gtc/type_ptr.hpp>
+
+// Include LoadOBJ
+#include "../System/LoadOBJ.h"
+
+#include <string>
+#include <vector>
+#include <map>
+using namespace std;
+
+// Draws many meshes with one shader through glMultiDrawElementsIndirect.
+// The meshes are stored in one shared vertex and index buffer. During a render pass, the entities
+// Submit() a draw command and a model matrix, which are only written into memory. Flush() then
+// writes the commands and the matrices straight into a region of a ring of mapped buffers, which is
+// fenced instead of synchronised by the driver, and submits one glMultiDrawElementsIndirect per texture.
+// The model matrix of each draw is read as an instanced vertex attribute at its base instance.
+// Where GL_ARB_multi_draw_indirect or GL_ARB_base_instance is missing (or it is disabled in CSettings),
+// Flush() falls back to a loop of glDrawElementsInstancedBaseVertex over the same commands.
+class CIndirectDrawBuffer : public CSingletonTemplate<CIndirectDrawBuffer>
+{
+	friend CSingletonTemplate<CIndirectDrawBuffer>;
+
+public:
+	// The layout of a command in GL_DRAW_INDIRECT_BUFFER
+	struct DrawElementsIndirectCommand
+	{
+		GLuint count;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+	// The first vertex attribute location of the model matrix. It uses 4 locations, one per column.
+	static const GLuint MODEL_ATTRIBUTE = 3;
+
+	// Initialise this class instance
+	bool Init(const std::string& sShaderName);
+	// Check if this class instance has been initialised
+	bool IsInitialised(void) const;
+
+	// Add a mesh to the shared buffers, or get the mesh which was already added with the same key
+	int AddMesh(const std::string& sKey,
+				const vector<ModelVertex>& vVertices,
+				const vector<GLuint>& vIndices);
+	// Get the mesh which was added with a key, or -1 if there is none
+	int FindMesh(const std::string& sKey) const;
+
+	// Start a render pass by removing the draws of the previous pass
+	void Begin(void);
+	// Add a draw of a mesh to the current render pass
+	bool Submit(const int iMeshID, const GLuint iTextureID, const glm::mat4& model);
+	// Render the draws of the current render pass
+	unsigned int Flush(void);
+
+	// Enable or disable glMultiDrawElementsIndirect. It is only used if it is supported.
+	void SetIndirectEnabled(const bool bIndirectEnabled);
+	// Check if glMultiDrawElementsIndirect is used
+	bool IsIndirectEnabled(void) const;
+	// Check if glMultiDrawElementsIndirect is supported by the OpenGL context
+	bool IsIndirectSupported(void) const;
+
+	// Get the number of draws rendered in the last Flush
+	unsigned int GetNumDraws(void) const;
+	// Get the number of OpenGL draw calls made in the last Flush
+	unsigned int GetNumDrawCalls(void) const;
+
+protected:
+	// The maximum number of draws in a render pass
+	static const unsigned int uiMaxDraws = 1024;
+	// The number of render passes which can be in flight before Flush waits for the GPU
+	static const unsigned int uiNumRegions = 3;
+
+	// A mesh in the shared buffers
+	struct Mesh
+	{
+		GLuint uiFirstIndex;
+		GLuint uiNumIndices;
+		GLint iBaseVertex;
+	};
+
+	// A draw submitted in the current render pass
+	struct Draw
+	{
+		GLuint iTextureID;
+		int iMeshID;
+		glm::mat4 model;
+	};
+
+	// The shader which reads the model matrix from MODEL_ATTRIBUTE
+	std::string sShaderName;
+
+	// The shared geometry, and a copy of it which is uploaded when meshes are added
+	GLuint VAO, VBO, IBO;
+	vector<ModelVertex> vVertices;
+	vector<GLuint> vIndices;
+	bool bGeometryDirty;
+	vector<Mesh> vMesh;
+	map<std::string, int> mMeshKey;
+
+	// The buffers of the commands and the model matrices, split into uiNumRegions regions of uiMaxDraws
+	GLuint uiCommandBuffer;
+	GLuint uiModelBuffer;
+	// The fence of the last pass which used each region
+	GLsync arrFence[uiNumRegions];
+	unsigned int uiRegion;
+
+	// The draws of the current render pass
+	vector<Draw> vDraw;
+	// The commands of the current render pass, kept for the fallback loop
+	vector<DrawElementsIndirectCommand> vCommand;
+
+	bool bInitialised;
+	bool bIndirectSupported;
+	bool bIndirectEnabled;
+
+	unsigned int uiNumDraws;
+	unsigned int uiNumDrawCalls;
+
+	// Constructor
+	CIndirectDrawBuffer(void);
+	// Destructor
+	virtual ~CIndirectDrawBuffer(void);
+
+	// Upload the shared geometry
+	void UploadGeometry(void);
+	// Point the model matrix attribute at a draw in the model buffer
+	void SetModelAttribute(const GLuint uiFirstModel);
+	// Wait until the GPU has finished the last pass which used a region
+	void WaitForRegion(const unsigned int uiRegion);
+};
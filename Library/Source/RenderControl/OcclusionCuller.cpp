@@ -0,0 +1,535 @@
+#include "OcclusionCuller.h"
+
+// Include CSettings
+#include "../GameControl/Settings.h"
+
+// Include CLogger
+#include "../System/Logger.h"
+
+// Include SSE2
+#include <emmintrin.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+// The 12 triangles of a box, as indices of its corners. Bit 0, 1 and 2 of a corner select its max x, y and z
+static const unsigned int arrBoxIndex[36] = {
+	0, 2, 6,	0, 6, 4,	// -x
+	1, 5, 7,	1, 7, 3,	// +x
+	0, 4, 5,	0, 5, 1,	// -y
+	2, 3, 7,	2, 7, 6,	// +y
+	0, 1, 3,	0, 3, 2,	// -z
+	4, 6, 7,	4, 7, 5 };	// +z
+
+/**
+ @brief Constructor
+ */
+COcclusionCuller::COcclusionCuller(void)
+	: iOccluderGroup(0)
+	, viewProjection(glm::mat4(1.0f))
+	, bStart(false)
+	, bDone(true)
+	, bQuit(false)
+	, bInitialised(false)
+	, bEnabled(true)
+	, bRasterised(false)
+	, bCulling(false)
+	, uiNumTested(0)
+	, uiNumOccluded(0)
+	, uiLastNumTested(0)
+	, uiLastNumOccluded(0)
+	, dRasteriseTime(0.0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+COcclusionCuller::~COcclusionCuller(void)
+{
+	if (cThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> cLock(cMutex);
+			bQuit = true;
+		}
+		cStartCondition.notify_one();
+		cThread.join();
+	}
+}
+
+/**
+ @brief Initialise this class instance and start the worker thread
+ @return true if the initialisation is successful, else false
+ */
+bool COcclusionCuller::Init(void)
+{
+	if (bInitialised)
+		return true;
+
+	vDepth.assign(iBufferWidth * iBufferHeight, 1.0f);
+	bEnabled = CSettings::GetInstance()->bUseOcclusionCulling;
+
+	cThread = std::thread(&COcclusionCuller::Run, this);
+
+	bInitialised = true;
+
+	LOG_INFO(RENDER, "COcclusionCuller: %dx%d depth buffer, occlusion culling is %s",
+			 iBufferWidth, iBufferHeight, bEnabled ? "enabled" : "disabled");
+	return true;
+}
+
+/**
+ @brief Add a box in world space as an occluder. It must lie inside the geometry it stands for.
+ @param vec3BoxMin A const glm::vec3& variable containing the min corner of the box
+ @param vec3BoxMax A const glm::vec3& variable containing the max corner of the box
+ */
+void COcclusionCuller::AddOccluderBox(const glm::vec3& vec3BoxMin, const glm::vec3& vec3BoxMax)
+{
+	// The occluders must not change while the worker thread reads them
+	WaitForRasterise();
+
+	OccluderGroup& cGroup = GetOccluderGroup();
+	const unsigned int uiFirstVertex = cGroup.vVertex.size();
+	for (unsigned int i = 0; i < 8; i++)
+	{
+		cGroup.vVertex.push_back(glm::vec3(	(i & 1) ? vec3BoxMax.x : vec3BoxMin.x,
+											(i & 2) ? vec3BoxMax.y : vec3BoxMin.y,
+											(i & 4) ? vec3BoxMax.z : vec3BoxMin.z));
+	}
+	for (unsigned int i = 0; i < 36; i++)
+		cGroup.vIndex.push_back(uiFirstVertex + arrBoxIndex[i]);
+}
+
+/**
+ @brief Add a triangle mesh in world space as an occluder. It must lie inside the geometry it stands for.
+ @param vVertices A const vector<glm::vec3>& variable containing the vertices
+ @param vIndices A const vector<unsigned int>& variable containing 3 indices per triangle
+ */
+void COcclusionCuller::AddOccluderMesh(const vector<glm::vec3>& vVertices, const vector<unsigned int>& vIndices)
+{
+	WaitForRasterise();
+
+	OccluderGroup& cGroup = GetOccluderGroup();
+	const unsigned int uiFirstVertex = cGroup.vVertex.size();
+	cGroup.vVertex.insert(cGroup.vVertex.end(), vVertices.begin(), vVertices.end());
+	for (unsigned int i = 0; i + 2 < vIndices.size(); i += 3)
+	{
+		cGroup.vIndex.push_back(uiFirstVertex + vIndices[i]);
+		cGroup.vIndex.push_back(uiFirstVertex + vIndices[i + 1]);
+		cGroup.vIndex.push_back(uiFirstVertex + vIndices[i + 2]);
+	}
+}
+
+/**
+ @brief Remove the occluders which were added with a group, or all occluders if iGroup is -1
+ @param iGroup A const int variable containing the group
+ */
+void COcclusionCuller::ClearOccluders(const int iGroup)
+{
+	WaitForRasterise();
+
+	for (unsigned int i = 0; i < vOccluder.size(); )
+	{
+		if ((iGroup == -1) || (vOccluder[i].iGroup == iGroup))
+			vOccluder.erase(vOccluder.begin() + i);
+		else
+			i++;
+	}
+}
+
+/**
+ @brief Set the group of the occluders which are added after this
+ @param iGroup A const int variable containing the group
+ */
+void COcclusionCuller::SetOccluderGroup(const int iGroup)
+{
+	iOccluderGroup = iGroup;
+}
+
+/**
+ @brief Get the number of occluder triangles
+ @return An unsigned int variable
+ */
+unsigned int COcclusionCuller::GetNumOccluderTriangles(void) const
+{
+	unsigned int uiNumTriangles = 0;
+	for (unsigned int i = 0; i < vOccluder.size(); i++)
+		uiNumTriangles += vOccluder[i].vIndex.size() / 3;
+	return uiNumTriangles;
+}
+
+/**
+ @brief Start rasterising the occluders for a view-projection matrix on the worker thread
+ @param viewProjection A const glm::mat4& variable containing the view-projection matrix of the render pass to cull
+ */
+void COcclusionCuller::StartRasterise(const glm::mat4& viewProjection)
+{
+	bRasterised = false;
+	if ((bInitialised == false) || (bEnabled == false))
+		return;
+
+	WaitForRasterise();
+	this->viewProjection = viewProjection;
+	{
+		std::lock_guard<std::mutex> cLock(cMutex);
+		bDone = false;
+		bStart = true;
+	}
+	cStartCondition.notify_one();
+	bRasterised = true;
+}
+
+/**
+ @brief Wait for the depth buffer and start testing bounding boxes against it
+ */
+void COcclusionCuller::BeginCulling(void)
+{
+	if ((bRasterised == false) || (bEnabled == false))
+		return;
+
+	WaitForRasterise();
+	uiNumTested = 0;
+	uiNumOccluded = 0;
+	bCulling = true;
+}
+
+/**
+ @brief Stop testing bounding boxes and record the statistics of this frame
+ */
+void COcclusionCuller::EndCulling(void)
+{
+	if (bCulling == false)
+		return;
+
+	bCulling = false;
+	bRasterised = false;
+	uiLastNumTested = uiNumTested;
+	uiLastNumOccluded = uiNumOccluded;
+
+	LOG_DEBUG_EVERY(1.0, RENDER, "COcclusionCuller: %u of %u bounding boxes occluded, %u triangles rasterised in %.3f ms",
+					uiLastNumOccluded, uiLastNumTested, GetNumOccluderTriangles(), dRasteriseTime);
+}
+
+/**
+ @brief Check if bounding boxes are being tested
+ @return A bool variable
+ */
+bool COcclusionCuller::IsCulling(void) const
+{
+	return bCulling;
+}
+
+/**
+ @brief Check if a bounding box in world space may be visible. It is always visible if IsCulling() is false.
+ @param vec3BoxMin A const glm::vec3& variable containing the min corner of the bounding box
+ @param vec3BoxMax A const glm::vec3& variable containing the max corner of the bounding box
+ @return false if the bounding box is hidden behind the occluders, else true
+ */
+bool COcclusionCuller::IsVisible(const glm::vec3& vec3BoxMin, const glm::vec3& vec3BoxMax)
+{
+	if (bCulling == false)
+		return true;
+
+	uiNumTested++;
+
+	// Find the screen space rectangle and the nearest depth of the bounding box
+	glm::vec3 vec3ScreenMin = glm::vec3(FLT_MAX);
+	glm::vec3 vec3ScreenMax = glm::vec3(-FLT_MAX);
+	for (unsigned int i = 0; i < 8; i++)
+	{
+		const glm::vec4 vec4Clip = viewProjection * glm::vec4(	(i & 1) ? vec3BoxMax.x : vec3BoxMin.x,
+																(i & 2) ? vec3BoxMax.y : vec3BoxMin.y,
+																(i & 4) ? vec3BoxMax.z : vec3BoxMin.z,
+																1.0f);
+		// A bounding box which crosses the near plane is too close to be occluded
+		if (vec4Clip.z < -vec4Clip.w)
+			return true;
+
+		const glm::vec3 vec3Screen = ToScreen(vec4Clip);
+		vec3ScreenMin = glm::min(vec3ScreenMin, vec3Screen);
+		vec3ScreenMax = glm::max(vec3ScreenMax, vec3Screen);
+	}
+
+	// A bounding box outside the view is left to the frustum culling
+	if ((vec3ScreenMax.x < 0.0f) || (vec3ScreenMin.x >= (float)iBufferWidth) ||
+		(vec3ScreenMax.y < 0.0f) || (vec3ScreenMin.y >= (float)iBufferHeight))
+		return true;
+
+	const int iMinX = std::max(0, (int)floor(vec3ScreenMin.x));
+	const int iMaxX = std::min(iBufferWidth - 1, (int)floor(vec3ScreenMax.x));
+	const int iMinY = std::max(0, (int)floor(vec3ScreenMin.y));
+	const int iMaxY = std::min(iBufferHeight - 1, (int)floor(vec3ScreenMax.y));
+
+	// The bounding box is visible if any pixel in its rectangle has no occluder nearer than it
+	const __m128 mNearest = _mm_set1_ps(vec3ScreenMin.z);
+	const __m128 mLane = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+	const __m128 mMinX = _mm_set1_ps((float)iMinX);
+	const __m128 mMaxX = _mm_set1_ps((float)iMaxX);
+	for (int y = iMinY; y <= iMaxY; y++)
+	{
+		const float* pRow = &vDepth[y * iBufferWidth];
+		for (int x = iMinX & ~3; x <= iMaxX; x += 4)
+		{
+			const __m128 mX = _mm_add_ps(_mm_set1_ps((float)x), mLane);
+			const __m128 mInside = _mm_and_ps(_mm_cmpge_ps(mX, mMinX), _mm_cmple_ps(mX, mMaxX));
+			const __m128 mVisible = _mm_and_ps(mInside, _mm_cmpge_ps(_mm_loadu_ps(pRow + x), mNearest));
+			if (_mm_movemask_ps(mVisible) != 0)
+				return true;
+		}
+	}
+
+	uiNumOccluded++;
+	return false;
+}
+
+/**
+ @brief Enable or disable the occlusion culling
+ @param bEnabled A const bool variable
+ */
+void COcclusionCuller::SetEnabled(const bool bEnabled)
+{
+	this->bEnabled = bEnabled;
+}
+
+/**
+ @brief Check if the occlusion culling is enabled
+ @return A bool variable
+ */
+bool COcclusionCuller::IsEnabled(void) const
+{
+	return bEnabled;
+}
+
+/**
+ @brief Get the number of bounding boxes tested in the last frame
+ @return An unsigned int variable
+ */
+unsigned int COcclusionCuller::GetNumTested(void) const
+{
+	return uiLastNumTested;
+}
+
+/**
+ @brief Get the number of bounding boxes which were occluded in the last frame
+ @return An unsigned int variable
+ */
+unsigned int COcclusionCuller::GetNumOccluded(void) const
+{
+	return uiLastNumOccluded;
+}
+
+/**
+ @brief Get the time taken by the worker thread to rasterise the occluders in the last frame, in milliseconds
+ @return A double variable
+ */
+double COcclusionCuller::GetRasteriseTime(void) const
+{
+	return dRasteriseTime;
+}
+
+/**
+ @brief Get the occluders of the current group, or add them
+ @return An OccluderGroup& variable
+ */
+COcclusionCuller::OccluderGroup& COcclusionCuller::GetOccluderGroup(void)
+{
+	for (unsigned int i = 0; i < vOccluder.size(); i++)
+	{
+		if (vOccluder[i].iGroup == iOccluderGroup)
+			return vOccluder[i];
+	}
+
+	OccluderGroup cGroup;
+	cGroup.iGroup = iOccluderGroup;
+	vOccluder.push_back(cGroup);
+	return vOccluder.back();
+}
+
+/**
+ @brief Wait until the worker thread has finished rasterising
+ */
+void COcclusionCuller::WaitForRasterise(void)
+{
+	std::unique_lock<std::mutex> cLock(cMutex);
+	cDoneCondition.wait(cLock, [this] { return bDone; });
+}
+
+/**
+ @brief The loop run by the worker thread
+ */
+void COcclusionCuller::Run(void)
+{
+	std::unique_lock<std::mutex> cLock(cMutex);
+	while (true)
+	{
+		cStartCondition.wait(cLock, [this] { return bStart || bQuit; });
+		if (bQuit)
+			break;
+		bStart = false;
+
+		cLock.unlock();
+		Rasterise();
+		cLock.lock();
+
+		bDone = true;
+		cDoneCondition.notify_all();
+	}
+}
+
+/**
+ @brief Rasterise all occluders into the depth buffer
+ */
+void COcclusionCuller::Rasterise(void)
+{
+	const std::chrono::steady_clock::time_point cStart = std::chrono::steady_clock::now();
+
+	std::fill(vDepth.begin(), vDepth.end(), 1.0f);
+
+	for (unsigned int i = 0; i < vOccluder.size(); i++)
+	{
+		const OccluderGroup& cGroup = vOccluder[i];
+
+		vClipVertex.resize(cGroup.vVertex.size());
+		for (unsigned int j = 0; j < cGroup.vVertex.size(); j++)
+			vClipVertex[j] = viewProjection * glm::vec4(cGroup.vVertex[j], 1.0f);
+
+		for (unsigned int j = 0; j + 2 < cGroup.vIndex.size(); j += 3)
+		{
+			RasteriseClipped(	vClipVertex[cGroup.vIndex[j]],
+								vClipVertex[cGroup.vIndex[j + 1]],
+								vClipVertex[cGroup.vIndex[j + 2]]);
+		}
+	}
+
+	dRasteriseTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cStart).count();
+}
+
+/**
+ @brief Clip a triangle against the near plane and rasterise the result
+ @param v0 A const glm::vec4& variable containing the 1st vertex in clip space
+ @param v1 A const glm::vec4& variable containing the 2nd vertex in clip space
+ @param v2 A const glm::vec4& variable containing the 3rd vertex in clip space
+ */
+void COcclusionCuller::RasteriseClipped(const glm::vec4& v0, const glm::vec4& v1, const glm::vec4& v2)
+{
+	const glm::vec4 arrIn[3] = { v0, v1, v2 };
+	// The distance of each vertex in front of the near plane
+	const float arrDistance[3] = { v0.z + v0.w, v1.z + v1.w, v2.z + v2.w };
+
+	if ((arrDistance[0] >= 0.0f) && (arrDistance[1] >= 0.0f) && (arrDistance[2] >= 0.0f))
+	{
+		RasteriseTriangle(ToScreen(v0), ToScreen(v1), ToScreen(v2));
+		return;
+	}
+	if ((arrDistance[0] < 0.0f) && (arrDistance[1] < 0.0f) && (arrDistance[2] < 0.0f))
+		return;
+
+	// Clipping a triangle against one plane leaves a polygon of 3 or 4 vertices
+	glm::vec3 arrOut[4];
+	unsigned int uiNumOut = 0;
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		const unsigned int j = (i + 1) % 3;
+		if (arrDistance[i] >= 0.0f)
+			arrOut[uiNumOut++] = ToScreen(arrIn[i]);
+		if ((arrDistance[i] >= 0.0f) != (arrDistance[j] >= 0.0f))
+		{
+			const float t = arrDistance[i] / (arrDistance[i] - arrDistance[j]);
+			arrOut[uiNumOut++] = ToScreen(arrIn[i] + (arrIn[j] - arrIn[i]) * t);
+		}
+	}
+
+	for (unsigned int i = 1; i + 1 < uiNumOut; i++)
+		RasteriseTriangle(arrOut[0], arrOut[i], arrOut[i + 1]);
+}
+
+/**
+ @brief Rasterise a triangle in screen space, keeping the nearest depth in each pixel.
+		4 pixels of a row are tested and written at once.
+ @param v0 A const glm::vec3& variable containing the 1st vertex in screen space
+ @param v1 A const glm::vec3& variable containing the 2nd vertex in screen space
+ @param v2 A const glm::vec3& variable containing the 3rd vertex in screen space
+ */
+void COcclusionCuller::RasteriseTriangle(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2)
+{
+	// Occluders are closed, so both windings are rasterised. Order the vertices counter-clockwise.
+	glm::vec3 a = v0, b = v1, c = v2;
+	float fArea = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+	if (fabs(fArea) < 1e-6f)
+		return;
+	if (fArea < 0.0f)
+	{
+		std::swap(b, c);
+		fArea = -fArea;
+	}
+
+	const int iMinX = std::max(0, (int)floor(std::min(a.x, std::min(b.x, c.x))));
+	const int iMaxX = std::min(iBufferWidth - 1, (int)ceil(std::max(a.x, std::max(b.x, c.x))));
+	const int iMinY = std::max(0, (int)floor(std::min(a.y, std::min(b.y, c.y))));
+	const int iMaxY = std::min(iBufferHeight - 1, (int)ceil(std::max(a.y, std::max(b.y, c.y))));
+	if ((iMinX > iMaxX) || (iMinY > iMaxY))
+		return;
+
+	// The edge functions E(x, y) = A * x + B * y + C, which are positive inside the triangle
+	const float fA0 = b.y - c.y, fB0 = c.x - b.x, fC0 = b.x * c.y - b.y * c.x;	// Opposite a
+	const float fA1 = c.y - a.y, fB1 = a.x - c.x, fC1 = c.x * a.y - c.y * a.x;	// Opposite b
+	const float fA2 = a.y - b.y, fB2 = b.x - a.x, fC2 = a.x * b.y - a.y * b.x;	// Opposite c
+
+	// The plane of the depth, z(x, y) = fZX * x + fZY * y + fZ0
+	const float fInvArea = 1.0f / fArea;
+	const float fZX = (fA1 * (b.z - a.z) + fA2 * (c.z - a.z)) * fInvArea;
+	const float fZY = (fB1 * (b.z - a.z) + fB2 * (c.z - a.z)) * fInvArea;
+	const float fZ0 = a.z + (fC1 * (b.z - a.z) + fC2 * (c.z - a.z)) * fInvArea;
+
+	const __m128 mZero = _mm_setzero_ps();
+	const __m128 mCentre = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 mA0 = _mm_set1_ps(fA0);
+	const __m128 mA1 = _mm_set1_ps(fA1);
+	const __m128 mA2 = _mm_set1_ps(fA2);
+	const __m128 mZX = _mm_set1_ps(fZX);
+
+	for (int y = iMinY; y <= iMaxY; y++)
+	{
+		const float fY = (float)y + 0.5f;
+		const __m128 mRow0 = _mm_set1_ps(fB0 * fY + fC0);
+		const __m128 mRow1 = _mm_set1_ps(fB1 * fY + fC1);
+		const __m128 mRow2 = _mm_set1_ps(fB2 * fY + fC2);
+		const __m128 mRowZ = _mm_set1_ps(fZY * fY + fZ0);
+		float* pRow = &vDepth[y * iBufferWidth];
+
+		// iBufferWidth is a multiple of 4, so the 4 pixels from an aligned x are always in the row
+		for (int x = iMinX & ~3; x <= iMaxX; x += 4)
+		{
+			const __m128 mX = _mm_add_ps(_mm_set1_ps((float)x), mCentre);
+			const __m128 mE0 = _mm_add_ps(_mm_mul_ps(mA0, mX), mRow0);
+			const __m128 mE1 = _mm_add_ps(_mm_mul_ps(mA1, mX), mRow1);
+			const __m128 mE2 = _mm_add_ps(_mm_mul_ps(mA2, mX), mRow2);
+			const __m128 mInside = _mm_and_ps(	_mm_cmpge_ps(mE0, mZero),
+												_mm_and_ps(_mm_cmpge_ps(mE1, mZero), _mm_cmpge_ps(mE2, mZero)));
+			if (_mm_movemask_ps(mInside) == 0)
+				continue;
+
+			const __m128 mZ = _mm_add_ps(_mm_mul_ps(mZX, mX), mRowZ);
+			const __m128 mDepth = _mm_loadu_ps(pRow + x);
+			const __m128 mNearest = _mm_min_ps(mDepth, mZ);
+			_mm_storeu_ps(pRow + x, _mm_or_ps(_mm_and_ps(mInside, mNearest), _mm_andnot_ps(mInside, mDepth)));
+		}
+	}
+}
+
+/**
+ @brief Convert a clip space position into screen space
+ @param vec4Clip A const glm::vec4& variable containing the position in clip space
+ @return A glm::vec3 variable containing the pixel coordinates and the depth in [0, 1]
+ */
+glm::vec3 COcclusionCuller::ToScreen(const glm::vec4& vec4Clip)
+{
+	const float fInvW = 1.0f / vec4Clip.w;
+	return glm::vec3(	(vec4Clip.x * fInvW * 0.5f + 0.5f) * (float)iBufferWidth,
+						(vec4Clip.y * fInvW * 0.5f + 0.5f) * (float)iBufferHeight,
+						vec4Clip.z * fInvW * 0.5f + 0.5f);
+}
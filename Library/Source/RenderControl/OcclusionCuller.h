@@ -0,0 +1,135 @@
+/**
+ COcclusionCuller
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "../DesignPatterns/SingletonTemplate.h"
+
+// Include GLM
+#include <includes/glm.hpp>
+#include <includes/gtc/matrix_transform.hpp>
+#include <includes/gtc/type_ptr.hpp>
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+
+// Culls entities which are hidden behind large occluders, such as buildings and terrain hills.
+// The occluders are low-poly proxies which must lie inside the geometry they stand for. Each frame,
+// a worker thread rasterises them with SSE2 into a low resolution depth buffer while the main thread
+// renders other passes. The bounding boxes of the entities are then tested against the depth buffer
+// between BeginCulling() and EndCulling(), so a render pass which does not call these is not culled.
+class COcclusionCuller : public CSingletonTemplate<COcclusionCuller>
+{
+	friend CSingletonTemplate<COcclusionCuller>;
+
+public:
+	// The size of the depth buffer. The width must be a multiple of 4.
+	static const int iBufferWidth = 256;
+	static const int iBufferHeight = 128;
+
+	// Initialise this class instance and start the worker thread
+	bool Init(void);
+
+	// Add a box in world space as an occluder
+	void AddOccluderBox(const glm::vec3& vec3BoxMin, const glm::vec3& vec3BoxMax);
+	// Add a triangle mesh in world space as an occluder
+	void AddOccluderMesh(const vector<glm::vec3>& vVertices, const vector<unsigned int>& vIndices);
+	// Remove the occluders which were added with a group, or all occluders if iGroup is -1
+	void ClearOccluders(const int iGroup = -1);
+	// Set the group of the occluders which are added after this
+	void SetOccluderGroup(const int iGroup);
+	// Get the number of occluder triangles
+	unsigned int GetNumOccluderTriangles(void) const;
+
+	// Start rasterising the occluders for a view-projection matrix on the worker thread
+	void StartRasterise(const glm::mat4& viewProjection);
+	// Wait for the depth buffer and start testing bounding boxes against it
+	void BeginCulling(void);
+	// Stop testing bounding boxes and record the statistics of this frame
+	void EndCulling(void);
+	// Check if bounding boxes are being tested
+	bool IsCulling(void) const;
+
+	// Check if a bounding box in world space may be visible. It is always visible if IsCulling() is false.
+	bool IsVisible(const glm::vec3& vec3BoxMin, const glm::vec3& vec3BoxMax);
+
+	// Enable or disable the occlusion culling
+	void SetEnabled(const bool bEnabled);
+	// Check if the occlusion culling is enabled
+	bool IsEnabled(void) const;
+
+	// Get the number of bounding boxes tested in the last frame
+	unsigned int GetNumTested(void) const;
+	// Get the number of bounding boxes which were occluded in the last frame
+	unsigned int GetNumOccluded(void) const;
+	// Get the time taken by the worker thread to rasterise the occluders in the last frame, in milliseconds
+	double GetRasteriseTime(void) const;
+
+protected:
+	// The occluders of a group in world space, as triangles of 3 indices into vVertex
+	struct OccluderGroup
+	{
+		int iGroup;
+		vector<glm::vec3> vVertex;
+		vector<unsigned int> vIndex;
+	};
+
+	// The occluders, and the group which new occluders are added to
+	vector<OccluderGroup> vOccluder;
+	int iOccluderGroup;
+
+	// The depth buffer, which stores the depth in [0, 1] of the nearest occluder in each pixel
+	vector<float> vDepth;
+	// The occluder vertices in clip space, used by the worker thread
+	vector<glm::vec4> vClipVertex;
+
+	// The view-projection matrix of the frame which is rasterised or tested
+	glm::mat4 viewProjection;
+
+	// The worker thread and its state
+	std::thread cThread;
+	std::mutex cMutex;
+	std::condition_variable cStartCondition;
+	std::condition_variable cDoneCondition;
+	bool bStart;
+	bool bDone;
+	bool bQuit;
+
+	bool bInitialised;
+	bool bEnabled;
+	bool bRasterised;
+	bool bCulling;
+
+	// The statistics of the current and the last frame
+	unsigned int uiNumTested;
+	unsigned int uiNumOccluded;
+	unsigned int uiLastNumTested;
+	unsigned int uiLastNumOccluded;
+	double dRasteriseTime;
+
+	// Constructor
+	COcclusionCuller(void);
+	// Destructor
+	virtual ~COcclusionCuller(void);
+
+	// Get the occluders of the current group, or add them
+	OccluderGroup& GetOccluderGroup(void);
+	// Wait until the worker thread has finished rasterising
+	void WaitForRasterise(void);
+	// The loop run by the worker thread
+	void Run(void);
+	// Rasterise all occluders into the depth buffer
+	void Rasterise(void);
+	// Clip a triangle against the near plane and rasterise the result
+	void RasteriseClipped(const glm::vec4& v0, const glm::vec4& v1, const glm::vec4& v2);
+	// Rasterise a triangle in screen space, keeping the nearest depth in each pixel
+	void RasteriseTriangle(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2);
+	// Convert a clip space position into screen space
+	static glm::vec3 ToScreen(const glm::vec4& vec4Clip);
+};
@@ -1,4 +1,7 @@
 #include "ShaderManager.h"
+
+// Include CCameraUniformBuffer
+#include "CameraUniformBuffer.h"
 #include <stdexcept>      // std::invalid_argument
 
 /**
@@ -54,6 +57,9 @@ void CShaderManager::Add(	const std::string& _name,
 
 	CShader* cNewShader = new CShader(vertexPath, fragmentPath);
 
+	// Let the shader read the camera of each render pass from the camera uniform buffer
+	CCameraUniformBuffer::BindShader(cNewShader->ID);
+
 	// Nothing wrong, add the scene to our map
 	shaderMap[_name] = cNewShader;
 }
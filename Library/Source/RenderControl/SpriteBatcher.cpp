@@ -0,0 +1,425 @@
+/**
+ CSpriteBatcher
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#include "SpriteBatcher.h"
+
+// Include ShaderManager
+#include "ShaderManager.h"
+
+// Include CLogger
+#include "../System/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor
+ */
+CSpriteBatcher::CSpriteBatcher(void)
+	: VAO(0)
+	, VBO(0)
+	, IBO(0)
+	, uiRegion(0)
+	, uiLastBatch(0)
+	, bInitialised(false)
+	, uiNumSprites(0)
+	, uiNumDrawCalls(0)
+{
+	for (unsigned int i = 0; i < uiNumRegions; i++)
+		arrFence[i] = 0;
+}
+
+/**
+ @brief Destructor
+ */
+CSpriteBatcher::~CSpriteBatcher(void)
+{
+	for (unsigned int i = 0; i < uiNumRegions; i++)
+	{
+		if (arrFence[i] != 0)
+		{
+			glDeleteSync(arrFence[i]);
+			arrFence[i] = 0;
+		}
+	}
+
+	if (VAO != 0)
+		glDeleteVertexArrays(1, &VAO);
+	if (VBO != 0)
+		glDeleteBuffers(1, &VBO);
+	if (IBO != 0)
+		glDeleteBuffers(1, &IBO);
+}
+
+/**
+ @brief Initialise this class instance
+ @param sShaderName A const std::string& variable containing the name of the shader which reads
+		the position, texture coordinates and colour of each SpriteVertex
+ @return true if the initialisation is successful, else false
+ */
+bool CSpriteBatcher::Init(const std::string& sShaderName)
+{
+	if (bInitialised)
+		return true;
+
+	this->sShaderName = sShaderName;
+
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &IBO);
+	if ((VAO == 0) || (VBO == 0) || (IBO == 0))
+	{
+		cout << "CSpriteBatcher::Init() - Unable to create the buffers" << endl;
+		return false;
+	}
+
+	// The indices of the sprites in a region, which are the same for every region and every frame.
+	// The corners are in the same order as CMeshBuilder::GenerateQuad().
+	vector<GLuint> vIndex(uiMaxSprites * 6);
+	for (GLuint i = 0; i < uiMaxSprites; i++)
+	{
+		vIndex[i * 6 + 0] = i * 4 + 3;
+		vIndex[i * 6 + 1] = i * 4 + 0;
+		vIndex[i * 6 + 2] = i * 4 + 2;
+		vIndex[i * 6 + 3] = i * 4 + 1;
+		vIndex[i * 6 + 4] = i * 4 + 2;
+		vIndex[i * 6 + 5] = i * 4 + 0;
+	}
+
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(SpriteVertex) * uiMaxSprites * 4 * uiNumRegions, NULL, GL_STREAM_DRAW);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)sizeof(glm::vec2));
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteVertex), (void*)(2 * sizeof(glm::vec2)));
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, vIndex.size() * sizeof(GLuint), &vIndex[0], GL_STATIC_DRAW);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	vVertex.reserve(1024 * 4);
+	vSpriteBatch.reserve(1024);
+	uiRegion = 0;
+	bInitialised = true;
+
+	return true;
+}
+
+/**
+ @brief Check if this class instance has been initialised
+ @return A bool variable
+ */
+bool CSpriteBatcher::IsInitialised(void) const
+{
+	return bInitialised;
+}
+
+/**
+ @brief Start a frame by removing the sprites of the previous frame
+ */
+void CSpriteBatcher::Begin(void)
+{
+	vVertex.clear();
+	vSpriteBatch.clear();
+	vBatch.clear();
+	uiLastBatch = 0;
+}
+
+/**
+ @brief Add a sprite, which is a rectangle of vec2Size centred on vec2Position
+ @param iTextureID A const GLuint variable containing the texture of the sprite
+ @param vec4UVRect A const glm::vec4& variable containing the rectangle of the texture: u0, v0, u1, v1
+ @param vec2Position A const glm::vec2& variable containing the centre of the sprite
+ @param vec2Size A const glm::vec2& variable containing the width and height of the sprite
+ @param vec4Colour A const glm::vec4& variable containing the colour which the texture is multiplied by
+ @param iLayer A const int variable containing the layer. The lower layers are drawn first.
+ */
+void CSpriteBatcher::Submit(const GLuint iTextureID,
+							const glm::vec4& vec4UVRect,
+							const glm::vec2& vec2Position,
+							const glm::vec2& vec2Size,
+							const glm::vec4& vec4Colour,
+							const int iLayer)
+{
+	const size_t uiFirstVertex = vVertex.size();
+	vVertex.resize(uiFirstVertex + 4);
+	SpriteVertex* pVertex = &vVertex[uiFirstVertex];
+
+	const glm::vec2 vec2HalfSize = vec2Size * 0.5f;
+	pVertex[0].vec2Position = glm::vec2(vec2Position.x - vec2HalfSize.x, vec2Position.y - vec2HalfSize.y);
+	pVertex[1].vec2Position = glm::vec2(vec2Position.x + vec2HalfSize.x, vec2Position.y - vec2HalfSize.y);
+	pVertex[2].vec2Position = glm::vec2(vec2Position.x + vec2HalfSize.x, vec2Position.y + vec2HalfSize.y);
+	pVertex[3].vec2Position = glm::vec2(vec2Position.x - vec2HalfSize.x, vec2Position.y + vec2HalfSize.y);
+	pVertex[0].vec2TexCoord = glm::vec2(vec4UVRect.x, vec4UVRect.y);
+	pVertex[1].vec2TexCoord = glm::vec2(vec4UVRect.z, vec4UVRect.y);
+	pVertex[2].vec2TexCoord = glm::vec2(vec4UVRect.z, vec4UVRect.w);
+	pVertex[3].vec2TexCoord = glm::vec2(vec4UVRect.x, vec4UVRect.w);
+	PackColour(vec4Colour, pVertex[0].arrColour);
+	memcpy(pVertex[1].arrColour, pVertex[0].arrColour, 4);
+	memcpy(pVertex[2].arrColour, pVertex[0].arrColour, 4);
+	memcpy(pVertex[3].arrColour, pVertex[0].arrColour, 4);
+
+	vSpriteBatch.push_back(GetBatch(iLayer, iTextureID));
+}
+
+/**
+ @brief Add a sprite, which is a rectangle of vec2Size centred on the origin, moved by a transform
+ @param iTextureID A const GLuint variable containing the texture of the sprite
+ @param vec4UVRect A const glm::vec4& variable containing the rectangle of the texture: u0, v0, u1, v1
+ @param transform A const glm::mat4& variable containing the transform of the sprite
+ @param vec2Size A const glm::vec2& variable containing the width and height of the sprite
+ @param vec4Colour A const glm::vec4& variable containing the colour which the texture is multiplied by
+ @param iLayer A const int variable containing the layer. The lower layers are drawn first.
+ */
+void CSpriteBatcher::Submit(const GLuint iTextureID,
+							const glm::vec4& vec4UVRect,
+							const glm::mat4& transform,
+							const glm::vec2& vec2Size,
+							const glm::vec4& vec4Colour,
+							const int iLayer)
+{
+	const size_t uiFirstVertex = vVertex.size();
+	vVertex.resize(uiFirstVertex + 4);
+	SpriteVertex* pVertex = &vVertex[uiFirstVertex];
+
+	// Only the x and y of the transformed corners are used
+	const glm::vec2 vec2HalfSize = vec2Size * 0.5f;
+	const glm::vec2 vec2Origin = glm::vec2(transform[3]);
+	const glm::vec2 vec2AxisX = glm::vec2(transform[0]) * vec2HalfSize.x;
+	const glm::vec2 vec2AxisY = glm::vec2(transform[1]) * vec2HalfSize.y;
+	pVertex[0].vec2Position = vec2Origin - vec2AxisX - vec2AxisY;
+	pVertex[1].vec2Position = vec2Origin + vec2AxisX - vec2AxisY;
+	pVertex[2].vec2Position = vec2Origin + vec2AxisX + vec2AxisY;
+	pVertex[3].vec2Position = vec2Origin - vec2AxisX + vec2AxisY;
+	pVertex[0].vec2TexCoord = glm::vec2(vec4UVRect.x, vec4UVRect.y);
+	pVertex[1].vec2TexCoord = glm::vec2(vec4UVRect.z, vec4UVRect.y);
+	pVertex[2].vec2TexCoord = glm::vec2(vec4UVRect.z, vec4UVRect.w);
+	pVertex[3].vec2TexCoord = glm::vec2(vec4UVRect.x, vec4UVRect.w);
+	PackColour(vec4Colour, pVertex[0].arrColour);
+	memcpy(pVertex[1].arrColour, pVertex[0].arrColour, 4);
+	memcpy(pVertex[2].arrColour, pVertex[0].arrColour, 4);
+	memcpy(pVertex[3].arrColour, pVertex[0].arrColour, 4);
+
+	vSpriteBatch.push_back(GetBatch(iLayer, iTextureID));
+}
+
+/**
+ @brief Set up the OpenGL display environment before Flush()
+ */
+void CSpriteBatcher::PreRender(void)
+{
+	// bind textures on corresponding texture units
+	glActiveTexture(GL_TEXTURE0);
+
+	// Activate blending mode
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	// Activate the shader
+	CShaderManager::GetInstance()->Use(sShaderName);
+}
+
+/**
+ @brief Draw the sprites of this frame, and remove them
+ @return The number of draw calls
+ */
+unsigned int CSpriteBatcher::Flush(void)
+{
+	uiNumSprites = vSpriteBatch.size();
+	uiNumDrawCalls = 0;
+	if ((bInitialised == false) || (uiNumSprites == 0))
+	{
+		Begin();
+		return 0;
+	}
+
+	// Order the batches by layer, then by texture
+	vBatchOrder.resize(vBatch.size());
+	for (unsigned int i = 0; i < vBatch.size(); i++)
+		vBatchOrder[i] = i;
+	sort(vBatchOrder.begin(), vBatchOrder.end(), [this](const unsigned int a, const unsigned int b)
+	{
+		if (vBatch[a].iLayer != vBatch[b].iLayer)
+			return vBatch[a].iLayer < vBatch[b].iLayer;
+		return vBatch[a].iTextureID < vBatch[b].iTextureID;
+	});
+
+	// Order the sprites by their batches with a counting sort, which keeps the order of submission in a batch.
+	// uiFirst is used as the write position, and is moved back to the start of each batch afterwards.
+	unsigned int uiFirst = 0;
+	for (unsigned int i = 0; i < vBatchOrder.size(); i++)
+	{
+		vBatch[vBatchOrder[i]].uiFirst = uiFirst;
+		uiFirst += vBatch[vBatchOrder[i]].uiNumSprites;
+	}
+	vSpriteOrder.resize(uiNumSprites);
+	for (unsigned int i = 0; i < uiNumSprites; i++)
+		vSpriteOrder[vBatch[vSpriteBatch[i]].uiFirst++] = i;
+	for (unsigned int i = 0; i < vBatch.size(); i++)
+		vBatch[i].uiFirst -= vBatch[i].uiNumSprites;
+
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+	// Draw the sprites in regions of at most uiMaxSprites
+	GLuint iBoundTextureID = 0;
+	unsigned int uiDrawn = 0;
+	while (uiDrawn < uiNumSprites)
+	{
+		const unsigned int uiNumInRegion = min(uiNumSprites - uiDrawn, uiMaxSprites);
+		const GLint iBaseVertex = uiRegion * uiMaxSprites * 4;
+
+		// Write the corners straight into the region. The region is fenced, so it is mapped unsynchronised
+		// and the driver does not stall.
+		WaitForRegion(uiRegion);
+		SpriteVertex* pMapped = (SpriteVertex*)glMapBufferRange(GL_ARRAY_BUFFER,
+																iBaseVertex * sizeof(SpriteVertex),
+																uiNumInRegion * 4 * sizeof(SpriteVertex),
+																GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+		if (pMapped == NULL)
+			break;
+		for (unsigned int i = 0; i < uiNumInRegion; i++)
+			memcpy(pMapped + i * 4, &vVertex[vSpriteOrder[uiDrawn + i] * 4], 4 * sizeof(SpriteVertex));
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+
+		// Draw each batch, or the part of it which is in this region, with one draw call
+		for (unsigned int i = 0; i < vBatchOrder.size(); i++)
+		{
+			const Batch& cBatch = vBatch[vBatchOrder[i]];
+			const unsigned int uiStart = max(cBatch.uiFirst, uiDrawn);
+			const unsigned int uiEnd = min(cBatch.uiFirst + cBatch.uiNumSprites, uiDrawn + uiNumInRegion);
+			if (uiStart >= uiEnd)
+				continue;
+
+			if (cBatch.iTextureID != iBoundTextureID)
+			{
+				glBindTexture(GL_TEXTURE_2D, cBatch.iTextureID);
+				iBoundTextureID = cBatch.iTextureID;
+			}
+			glDrawElementsBaseVertex(	GL_TRIANGLES,
+										(uiEnd - uiStart) * 6,
+										GL_UNSIGNED_INT,
+										(void*)((uiStart - uiDrawn) * 6 * sizeof(GLuint)),
+										iBaseVertex);
+			uiNumDrawCalls++;
+		}
+
+		// Fence this region so that it is not overwritten while the GPU still reads it
+		arrFence[uiRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		uiRegion = (uiRegion + 1) % uiNumRegions;
+		uiDrawn += uiNumInRegion;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	Begin();
+
+	LOG_TRACE_EVERY(1.0, RENDER, "CSpriteBatcher: %u sprites in %u draw calls", uiNumSprites, uiNumDrawCalls);
+
+	return uiNumDrawCalls;
+}
+
+/**
+ @brief Set up the OpenGL display environment after Flush()
+ */
+void CSpriteBatcher::PostRender(void)
+{
+	// Disable blending
+	glDisable(GL_BLEND);
+}
+
+/**
+ @brief Get the number of sprites drawn in the last Flush
+ @return An unsigned int variable
+ */
+unsigned int CSpriteBatcher::GetNumSprites(void) const
+{
+	return uiNumSprites;
+}
+
+/**
+ @brief Get the number of OpenGL draw calls made in the last Flush
+ @return An unsigned int variable
+ */
+unsigned int CSpriteBatcher::GetNumDrawCalls(void) const
+{
+	return uiNumDrawCalls;
+}
+
+/**
+ @brief Get the batch of a layer and a texture, adding it if needed
+ @param iLayer A const int variable containing the layer
+ @param iTextureID A const GLuint variable containing the texture
+ @return The index of the batch in vBatch
+ */
+unsigned int CSpriteBatcher::GetBatch(const int iLayer, const GLuint iTextureID)
+{
+	// Most sprites are submitted one entity type at a time, so they share the last batch
+	if ((uiLastBatch < vBatch.size()) &&
+		(vBatch[uiLastBatch].iLayer == iLayer) && (vBatch[uiLastBatch].iTextureID == iTextureID))
+	{
+		vBatch[uiLastBatch].uiNumSprites++;
+		return uiLastBatch;
+	}
+
+	for (unsigned int i = 0; i < vBatch.size(); i++)
+	{
+		if ((vBatch[i].iLayer == iLayer) && (vBatch[i].iTextureID == iTextureID))
+		{
+			vBatch[i].uiNumSprites++;
+			uiLastBatch = i;
+			return i;
+		}
+	}
+
+	Batch cBatch;
+	cBatch.iLayer = iLayer;
+	cBatch.iTextureID = iTextureID;
+	cBatch.uiNumSprites = 1;
+	cBatch.uiFirst = 0;
+	vBatch.push_back(cBatch);
+	uiLastBatch = vBatch.size() - 1;
+	return uiLastBatch;
+}
+
+/**
+ @brief Convert a colour into 4 normalised bytes
+ @param vec4Colour A const glm::vec4& variable containing the colour, from 0 to 1
+ @param arrColour A GLubyte* variable which receives the 4 bytes
+ */
+void CSpriteBatcher::PackColour(const glm::vec4& vec4Colour, GLubyte* arrColour)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		const float fValue = vec4Colour[i] < 0.0f ? 0.0f : (vec4Colour[i] > 1.0f ? 1.0f : vec4Colour[i]);
+		arrColour[i] = (GLubyte)(fValue * 255.0f + 0.5f);
+	}
+}
+
+/**
+ @brief Wait until the GPU has finished the last Flush which used a region
+ @param uiRegion A const unsigned int variable containing the region
+ */
+void CSpriteBatcher::WaitForRegion(const unsigned int uiRegion)
+{
+	if (arrFence[uiRegion] == 0)
+		return;
+
+	GLenum eResult = glClientWaitSync(arrFence[uiRegion], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+	while (eResult == GL_TIMEOUT_EXPIRED)
+	{
+		// 1 millisecond
+		eResult = glClientWaitSync(arrFence[uiRegion], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+	}
+	glDeleteSync(arrFence[uiRegion]);
+	arrFence[uiRegion] = 0;
+}
@@ -0,0 +1,133 @@
+/**
+ CSpriteBatcher
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "../DesignPatterns/SingletonTemplate.h"
+
+// Include GLEW
+#ifndef GLEW_STATIC
+#include <GL/glew.h>
+#define GLEW_STATIC
+#endif
+
+// Include GLM
+#include <includes/glm.hpp>
+#include <includes/gtc/matrix_transform.hpp>
+#include <includes/gtc/type_ptr.hpp>
+
+#include <string>
+#include <vector>
+using namespace std;
+
+// Draws the 2D sprites of a frame in as few draw calls as possible.
+// During a frame, the entities Submit() a sprite as a texture, a rectangle of that texture, a position or
+// a transform, and a colour. Submit() only writes the 4 corners of the sprite into memory. Flush() orders the
+// sprites by layer and then by texture, keeping the order of submission within each texture, writes them into
+// the next region of a ring of mapped vertex buffers, which is fenced instead of synchronised by the driver,
+// and draws each run of sprites which share a texture with one glDrawElementsBaseVertex.
+// A sprite sheet or an atlas should be submitted as one texture with a rectangle per frame, so that all of its
+// sprites are drawn together. Sprites of different textures within one layer must not overlap, since their
+// order of drawing is changed; put them into different layers instead.
+class CSpriteBatcher : public CSingletonTemplate<CSpriteBatcher>
+{
+	friend CSingletonTemplate<CSpriteBatcher>;
+
+public:
+	// Initialise this class instance
+	bool Init(const std::string& sShaderName);
+	// Check if this class instance has been initialised
+	bool IsInitialised(void) const;
+
+	// Start a frame by removing the sprites of the previous frame
+	void Begin(void);
+	// Add a sprite, which is a rectangle of vec2Size centred on vec2Position.
+	// vec4UVRect is the rectangle of the texture: u0, v0, u1, v1.
+	void Submit(const GLuint iTextureID,
+				const glm::vec4& vec4UVRect,
+				const glm::vec2& vec2Position,
+				const glm::vec2& vec2Size,
+				const glm::vec4& vec4Colour = glm::vec4(1.0f),
+				const int iLayer = 0);
+	// Add a sprite, which is a rectangle of vec2Size centred on the origin, moved by a transform
+	void Submit(const GLuint iTextureID,
+				const glm::vec4& vec4UVRect,
+				const glm::mat4& transform,
+				const glm::vec2& vec2Size,
+				const glm::vec4& vec4Colour = glm::vec4(1.0f),
+				const int iLayer = 0);
+
+	// Set up the OpenGL display environment before Flush()
+	void PreRender(void);
+	// Draw the sprites of this frame, and remove them. Returns the number of draw calls.
+	unsigned int Flush(void);
+	// Set up the OpenGL display environment after Flush()
+	void PostRender(void);
+
+	// Get the number of sprites drawn in the last Flush
+	unsigned int GetNumSprites(void) const;
+	// Get the number of OpenGL draw calls made in the last Flush
+	unsigned int GetNumDrawCalls(void) const;
+
+protected:
+	// The maximum number of sprites in a region of the vertex buffer. More sprites are drawn in several regions.
+	static const unsigned int uiMaxSprites = 65536;
+	// The number of regions which can be in flight before Flush waits for the GPU
+	static const unsigned int uiNumRegions = 3;
+
+	// A corner of a sprite. The colour is 4 normalised bytes.
+	struct SpriteVertex
+	{
+		glm::vec2 vec2Position;
+		glm::vec2 vec2TexCoord;
+		GLubyte arrColour[4];
+	};
+
+	// The sprites of a layer which share a texture
+	struct Batch
+	{
+		int iLayer;
+		GLuint iTextureID;
+		unsigned int uiNumSprites;
+		unsigned int uiFirst;
+	};
+
+	// The shader which reads the SpriteVertex attributes
+	std::string sShaderName;
+
+	GLuint VAO, VBO, IBO;
+	// The fence of the last Flush which used each region
+	GLsync arrFence[uiNumRegions];
+	unsigned int uiRegion;
+
+	// The corners of the sprites, in the order of submission
+	vector<SpriteVertex> vVertex;
+	// The batch of each sprite
+	vector<unsigned int> vSpriteBatch;
+	// The batches of this frame, and the last batch which was used, since most sprites share it
+	vector<Batch> vBatch;
+	unsigned int uiLastBatch;
+	// The batches and the sprites, in the order of drawing
+	vector<unsigned int> vBatchOrder;
+	vector<unsigned int> vSpriteOrder;
+
+	bool bInitialised;
+
+	unsigned int uiNumSprites;
+	unsigned int uiNumDrawCalls;
+
+	// Constructor
+	CSpriteBatcher(void);
+	// Destructor
+	virtual ~CSpriteBatcher(void);
+
+	// Get the batch of a layer and a texture, adding it if needed
+	unsigned int GetBatch(const int iLayer, const GLuint iTextureID);
+	// Convert a colour into 4 normalised bytes
+	static void PackColour(const glm::vec4& vec4Colour, GLubyte* arrColour);
+	// Wait until the GPU has finished the last Flush which used a region
+	void WaitForRegion(const unsigned int uiRegion);
+};
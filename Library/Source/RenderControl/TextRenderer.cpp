@@ -9,18 +9,38 @@
 #include "..\RenderControl\ShaderManager.h"
 
 #include <iostream>
+#include <cstring>
 using namespace std;
 
 #include "../System/filesystem.h"
 
+// Include CLogger
+#include "../System/Logger.h"
+
 // FreeType
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+// stb_rect_pack. imgui_draw.cpp compiles its copy as static, so this file compiles its own.
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "../GUI/imstb_rectpack.h"
+
 /**
  @brief Constructor This constructor has protected access modifier as this class will be a Singleton
  */
 CTextRenderer::CTextRenderer(void)
+	: uiAtlasTextureID(0)
+	, cPackContext(NULL)
+	, arrPackNodes(NULL)
+	, ftLibrary(NULL)
+	, ftFace(NULL)
+	, bHasKerning(false)
+	, uiVBOCapacity(0)
+	, uiNumDrawCalls(0)
+	, uiNumGlyphs(0)
+	, uiLastNumDrawCalls(0)
+	, uiLastNumGlyphs(0)
 {
 }
 
@@ -34,6 +54,17 @@ CTextRenderer::~CTextRenderer(void)
 	glDeleteVertexArrays(1, &VAO);
 	glDeleteBuffers(1, &VBO);
 	glDeleteBuffers(1, &EBO);
+	if (uiAtlasTextureID != 0)
+		glDeleteTextures(1, &uiAtlasTextureID);
+
+	// Destroy FreeType
+	if (ftFace)
+		FT_Done_Face(ftFace);
+	if (ftLibrary)
+		FT_Done_FreeType(ftLibrary);
+
+	delete cPackContext;
+	delete[] arrPackNodes;
 }
 
 /**
@@ -51,77 +82,70 @@ bool CTextRenderer::Init(void)
 	CShaderManager::GetInstance()->activeShader->setInt("text", 0);
 
 	// FreeType
-	FT_Library ft;
 	// All functions return a value different than 0 whenever an error occurred
-	if (FT_Init_FreeType(&ft))
+	if (FT_Init_FreeType(&ftLibrary))
+	{
 		std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
+		ftLibrary = NULL;
+		return false;
+	}
 
-	// Load font as face
-	FT_Face face;
-	if (FT_New_Face(ft, "Fonts//cour.ttf", 0, &face))
+	// Load font as face. It is kept open so that glyphs can be loaded when they are first used.
+	if (FT_New_Face(ftLibrary, "Fonts//cour.ttf", 0, &ftFace))
+	{
 		std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
+		ftFace = NULL;
+		return false;
+	}
+	bHasKerning = FT_HAS_KERNING(ftFace) != 0;
 
 	// Set size to load glyphs as
-	FT_Set_Pixel_Sizes(face, 0, 40);
+	FT_Set_Pixel_Sizes(ftFace, 0, iFontSize);
 
-	// Disable byte-alignment restriction
+	// Create the atlas texture, cleared to transparent
+	std::vector<unsigned char> vClear(iAtlasSize * iAtlasSize, 0);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-	// Load first 128 characters of ASCII set
-	for (GLubyte c = 0; c < 128; c++)
-	{
-		// Load character glyph 
-		if (FT_Load_Char(face, c, FT_LOAD_RENDER))
-		{
-			std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
-			continue;
-		}
-		// Generate texture
-		GLuint texture;
-		glGenTextures(1, &texture);
-		glBindTexture(GL_TEXTURE_2D, texture);
-		glTexImage2D(
-			GL_TEXTURE_2D,
-			0,
-			GL_RED,
-			face->glyph->bitmap.width,
-			face->glyph->bitmap.rows,
-			0,
-			GL_RED,
-			GL_UNSIGNED_BYTE,
-			face->glyph->bitmap.buffer
-			);
-		// Set texture options
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		// Now store character for later use
-		Character character = {
-			texture,
-			glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-			glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-			(GLuint)face->glyph->advance.x
-		};
-		Characters.insert(std::pair<GLchar, Character>(c, character));
-	}
+	glGenTextures(1, &uiAtlasTextureID);
+	glBindTexture(GL_TEXTURE_2D, uiAtlasTextureID);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, iAtlasSize, iAtlasSize, 0, GL_RED, GL_UNSIGNED_BYTE, &vClear[0]);
+	// Set texture options
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glBindTexture(GL_TEXTURE_2D, 0);
-	// Destroy FreeType once we're finished
-	FT_Done_Face(face);
-	FT_Done_FreeType(ft);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	// Set up the rectangle packer for the atlas. Using as many nodes as the width gives the best packing.
+	cPackContext = new stbrp_context;
+	arrPackNodes = new stbrp_node[iAtlasSize];
+	stbrp_init_target(cPackContext, iAtlasSize, iAtlasSize, arrPackNodes, iAtlasSize);
 
+	// Pack the printable ASCII characters together, since they are used the most.
+	// Other characters are added when they are first used.
+	unsigned int arrASCII[127 - 32];
+	for (unsigned int c = 32; c < 127; c++)
+		arrASCII[c - 32] = c;
+	AddCharacters(arrASCII, 127 - 32);
 
-	// Configure VAO/VBO for texture quads
+	// Configure VAO/VBO for the glyph quads
+	uiVBOCapacity = 6 * 256;
 	glGenVertexArrays(1, &VAO);
 	glGenBuffers(1, &VBO);
 	glBindVertexArray(VAO);
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(TextVertex) * uiVBOCapacity, NULL, GL_STREAM_DRAW);
+	// Position and texture coordinates
 	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), 0);
+	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)0);
+	// Colour
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)(4 * sizeof(GLfloat)));
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
 
+	vVertices.reserve(uiVBOCapacity);
+
 	return true;
 }
 
@@ -146,61 +170,278 @@ void CTextRenderer::PreRender(void)
 
 	// Activate the shader
 	CShaderManager::GetInstance()->Use(sShaderName);
+
+	// Start counting the draw calls for this frame
+	uiNumDrawCalls = 0;
+	uiNumGlyphs = 0;
 }
 
 /**
- @brief Render Render this instance
+ @brief Render Add a string to the batch of text for this frame
+ @param text The UTF-8 encoded string
+ @param x The x-coordinate of the start of the baseline, in pixels
+ @param y The y-coordinate of the baseline, in pixels
+ @param scale The scale of the text
+ @param colour The colour of the text
  */
 void CTextRenderer::Render(std::string text, GLfloat x, GLfloat y, GLfloat scale, glm::vec3 colour)
 {
-	// Activate corresponding render state	
-	glUniform3f(glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "textColour"), 
-				colour.x, colour.y, colour.z);
-	glActiveTexture(GL_TEXTURE0);
-	glBindVertexArray(VAO);
+	unsigned int uiPreviousGlyphIndex = 0;
 
 	// Iterate through all characters
-	std::string::const_iterator c;
-	for (c = text.begin(); c != text.end(); c++)
+	size_t uiPos = 0;
+	while (uiPos < text.size())
 	{
-		Character ch = Characters[*c];
-
-		GLfloat xpos = x + ch.Bearing.x * scale;
-		GLfloat ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
-
-		GLfloat w = ch.Size.x * scale;
-		GLfloat h = ch.Size.y * scale;
-		// Update VBO for each character
-		GLfloat vertices[6][4] = {
-			{ xpos, ypos + h, 0.0, 0.0 },
-			{ xpos, ypos, 0.0, 1.0 },
-			{ xpos + w, ypos, 1.0, 1.0 },
-
-			{ xpos, ypos + h, 0.0, 0.0 },
-			{ xpos + w, ypos, 1.0, 1.0 },
-			{ xpos + w, ypos + h, 1.0, 0.0 }
-		};
-		// Render glyph texture over quad
-		glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-		// Update content of VBO memory
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); // Be sure to use glBufferSubData and not glBufferData
-
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		// Render quad
-		glDrawArrays(GL_TRIANGLES, 0, 6);
+		const Character* ch = GetCharacter(DecodeUTF8(text, uiPos));
+		if (ch == NULL)
+			continue;
+
+		// Move the pen by the kerning between this character and the previous one
+		if ((bHasKerning) && (uiPreviousGlyphIndex != 0) && (ch->GlyphIndex != 0))
+		{
+			FT_Vector delta;
+			FT_Get_Kerning(ftFace, uiPreviousGlyphIndex, ch->GlyphIndex, FT_KERNING_DEFAULT, &delta);
+			x += (delta.x >> 6) * scale;
+		}
+		uiPreviousGlyphIndex = ch->GlyphIndex;
+
+		if ((ch->Size.x > 0) && (ch->Size.y > 0))
+		{
+			GLfloat xpos = x + ch->Bearing.x * scale;
+			GLfloat ypos = y - (ch->Size.y - ch->Bearing.y) * scale;
+
+			GLfloat w = ch->Size.x * scale;
+			GLfloat h = ch->Size.y * scale;
+
+			// Add the quad of this character to the batch
+			TextVertex vertices[6] = {
+				{ xpos, ypos + h, ch->UV.x, ch->UV.y, colour.x, colour.y, colour.z },
+				{ xpos, ypos, ch->UV.x, ch->UV.w, colour.x, colour.y, colour.z },
+				{ xpos + w, ypos, ch->UV.z, ch->UV.w, colour.x, colour.y, colour.z },
+
+				{ xpos, ypos + h, ch->UV.x, ch->UV.y, colour.x, colour.y, colour.z },
+				{ xpos + w, ypos, ch->UV.z, ch->UV.w, colour.x, colour.y, colour.z },
+				{ xpos + w, ypos + h, ch->UV.z, ch->UV.y, colour.x, colour.y, colour.z }
+			};
+			vVertices.insert(vVertices.end(), vertices, vertices + 6);
+			uiNumGlyphs++;
+		}
+
 		// Now advance cursors for next glyph (note that advance is number of 1/64 pixels)
-		x += (ch.Advance >> 6) * scale; // Bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
+		x += (ch->Advance >> 6) * scale; // Bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
 	}
+}
+
+/**
+ @brief Flush Draw all the text added since the last Flush() in one draw call
+ */
+void CTextRenderer::Flush(void)
+{
+	if (vVertices.empty())
+		return;
+
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+	// Grow the VBO if needed
+	if (vVertices.size() > uiVBOCapacity)
+	{
+		while (vVertices.size() > uiVBOCapacity)
+			uiVBOCapacity *= 2;
+	}
+
+	// Orphan the old buffer so that the driver does not wait for the last draw to finish with it
+	glBufferData(GL_ARRAY_BUFFER, sizeof(TextVertex) * uiVBOCapacity, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(TextVertex) * vVertices.size(), &vVertices[0]);
+
+	// Render all the glyph quads from the atlas
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, uiAtlasTextureID);
+	glDrawArrays(GL_TRIANGLES, 0, vVertices.size());
+	uiNumDrawCalls++;
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
 	glBindTexture(GL_TEXTURE_2D, 0);
+
+	vVertices.clear();
 }
 
 /**
- @brief PostRender Set up the OpenGL display environment after rendering.
+ @brief PostRender Draw the text of this frame, then set up the OpenGL display environment after rendering.
  */
 void CTextRenderer::PostRender(void)
 {
+	Flush();
+
+	uiLastNumDrawCalls = uiNumDrawCalls;
+	uiLastNumGlyphs = uiNumGlyphs;
+	LOG_TRACE_EVERY(1.0, RENDER, "CTextRenderer: %u glyphs in %u draw calls", uiLastNumGlyphs, uiLastNumDrawCalls);
+
 	// Disable blending
 	glDisable(GL_BLEND);
 }
+
+/**
+ @brief Get the number of draw calls used for the text in the last frame
+ @return The number of draw calls
+ */
+unsigned int CTextRenderer::GetNumDrawCalls(void) const
+{
+	return uiLastNumDrawCalls;
+}
+
+/**
+ @brief Get the number of glyphs drawn in the last frame
+ @return The number of glyphs
+ */
+unsigned int CTextRenderer::GetNumGlyphs(void) const
+{
+	return uiLastNumGlyphs;
+}
+
+/**
+ @brief Get a character, adding it to the atlas if it is not there yet
+ @param uiCodePoint The Unicode code point of the character
+ @return The character, or NULL if it cannot be loaded
+ */
+const CTextRenderer::Character* CTextRenderer::GetCharacter(const unsigned int uiCodePoint)
+{
+	std::unordered_map<unsigned int, Character>::const_iterator it = Characters.find(uiCodePoint);
+	if (it != Characters.end())
+		return &it->second;
+
+	if (AddCharacters(&uiCodePoint, 1) == false)
+	{
+		// Use '?' for this code point from now on, so that we do not try to load it again
+		it = Characters.find('?');
+		if (it == Characters.end())
+			return NULL;
+		Characters[uiCodePoint] = it->second;
+	}
+
+	return &Characters[uiCodePoint];
+}
+
+/**
+ @brief Rasterize characters with FreeType and pack them into the atlas
+ @param arrCodePoints The Unicode code points of the characters
+ @param iNumCodePoints The number of code points
+ @return true if all the characters were added, else false
+ */
+bool CTextRenderer::AddCharacters(const unsigned int* arrCodePoints, const int iNumCodePoints)
+{
+	if ((ftFace == NULL) || (cPackContext == NULL))
+		return false;
+
+	// Rasterize the glyphs and keep their bitmaps until they are packed
+	std::vector<Character> vCharacter(iNumCodePoints);
+	std::vector< std::vector<unsigned char> > vBitmap(iNumCodePoints);
+	std::vector<stbrp_rect> vRect(iNumCodePoints);
+	int iNumRects = 0;
+	for (int i = 0; i < iNumCodePoints; i++)
+	{
+		// Load character glyph 
+		if (FT_Load_Char(ftFace, arrCodePoints[i], FT_LOAD_RENDER))
+		{
+			LOG_WARNING(RENDER, "CTextRenderer: Failed to load glyph U+%04X", arrCodePoints[i]);
+			continue;
+		}
+
+		const FT_Bitmap& bitmap = ftFace->glyph->bitmap;
+		Character& character = vCharacter[iNumRects];
+		character.Size = glm::ivec2(bitmap.width, bitmap.rows);
+		character.Bearing = glm::ivec2(ftFace->glyph->bitmap_left, ftFace->glyph->bitmap_top);
+		character.Advance = (GLuint)ftFace->glyph->advance.x;
+		character.GlyphIndex = FT_Get_Char_Index(ftFace, arrCodePoints[i]);
+
+		// Copy the rows, since the pitch of the FreeType bitmap may be larger than its width
+		vBitmap[iNumRects].resize(bitmap.width * bitmap.rows);
+		for (unsigned int row = 0; row < bitmap.rows; row++)
+			memcpy(&vBitmap[iNumRects][row * bitmap.width], bitmap.buffer + row * bitmap.pitch, bitmap.width);
+
+		// Leave 1 pixel of padding around each glyph, so that linear filtering does not sample its neighbours
+		vRect[iNumRects].id = (int)arrCodePoints[i];
+		vRect[iNumRects].w = (stbrp_coord)(bitmap.width + 2);
+		vRect[iNumRects].h = (stbrp_coord)(bitmap.rows + 2);
+		iNumRects++;
+	}
+	if (iNumRects == 0)
+		return false;
+
+	bool bAllPacked = (stbrp_pack_rects(cPackContext, &vRect[0], iNumRects) != 0) && (iNumRects == iNumCodePoints);
+
+	// Upload the packed glyphs into the atlas
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glBindTexture(GL_TEXTURE_2D, uiAtlasTextureID);
+	for (int i = 0; i < iNumRects; i++)
+	{
+		// stbrp_pack_rects() reorders the rects while it runs, but restores their order before it returns
+		if (vRect[i].was_packed == 0)
+		{
+			LOG_WARNING(RENDER, "CTextRenderer: The glyph atlas is full. U+%04X is not added", (unsigned int)vRect[i].id);
+			continue;
+		}
+
+		Character& character = vCharacter[i];
+		const int iX = vRect[i].x + 1;
+		const int iY = vRect[i].y + 1;
+		if ((character.Size.x > 0) && (character.Size.y > 0))
+			glTexSubImage2D(GL_TEXTURE_2D, 0, iX, iY, character.Size.x, character.Size.y, GL_RED, GL_UNSIGNED_BYTE, &vBitmap[i][0]);
+
+		character.UV = glm::vec4(	(float)iX / iAtlasSize,
+									(float)iY / iAtlasSize,
+									(float)(iX + character.Size.x) / iAtlasSize,
+									(float)(iY + character.Size.y) / iAtlasSize);
+
+		// Now store character for later use
+		Characters[(unsigned int)vRect[i].id] = character;
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	return bAllPacked;
+}
+
+/**
+ @brief Decode the next Unicode code point from a UTF-8 string
+ @param text The UTF-8 encoded string
+ @param uiPos The position of the next byte to decode. It is moved past the decoded bytes.
+ @return The code point, or U+FFFD if the bytes are not valid UTF-8
+ */
+unsigned int CTextRenderer::DecodeUTF8(const std::string& text, size_t& uiPos)
+{
+	const unsigned char c = (unsigned char)text[uiPos++];
+	if (c < 0x80)
+		return c;
+
+	// Find the number of continuation bytes from the lead byte
+	int iNumBytes = 0;
+	unsigned int uiCodePoint = 0;
+	if ((c & 0xE0) == 0xC0)
+	{
+		iNumBytes = 1;
+		uiCodePoint = c & 0x1F;
+	}
+	else if ((c & 0xF0) == 0xE0)
+	{
+		iNumBytes = 2;
+		uiCodePoint = c & 0x0F;
+	}
+	else if ((c & 0xF8) == 0xF0)
+	{
+		iNumBytes = 3;
+		uiCodePoint = c & 0x07;
+	}
+	else
+		return 0xFFFD;
+
+	for (int i = 0; i < iNumBytes; i++)
+	{
+		if ((uiPos >= text.size()) || (((unsigned char)text[uiPos] & 0xC0) != 0x80))
+			return 0xFFFD;
+		uiCodePoint = (uiCodePoint << 6) | ((unsigned char)text[uiPos++] & 0x3F);
+	}
+
+	return uiCodePoint;
+}
@@ -23,7 +23,14 @@
 #include "../Primitives/Entity2D.h"
 
 #include <string>
-#include <map>
+#include <vector>
+#include <unordered_map>
+
+// FreeType and stb_rect_pack are only used in TextRenderer.cpp
+struct FT_LibraryRec_;
+struct FT_FaceRec_;
+struct stbrp_context;
+struct stbrp_node;
 
 class CTextRenderer : public CSingletonTemplate<CTextRenderer>, public CEntity2D
 {
@@ -31,10 +38,18 @@ class CTextRenderer : public CSingletonTemplate<CTextRenderer>, public CEntity2D
 
 	// Holds all state information relevant to a character as loaded using FreeType
 	struct Character {
-		GLuint TextureID;   // ID handle of the glyph texture
-		glm::ivec2 Size;    // Size of glyph
-		glm::ivec2 Bearing;  // Offset from baseline to left/top of glyph
-		GLuint Advance;    // Horizontal offset to advance to next glyph
+		glm::vec4 UV;			// Rectangle of the glyph in the atlas: u0, v0, u1, v1
+		glm::ivec2 Size;		// Size of glyph
+		glm::ivec2 Bearing;		// Offset from baseline to left/top of glyph
+		GLuint Advance;			// Horizontal offset to advance to next glyph
+		unsigned int GlyphIndex;	// FreeType glyph index, used for kerning
+	};
+
+	// A vertex of a glyph quad: position, texture coordinates and colour
+	struct TextVertex {
+		GLfloat x, y;
+		GLfloat u, v;
+		GLfloat r, g, b;
 	};
 
 public:
@@ -47,20 +62,61 @@ public:
 	// PreRender
 	void PreRender(void);
 
-	// Render
+	// Render. The text is UTF-8 encoded, and it is drawn together with the
+	// other text of this frame when PostRender() or Flush() is called.
 	void Render(std::string text, GLfloat x, GLfloat y, GLfloat scale, glm::vec3 colour);
 
+	// Draw all the text added since the last Flush() in one draw call
+	void Flush(void);
+
 	// PostRender
 	void PostRender(void);
 
+	// Get the number of draw calls used for the text in the last frame
+	unsigned int GetNumDrawCalls(void) const;
+	// Get the number of glyphs drawn in the last frame
+	unsigned int GetNumGlyphs(void) const;
+
 protected:
-	// Map of characters
-	std::map<GLchar, Character> Characters;
+	// The size of the glyph atlas texture
+	static const int iAtlasSize = 1024;
+	// The pixel size of the font
+	static const int iFontSize = 40;
+
+	// Map of characters which are in the atlas, indexed by Unicode code point
+	std::unordered_map<unsigned int, Character> Characters;
+
+	// The glyph atlas
+	GLuint uiAtlasTextureID;
+	stbrp_context* cPackContext;
+	stbrp_node* arrPackNodes;
+
+	// The font, kept open so that glyphs can be added to the atlas when they are first used
+	FT_LibraryRec_* ftLibrary;
+	FT_FaceRec_* ftFace;
+	bool bHasKerning;
+
+	// The vertices of the glyphs which are waiting to be drawn
+	std::vector<TextVertex> vVertices;
+	// The capacity of the VBO in vertices
+	unsigned int uiVBOCapacity;
+
+	// Statistics for the current and last frame
+	unsigned int uiNumDrawCalls;
+	unsigned int uiNumGlyphs;
+	unsigned int uiLastNumDrawCalls;
+	unsigned int uiLastNumGlyphs;
 
 	// Constructor
 	CTextRenderer(void);
 
 	// Destructor
 	virtual ~CTextRenderer(void);
-};
 
+	// Get a character, adding it to the atlas if it is not there yet. Returns NULL if it cannot be loaded.
+	const Character* GetCharacter(const unsigned int uiCodePoint);
+	// Rasterize characters with FreeType and pack them into the atlas
+	bool AddCharacters(const unsigned int* arrCodePoints, const int iNumCodePoints);
+	// Decode the next Unicode code point from a UTF-8 string
+	static unsigned int DecodeUTF8(const std::string& text, size_t& uiPos);
+};
@@ -0,0 +1,407 @@
+#include "TileMapRenderer.h"
+
+// Include CLogger
+#include "../System/Logger.h"
+
+/**
+ @brief Constructor
+ */
+CTileMapRenderer::CTileMapRenderer(void)
+	: uiTextureArray(0)
+	, uiNumLayers(0)
+	, uiNumRowsUploaded(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CTileMapRenderer::~CTileMapRenderer(void)
+{
+	for (unsigned int i = 0; i < vLevel.size(); i++)
+		DeleteLevel(vLevel[i]);
+	vLevel.clear();
+
+	if (uiTextureArray != 0)
+	{
+		glDeleteTextures(1, &uiTextureArray);
+		uiTextureArray = 0;
+	}
+}
+
+/**
+ @brief Initialise this class instance for a number of levels. The levels which are below uiNumLevels are kept,
+		so this can add a level for a while and remove it again.
+ @param uiNumLevels A const unsigned int variable containing the number of levels
+ @return true if the initialisation is successful, else false
+ */
+bool CTileMapRenderer::Init(const unsigned int uiNumLevels)
+{
+	for (unsigned int i = uiNumLevels; i < vLevel.size(); i++)
+		DeleteLevel(vLevel[i]);
+
+	const unsigned int uiOldNumLevels = vLevel.size();
+	vLevel.resize(uiNumLevels);
+	for (unsigned int i = uiOldNumLevels; i < uiNumLevels; i++)
+	{
+		vLevel[i].VAO = 0;
+		vLevel[i].VBO = 0;
+		vLevel[i].EBO = 0;
+		vLevel[i].uiNumRows = 0;
+		vLevel[i].uiNumCols = 0;
+		vLevel[i].bDirty = false;
+	}
+	return true;
+}
+
+/**
+ @brief Add the image of a tile texture. The images are packed into the array texture by BuildTextures().
+ @param iTextureCode A const int variable containing the code of the tiles which use this texture
+ @param pData A const unsigned char* variable containing the pixels, with the first row at the bottom
+ @param iWidth A const int variable containing the width of the image
+ @param iHeight A const int variable containing the height of the image
+ @param iNumChannels A const int variable containing the number of channels, which must be 3 or 4
+ @return true if the image is added, else false
+ */
+bool CTileMapRenderer::AddTexture(	const int iTextureCode,
+									const unsigned char* pData,
+									const int iWidth,
+									const int iHeight,
+									const int iNumChannels)
+{
+	if ((pData == NULL) || (iTextureCode <= 0) || (iWidth <= 0) || (iHeight <= 0) ||
+		((iNumChannels != 3) && (iNumChannels != 4)))
+	{
+		LOG_ERROR(RENDER, "CTileMapRenderer::AddTexture - Invalid image for texture code %d", iTextureCode);
+		return false;
+	}
+
+	// Store the image as RGBA, so that every layer of the array texture has the same format
+	PendingImage cImage;
+	cImage.iTextureCode = iTextureCode;
+	cImage.iWidth = iWidth;
+	cImage.iHeight = iHeight;
+	cImage.vRGBA.resize(iWidth * iHeight * 4);
+	for (int i = 0; i < iWidth * iHeight; i++)
+	{
+		cImage.vRGBA[i * 4 + 0] = pData[i * iNumChannels + 0];
+		cImage.vRGBA[i * 4 + 1] = pData[i * iNumChannels + 1];
+		cImage.vRGBA[i * 4 + 2] = pData[i * iNumChannels + 2];
+		cImage.vRGBA[i * 4 + 3] = (iNumChannels == 4) ? pData[i * iNumChannels + 3] : 255;
+	}
+	vPendingImage.push_back(cImage);
+	return true;
+}
+
+/**
+ @brief Pack the images into the array texture, and free them.
+		The layers are the size of the largest image; smaller images are scaled up to fill a layer.
+ @return true if the array texture is built, else false
+ */
+bool CTileMapRenderer::BuildTextures(void)
+{
+	if (vPendingImage.empty())
+	{
+		LOG_WARNING(RENDER, "CTileMapRenderer::BuildTextures - There are no tile textures");
+		return false;
+	}
+
+	int iLayerWidth = 0, iLayerHeight = 0, iMaxCode = 0;
+	for (unsigned int i = 0; i < vPendingImage.size(); i++)
+	{
+		if (vPendingImage[i].iWidth > iLayerWidth)
+			iLayerWidth = vPendingImage[i].iWidth;
+		if (vPendingImage[i].iHeight > iLayerHeight)
+			iLayerHeight = vPendingImage[i].iHeight;
+		if (vPendingImage[i].iTextureCode > iMaxCode)
+			iMaxCode = vPendingImage[i].iTextureCode;
+	}
+
+	if (uiTextureArray != 0)
+		glDeleteTextures(1, &uiTextureArray);
+	glGenTextures(1, &uiTextureArray);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, uiTextureArray);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	// The tiles are drawn at about the size of their textures, so the layers have no mipmaps
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, iLayerWidth, iLayerHeight, (GLsizei)vPendingImage.size(),
+				0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+	vLayerOfCode.assign(iMaxCode + 1, -1);
+	vector<unsigned char> vLayer(iLayerWidth * iLayerHeight * 4);
+	for (unsigned int i = 0; i < vPendingImage.size(); i++)
+	{
+		const PendingImage& cImage = vPendingImage[i];
+		const unsigned char* pPixels = &cImage.vRGBA[0];
+		if ((cImage.iWidth != iLayerWidth) || (cImage.iHeight != iLayerHeight))
+		{
+			// Scale the image to the size of a layer with the nearest pixels
+			for (int y = 0; y < iLayerHeight; y++)
+			{
+				const int iSrcY = y * cImage.iHeight / iLayerHeight;
+				for (int x = 0; x < iLayerWidth; x++)
+				{
+					const int iSrcX = x * cImage.iWidth / iLayerWidth;
+					for (int c = 0; c < 4; c++)
+						vLayer[(y * iLayerWidth + x) * 4 + c] = cImage.vRGBA[(iSrcY * cImage.iWidth + iSrcX) * 4 + c];
+				}
+			}
+			pPixels = &vLayer[0];
+		}
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, iLayerWidth, iLayerHeight, 1, GL_RGBA, GL_UNSIGNED_BYTE, pPixels);
+		vLayerOfCode[cImage.iTextureCode] = i;
+	}
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	uiNumLayers = vPendingImage.size();
+	vPendingImage.clear();
+	vPendingImage.shrink_to_fit();
+
+	LOG_INFO(RENDER, "CTileMapRenderer::BuildTextures - Packed %u tile textures into %dx%d layers",
+			uiNumLayers, iLayerWidth, iLayerHeight);
+	return true;
+}
+
+/**
+ @brief Set the size of a level and create its vertex buffer. All its tiles are empty.
+ @param uiLevel A const unsigned int variable containing the level
+ @param uiNumRows A const unsigned int variable containing the number of rows
+ @param uiNumCols A const unsigned int variable containing the number of columns
+ @param fLeft A const float variable containing the left edge of column 0
+ @param fTop A const float variable containing the top edge of row 0
+ @param fTileWidth A const float variable containing the width of a tile
+ @param fTileHeight A const float variable containing the height of a tile
+ @return true if the level is created, else false
+ */
+bool CTileMapRenderer::SetLevelSize(const unsigned int uiLevel,
+									const unsigned int uiNumRows,
+									const unsigned int uiNumCols,
+									const float fLeft,
+									const float fTop,
+									const float fTileWidth,
+									const float fTileHeight)
+{
+	if (uiLevel >= vLevel.size())
+	{
+		LOG_ERROR(RENDER, "CTileMapRenderer::SetLevelSize - Invalid level %u", uiLevel);
+		return false;
+	}
+
+	Level& cLevel = vLevel[uiLevel];
+	DeleteLevel(cLevel);
+	cLevel.uiNumRows = uiNumRows;
+	cLevel.uiNumCols = uiNumCols;
+	cLevel.fLeft = fLeft;
+	cLevel.fTop = fTop;
+	cLevel.fTileWidth = fTileWidth;
+	cLevel.fTileHeight = fTileHeight;
+
+	const unsigned int uiNumTiles = uiNumRows * uiNumCols;
+	TileVertex cEmpty;
+	cEmpty.vec2Position = glm::vec2(0.0f);
+	cEmpty.vec3TexCoord = glm::vec3(0.0f);
+	cLevel.vVertex.assign(uiNumTiles * 4, cEmpty);
+	cLevel.vDirtyRow.assign(uiNumRows, 0);
+	cLevel.bDirty = false;
+
+	// The quads of the tiles never change order, so the indices are built once
+	vector<GLuint> vIndex(uiNumTiles * 6);
+	for (unsigned int i = 0; i < uiNumTiles; i++)
+	{
+		vIndex[i * 6 + 0] = i * 4 + 3;
+		vIndex[i * 6 + 1] = i * 4 + 0;
+		vIndex[i * 6 + 2] = i * 4 + 2;
+		vIndex[i * 6 + 3] = i * 4 + 1;
+		vIndex[i * 6 + 4] = i * 4 + 2;
+		vIndex[i * 6 + 5] = i * 4 + 0;
+	}
+
+	glGenVertexArrays(1, &cLevel.VAO);
+	glGenBuffers(1, &cLevel.VBO);
+	glGenBuffers(1, &cLevel.EBO);
+	glBindVertexArray(cLevel.VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, cLevel.VBO);
+	glBufferData(GL_ARRAY_BUFFER, cLevel.vVertex.size() * sizeof(TileVertex), cLevel.vVertex.data(), GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cLevel.EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, vIndex.size() * sizeof(GLuint), vIndex.data(), GL_STATIC_DRAW);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(TileVertex), (void*)offsetof(TileVertex, vec2Position));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(TileVertex), (void*)offsetof(TileVertex, vec3TexCoord));
+	glBindVertexArray(0);
+
+	return true;
+}
+
+/**
+ @brief Set the texture code of a tile. A code of 0, or a code without a texture, is an empty tile.
+ @param uiLevel A const unsigned int variable containing the level
+ @param uiRow A const unsigned int variable containing the row, where row 0 is at the top
+ @param uiCol A const unsigned int variable containing the column
+ @param iTextureCode A const int variable containing the texture code
+ */
+void CTileMapRenderer::SetTile(const unsigned int uiLevel, const unsigned int uiRow, const unsigned int uiCol, const int iTextureCode)
+{
+	if (uiLevel >= vLevel.size())
+		return;
+	Level& cLevel = vLevel[uiLevel];
+	if ((uiRow >= cLevel.uiNumRows) || (uiCol >= cLevel.uiNumCols))
+		return;
+
+	TileVertex* pVertex = &cLevel.vVertex[(uiRow * cLevel.uiNumCols + uiCol) * 4];
+	const int iLayer = GetLayer(iTextureCode);
+	if (iLayer < 0)
+	{
+		// Collapse the quad so that it covers no pixels
+		for (int i = 0; i < 4; i++)
+		{
+			pVertex[i].vec2Position = glm::vec2(0.0f);
+			pVertex[i].vec3TexCoord = glm::vec3(0.0f);
+		}
+	}
+	else
+	{
+		const float fLayer = (float)iLayer;
+		const float fLeft = cLevel.fLeft + uiCol * cLevel.fTileWidth;
+		const float fRight = fLeft + cLevel.fTileWidth;
+		const float fTop = cLevel.fTop - uiRow * cLevel.fTileHeight;
+		const float fBottom = fTop - cLevel.fTileHeight;
+		pVertex[0].vec2Position = glm::vec2(fLeft, fBottom);
+		pVertex[0].vec3TexCoord = glm::vec3(0.0f, 0.0f, fLayer);
+		pVertex[1].vec2Position = glm::vec2(fRight, fBottom);
+		pVertex[1].vec3TexCoord = glm::vec3(1.0f, 0.0f, fLayer);
+		pVertex[2].vec2Position = glm::vec2(fRight, fTop);
+		pVertex[2].vec3TexCoord = glm::vec3(1.0f, 1.0f, fLayer);
+		pVertex[3].vec2Position = glm::vec2(fLeft, fTop);
+		pVertex[3].vec3TexCoord = glm::vec3(0.0f, 1.0f, fLayer);
+	}
+
+	cLevel.vDirtyRow[uiRow] = 1;
+	cLevel.bDirty = true;
+}
+
+/**
+ @brief Upload the changed rows of a level now, such as for a level which is about to be shown,
+		so that its next Render() does not have to upload them
+ @param uiLevel A const unsigned int variable containing the level
+ */
+void CTileMapRenderer::Upload(const unsigned int uiLevel)
+{
+	if ((uiLevel >= vLevel.size()) || (vLevel[uiLevel].VAO == 0))
+		return;
+	UploadDirtyRows(vLevel[uiLevel]);
+}
+
+/**
+ @brief Draw the rows of a level with one draw call. The array texture is bound to texture unit 0.
+ @param uiLevel A const unsigned int variable containing the level
+ @param uiFirstRow A const unsigned int variable containing the first row to draw
+ @param uiNumRows A const unsigned int variable containing the number of rows to draw
+ */
+void CTileMapRenderer::Render(const unsigned int uiLevel, const unsigned int uiFirstRow, const unsigned int uiNumRows)
+{
+	uiNumRowsUploaded = 0;
+	if ((uiLevel >= vLevel.size()) || (vLevel[uiLevel].VAO == 0))
+		return;
+
+	Level& cLevel = vLevel[uiLevel];
+	UploadDirtyRows(cLevel);
+
+	if (uiFirstRow >= cLevel.uiNumRows)
+		return;
+	const unsigned int uiLastRow = (uiNumRows > cLevel.uiNumRows - uiFirstRow) ? cLevel.uiNumRows : uiFirstRow + uiNumRows;
+	const size_t uiFirstIndex = (size_t)uiFirstRow * cLevel.uiNumCols * 6;
+	const GLsizei iNumIndices = (GLsizei)((uiLastRow - uiFirstRow) * cLevel.uiNumCols * 6);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, uiTextureArray);
+	glBindVertexArray(cLevel.VAO);
+	glDrawElements(GL_TRIANGLES, iNumIndices, GL_UNSIGNED_INT, (void*)(uiFirstIndex * sizeof(GLuint)));
+	glBindVertexArray(0);
+}
+
+/**
+ @brief Get the number of layers in the array texture
+ @return An unsigned int variable
+ */
+unsigned int CTileMapRenderer::GetNumLayers(void) const
+{
+	return uiNumLayers;
+}
+
+/**
+ @brief Get the number of rows which were uploaded in the last Render()
+ @return An unsigned int variable
+ */
+unsigned int CTileMapRenderer::GetNumRowsUploaded(void) const
+{
+	return uiNumRowsUploaded;
+}
+
+/**
+ @brief Delete the buffers of a level
+ @param cLevel A Level& variable containing the level
+ */
+void CTileMapRenderer::DeleteLevel(Level& cLevel)
+{
+	if (cLevel.VAO != 0)
+		glDeleteVertexArrays(1, &cLevel.VAO);
+	if (cLevel.VBO != 0)
+		glDeleteBuffers(1, &cLevel.VBO);
+	if (cLevel.EBO != 0)
+		glDeleteBuffers(1, &cLevel.EBO);
+	cLevel.VAO = 0;
+	cLevel.VBO = 0;
+	cLevel.EBO = 0;
+	cLevel.vVertex.clear();
+	cLevel.vDirtyRow.clear();
+}
+
+/**
+ @brief Get the layer of a texture code, or -1 if it has no texture
+ @param iTextureCode A const int variable containing the texture code
+ @return An int variable
+ */
+int CTileMapRenderer::GetLayer(const int iTextureCode) const
+{
+	if ((iTextureCode <= 0) || (iTextureCode >= (int)vLayerOfCode.size()))
+		return -1;
+	return vLayerOfCode[iTextureCode];
+}
+
+/**
+ @brief Upload the rows of a level which have been changed. Adjacent rows are uploaded together.
+ @param cLevel A Level& variable containing the level
+ */
+void CTileMapRenderer::UploadDirtyRows(Level& cLevel)
+{
+	if (cLevel.bDirty == false)
+		return;
+
+	const size_t uiRowSize = (size_t)cLevel.uiNumCols * 4 * sizeof(TileVertex);
+	glBindBuffer(GL_ARRAY_BUFFER, cLevel.VBO);
+	unsigned int uiRow = 0;
+	while (uiRow < cLevel.uiNumRows)
+	{
+		if (cLevel.vDirtyRow[uiRow] == 0)
+		{
+			uiRow++;
+			continue;
+		}
+
+		unsigned int uiEnd = uiRow;
+		while ((uiEnd < cLevel.uiNumRows) && (cLevel.vDirtyRow[uiEnd] != 0))
+		{
+			cLevel.vDirtyRow[uiEnd] = 0;
+			uiEnd++;
+		}
+		glBufferSubData(GL_ARRAY_BUFFER, uiRow * uiRowSize, (uiEnd - uiRow) * uiRowSize,
+						&cLevel.vVertex[(size_t)uiRow * cLevel.uiNumCols * 4]);
+		uiNumRowsUploaded += uiEnd - uiRow;
+		uiRow = uiEnd;
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	cLevel.bDirty = false;
+}
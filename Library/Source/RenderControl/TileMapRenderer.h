@@ -0,0 +1,122 @@
+/**
+ CTileMapRenderer
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include GLEW
+#ifndef GLEW_STATIC
+#include <GL/glew.h>
+#define GLEW_STATIC
+#endif
+
+// Include GLM
+#include <includes/glm.hpp>
+#include <includes/gtc/matrix_transform.hpp>
+#include <includes/gtc/type_ptr.hpp>
+
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+// Draws a grid of tiles with one draw call per level. The tile textures are packed into the layers of one
+// array texture, and each level keeps a static vertex buffer with a quad for every tile, whose texture
+// coordinates select the layer of its tile. An empty tile has a quad of zero size. Changing a tile only
+// rewrites its row of the vertex buffer, which is uploaded before the next Render().
+// Row 0 of a level is drawn at the top, and the tiles fill a rectangle from fLeft to fLeft + uiNumCols * fTileWidth
+// and from fTop down to fTop - uiNumRows * fTileHeight.
+class CTileMapRenderer
+{
+public:
+	// Constructor
+	CTileMapRenderer(void);
+	// Destructor
+	virtual ~CTileMapRenderer(void);
+
+	// Initialise this class instance for a number of levels. The levels which are below uiNumLevels are kept.
+	bool Init(const unsigned int uiNumLevels);
+
+	// Add the image of a tile texture. The images are packed into the array texture by BuildTextures().
+	bool AddTexture(const int iTextureCode,
+					const unsigned char* pData,
+					const int iWidth,
+					const int iHeight,
+					const int iNumChannels);
+	// Pack the images into the array texture, and free them
+	bool BuildTextures(void);
+
+	// Set the size of a level and create its vertex buffer. All its tiles are empty.
+	bool SetLevelSize(	const unsigned int uiLevel,
+						const unsigned int uiNumRows,
+						const unsigned int uiNumCols,
+						const float fLeft,
+						const float fTop,
+						const float fTileWidth,
+						const float fTileHeight);
+	// Set the texture code of a tile. A code of 0, or a code without a texture, is an empty tile.
+	void SetTile(const unsigned int uiLevel, const unsigned int uiRow, const unsigned int uiCol, const int iTextureCode);
+	// Upload the changed rows of a level now, instead of in its next Render()
+	void Upload(const unsigned int uiLevel);
+
+	// Draw the rows of a level with one draw call. The array texture is bound to texture unit 0.
+	void Render(const unsigned int uiLevel, const unsigned int uiFirstRow = 0, const unsigned int uiNumRows = 0xFFFFFFFF);
+
+	// Get the number of layers in the array texture
+	unsigned int GetNumLayers(void) const;
+	// Get the number of rows which were uploaded in the last Render()
+	unsigned int GetNumRowsUploaded(void) const;
+
+protected:
+	// A vertex of a tile, whose texture coordinate z is the layer in the array texture
+	struct TileVertex
+	{
+		glm::vec2 vec2Position;
+		glm::vec3 vec3TexCoord;
+	};
+
+	// The buffers and the tiles of a level
+	struct Level
+	{
+		GLuint VAO;
+		GLuint VBO;
+		GLuint EBO;
+		unsigned int uiNumRows;
+		unsigned int uiNumCols;
+		float fLeft;
+		float fTop;
+		float fTileWidth;
+		float fTileHeight;
+		// 4 vertices per tile, in the order of the rows
+		vector<TileVertex> vVertex;
+		// 1 if the row has been changed since it was last uploaded
+		vector<unsigned char> vDirtyRow;
+		bool bDirty;
+	};
+
+	// An image which is waiting to be packed into the array texture
+	struct PendingImage
+	{
+		int iTextureCode;
+		int iWidth;
+		int iHeight;
+		vector<unsigned char> vRGBA;
+	};
+
+	vector<Level> vLevel;
+
+	// The array texture, and the layer of each texture code, or -1 if it has no texture
+	GLuint uiTextureArray;
+	vector<int> vLayerOfCode;
+	unsigned int uiNumLayers;
+	vector<PendingImage> vPendingImage;
+
+	unsigned int uiNumRowsUploaded;
+
+	// Delete the buffers of a level
+	void DeleteLevel(Level& cLevel);
+	// Get the layer of a texture code, or -1 if it has no texture
+	int GetLayer(const int iTextureCode) const;
+	// Upload the rows of a level which have been changed
+	void UploadDirtyRows(Level& cLevel);
+};
@@ -0,0 +1,176 @@
+#include "FrameArena.h"
+
+// Include CLogger
+#include "Logger.h"
+
+#include <cstdlib>
+#include <new>
+
+/**
+ @brief Constructor
+ */
+CFrameArena::CFrameArena(void)
+	: pBuffer(NULL)
+	, uiSize(0)
+	, uiUsed(0)
+	, uiNeeded(0)
+	, uiPeakNeeded(0)
+	, uiLastUsed(0)
+	, uiLastNumOverflows(0)
+	, uiNumOverflows(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CFrameArena::~CFrameArena(void)
+{
+	FreeOverflow(0);
+	if (pBuffer)
+	{
+		::operator delete(pBuffer);
+		pBuffer = NULL;
+	}
+}
+
+/**
+ @brief Initialise this class instance
+ @param uiSize A const size_t variable containing the size of the buffer in bytes
+ @return true if the initialisation is successful, else false
+ */
+bool CFrameArena::Init(const size_t uiSize)
+{
+	FreeOverflow(0);
+	if (pBuffer)
+		::operator delete(pBuffer);
+
+	pBuffer = static_cast<unsigned char*>(::operator new(uiSize, std::nothrow));
+	if (pBuffer == NULL)
+	{
+		LOG_ERROR(GENERAL, "CFrameArena::Init - Unable to allocate %u bytes", (unsigned int)uiSize);
+		this->uiSize = 0;
+		return false;
+	}
+	this->uiSize = uiSize;
+	uiUsed = 0;
+	uiNeeded = 0;
+	uiPeakNeeded = 0;
+	uiNumOverflows = 0;
+	return true;
+}
+
+/**
+ @brief Free all allocations. This is called at the start of each frame.
+ */
+void CFrameArena::Reset(void)
+{
+	uiLastUsed = uiNeeded;
+	uiLastNumOverflows = uiNumOverflows;
+
+	FreeOverflow(0);
+
+	// Grow the buffer if the last frame did not fit in it
+	if (uiPeakNeeded > uiSize)
+	{
+		size_t uiNewSize = (uiSize > 0) ? uiSize : 1024;
+		while (uiNewSize < uiPeakNeeded)
+			uiNewSize *= 2;
+		LOG_INFO(GENERAL, "CFrameArena::Reset - Growing the arena from %u to %u bytes",
+				(unsigned int)uiSize, (unsigned int)uiNewSize);
+		Init(uiNewSize);
+	}
+
+	uiUsed = 0;
+	uiNeeded = 0;
+	uiNumOverflows = 0;
+}
+
+/**
+ @brief Allocate memory which is valid until the next Reset()
+ @param uiSize A const size_t variable containing the number of bytes to allocate
+ @param uiAlignment A const size_t variable containing the alignment, which must be a power of 2
+ @return A void* variable
+ */
+void* CFrameArena::Allocate(const size_t uiSize, const size_t uiAlignment)
+{
+	// uiUsed keeps counting past the end of the buffer, so that it measures the size which would have fitted
+	const size_t uiStart = (uiUsed + uiAlignment - 1) & ~(uiAlignment - 1);
+	const size_t uiEnd = uiStart + uiSize;
+	uiUsed = uiEnd;
+	if (uiUsed > uiNeeded)
+		uiNeeded = uiUsed;
+	if (uiNeeded > uiPeakNeeded)
+		uiPeakNeeded = uiNeeded;
+
+	if ((pBuffer != NULL) && (uiEnd <= this->uiSize))
+		return pBuffer + uiStart;
+
+	// The buffer is full, so use the heap until the next Reset() or Rewind()
+	uiNumOverflows++;
+	void* p = ::operator new(uiSize);
+	vOverflow.push_back(p);
+	return p;
+}
+
+/**
+ @brief Get the current position in the arena
+ @return A Marker variable
+ */
+CFrameArena::Marker CFrameArena::GetMarker(void) const
+{
+	Marker cMarker;
+	cMarker.uiUsed = uiUsed;
+	cMarker.uiNumOverflow = vOverflow.size();
+	return cMarker;
+}
+
+/**
+ @brief Free the allocations which were made after a marker
+ @param cMarker A const Marker& variable which was returned by GetMarker() in the current frame
+ */
+void CFrameArena::Rewind(const Marker& cMarker)
+{
+	if (cMarker.uiUsed < uiUsed)
+		uiUsed = cMarker.uiUsed;
+	FreeOverflow(cMarker.uiNumOverflow);
+}
+
+/**
+ @brief Get the size of the buffer in bytes
+ @return A size_t variable
+ */
+size_t CFrameArena::GetSize(void) const
+{
+	return uiSize;
+}
+
+/**
+ @brief Get the number of bytes which were allocated in the last frame
+ @return A size_t variable
+ */
+size_t CFrameArena::GetNumBytesUsed(void) const
+{
+	return uiLastUsed;
+}
+
+/**
+ @brief Get the number of allocations which did not fit in the buffer in the last frame
+ @return An unsigned int variable
+ */
+unsigned int CFrameArena::GetNumOverflows(void) const
+{
+	return uiLastNumOverflows;
+}
+
+/**
+ @brief Free the allocations which did not fit in the buffer, from an index onwards
+ @param uiFirst A const size_t variable containing the index of the first allocation to free
+ */
+void CFrameArena::FreeOverflow(const size_t uiFirst)
+{
+	for (size_t i = uiFirst; i < vOverflow.size(); i++)
+		::operator delete(vOverflow[i]);
+	if (uiFirst < vOverflow.size())
+		vOverflow.resize(uiFirst);
+}
@@ -0,0 +1,137 @@
+/**
+ CFrameArena
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "../DesignPatterns/SingletonTemplate.h"
+
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+// A linear allocator for the transient data of a frame, such as the temporary vectors built while loading
+// a model or the terrain. Allocating only moves an offset in one buffer, and nothing is freed until Reset()
+// at the start of the next frame, or until a CFrameArenaScope ends. If the buffer is full, the allocation
+// is taken from the heap instead, and the buffer is grown in the next Reset() to fit the largest frame.
+// This is not thread-safe; it must only be used on the main thread.
+class CFrameArena : public CSingletonTemplate<CFrameArena>
+{
+	friend CSingletonTemplate<CFrameArena>;
+
+public:
+	// A position in the arena, which the arena can be rewound to
+	struct Marker
+	{
+		size_t uiUsed;
+		size_t uiNumOverflow;
+	};
+
+	// Initialise this class instance
+	bool Init(const size_t uiSize = 8 * 1024 * 1024);
+
+	// Free all allocations. This is called at the start of each frame.
+	void Reset(void);
+
+	// Allocate memory which is valid until the next Reset()
+	void* Allocate(const size_t uiSize, const size_t uiAlignment = 16);
+
+	// Get the current position in the arena
+	Marker GetMarker(void) const;
+	// Free the allocations which were made after a marker
+	void Rewind(const Marker& cMarker);
+
+	// Get the size of the buffer in bytes
+	size_t GetSize(void) const;
+	// Get the number of bytes which were allocated in the last frame
+	size_t GetNumBytesUsed(void) const;
+	// Get the number of allocations which did not fit in the buffer in the last frame
+	unsigned int GetNumOverflows(void) const;
+
+protected:
+	// The buffer, and the number of bytes used in it, which may be more than uiSize if it overflowed
+	unsigned char* pBuffer;
+	size_t uiSize;
+	size_t uiUsed;
+
+	// The allocations which did not fit in the buffer
+	vector<void*> vOverflow;
+	// The number of bytes which were needed in the current frame, and the most needed in any frame
+	size_t uiNeeded;
+	size_t uiPeakNeeded;
+
+	// The statistics of the last frame
+	size_t uiLastUsed;
+	unsigned int uiLastNumOverflows;
+	unsigned int uiNumOverflows;
+
+	// Constructor
+	CFrameArena(void);
+	// Destructor
+	virtual ~CFrameArena(void);
+
+	// Free the allocations which did not fit in the buffer, from an index onwards
+	void FreeOverflow(const size_t uiFirst);
+};
+
+// Frees the allocations which were made in the CFrameArena while this is in scope.
+// Declare it before the containers which use a CFrameAllocator, so that they are destroyed first.
+class CFrameArenaScope
+{
+public:
+	// Constructor
+	CFrameArenaScope(void)
+		: cMarker(CFrameArena::GetInstance()->GetMarker())
+	{
+	}
+	// Destructor
+	~CFrameArenaScope(void)
+	{
+		CFrameArena::GetInstance()->Rewind(cMarker);
+	}
+
+protected:
+	CFrameArena::Marker cMarker;
+
+	// This cannot be copied
+	CFrameArenaScope(const CFrameArenaScope&);
+	CFrameArenaScope& operator=(const CFrameArenaScope&);
+};
+
+// A STL allocator which allocates from the CFrameArena, for containers which only live for a frame
+// or inside a CFrameArenaScope. Deallocating does nothing, since the arena frees everything at once.
+template <class T>
+class CFrameAllocator
+{
+public:
+	typedef T value_type;
+
+	CFrameAllocator(void)
+	{
+	}
+	template <class U>
+	CFrameAllocator(const CFrameAllocator<U>&)
+	{
+	}
+
+	T* allocate(const size_t uiNum)
+	{
+		return static_cast<T*>(CFrameArena::GetInstance()->Allocate(uiNum * sizeof(T), alignof(T)));
+	}
+	void deallocate(T*, const size_t)
+	{
+	}
+
+	template <class U>
+	bool operator==(const CFrameAllocator<U>&) const
+	{
+		return true;
+	}
+	template <class U>
+	bool operator!=(const CFrameAllocator<U>&) const
+	{
+		return false;
+	}
+};
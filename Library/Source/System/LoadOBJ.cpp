@@ -9,6 +9,14 @@
 
 #include "LoadOBJ.h"
 
+// Include CFrameArena
+#include "FrameArena.h"
+
+// The temporary containers of the loader, which are allocated from the CFrameArena
+typedef std::vector<unsigned, CFrameAllocator<unsigned> > TempIndexVector;
+typedef std::vector<glm::vec3, CFrameAllocator<glm::vec3> > TempVec3Vector;
+typedef std::vector<glm::vec2, CFrameAllocator<glm::vec2> > TempVec2Vector;
+
 struct PackedVertex{
 	glm::vec3 position;
 	glm::vec2 uv;
@@ -18,12 +26,15 @@ struct PackedVertex{
 	};
 };
 
+typedef std::map<PackedVertex, unsigned short, std::less<PackedVertex>,
+				CFrameAllocator<std::pair<const PackedVertex, unsigned short> > > TempVertexMap;
+
 bool getSimilarVertexIndex_fast( 
 	PackedVertex & packed, 
-	std::map<PackedVertex, unsigned short> & VertexToOutIndex,
+	TempVertexMap & VertexToOutIndex,
 	unsigned short & result
 ){
-	std::map<PackedVertex, unsigned short>::iterator it = VertexToOutIndex.find(packed);
+	TempVertexMap::iterator it = VertexToOutIndex.find(packed);
 	if(it == VertexToOutIndex.end())
 	{
 		return false;
@@ -53,10 +64,12 @@ bool CLoadOBJ::LoadOBJ(
 		return false;
 	}
 
-	std::vector<unsigned> vertexIndices, uvIndices, normalIndices;
-	std::vector<glm::vec3> temp_vertices;
-	std::vector<glm::vec2> temp_uvs;
-	std::vector<glm::vec3> temp_normals;
+	// The temporary vectors are freed from the CFrameArena when this function returns
+	CFrameArenaScope cFrameArenaScope;
+	TempIndexVector vertexIndices, uvIndices, normalIndices;
+	TempVec3Vector temp_vertices;
+	TempVec2Vector temp_uvs;
+	TempVec3Vector temp_normals;
 
 	while (!fileStream.eof())
 	{
@@ -171,7 +184,9 @@ void CLoadOBJ::IndexVBO(
 	std::vector<ModelVertex> & out_vertices
 )
 {
-	std::map<PackedVertex,unsigned short> VertexToOutIndex;
+	// The map is freed from the CFrameArena when this function returns
+	CFrameArenaScope cFrameArenaScope;
+	TempVertexMap VertexToOutIndex;
 
 	// For each input vertex
 	for(unsigned int i = 0; i < in_vertices.size(); ++i) 
@@ -0,0 +1,263 @@
+#include "Logger.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <iostream>
+
+// The names of the levels and categories, used when writing out the log messages
+static const char* arrLevelName[CLogger::NUM_LEVEL] = { "OFF", "ERROR", "WARNING", "INFO", "DEBUG", "TRACE" };
+static const char* arrCategoryName[CLogger::NUM_CATEGORY] = { "General", "Entity", "Collision", "AI", "Weapon", "Physics", "Render", "Map", "Audio" };
+
+// The time when the program started
+static const std::chrono::steady_clock::time_point cStartTime = std::chrono::steady_clock::now();
+
+// The run-time level of each category. Debug and trace messages are off until they are requested
+std::atomic<int> CLogger::arrCategoryLevel[CLogger::NUM_CATEGORY] = {
+	{ CLogger::LEVEL_INFO }, { CLogger::LEVEL_INFO }, { CLogger::LEVEL_INFO },
+	{ CLogger::LEVEL_INFO }, { CLogger::LEVEL_INFO }, { CLogger::LEVEL_INFO },
+	{ CLogger::LEVEL_INFO }, { CLogger::LEVEL_INFO }, { CLogger::LEVEL_INFO } };
+
+/**
+ @brief Constructor
+ */
+CLogger::CLogger(void)
+	: arrSlots(NULL)
+	, uiEnqueuePos(0)
+	, uiDequeuePos(0)
+	, uiNumDropped(0)
+	, bRunning(false)
+	, iOutput(OUTPUT_CONSOLE)
+{
+	arrSlots = new Slot[uiNumSlots];
+	for (unsigned int i = 0; i < uiNumSlots; i++)
+		arrSlots[i].uiSequence.store(i, std::memory_order_relaxed);
+}
+
+/**
+ @brief Destructor
+ */
+CLogger::~CLogger(void)
+{
+	Stop();
+
+	delete[] arrSlots;
+	arrSlots = NULL;
+}
+
+/**
+ @brief Initialise this class instance and start the background thread
+ @param iOutput A bitmask of OUTPUT values
+ @param sFilename The name of the log file, used if iOutput contains OUTPUT_FILE
+ @return true if the initialisation is successful, else false
+ */
+bool CLogger::Init(const int iOutput, const std::string& sFilename)
+{
+	// Stop the background thread if this was initialised before
+	Stop();
+
+	this->iOutput = iOutput;
+	if (iOutput & OUTPUT_FILE)
+	{
+		cFile.open(sFilename.c_str(), std::ios::out | std::ios::trunc);
+		if (!cFile.is_open())
+		{
+			cout << "CLogger::Init() : Unable to open " << sFilename << endl;
+			this->iOutput &= ~OUTPUT_FILE;
+		}
+	}
+
+	bRunning.store(true);
+	cThread = std::thread(&CLogger::Run, this);
+
+	return true;
+}
+
+/**
+ @brief Stop the background thread after writing out the remaining log messages
+ */
+void CLogger::Stop(void)
+{
+	if (bRunning.exchange(false) == false)
+		return;
+
+	if (cThread.joinable())
+		cThread.join();
+
+	// Write out anything which was added after the background thread stopped
+	Drain();
+
+	if (uiNumDropped.load() > 0)
+		cout << "CLogger: " << uiNumDropped.load() << " log messages were dropped" << endl;
+
+	if (cFile.is_open())
+		cFile.close();
+}
+
+/**
+ @brief Set the run-time level of a category
+ @param eCategory The category
+ @param eLevel The highest level of log messages to write for this category
+ */
+void CLogger::SetLevel(const CATEGORY eCategory, const LEVEL eLevel)
+{
+	arrCategoryLevel[eCategory].store(eLevel, std::memory_order_relaxed);
+}
+
+/**
+ @brief Set the run-time level of all categories
+ @param eLevel The highest level of log messages to write
+ */
+void CLogger::SetLevel(const LEVEL eLevel)
+{
+	for (int i = 0; i < NUM_CATEGORY; i++)
+		arrCategoryLevel[i].store(eLevel, std::memory_order_relaxed);
+}
+
+/**
+ @brief Get the run-time level of a category
+ @param eCategory The category
+ @return The highest level of log messages written for this category
+ */
+CLogger::LEVEL CLogger::GetLevel(const CATEGORY eCategory) const
+{
+	return (LEVEL)arrCategoryLevel[eCategory].load(std::memory_order_relaxed);
+}
+
+/**
+ @brief Format a log message and add it to the ring buffer
+ @param eLevel The level of this log message
+ @param eCategory The category of this log message
+ @param format A printf-style format string
+ @return true if the message was added, false if the ring buffer was full
+ */
+bool CLogger::Log(const LEVEL eLevel, const CATEGORY eCategory, const char* format, ...)
+{
+	unsigned int uiPos = 0;
+	Slot* cSlot = Reserve(uiPos);
+	if (cSlot == NULL)
+	{
+		uiNumDropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	cSlot->eLevel = (unsigned char)eLevel;
+	cSlot->eCategory = (unsigned char)eCategory;
+	cSlot->fTime = (float)GetTime();
+
+	va_list args;
+	va_start(args, format);
+	vsnprintf(cSlot->message, uiMessageSize, format, args);
+	va_end(args);
+
+	// Publish the slot to the background thread
+	cSlot->uiSequence.store(uiPos + 1, std::memory_order_release);
+	return true;
+}
+
+/**
+ @brief Get the number of log messages which were dropped because the ring buffer was full
+ @return The number of dropped log messages
+ */
+unsigned int CLogger::GetNumDropped(void) const
+{
+	return uiNumDropped.load(std::memory_order_relaxed);
+}
+
+/**
+ @brief Get the time in seconds since the program started
+ @return The time in seconds
+ */
+double CLogger::GetTime(void)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - cStartTime).count();
+}
+
+/**
+ @brief Reserve a slot in the ring buffer
+ @param uiPos The position of the reserved slot
+ @return The reserved slot, or NULL if the ring buffer is full
+ */
+CLogger::Slot* CLogger::Reserve(unsigned int& uiPos)
+{
+	uiPos = uiEnqueuePos.load(std::memory_order_relaxed);
+	while (true)
+	{
+		Slot* cSlot = &arrSlots[uiPos & (uiNumSlots - 1)];
+		unsigned int uiSequence = cSlot->uiSequence.load(std::memory_order_acquire);
+		int iDifference = (int)(uiSequence - uiPos);
+		if (iDifference == 0)
+		{
+			// The slot is free; try to claim it
+			if (uiEnqueuePos.compare_exchange_weak(uiPos, uiPos + 1, std::memory_order_relaxed))
+				return cSlot;
+		}
+		else if (iDifference < 0)
+		{
+			// The slot has not been written out yet, so the ring buffer is full
+			return NULL;
+		}
+		else
+		{
+			// Another thread claimed this slot; try the next one
+			uiPos = uiEnqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+/**
+ @brief Write out all log messages in the ring buffer
+ @return The number of messages written
+ */
+unsigned int CLogger::Drain(void)
+{
+	unsigned int uiNumWritten = 0;
+	char buffer[uiMessageSize + 64];
+
+	while (true)
+	{
+		Slot* cSlot = &arrSlots[uiDequeuePos & (uiNumSlots - 1)];
+		unsigned int uiSequence = cSlot->uiSequence.load(std::memory_order_acquire);
+		if (uiSequence != uiDequeuePos + 1)
+			break;
+
+		snprintf(buffer, sizeof(buffer), "[%9.3f][%s][%s] %s\n",
+			cSlot->fTime,
+			arrLevelName[cSlot->eLevel],
+			arrCategoryName[cSlot->eCategory],
+			cSlot->message);
+
+		if (iOutput & OUTPUT_CONSOLE)
+			fputs(buffer, stdout);
+		if (iOutput & OUTPUT_FILE)
+			cFile << buffer;
+
+		// Release the slot for reuse in the next lap of the ring buffer
+		cSlot->uiSequence.store(uiDequeuePos + uiNumSlots, std::memory_order_release);
+		uiDequeuePos++;
+		uiNumWritten++;
+	}
+
+	if (uiNumWritten > 0)
+	{
+		if (iOutput & OUTPUT_CONSOLE)
+			fflush(stdout);
+		if (iOutput & OUTPUT_FILE)
+			cFile.flush();
+	}
+
+	return uiNumWritten;
+}
+
+/**
+ @brief The loop run by the background thread
+ */
+void CLogger::Run(void)
+{
+	while (bRunning.load())
+	{
+		// Sleep only when there is nothing to write, so that bursts are written out quickly
+		if (Drain() == 0)
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+}
@@ -0,0 +1,227 @@
+/**
+ CLogger
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "../DesignPatterns/SingletonTemplate.h"
+
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <string>
+using namespace std;
+
+// The levels of the log messages. These are #defines so that they can be used in #if
+#define LOG_LEVEL_OFF		0
+#define LOG_LEVEL_ERROR		1
+#define LOG_LEVEL_WARNING	2
+#define LOG_LEVEL_INFO		3
+#define LOG_LEVEL_DEBUG		4
+#define LOG_LEVEL_TRACE		5
+
+// Log messages above this level are removed by the compiler
+#ifndef LOG_COMPILE_LEVEL
+	#ifdef _DEBUG
+		#define LOG_COMPILE_LEVEL LOG_LEVEL_TRACE
+	#else
+		#define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+	#endif
+#endif
+
+class CLogger : public CSingletonTemplate<CLogger>
+{
+	friend CSingletonTemplate<CLogger>;
+public:
+	enum LEVEL
+	{
+		OFF = LOG_LEVEL_OFF,
+		LEVEL_ERROR = LOG_LEVEL_ERROR,
+		LEVEL_WARNING = LOG_LEVEL_WARNING,
+		LEVEL_INFO = LOG_LEVEL_INFO,
+		LEVEL_DEBUG = LOG_LEVEL_DEBUG,
+		LEVEL_TRACE = LOG_LEVEL_TRACE,
+		NUM_LEVEL
+	};
+
+	// The subsystems which write log messages. Each has its own run-time level
+	enum CATEGORY
+	{
+		GENERAL = 0,
+		ENTITY,
+		COLLISION,
+		AI,
+		WEAPON,
+		PHYSICS,
+		RENDER,
+		MAP,
+		AUDIO,
+		NUM_CATEGORY
+	};
+
+	// Where the background thread writes the log messages to. These can be combined
+	enum OUTPUT
+	{
+		OUTPUT_CONSOLE = 1,
+		OUTPUT_FILE = 2
+	};
+
+	// Initialise this class instance and start the background thread
+	bool Init(const int iOutput = OUTPUT_CONSOLE, const std::string& sFilename = "Log.txt");
+	// Stop the background thread after writing out the remaining log messages
+	void Stop(void);
+
+	// Set the run-time level of a category
+	void SetLevel(const CATEGORY eCategory, const LEVEL eLevel);
+	// Set the run-time level of all categories
+	void SetLevel(const LEVEL eLevel);
+	// Get the run-time level of a category
+	LEVEL GetLevel(const CATEGORY eCategory) const;
+
+	// Check if a log message will be written. This is called before formatting the message
+	static inline bool IsEnabled(const CATEGORY eCategory, const LEVEL eLevel)
+	{
+		return eLevel <= arrCategoryLevel[eCategory].load(std::memory_order_relaxed);
+	}
+
+	// Format a log message and add it to the ring buffer.
+	// This does not wait for the message to be written. Returns false if the ring buffer is full.
+	bool Log(const LEVEL eLevel, const CATEGORY eCategory, const char* format, ...);
+
+	// Get the number of log messages which were dropped because the ring buffer was full
+	unsigned int GetNumDropped(void) const;
+
+	// Get the time in seconds since the program started. Used for rate limiting
+	static double GetTime(void);
+
+protected:
+	// The number of slots in the ring buffer. Must be a power of 2
+	static const unsigned int uiNumSlots = 1024;
+	// The maximum length of a log message, including the null terminator
+	static const unsigned int uiMessageSize = 240;
+
+	// A slot in the ring buffer
+	struct Slot
+	{
+		std::atomic<unsigned int> uiSequence;
+		unsigned char eLevel;
+		unsigned char eCategory;
+		float fTime;
+		char message[uiMessageSize];
+	};
+
+	// The run-time level of each category
+	static std::atomic<int> arrCategoryLevel[NUM_CATEGORY];
+
+	// The ring buffer. Any thread may add messages; only the background thread removes them
+	Slot* arrSlots;
+	std::atomic<unsigned int> uiEnqueuePos;
+	unsigned int uiDequeuePos;
+
+	// The number of messages dropped because the ring buffer was full
+	std::atomic<unsigned int> uiNumDropped;
+
+	// The background thread
+	std::thread cThread;
+	std::atomic<bool> bRunning;
+
+	// Output
+	int iOutput;
+	std::ofstream cFile;
+
+	// Constructor
+	CLogger(void);
+	// Destructor
+	virtual ~CLogger(void);
+
+	// Reserve a slot in the ring buffer. Returns NULL if the ring buffer is full
+	Slot* Reserve(unsigned int& uiPos);
+	// Write out all log messages in the ring buffer. Returns the number of messages written
+	unsigned int Drain(void);
+	// The loop run by the background thread
+	void Run(void);
+};
+
+// Limits a log call site to one message per interval, so that it cannot flood the log
+class CLogRateLimiter
+{
+public:
+	// Constructor
+	CLogRateLimiter(const double dInterval)
+		: dInterval(dInterval)
+		, dNextTime(0.0)
+	{
+	}
+
+	// Check if a log message can be written now
+	bool Allow(void)
+	{
+		double dTime = CLogger::GetTime();
+		if (dTime < dNextTime)
+			return false;
+		dNextTime = dTime + dInterval;
+		return true;
+	}
+
+protected:
+	double dInterval;
+	double dNextTime;
+};
+
+// Write a log message if its category is enabled for its level at run-time
+#define LOG_MESSAGE(eLevel, eCategory, ...) \
+	do { \
+		if (CLogger::IsEnabled(eCategory, eLevel)) \
+			CLogger::GetInstance()->Log(eLevel, eCategory, __VA_ARGS__); \
+	} while (0)
+
+// Write a log message at most once every dInterval seconds from this call site
+#define LOG_MESSAGE_RATE_LIMITED(eLevel, eCategory, dInterval, ...) \
+	do { \
+		if (CLogger::IsEnabled(eCategory, eLevel)) \
+		{ \
+			static CLogRateLimiter cLogRateLimiter(dInterval); \
+			if (cLogRateLimiter.Allow()) \
+				CLogger::GetInstance()->Log(eLevel, eCategory, __VA_ARGS__); \
+		} \
+	} while (0)
+
+#define LOG_NOTHING do { } while (0)
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_ERROR
+	#define LOG_ERROR(eCategory, ...)	LOG_MESSAGE(CLogger::LEVEL_ERROR, CLogger::eCategory, __VA_ARGS__)
+#else
+	#define LOG_ERROR(eCategory, ...)	LOG_NOTHING
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_WARNING
+	#define LOG_WARNING(eCategory, ...)	LOG_MESSAGE(CLogger::LEVEL_WARNING, CLogger::eCategory, __VA_ARGS__)
+#else
+	#define LOG_WARNING(eCategory, ...)	LOG_NOTHING
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_INFO
+	#define LOG_INFO(eCategory, ...)	LOG_MESSAGE(CLogger::LEVEL_INFO, CLogger::eCategory, __VA_ARGS__)
+#else
+	#define LOG_INFO(eCategory, ...)	LOG_NOTHING
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_DEBUG
+	#define LOG_DEBUG(eCategory, ...)	LOG_MESSAGE(CLogger::LEVEL_DEBUG, CLogger::eCategory, __VA_ARGS__)
+	#define LOG_DEBUG_EVERY(dInterval, eCategory, ...) \
+		LOG_MESSAGE_RATE_LIMITED(CLogger::LEVEL_DEBUG, CLogger::eCategory, dInterval, __VA_ARGS__)
+#else
+	#define LOG_DEBUG(eCategory, ...)	LOG_NOTHING
+	#define LOG_DEBUG_EVERY(dInterval, eCategory, ...)	LOG_NOTHING
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_TRACE
+	#define LOG_TRACE(eCategory, ...)	LOG_MESSAGE(CLogger::LEVEL_TRACE, CLogger::eCategory, __VA_ARGS__)
+	#define LOG_TRACE_EVERY(dInterval, eCategory, ...) \
+		LOG_MESSAGE_RATE_LIMITED(CLogger::LEVEL_TRACE, CLogger::eCategory, dInterval, __VA_ARGS__)
+#else
+	#define LOG_TRACE(eCategory, ...)	LOG_NOTHING
+	#define LOG_TRACE_EVERY(dInterval, eCategory, ...)	LOG_NOTHING
+#endif
@@ -0,0 +1,212 @@
+#include "MemoryStats.h"
+
+// Include CLogger
+#include "Logger.h"
+
+#include <cstdlib>
+#include <new>
+
+// The counts of all threads
+std::atomic<unsigned long long> CMemoryStats::uiNumTotalAllocations(0);
+std::atomic<unsigned long long> CMemoryStats::uiNumTotalFrees(0);
+
+// The counts of the thread which called Init()
+unsigned long long CMemoryStats::uiNumThreadAllocations = 0;
+unsigned long long CMemoryStats::uiNumThreadBytes = 0;
+
+// Set in the thread which called Init()
+static thread_local bool bCountThread = false;
+
+/**
+ @brief Allocate memory from the heap and count it. This replaces the global operator new;
+		the array and nothrow forms call this one.
+ @param uiSize A size_t variable containing the number of bytes to allocate
+ @return A void* variable
+ */
+void* operator new(size_t uiSize)
+{
+	void* p = malloc(uiSize > 0 ? uiSize : 1);
+	if (p == NULL)
+		throw std::bad_alloc();
+	CMemoryStats::CountAllocation(uiSize);
+	return p;
+}
+
+/**
+ @brief Free memory which was allocated by operator new and count it. This replaces the global operator delete.
+ @param p A void* variable containing the memory to free
+ */
+void operator delete(void* p) noexcept
+{
+	if (p == NULL)
+		return;
+	CMemoryStats::CountFree();
+	free(p);
+}
+
+/**
+ @brief Free memory which was allocated by operator new and count it. This replaces the global sized operator delete.
+ @param p A void* variable containing the memory to free
+ */
+void operator delete(void* p, size_t) noexcept
+{
+	operator delete(p);
+}
+
+/**
+ @brief Constructor
+ */
+CMemoryStats::CMemoryStats(void)
+	: uiFrameStartAllocations(0)
+	, uiFrameStartBytes(0)
+	, uiNumFrameAllocations(0)
+	, uiNumFrameBytes(0)
+	, bExpectNoAllocations(false)
+	, bAllowFrameAllocations(false)
+	, uiNumUnexpectedFrames(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CMemoryStats::~CMemoryStats(void)
+{
+	bCountThread = false;
+}
+
+/**
+ @brief Initialise this class instance. The calling thread is the one whose frames are counted.
+ @return true if the initialisation is successful, else false
+ */
+bool CMemoryStats::Init(void)
+{
+	bCountThread = true;
+	uiNumUnexpectedFrames = 0;
+	BeginFrame();
+	return true;
+}
+
+/**
+ @brief Start counting the allocations of a frame
+ */
+void CMemoryStats::BeginFrame(void)
+{
+	uiFrameStartAllocations = uiNumThreadAllocations;
+	uiFrameStartBytes = uiNumThreadBytes;
+	bAllowFrameAllocations = false;
+}
+
+/**
+ @brief Stop counting the allocations of a frame
+ */
+void CMemoryStats::EndFrame(void)
+{
+	const unsigned int uiLastNumFrameAllocations = uiNumFrameAllocations;
+	uiNumFrameAllocations = (unsigned int)(uiNumThreadAllocations - uiFrameStartAllocations);
+	uiNumFrameBytes = (size_t)(uiNumThreadBytes - uiFrameStartBytes);
+
+	if ((bExpectNoAllocations == true) && (bAllowFrameAllocations == false) && (uiNumFrameAllocations > 0))
+	{
+		uiNumUnexpectedFrames++;
+		// Only warn when a run of frames starts allocating, so that the log is not flooded
+		if (uiLastNumFrameAllocations == 0)
+			LOG_WARNING(GENERAL, "%u heap allocations (%u bytes) in a frame which was expected to make none",
+						uiNumFrameAllocations, (unsigned int)uiNumFrameBytes);
+	}
+	LOG_DEBUG_EVERY(5.0, GENERAL, "Heap allocations in the last frame: %u (%u bytes)",
+					uiNumFrameAllocations, (unsigned int)uiNumFrameBytes);
+}
+
+/**
+ @brief Allow the current frame to allocate, such as when a wave of entities is spawned
+ */
+void CMemoryStats::AllowFrameAllocations(void)
+{
+	bAllowFrameAllocations = true;
+}
+
+/**
+ @brief Set if the frames are expected to make no heap allocations. A warning is logged when one does.
+ @param bExpectNoAllocations A const bool variable which is true if the frames should not allocate
+ */
+void CMemoryStats::SetExpectNoAllocations(const bool bExpectNoAllocations)
+{
+	this->bExpectNoAllocations = bExpectNoAllocations;
+}
+
+/**
+ @brief Check if the frames are expected to make no heap allocations
+ @return A bool variable
+ */
+bool CMemoryStats::IsExpectNoAllocations(void) const
+{
+	return bExpectNoAllocations;
+}
+
+/**
+ @brief Get the number of heap allocations in the last frame
+ @return An unsigned int variable
+ */
+unsigned int CMemoryStats::GetNumFrameAllocations(void) const
+{
+	return uiNumFrameAllocations;
+}
+
+/**
+ @brief Get the number of bytes allocated from the heap in the last frame
+ @return A size_t variable
+ */
+size_t CMemoryStats::GetNumFrameBytes(void) const
+{
+	return uiNumFrameBytes;
+}
+
+/**
+ @brief Get the number of frames which allocated when they were expected not to
+ @return An unsigned int variable
+ */
+unsigned int CMemoryStats::GetNumUnexpectedFrames(void) const
+{
+	return uiNumUnexpectedFrames;
+}
+
+/**
+ @brief Get the number of heap allocations by all threads since the program started
+ @return An unsigned long long variable
+ */
+unsigned long long CMemoryStats::GetNumTotalAllocations(void)
+{
+	return uiNumTotalAllocations.load(std::memory_order_relaxed);
+}
+
+/**
+ @brief Get the number of heap deallocations by all threads since the program started
+ @return An unsigned long long variable
+ */
+unsigned long long CMemoryStats::GetNumTotalFrees(void)
+{
+	return uiNumTotalFrees.load(std::memory_order_relaxed);
+}
+
+/**
+ @brief Count a heap allocation. This is called by operator new.
+ @param uiSize A const size_t variable containing the number of bytes allocated
+ */
+void CMemoryStats::CountAllocation(const size_t uiSize)
+{
+	uiNumTotalAllocations.fetch_add(1, std::memory_order_relaxed);
+	if (bCountThread)
+	{
+		uiNumThreadAllocations++;
+		uiNumThreadBytes += uiSize;
+	}
+}
+
+/**
+ @brief Count a heap deallocation. This is called by operator delete.
+ */
+void CMemoryStats::CountFree(void)
+{
+	uiNumTotalFrees.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,80 @@
+/**
+ CMemoryStats
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "../DesignPatterns/SingletonTemplate.h"
+
+#include <atomic>
+#include <cstddef>
+using namespace std;
+
+// Counts the heap allocations which are made through operator new, which is replaced in MemoryStats.cpp.
+// The totals include every thread, while the counts of each frame only include the thread which called
+// Init(), so that the frames of the steady-state gameplay can be checked for heap allocations.
+class CMemoryStats : public CSingletonTemplate<CMemoryStats>
+{
+	friend CSingletonTemplate<CMemoryStats>;
+
+public:
+	// Initialise this class instance. The calling thread is the one whose frames are counted.
+	bool Init(void);
+
+	// Start counting the allocations of a frame
+	void BeginFrame(void);
+	// Stop counting the allocations of a frame
+	void EndFrame(void);
+
+	// Allow the current frame to allocate, such as when a wave of entities is spawned
+	void AllowFrameAllocations(void);
+	// Set if the frames are expected to make no heap allocations. A warning is logged when one does.
+	void SetExpectNoAllocations(const bool bExpectNoAllocations);
+	// Check if the frames are expected to make no heap allocations
+	bool IsExpectNoAllocations(void) const;
+
+	// Get the number of heap allocations in the last frame
+	unsigned int GetNumFrameAllocations(void) const;
+	// Get the number of bytes allocated from the heap in the last frame
+	size_t GetNumFrameBytes(void) const;
+	// Get the number of frames which allocated when they were expected not to
+	unsigned int GetNumUnexpectedFrames(void) const;
+
+	// Get the number of heap allocations by all threads since the program started
+	static unsigned long long GetNumTotalAllocations(void);
+	// Get the number of heap deallocations by all threads since the program started
+	static unsigned long long GetNumTotalFrees(void);
+
+	// Count a heap allocation. This is called by operator new.
+	static void CountAllocation(const size_t uiSize);
+	// Count a heap deallocation. This is called by operator delete.
+	static void CountFree(void);
+
+protected:
+	// The counts of all threads
+	static std::atomic<unsigned long long> uiNumTotalAllocations;
+	static std::atomic<unsigned long long> uiNumTotalFrees;
+
+	// The counts of the thread which called Init(). Only that thread writes them.
+	static unsigned long long uiNumThreadAllocations;
+	static unsigned long long uiNumThreadBytes;
+
+	// The counts when the current frame started
+	unsigned long long uiFrameStartAllocations;
+	unsigned long long uiFrameStartBytes;
+
+	// The counts of the last frame
+	unsigned int uiNumFrameAllocations;
+	size_t uiNumFrameBytes;
+
+	bool bExpectNoAllocations;
+	bool bAllowFrameAllocations;
+	unsigned int uiNumUnexpectedFrames;
+
+	// Constructor
+	CMemoryStats(void);
+	// Destructor
+	virtual ~CMemoryStats(void);
+};
@@ -0,0 +1,128 @@
+/**
+ CObjectPool
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+using namespace std;
+
+// A pool of memory for the instances of a class T, for use by the class-specific operator new and
+// operator delete of T. The memory is allocated in blocks of uiBlockSize instances and is only returned
+// to the heap when the pool is destroyed, so deleting an instance and creating another reuses its memory.
+// This is not thread-safe; the instances must be created and deleted on the main thread.
+template <class T>
+class CObjectPool
+{
+public:
+	// The number of instances in each block
+	static const unsigned int uiBlockSize = 32;
+
+	// Constructor
+	CObjectPool(void)
+		: pFreeList(NULL)
+		, uiNumAllocated(0)
+		, uiNumPeak(0)
+	{
+	}
+
+	// Destructor
+	~CObjectPool(void)
+	{
+		for (unsigned int i = 0; i < vBlocks.size(); i++)
+			::operator delete(vBlocks[i]);
+		vBlocks.clear();
+		pFreeList = NULL;
+	}
+
+	// Allocate the memory of an instance. A class which inherits the operator new of T is bigger than T,
+	// so its instances are allocated from the heap instead.
+	void* Allocate(const size_t uiSize)
+	{
+		if (uiSize != sizeof(T))
+			return ::operator new(uiSize);
+
+		if (pFreeList == NULL)
+			AddBlock();
+
+		Slot* pSlot = pFreeList;
+		pFreeList = pSlot->pNext;
+		uiNumAllocated++;
+		if (uiNumAllocated > uiNumPeak)
+			uiNumPeak = uiNumAllocated;
+		return pSlot;
+	}
+
+	// Return the memory of an instance to the pool
+	void Free(void* p, const size_t uiSize)
+	{
+		if (p == NULL)
+			return;
+		if (uiSize != sizeof(T))
+		{
+			::operator delete(p);
+			return;
+		}
+
+		Slot* pSlot = static_cast<Slot*>(p);
+		pSlot->pNext = pFreeList;
+		pFreeList = pSlot;
+		uiNumAllocated--;
+	}
+
+	// Allocate enough blocks for a number of instances, so that creating them does not use the heap
+	void Reserve(const unsigned int uiNumInstances)
+	{
+		while (GetCapacity() < uiNumInstances)
+			AddBlock();
+	}
+
+	// Get the number of instances which fit in the blocks
+	unsigned int GetCapacity(void) const
+	{
+		return (unsigned int)vBlocks.size() * uiBlockSize;
+	}
+
+	// Get the number of instances which are allocated
+	unsigned int GetNumAllocated(void) const
+	{
+		return uiNumAllocated;
+	}
+
+	// Get the largest number of instances which were allocated at the same time
+	unsigned int GetNumPeak(void) const
+	{
+		return uiNumPeak;
+	}
+
+protected:
+	// The memory of an instance, which links to the next free slot while it is not allocated
+	union Slot
+	{
+		Slot* pNext;
+		alignas(T) unsigned char data[sizeof(T)];
+	};
+
+	// The blocks of slots, and the free slots in them
+	vector<Slot*> vBlocks;
+	Slot* pFreeList;
+
+	unsigned int uiNumAllocated;
+	unsigned int uiNumPeak;
+
+	// Allocate a block of slots and add them to the free list
+	void AddBlock(void)
+	{
+		Slot* pBlock = static_cast<Slot*>(::operator new(sizeof(Slot) * uiBlockSize));
+		vBlocks.push_back(pBlock);
+		// Link the slots in reverse, so that they are allocated in the order of their addresses
+		for (int i = (int)uiBlockSize - 1; i >= 0; i--)
+		{
+			pBlock[i].pNext = pFreeList;
+			pFreeList = &pBlock[i];
+		}
+	}
+};
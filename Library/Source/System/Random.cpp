@@ -0,0 +1,94 @@
+#include "Random.h"
+
+// Include CLogger
+#include "Logger.h"
+
+#include <chrono>
+
+/**
+ @brief Fill an array with random floats in [fMin, fMax)
+ @param pfOut A float* variable containing the array to fill
+ @param uiNum A const size_t variable containing the number of floats to fill
+ @param fMin A const float variable containing the minimum value
+ @param fMax A const float variable containing the maximum value
+ */
+void CRandom::FillFloat(float* pfOut, const size_t uiNum, const float fMin, const float fMax)
+{
+	const float fScale = (fMax - fMin) * (1.0f / 16777216.0f);
+	for (size_t i = 0; i < uiNum; i++)
+		pfOut[i] = fMin + (float)(NextUInt() >> 8) * fScale;
+}
+
+/**
+ @brief Fill an array with random unsigned integers
+ @param puiOut A uint32_t* variable containing the array to fill
+ @param uiNum A const size_t variable containing the number of integers to fill
+ */
+void CRandom::FillUInt(uint32_t* puiOut, const size_t uiNum)
+{
+	for (size_t i = 0; i < uiNum; i++)
+		puiOut[i] = NextUInt();
+}
+
+/**
+ @brief Constructor
+ */
+CRandomStreams::CRandomStreams(void)
+	: uiSeed(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CRandomStreams::~CRandomStreams(void)
+{
+}
+
+/**
+ @brief Initialise this class instance. A seed of 0 is replaced by a seed from the clock.
+ @param uiSeed A const uint64_t variable containing the global seed
+ @return true if the initialisation is successful, else false
+ */
+bool CRandomStreams::Init(const uint64_t uiSeed)
+{
+	this->uiSeed = uiSeed;
+	if (this->uiSeed == 0)
+		this->uiSeed = (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+
+	for (unsigned int i = 0; i < NUM_STREAMS; i++)
+		arrStream[i].Seed(this->uiSeed, i);
+
+	// Log the seed, so that a session can be replayed by setting it in CSettings
+	LOG_INFO(GENERAL, "Random seed: %llu", (unsigned long long)this->uiSeed);
+	return true;
+}
+
+/**
+ @brief Get the generator of a subsystem. It must only be used by the main thread.
+ @param eStream A const STREAM variable containing the subsystem
+ @return A CRandom& variable
+ */
+CRandom& CRandomStreams::Get(const STREAM eStream)
+{
+	return arrStream[eStream];
+}
+
+/**
+ @brief Create a generator for a worker thread, which owns it. Each uiWorkerStream gives an independent sequence.
+ @param uiWorkerStream A const unsigned int variable containing the number of the worker stream
+ @return A CRandom variable
+ */
+CRandom CRandomStreams::CreateWorkerStream(const unsigned int uiWorkerStream) const
+{
+	return CRandom(uiSeed, (uint64_t)NUM_STREAMS + uiWorkerStream);
+}
+
+/**
+ @brief Get the global seed
+ @return A uint64_t variable
+ */
+uint64_t CRandomStreams::GetSeed(void) const
+{
+	return uiSeed;
+}
@@ -0,0 +1,118 @@
+/**
+ CRandom
+ By: Toh Da Jun
+ Date: Oct 2026
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "../DesignPatterns/SingletonTemplate.h"
+
+#include <cstdint>
+#include <cstddef>
+using namespace std;
+
+// A PCG32 random number generator. Each generator has its own state, so it needs no lock, and generators
+// which are seeded with the same seed but different streams produce independent sequences.
+// A generator must only be used by one thread at a time; a worker thread should own its own stream.
+class CRandom
+{
+public:
+	// Constructor
+	CRandom(const uint64_t uiSeed = 0, const uint64_t uiStream = 0)
+	{
+		Seed(uiSeed, uiStream);
+	}
+
+	// Restart the sequence of a seed and a stream
+	void Seed(const uint64_t uiSeed, const uint64_t uiStream = 0)
+	{
+		// The increment must be odd, and selects the stream
+		uiState = 0;
+		uiIncrement = (uiStream << 1) | 1;
+		NextUInt();
+		uiState += uiSeed;
+		NextUInt();
+	}
+
+	// Get a random unsigned integer in [0, 0xFFFFFFFF]
+	uint32_t NextUInt(void)
+	{
+		const uint64_t uiOldState = uiState;
+		uiState = uiOldState * 6364136223846793005ULL + uiIncrement;
+		const uint32_t uiXorShifted = (uint32_t)(((uiOldState >> 18) ^ uiOldState) >> 27);
+		const uint32_t uiRotation = (uint32_t)(uiOldState >> 59);
+		return (uiXorShifted >> uiRotation) | (uiXorShifted << ((0u - uiRotation) & 31));
+	}
+
+	// Get a random float in [0, 1)
+	float NextFloat(void)
+	{
+		// Use the top 24 bits, which is the precision of a float
+		return (float)(NextUInt() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	// Get a random float in [fMin, fMax)
+	float RangeFloat(const float fMin, const float fMax)
+	{
+		return fMin + (fMax - fMin) * NextFloat();
+	}
+
+	// Get a random integer in [iMin, iMax]
+	int RangeInt(const int iMin, const int iMax)
+	{
+		if (iMax <= iMin)
+			return iMin;
+		// Scale by a multiply instead of a modulo, which is faster and less biased
+		const uint32_t uiRange = (uint32_t)((int64_t)iMax - iMin) + 1;
+		return (int)((int64_t)iMin + (int64_t)(((uint64_t)NextUInt() * uiRange) >> 32));
+	}
+
+	// Fill an array with random floats in [fMin, fMax), such as for the SIMD code which reads them 4 at a time
+	void FillFloat(float* pfOut, const size_t uiNum, const float fMin, const float fMax);
+	// Fill an array with random unsigned integers
+	void FillUInt(uint32_t* puiOut, const size_t uiNum);
+
+protected:
+	uint64_t uiState;
+	uint64_t uiIncrement;
+};
+
+// Owns a CRandom for each subsystem, all seeded from one global seed. Each subsystem draws from its own
+// stream, so a change in how many numbers one subsystem uses does not change the numbers of the others,
+// and a session which is started with the same seed and the same inputs plays out the same way.
+class CRandomStreams : public CSingletonTemplate<CRandomStreams>
+{
+	friend CSingletonTemplate<CRandomStreams>;
+
+public:
+	// The subsystems which have their own stream
+	enum STREAM
+	{
+		GENERAL = 0,
+		SPAWN,		// Spawning of enemies and pickups
+		WEAPON,		// Bullet spread and recoil
+		PLACEMENT,	// Placement of the scenery
+		NUM_STREAMS
+	};
+
+	// Initialise this class instance. A seed of 0 is replaced by a seed from the clock.
+	bool Init(const uint64_t uiSeed = 0);
+
+	// Get the generator of a subsystem. It must only be used by the main thread.
+	CRandom& Get(const STREAM eStream);
+	// Create a generator for a worker thread, which owns it. Each uiWorkerStream gives an independent sequence.
+	CRandom CreateWorkerStream(const unsigned int uiWorkerStream) const;
+
+	// Get the global seed
+	uint64_t GetSeed(void) const;
+
+protected:
+	uint64_t uiSeed;
+	CRandom arrStream[NUM_STREAMS];
+
+	// Constructor
+	CRandomStreams(void);
+	// Destructor
+	virtual ~CRandomStreams(void);
+};